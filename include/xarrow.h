@@ -0,0 +1,25 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ *  A set of functions for exporting arrays of structures as Apache Arrow IPC streams or files, in which each
+ *  scalar field becomes a contiguous column.
+ */
+
+#ifndef XARROW_H_
+#define XARROW_H_
+
+#include <stdio.h>
+#include <stddef.h>
+#include <xchange.h>
+
+#define XARROW_STREAM       0       ///< Arrow IPC streaming format
+#define XARROW_FILE         1       ///< Arrow IPC (random access) file format
+
+void *xarrowEncode(const XStructure *s, int n, int format, size_t *size);
+void *xarrowEncodeField(const XField *f, int format, size_t *size);
+int xarrowWrite(const XStructure *s, int n, int format, FILE *fp);
+
+#endif /* XARROW_H_ */
@@ -0,0 +1,22 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ *  A set of functions for converting structured data to and from a compact, platform-independent binary
+ *  representation.
+ */
+
+#ifndef XBIN_H_
+#define XBIN_H_
+
+#include <stddef.h>
+#include <xchange.h>
+
+#define XBIN_VERSION                 1  ///< Version of the binary format produced by xbinEncode().
+
+void *xbinEncode(const XStructure *s, size_t *size);
+XStructure *xbinDecode(const void *data, size_t size);
+
+#endif /* XBIN_H_ */
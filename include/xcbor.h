@@ -0,0 +1,20 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ *  A set of functions for converting structured data to and from CBOR (RFC 8949), using RFC 8746 typed arrays for
+ *  numerical data.
+ */
+
+#ifndef XCBOR_H_
+#define XCBOR_H_
+
+#include <stddef.h>
+#include <xchange.h>
+
+void *xcborEncode(const XStructure *s, size_t *size);
+XStructure *xcborDecode(const void *data, size_t size);
+
+#endif /* XCBOR_H_ */
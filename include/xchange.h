@@ -151,6 +151,8 @@ typedef int XType;          ///< SMA-X data type.
 #define X_MAX_DIMS                      20      ///< Maximum number of dimensionas (2^20 -> 1 million points).
 #define X_MAX_STRING_DIMS               (2 * X_MAX_DIMS + 1)    ///< \hideinitializer Maximum length of string representation of dimensions
 #define X_MAX_ELEMENTS                  (1<<X_MAX_DIMS)         ///< \hideinitializer Maximum number of array elements (~1 million).
+#define X_INLINE_DIMS                   3       ///< Number of dimensions stored inside fields (see xSetFieldDims())
+#define X_INLINE_VALUE_SIZE             16      ///< (bytes) Largest value that may be stored inside a field (see xSetValueInlining())
 
 
 #ifndef _TYPEDEF_BOOLEAN
@@ -193,19 +195,41 @@ typedef struct XField {
                             ///< entirely up to the user / application to assing meaning to this field.
                             ///< NOTE: it should normally be dynamically allocated, to work with xClearField() / xDestroyField().
   int ndim;                 ///< The dimensionality of the data
-  int sizes[X_MAX_DIMS];    ///< The sizes along each dimension
+  int sizes[X_INLINE_DIMS]; ///< The sizes along the leading dimensions. Fields with more than X_INLINE_DIMS dimensions
+                            ///< store all their dimensions elsewhere, so use xGetFieldSizes() / xSetFieldDims() to
+                            ///< access all dimensions.
+  int *extSizes;            ///< (private) All dimensions, if there are more than X_INLINE_DIMS, or else NULL. Do not
+                            ///< modify.
   boolean isSerialized;     ///< Whether the fields is stored in serialized (string) format.
   struct XField *next;      ///< Pointer to the next linked element (if inside an XStructure).
+  void *cache;              ///< (private) Decoded data cached by the library for serialized values. Do not modify.
+  void *pool;               ///< (private) The storage block containing this field, or NULL if the field was allocated
+                            ///< individually (e.g. with malloc()). Do not modify.
+  union {
+    long long l;            ///< (private) for alignment only
+    double d;               ///< (private) for alignment only
+    void *ptr;              ///< (private) for alignment only
+    char bytes[X_INLINE_VALUE_SIZE]; ///< (private) the inline storage
+  } local;                  ///< (private) Storage for small values inside the field itself (see xSetValueInlining()).
+                            ///< Do not modify.
 } XField;
 
 /**
  * Static initializer for the XField data structure.
   */
-#define X_FIELD_INIT        {NULL, NULL, X_UNKNOWN, NULL, 0, {0}, FALSE, NULL}
+#define X_FIELD_INIT        {NULL, NULL, X_UNKNOWN, NULL, 0, {0}, NULL, FALSE, NULL, NULL, NULL, {0}}
 
 /**
  * \brief SMA-X structure object, containing a linked-list of XField elements.
  *
+ * Large structures are indexed automatically (by field name), so that xGetField(), xSetField(), xRemoveField()
+ * and xCountFields() take constant time, regardless of the number of fields. The index is kept up to date by all
+ * library functions that modify structures. If you modify the linked list of fields directly, other than by changing
+ * `firstField` (which is detected), call xClearStructIndex() afterwards (see there for details).
+ *
+ * The fields of a structure may also be relocated into contiguous storage with xPackStruct(), so that traversing
+ * the structure (e.g. for serialization) streams through memory, rather than chasing pointers across the heap.
+ *
  * \sa smaxCreateStruct()
  * \sa smaxDestroyStruct()
  * \sa smaxShareStruct()
@@ -213,6 +237,9 @@ typedef struct XField {
 typedef struct XStructure {
   XField *firstField;           ///< Pointer to the first field in this structure or NULL if the structure is empty.
   struct XStructure *parent;    ///< Reference to parent structure (if any)
+  void *index;                  ///< (private) Hash index of the fields in large structures. Do not modify.
+  void *pool;                   ///< (private) The storage containing this structure, or NULL if it was allocated
+                                ///< individually (e.g. with malloc()). Do not modify.
 } XStructure;
 
 /**
@@ -243,6 +270,14 @@ extern boolean xDebug;          ///< Switch to enable debugging (very verbose) o
 boolean xIsVerbose();
 void xSetVerbose(boolean value);
 void xSetDebug(boolean value);
+void xSetNodePooling(boolean value);
+boolean xIsNodePooling();
+void xSetValueInlining(boolean value);
+boolean xIsValueInlining();
+void xSetNameInterning(boolean value);
+boolean xIsNameInterning();
+const char *xInternName(const char *name);
+boolean xIsInternedName(const char *name);
 int xError(const char *fn, int code);
 const char *xErrorDescription(int code);
 
@@ -258,9 +293,12 @@ void xClearField(XField *f);
 void xDestroyField(XField *f);
 XField *xGetField(const XStructure *s, const char *name);
 XField *xSetField(XStructure *s, XField *f);
+int xInsertField(XStructure *s, XField *f);
 XField *xRemoveField(XStructure *s, const char *name);
 boolean xIsFieldValid(const XField *f);
 long xGetFieldCount(const XField *f);
+const int *xGetFieldSizes(const XField *f);
+int xSetFieldDims(XField *f, int ndim, const int *sizes);
 void *xGetElementAtIndex(const XField *f, int idx);
 long xGetAsLongAtIndex(const XField *f, int idx, long defaultValue);
 double xGetAsDoubleAtIndex(const XField *f, int idx);
@@ -270,12 +308,17 @@ double xGetAsDouble(const XField *f);
 char *xGetStringValue(const XField *f);
 
 int xCountFields(const XStructure *s);
+void xClearStructIndex(XStructure *s);
+int xPackStruct(XStructure *s);
 long xDeepCountFields(const XStructure *s);
 XStructure *xGetSubstruct(const XStructure *s, const char *id);
 XField *xSetSubstruct(XStructure *s, const char *name, XStructure *substruct);
 int xReduceDims(int *ndim, int *sizes);
 int xReduceStruct(XStructure *s);
 int xReduceField(XField *f);
+int xSerializeField(XField *f);
+int xDeserializeField(XField *f);
+void xClearFieldCache(XField *f);
 
 // Sorting, ordering
 int xSortFields(XStructure *s, int (*cmp)(const XField **f1, const XField **f2), boolean recursive);
@@ -347,10 +390,42 @@ char *xStringCopyOf(const char *str);
 #  define NAN               (0.0/0.0)
 #endif
 
+/**
+ * A growable output buffer, to which encoders append their bytes.
+ */
+typedef struct {
+  unsigned char *data;      ///< The output buffer
+  size_t n;                 ///< (bytes) Number of bytes written
+  size_t size;              ///< (bytes) Allocated size of the buffer
+} XBuffer;
+
 int x_error(int ret, int en, const char *from, const char *desc, ...);
 int x_warn(const char *from, const char *desc, ...);
 int x_trace(const char *loc, const char *op, int n);
 void *x_trace_null(const char *loc, const char *op);
+void x_swap_bytes(void *data, int eSize, long count);
+unsigned char *x_buffer_reserve(XBuffer *b, size_t m);
+void x_buffer_put(XBuffer *b, const void *src, size_t m);
+char *x_print_scalar(char *dst, XType type, const void *value);
+int x_parse_scalar(const char *str, XType type, void *value);
+XField *x_alloc_field();
+XField *x_alloc_fields(int n);
+XField *x_append_new_field(XStructure *s, XField **last);
+void x_free_field(XField *f);
+XStructure *x_alloc_struct();
+void x_free_struct(XStructure *s);
+void *x_alloc_value(XField *f, int n);
+char *x_copy_element_string(XField *f, const char *str);
+boolean x_is_inline(const XField *f, const void *ptr);
+void x_free_value(const XField *f, void *ptr);
+void x_rebase_value(XField *f, const XField *from);
+char *x_copy_name(const char *name);
+char *x_adopt_name(char *name);
+void x_free_name(char *name);
+
+#  if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#    define X_BIG_ENDIAN_HOST   1     ///< Defined if the native byte order is big-endian
+#  endif
 
 /**
  * Propagates an error (if any) with an offset. If the error is non-zero, it returns with the offset
@@ -0,0 +1,23 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ *  A set of functions for writing arrays of structures as CSV or TSV tables, and for reading such tables back
+ *  into arrays of structures, for bulk exchange with spreadsheets and databases.
+ */
+
+#ifndef XCSV_H_
+#define XCSV_H_
+
+#include <stdio.h>
+#include <xchange.h>
+
+#define XCSV_COMMA          ','     ///< Column delimiter for CSV (comma-separated values)
+#define XCSV_TAB            '\t'    ///< Column delimiter for TSV (tab-separated values)
+
+int xcsvWrite(const XStructure *s, int n, char delim, FILE *fp);
+XField *xcsvRead(const char *name, FILE *fp, char delim, const XStructure *proto);
+
+#endif /* XCSV_H_ */
@@ -0,0 +1,72 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ *  Frozen images of structured data, in which all links are relative offsets rather than pointers. Images can be
+ *  memory mapped from files, or published into shared memory segments, and queried in place through read-only
+ *  accessors, without deserialization.
+ */
+
+#ifndef XFROZEN_H_
+#define XFROZEN_H_
+
+#include <stddef.h>
+#include <xchange.h>
+
+#define XFROZEN_VERSION     1       ///< Version of the frozen image layout
+
+/**
+ * A structure inside a frozen image. It is opaque, and may be accessed only via the xfrozen...() functions.
+ */
+typedef struct XFrozenStruct XFrozenStruct;
+
+/**
+ * A field inside a frozen image. It is opaque, and may be accessed only via the xfrozen...() functions.
+ */
+typedef struct XFrozenField XFrozenField;
+
+/**
+ * A shared memory segment, into which one process publishes frozen images of structures, which other processes
+ * on the same host can read in place. It is opaque, and may be accessed only via the xfrozen...() functions.
+ *
+ * @since 1.1
+ */
+typedef struct XFrozenSegment XFrozenSegment;
+
+void *xfrozenCreate(const XStructure *s, size_t *size);
+const XFrozenStruct *xfrozenRoot(const void *image, size_t size);
+XStructure *xfrozenThaw(const XFrozenStruct *s);
+
+const void *xfrozenMapFile(const char *fileName, size_t *size);
+int xfrozenUnmapFile(const void *image, size_t size);
+
+int xfrozenCountFields(const XFrozenStruct *s);
+const XFrozenField *xfrozenGetFieldByIndex(const XFrozenStruct *s, int idx);
+const XFrozenField *xfrozenGetField(const XFrozenStruct *s, const char *id);
+
+const char *xfrozenGetName(const XFrozenField *f);
+XType xfrozenGetType(const XFrozenField *f);
+const char *xfrozenGetSubtype(const XFrozenField *f);
+boolean xfrozenIsSerialized(const XFrozenField *f);
+int xfrozenGetDims(const XFrozenField *f, int *sizes);
+long xfrozenGetFieldCount(const XFrozenField *f);
+
+const void *xfrozenGetValue(const XFrozenField *f);
+const void *xfrozenGetElementAtIndex(const XFrozenField *f, int idx);
+const char *xfrozenGetStringAtIndex(const XFrozenField *f, int idx);
+const XFrozenStruct *xfrozenGetStructAtIndex(const XFrozenField *f, int idx);
+const XFrozenField *xfrozenGetFieldAtIndex(const XFrozenField *f, int idx);
+
+XFrozenSegment *xfrozenCreateSegment(const char *name, size_t capacity);
+XFrozenSegment *xfrozenAttachSegment(const char *name);
+int xfrozenCloseSegment(XFrozenSegment *seg);
+int xfrozenRemoveSegment(const char *name);
+int xfrozenPublish(XFrozenSegment *seg, const XStructure *s);
+uint64_t xfrozenGetGeneration(const XFrozenSegment *seg);
+const XFrozenStruct *xfrozenBeginRead(const XFrozenSegment *seg, uint64_t *generation);
+boolean xfrozenEndRead(const XFrozenSegment *seg, uint64_t generation);
+XStructure *xfrozenSnapshot(const XFrozenSegment *seg, uint64_t *generation);
+
+#endif /* XFROZEN_H_ */
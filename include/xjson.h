@@ -11,6 +11,7 @@
 #define XJSON_H_
 
 #include <stdio.h>
+#include <sys/uio.h>
 #include <xchange.h>
 
 #define XJSON_DEFAULT_INDENT         2  ///< Number of characters to indent.
@@ -19,12 +20,49 @@
 #  define NULLDEV "/dev/null"           ///< null device on system
 #endif
 
+/**
+ * A precompiled emission plan for the JSON representation of structures with a fixed layout.
+ *
+ * @since 1.1
+ *
+ * @sa xjsonCompile()
+ * @sa xjsonRender()
+ * @sa xjsonDestroyPlan()
+ */
+typedef struct {
+  void *priv;                   ///< Private data, not exposed to users
+} XJsonPlan;
+
+/**
+ * JSON representation of structured data as a list of I/O vectors, e.g. for `writev()`.
+ *
+ * @since 1.1
+ *
+ * @sa xjsonToIOVector()
+ * @sa xjsonDestroyIOVector()
+ */
+typedef struct {
+  struct iovec *iov;            ///< Array of I/O vectors
+  int n;                        ///< Number of I/O vectors in the array
+  void *priv;                   ///< Private data, not exposed to users
+} XJsonIOVector;
+
 void xjsonSetIndent(int nchars);
 int xjsonGetIndent();
+void xjsonSetThreads(int n);
+int xjsonGetThreads();
+void xjsonSetBase64Threshold(int nElements);
+int xjsonGetBase64Threshold();
 
 char *xjsonToString(const XStructure *s);
 char *xjsonFieldToString(const XField *f);
 char *xjsonFieldToIndentedString(int indent, const XField *f);
+XJsonIOVector *xjsonToIOVector(const XStructure *s);
+void xjsonDestroyIOVector(XJsonIOVector *v);
+char *xjsonDiff(const XStructure *old, const XStructure *updated);
+XJsonPlan *xjsonCompile(const XStructure *s);
+char *xjsonRender(const XJsonPlan *plan, const XStructure *s);
+void xjsonDestroyPlan(XJsonPlan *plan);
 XStructure *xjsonParseString(const char *src, char **tail);
 XStructure *xjsonParsePath(const char *fileName);
 XStructure *xjsonParseFile(FILE *file, size_t length);
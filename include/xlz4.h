@@ -0,0 +1,35 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ *  A set of functions for compressing and decompressing serialized data (JSON, binary, CSV etc.) on the fly, using
+ *  the standard LZ4 frame format, with a built-in block codec (no external dependency).
+ */
+
+#ifndef XLZ4_H_
+#define XLZ4_H_
+
+#include <stdio.h>
+#include <xchange.h>
+
+/**
+ * An LZ4 compressing or decompressing stream.
+ *
+ * @since 1.1
+ */
+typedef struct XLZ4Stream XLZ4Stream;
+
+XLZ4Stream *xlz4OpenWriter(FILE *fp);
+int xlz4Write(XLZ4Stream *z, const void *data, size_t size);
+XLZ4Stream *xlz4OpenReader(FILE *fp);
+long xlz4Read(XLZ4Stream *z, void *buf, size_t size);
+int xlz4Close(XLZ4Stream *z);
+
+void *xlz4Compress(const void *data, size_t size, size_t *outSize);
+void *xlz4Decompress(const void *data, size_t size, size_t *outSize);
+
+FILE *xlz4Open(FILE *fp, const char *mode);
+
+#endif /* XLZ4_H_ */
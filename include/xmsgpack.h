@@ -0,0 +1,19 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ *  A set of functions for converting structured data to and from MessagePack (https://msgpack.org).
+ */
+
+#ifndef XMSGPACK_H_
+#define XMSGPACK_H_
+
+#include <stddef.h>
+#include <xchange.h>
+
+void *xmsgpackEncode(const XStructure *s, size_t *size);
+XStructure *xmsgpackDecode(const void *data, size_t size);
+
+#endif /* XMSGPACK_H_ */
@@ -0,0 +1,21 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ *  A set of functions for writing numerical array fields to NumPy `.npy` files, and for loading (or memory mapping)
+ *  `.npy` files into fields, for fast binary data exchange with Python.
+ */
+
+#ifndef XNPY_H_
+#define XNPY_H_
+
+#include <xchange.h>
+
+int xnpyWrite(const XField *f, const char *fileName);
+XField *xnpyRead(const char *fileName, const char *name);
+XField *xnpyMap(const char *fileName, const char *name);
+int xnpyUnmap(XField *f);
+
+#endif /* XNPY_H_ */
@@ -0,0 +1,23 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ *  A set of functions for encoding structured data as pipelined RESP (Redis serialization protocol) commands, and
+ *  for decoding RESP2 / RESP3 replies into fields.
+ */
+
+#ifndef XRESP_H_
+#define XRESP_H_
+
+#include <stddef.h>
+#include <xchange.h>
+
+#define XRESP_ERROR_SUBTYPE     "error"     ///< Subtype of decoded RESP error replies
+#define XRESP_BIGNUM_SUBTYPE    "bignum"    ///< Subtype of decoded RESP3 big numbers
+
+char *xrespEncodeHSET(const XStructure *s, const char *id, size_t *size, int *nCommands);
+XField *xrespDecode(const char *name, const void *data, size_t size, size_t *len);
+
+#endif /* XRESP_H_ */
@@ -0,0 +1,718 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * @brief   Apache Arrow IPC (columnar) export for arrays of structures.
+ *
+ *  An array of structures (records) is written as an Arrow table, in which each scalar field of the first record
+ *  becomes a column, with the same name, and the field values of all records are stored contiguously in the
+ *  column's buffers. The XTypes map to Arrow types as:
+ *
+ *  | XType                       | Arrow type       |
+ *  |-----------------------------|------------------|
+ *  | `X_BOOLEAN`                 | `bool`           |
+ *  | `X_BYTE`                    | `int8`           |
+ *  | `X_INT16`                   | `int16`          |
+ *  | `X_INT32`                   | `int32`          |
+ *  | `X_INT64`                   | `int64`          |
+ *  | `X_FLOAT`                   | `float32`        |
+ *  | `X_DOUBLE`                  | `float64`        |
+ *  | `X_STRING` / `X_CHARS(n)`   | `utf8`           |
+ *
+ *  All columns are nullable. Records in which a column's field is missing, has a different type, is serialized, or
+ *  is not a scalar, have a null value in that column. Other fields (arrays, substructures etc.) are not exported.
+ *
+ *  The Arrow IPC messages (schema, record batches, and footer) are FlatBuffers, which are built here directly,
+ *  without any dependency on the Arrow or FlatBuffers libraries. Column data are written in the native byte
+ *  order (which is declared in the schema), with up to ARROW_BATCH_ROWS records per record batch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+#define __XCHANGE_INTERNAL_API__        ///< Use internal definitions
+#include "xarrow.h"
+
+#ifndef TRUE
+#define TRUE 1          ///< Boolean 'true' in case it isn't already defined
+#endif
+
+#ifndef FALSE
+#define FALSE 0         ///< Boolean 'false' in case it isn't already defined
+#endif
+
+/// \cond PRIVATE
+#define ARROW_MAGIC             "ARROW1"        ///< Leading and trailing magic of Arrow IPC files
+#define ARROW_CONTINUATION      0xffffffffU     ///< IPC message continuation marker
+#define ARROW_BATCH_ROWS        65536           ///< Maximum number of records per record batch
+
+#define ARROW_VERSION_V5        4               ///< MetadataVersion.V5
+
+#define ARROW_HEADER_SCHEMA     1               ///< MessageHeader.Schema
+#define ARROW_HEADER_BATCH      3               ///< MessageHeader.RecordBatch
+
+#define ARROW_TYPE_INT          2               ///< Type.Int
+#define ARROW_TYPE_FLOAT        3               ///< Type.FloatingPoint
+#define ARROW_TYPE_UTF8         5               ///< Type.Utf8
+#define ARROW_TYPE_BOOL         6               ///< Type.Bool
+
+#define ARROW_MAX_TABLE_FIELDS  6               ///< Largest number of fields in the tables we write
+
+#if defined(X_BIG_ENDIAN_HOST)
+#  define ARROW_ENDIANNESS      1               ///< Endianness.Big
+#else
+#  define ARROW_ENDIANNESS      0               ///< Endianness.Little
+#endif
+
+typedef struct {
+  XBuffer buf;              ///< The output buffer
+  FILE *fp;                 ///< File to which to flush complete messages, or NULL to keep all in the buffer
+  size_t flushed;           ///< (bytes) Number of bytes already written to the file
+} ArrowWriter;
+
+/// A field of a FlatBuffers table
+typedef struct {
+  int size;                 ///< (bytes) Size of the field (1, 2, 4, or 8), or 0 if the field is absent
+  long long value;          ///< Scalar value (or 0 for offsets, which are set later via PutOffset())
+  size_t pos;               ///< [out] Position of the field in the buffer
+} FbField;
+
+/// A block (message) in an Arrow IPC file
+typedef struct {
+  size_t offset;            ///< (bytes) Offset of the message in the file
+  int metaLength;           ///< (bytes) Length of the message metadata, including prefix and padding
+  size_t bodyLength;        ///< (bytes) Length of the message body
+} ArrowBlock;
+
+/// A column, and its buffers for the current record batch
+typedef struct {
+  const char *name;         ///< Column name
+  XType type;               ///< Field type (X_STRING for all character types)
+  int eSize;                ///< (bytes) Size of fixed-width values, or 0 for booleans and strings
+  unsigned char *validity;  ///< Validity bitmap
+  unsigned char *values;    ///< Values (bit-packed for booleans), or 32-bit offsets for strings
+  char *data;               ///< String data
+  size_t nData;             ///< (bytes) Size of the string data
+  size_t dataSize;          ///< (bytes) Allocated size of the string data buffer
+  long nulls;               ///< Number of null values in the current batch
+} ArrowColumn;
+/// \endcond
+
+static void PutZeros(ArrowWriter *w, size_t m) {
+  if(m) memset(x_buffer_reserve(&w->buf, m), 0, m);
+  w->buf.n += m;
+}
+
+static void Align(ArrowWriter *w, int a) {
+  PutZeros(w, (a - w->buf.n % a) % a);
+}
+
+/// Sets a little-endian value (as all FlatBuffers scalars are) at the specified position.
+static void SetLE(ArrowWriter *w, size_t pos, unsigned long long value, int nBytes) {
+  int i;
+  for(i = 0; i < nBytes; i++, value >>= 8) w->buf.data[pos + i] = value & 0xff;
+}
+
+static void PutLE(ArrowWriter *w, unsigned long long value, int nBytes) {
+  x_buffer_reserve(&w->buf, nBytes);
+  SetLE(w, w->buf.n, value, nBytes);
+  w->buf.n += nBytes;
+}
+
+/// Sets the (forward) offset at the specified position to point to the target position.
+static void PutOffset(ArrowWriter *w, size_t at, size_t target) {
+  SetLE(w, at, target - at, 4);
+}
+
+/**
+ * Writes a FlatBuffers table, preceded by its vtable. Offset fields are left zero, and must be set via PutOffset()
+ * once their targets (which must follow the table) have been written.
+ */
+static size_t PutTable(ArrowWriter *w, FbField *fields, int nFields) {
+  int vt[ARROW_MAX_TABLE_FIELDS];
+  int i, tableSize = 4;
+  size_t vtPos, t;
+
+  // Layout, with each field aligned to its size
+  for(i = 0; i < nFields; i++) {
+    int size = fields[i].size;
+    if(!size) {
+      vt[i] = 0;
+      continue;
+    }
+    tableSize = (tableSize + size - 1) & ~(size - 1);
+    vt[i] = tableSize;
+    tableSize += size;
+  }
+
+  Align(w, 2);
+  vtPos = w->buf.n;
+  PutLE(w, 4 + 2 * nFields, 2);
+  PutLE(w, tableSize, 2);
+  for(i = 0; i < nFields; i++) PutLE(w, vt[i], 2);
+
+  Align(w, 8);
+  t = w->buf.n;
+  PutLE(w, t - vtPos, 4);       // vtable is at (table - soffset)
+  PutZeros(w, tableSize - 4);
+
+  for(i = 0; i < nFields; i++) if(fields[i].size) {
+    fields[i].pos = t + vt[i];
+    SetLE(w, fields[i].pos, fields[i].value, fields[i].size);
+  }
+
+  return t;
+}
+
+static size_t PutString(ArrowWriter *w, const char *str) {
+  size_t pos, l = strlen(str);
+
+  Align(w, 4);
+  pos = w->buf.n;
+  PutLE(w, l, 4);
+  x_buffer_put(&w->buf, str, l + 1);
+  return pos;
+}
+
+/// Starts a vector of offsets (e.g. to tables), with the elements to be set later via PutOffset().
+static size_t PutOffsetVector(ArrowWriter *w, int count) {
+  size_t pos;
+
+  Align(w, 4);
+  pos = w->buf.n;
+  PutLE(w, count, 4);
+  PutZeros(w, 4 * count);
+  return pos;
+}
+
+/// Starts a vector of 8-byte aligned structs, which the caller should write next.
+static size_t StartStructVector(ArrowWriter *w, int count) {
+  size_t pos;
+
+  Align(w, 4);
+  if(w->buf.n % 8 == 0) PutZeros(w, 4);
+  pos = w->buf.n;
+  PutLE(w, count, 4);
+  return pos;
+}
+
+static size_t PutTypeTable(ArrowWriter *w, XType type) {
+  FbField f[2] = {{0, 0, 0}};
+
+  switch(type) {
+    case X_BYTE:
+    case X_INT16:
+    case X_INT32:
+    case X_INT64:
+      f[0].size = 4;
+      f[0].value = 8 * xElementSizeOf(type);    // bitWidth
+      f[1].size = 1;
+      f[1].value = TRUE;                        // is_signed
+      return PutTable(w, f, 2);
+    case X_FLOAT:
+    case X_DOUBLE:
+      f[0].size = 2;
+      f[0].value = (type == X_FLOAT) ? 1 : 2;   // precision: SINGLE or DOUBLE
+      return PutTable(w, f, 1);
+    default:
+      return PutTable(w, f, 0);                 // Bool and Utf8 have no properties
+  }
+}
+
+static int GetTypeID(XType type) {
+  switch(type) {
+    case X_BOOLEAN: return ARROW_TYPE_BOOL;
+    case X_FLOAT:
+    case X_DOUBLE: return ARROW_TYPE_FLOAT;
+    case X_STRING: return ARROW_TYPE_UTF8;
+    default: return ARROW_TYPE_INT;
+  }
+}
+
+static size_t PutFieldTable(ArrowWriter *w, const ArrowColumn *c) {
+  // name, nullable, type_type, type, dictionary, children
+  FbField f[6] = {{4, 0, 0}, {1, TRUE, 0}, {1, 0, 0}, {4, 0, 0}, {0, 0, 0}, {4, 0, 0}};
+  size_t t;
+
+  f[2].value = GetTypeID(c->type);
+  t = PutTable(w, f, 6);
+
+  PutOffset(w, f[0].pos, PutString(w, c->name));
+  PutOffset(w, f[3].pos, PutTypeTable(w, c->type));
+  PutOffset(w, f[5].pos, PutOffsetVector(w, 0));
+
+  return t;
+}
+
+static size_t PutSchemaTable(ArrowWriter *w, const ArrowColumn *cols, int nCols) {
+  // endianness, fields
+  FbField f[2] = {{2, ARROW_ENDIANNESS, 0}, {4, 0, 0}};
+  size_t t, v;
+  int i;
+
+  t = PutTable(w, f, 2);
+  v = PutOffsetVector(w, nCols);
+  PutOffset(w, f[1].pos, v);
+
+  for(i = 0; i < nCols; i++) PutOffset(w, v + 4 + 4 * i, PutFieldTable(w, &cols[i]));
+
+  return t;
+}
+
+/// Starts an encapsulated IPC message, with the header of the given type and the given body length.
+static size_t StartMessage(ArrowWriter *w, int headerType, size_t bodyLength, size_t *header) {
+  // version, header_type, header, bodyLength
+  FbField f[4] = {{2, ARROW_VERSION_V5, 0}, {1, 0, 0}, {4, 0, 0}, {8, 0, 0}};
+  size_t start = w->buf.n, t;
+
+  f[1].value = headerType;
+  f[3].value = (long long) bodyLength;
+
+  PutLE(w, ARROW_CONTINUATION, 4);
+  PutLE(w, 0, 4);                       // metadata length, set by EndMessageMetadata()
+  PutLE(w, 0, 4);                       // offset to the root table
+
+  t = PutTable(w, f, 4);
+  PutOffset(w, start + 8, t);
+
+  *header = f[2].pos;
+  return start;
+}
+
+/// Completes the metadata of an IPC message, and returns its total length (including the prefix and padding).
+static int EndMessageMetadata(ArrowWriter *w, size_t start) {
+  Align(w, 8);
+  SetLE(w, start + 4, w->buf.n - start - 8, 4);
+  return (int) (w->buf.n - start);
+}
+
+static int Flush(ArrowWriter *w) {
+  static const char *fn = "Flush";
+
+  if(!w->fp) return X_SUCCESS;
+
+  if(fwrite(w->buf.data, 1, w->buf.n, w->fp) != w->buf.n)
+    return x_error(X_FAILURE, errno, fn, "write error: %s", strerror(errno));
+  w->flushed += w->buf.n;
+  w->buf.n = 0;
+
+  return X_SUCCESS;
+}
+
+static void PutSchemaMessage(ArrowWriter *w, const ArrowColumn *cols, int nCols) {
+  size_t header;
+  size_t start = StartMessage(w, ARROW_HEADER_SCHEMA, 0, &header);
+  PutOffset(w, header, PutSchemaTable(w, cols, nCols));
+  EndMessageMetadata(w, start);
+}
+
+static size_t Padded(size_t n) {
+  return (n + 7) & ~((size_t) 7);
+}
+
+/// Returns the number of buffers of a column, and their lengths for a batch with the specified number of rows.
+static int GetBuffers(const ArrowColumn *c, long rows, size_t *len) {
+  len[0] = c->nulls ? (rows + 7) >> 3 : 0;
+
+  if(c->type == X_STRING) {
+    len[1] = (rows + 1) * sizeof(int32_t);
+    len[2] = c->nData;
+    return 3;
+  }
+
+  len[1] = (c->type == X_BOOLEAN) ? (size_t) (rows + 7) >> 3 : (size_t) rows * c->eSize;
+  return 2;
+}
+
+static void PutBatchMessage(ArrowWriter *w, const ArrowColumn *cols, int nCols, long rows, ArrowBlock *block) {
+  // length, nodes, buffers
+  FbField f[3] = {{8, 0, 0}, {4, 0, 0}, {4, 0, 0}};
+  size_t header, start, v, len[3], bodyLength = 0, offset = 0;
+  int i, k, n, nBuffers = 0;
+
+  for(i = 0; i < nCols; i++) {
+    n = GetBuffers(&cols[i], rows, len);
+    nBuffers += n;
+    for(k = 0; k < n; k++) bodyLength += Padded(len[k]);
+  }
+
+  start = StartMessage(w, ARROW_HEADER_BATCH, bodyLength, &header);
+
+  f[0].value = rows;
+  PutOffset(w, header, PutTable(w, f, 3));
+
+  // FieldNode structs: length, null_count
+  v = StartStructVector(w, nCols);
+  PutOffset(w, f[1].pos, v);
+  for(i = 0; i < nCols; i++) {
+    PutLE(w, rows, 8);
+    PutLE(w, cols[i].nulls, 8);
+  }
+
+  // Buffer structs: offset, length
+  v = StartStructVector(w, nBuffers);
+  PutOffset(w, f[2].pos, v);
+  for(i = 0; i < nCols; i++) {
+    n = GetBuffers(&cols[i], rows, len);
+    for(k = 0; k < n; k++) {
+      PutLE(w, offset, 8);
+      PutLE(w, len[k], 8);
+      offset += Padded(len[k]);
+    }
+  }
+
+  block->offset = w->flushed + start;
+  block->metaLength = EndMessageMetadata(w, start);
+  block->bodyLength = bodyLength;
+
+  // The body
+  for(i = 0; i < nCols; i++) {
+    const ArrowColumn *c = &cols[i];
+
+    n = GetBuffers(c, rows, len);
+    x_buffer_put(&w->buf, c->validity, len[0]);
+    Align(w, 8);
+    x_buffer_put(&w->buf, c->values, len[1]);
+    Align(w, 8);
+    if(n > 2) {
+      x_buffer_put(&w->buf, c->data, len[2]);
+      Align(w, 8);
+    }
+  }
+}
+
+static void PutFooter(ArrowWriter *w, const ArrowColumn *cols, int nCols, const ArrowBlock *blocks, int nBlocks) {
+  // version, schema, dictionaries, recordBatches
+  FbField f[4] = {{2, ARROW_VERSION_V5, 0}, {4, 0, 0}, {4, 0, 0}, {4, 0, 0}};
+  size_t start = w->buf.n, v;
+  int i;
+
+  PutLE(w, 0, 4);                       // offset to the root table
+  PutOffset(w, start, PutTable(w, f, 4));
+
+  PutOffset(w, f[1].pos, PutSchemaTable(w, cols, nCols));
+  PutOffset(w, f[2].pos, PutOffsetVector(w, 0));
+
+  // Block structs: offset, metaDataLength, (padding), bodyLength
+  v = StartStructVector(w, nBlocks);
+  PutOffset(w, f[3].pos, v);
+  for(i = 0; i < nBlocks; i++) {
+    PutLE(w, blocks[i].offset, 8);
+    PutLE(w, blocks[i].metaLength, 4);
+    PutLE(w, 0, 4);
+    PutLE(w, blocks[i].bodyLength, 8);
+  }
+
+  PutLE(w, w->buf.n - start, 4);
+  x_buffer_put(&w->buf, ARROW_MAGIC, 6);
+}
+
+/// Returns the column type for a field, or X_UNKNOWN if the field cannot be a column.
+static XType GetColumnType(const XField *f) {
+  if(f->isSerialized || xGetFieldCount(f) != 1) return X_UNKNOWN;
+  if(xIsCharSequence(f->type)) return X_STRING;
+
+  switch(f->type) {
+    case X_BOOLEAN:
+    case X_BYTE:
+    case X_INT16:
+    case X_INT32:
+    case X_INT64:
+    case X_FLOAT:
+    case X_DOUBLE:
+    case X_STRING:
+      return f->type;
+    default:
+      return X_UNKNOWN;
+  }
+}
+
+static void SetBit(unsigned char *bits, long i) {
+  bits[i >> 3] |= (unsigned char) (1 << (i & 7));
+}
+
+/// Adds the value of a field (or null if NULL or incompatible) to a column, at the specified row of the batch.
+static void SetCell(ArrowColumn *c, long row, const XField *f) {
+  const char *str = NULL;
+  size_t l = 0;
+
+  if(f && (!f->value || GetColumnType(f) != c->type)) f = NULL;
+
+  if(f && c->type == X_STRING) {
+    if(f->type == X_STRING) {
+      str = *(char **) f->value;
+      if(!str) f = NULL;
+      else l = strlen(str);
+    }
+    else {
+      const char *end;
+      str = (const char *) f->value;
+      end = (const char *) memchr(str, '\0', xElementSizeOf(f->type));
+      l = end ? (size_t) (end - str) : (size_t) xElementSizeOf(f->type);
+    }
+  }
+
+  if(f) SetBit(c->validity, row);
+  else c->nulls++;
+
+  if(c->type == X_STRING) {
+    if(c->nData + l > c->dataSize) {
+      char *data;
+      c->dataSize = (2 * c->dataSize > c->nData + l) ? 2 * c->dataSize : c->nData + l;
+      data = (char *) realloc(c->data, c->dataSize);
+      x_check_alloc(data);
+      c->data = data;
+    }
+    if(l) memcpy(&c->data[c->nData], str, l);
+    c->nData += l;
+    ((int32_t *) c->values)[row + 1] = (int32_t) c->nData;
+  }
+  else if(c->type == X_BOOLEAN) {
+    if(f && *(boolean *) f->value) SetBit(c->values, row);
+  }
+  else if(f) memcpy(&c->values[row * c->eSize], f->value, c->eSize);
+  else memset(&c->values[row * c->eSize], 0, c->eSize);
+}
+
+static void ClearColumns(ArrowColumn *cols, int nCols) {
+  int i;
+
+  for(i = 0; i < nCols; i++) {
+    if(cols[i].validity) free(cols[i].validity);
+    if(cols[i].values) free(cols[i].values);
+    if(cols[i].data) free(cols[i].data);
+  }
+
+  free(cols);
+}
+
+/// Creates the columns for the scalar fields of the first record, with buffers for batches of the given size.
+static ArrowColumn *CreateColumns(const XStructure *s, long batchRows, int *nCols) {
+  ArrowColumn *cols;
+  const XField *f;
+  int n = 0;
+
+  cols = (ArrowColumn *) calloc(xCountFields(s) + 1, sizeof(ArrowColumn));
+  x_check_alloc(cols);
+
+  for(f = s->firstField; f != NULL; f = f->next) {
+    ArrowColumn *c = &cols[n];
+
+    c->type = GetColumnType(f);
+    if(c->type == X_UNKNOWN || !f->name) continue;
+
+    c->name = f->name;
+
+    if(c->type == X_STRING) c->values = (unsigned char *) calloc(batchRows + 1, sizeof(int32_t));
+    else if(c->type == X_BOOLEAN) c->values = (unsigned char *) calloc((batchRows + 7) >> 3, 1);
+    else {
+      c->eSize = xElementSizeOf(c->type);
+      c->values = (unsigned char *) calloc(batchRows, c->eSize);
+    }
+    x_check_alloc(c->values);
+
+    c->validity = (unsigned char *) calloc((batchRows + 7) >> 3, 1);
+    x_check_alloc(c->validity);
+
+    n++;
+  }
+
+  *nCols = n;
+  return cols;
+}
+
+static void ResetColumns(ArrowColumn *cols, int nCols, long batchRows) {
+  int i;
+
+  for(i = 0; i < nCols; i++) {
+    ArrowColumn *c = &cols[i];
+
+    memset(c->validity, 0, (batchRows + 7) >> 3);
+    if(c->type == X_BOOLEAN) memset(c->values, 0, (batchRows + 7) >> 3);
+    c->nData = 0;
+    c->nulls = 0;
+  }
+}
+
+static int Encode(const XStructure *s, int n, int format, ArrowWriter *w) {
+  static const char *fn = "Encode";
+
+  ArrowColumn *cols;
+  ArrowBlock *blocks;
+  long batchRows = n < ARROW_BATCH_ROWS ? n : ARROW_BATCH_ROWS, row0;
+  int nCols = 0, nBlocks = 0, status = X_SUCCESS;
+
+  if(format != XARROW_STREAM && format != XARROW_FILE) return x_error(X_FAILURE, EINVAL, fn, "invalid format: %d", format);
+
+  if(batchRows < 1) batchRows = 1;
+  cols = n > 0 ? CreateColumns(&s[0], batchRows, &nCols) : (ArrowColumn *) calloc(1, sizeof(ArrowColumn));
+  x_check_alloc(cols);
+
+  blocks = (ArrowBlock *) calloc(1 + n / batchRows, sizeof(ArrowBlock));
+  x_check_alloc(blocks);
+
+  if(format == XARROW_FILE) x_buffer_put(&w->buf, ARROW_MAGIC "\0\0", 8);     // magic, padded to 8 bytes
+
+  PutSchemaMessage(w, cols, nCols);
+  status = Flush(w);
+
+  for(row0 = 0; row0 < n && status == X_SUCCESS; row0 += batchRows) {
+    long row, rows = (n - row0 < batchRows) ? n - row0 : batchRows;
+
+    ResetColumns(cols, nCols, batchRows);
+
+    for(row = 0; row < rows; row++) {
+      const XStructure *rec = &s[row0 + row];
+      const XField *f = rec->firstField;
+      int i;
+
+      // Records typically have the same field order, so check the next field first before looking up by name.
+      for(i = 0; i < nCols; i++) {
+        const XField *e = (f && f->name && strcmp(f->name, cols[i].name) == 0) ? f : xGetField(rec, cols[i].name);
+        SetCell(&cols[i], row, e);
+        if(e) f = e->next;
+      }
+    }
+
+    PutBatchMessage(w, cols, nCols, rows, &blocks[nBlocks++]);
+    status = Flush(w);
+  }
+
+  if(status == X_SUCCESS) {
+    // End-of-stream marker
+    PutLE(w, ARROW_CONTINUATION, 4);
+    PutLE(w, 0, 4);
+
+    if(format == XARROW_FILE) PutFooter(w, cols, nCols, blocks, nBlocks);
+    status = Flush(w);
+  }
+
+  free(blocks);
+  ClearColumns(cols, nCols);
+
+  prop_error(fn, status);
+  return X_SUCCESS;
+}
+
+/**
+ * Converts an array of structures (records) into an Arrow IPC stream or file, as a table in which each scalar field
+ * of the first record is a column. Records are written in batches of up to 65536 rows. Records in which a column's
+ * field is missing, or has a different type, have a null value for that column.
+ *
+ * @param s           Pointer to an array of structures, e.g. the value of an `X_STRUCT` array field.
+ * @param n           Number of structures in the array.
+ * @param format      XARROW_STREAM (0) for the Arrow IPC streaming format, or XARROW_FILE (1) for the Arrow IPC
+ *                    (random access) file format.
+ * @param[out] size   (bytes) Pointer to which to return the size of the Arrow data.
+ * @return            A newly allocated buffer with the Arrow data, or NULL if there was an error (errno will
+ *                    inform about the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xarrowEncodeField()
+ * @sa xarrowWrite()
+ */
+void *xarrowEncode(const XStructure *s, int n, int format, size_t *size) {
+  static const char *fn = "xarrowEncode";
+
+  ArrowWriter w = {{NULL}, NULL, 0};
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(n < 0) {
+    x_error(0, EINVAL, fn, "invalid number of structures: %d", n);
+    return NULL;
+  }
+
+  if(!size) {
+    x_error(0, EINVAL, fn, "output size pointer is NULL");
+    return NULL;
+  }
+
+  if(Encode(s, n, format, &w) != X_SUCCESS) {
+    if(w.buf.data) free(w.buf.data);
+    return x_trace_null(fn, NULL);
+  }
+
+  *size = w.buf.n;
+  return w.buf.data;
+}
+
+/**
+ * Converts the structures of an `X_STRUCT` array field into an Arrow IPC stream or file. It is the same as
+ * xarrowEncode() with the field's value and element count.
+ *
+ * @param f           Pointer to a field of type `X_STRUCT`.
+ * @param format      XARROW_STREAM (0) for the Arrow IPC streaming format, or XARROW_FILE (1) for the Arrow IPC
+ *                    (random access) file format.
+ * @param[out] size   (bytes) Pointer to which to return the size of the Arrow data.
+ * @return            A newly allocated buffer with the Arrow data, or NULL if there was an error (errno will
+ *                    inform about the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xarrowEncode()
+ */
+void *xarrowEncodeField(const XField *f, int format, size_t *size) {
+  static const char *fn = "xarrowEncodeField";
+
+  void *data;
+
+  if(!f) {
+    x_error(0, EINVAL, fn, "input field is NULL");
+    return NULL;
+  }
+
+  if(f->type != X_STRUCT) {
+    x_error(0, EINVAL, fn, "field is not a structure: type '%c'", xTypeChar(f->type));
+    return NULL;
+  }
+
+  data = xarrowEncode((const XStructure *) f->value, xGetFieldCount(f), format, size);
+  if(!data) return x_trace_null(fn, f->name);
+
+  return data;
+}
+
+/**
+ * Writes an array of structures (records) to a file, as an Arrow IPC stream or file. Unlike xarrowEncode(), each
+ * record batch is written to the file as soon as it is complete, so the memory needed does not grow with the number
+ * of records.
+ *
+ * @param s           Pointer to an array of structures, e.g. the value of an `X_STRUCT` array field.
+ * @param n           Number of structures in the array.
+ * @param format      XARROW_STREAM (0) for the Arrow IPC streaming format, or XARROW_FILE (1) for the Arrow IPC
+ *                    (random access) file format.
+ * @param fp          The file (or pipe, for the streaming format) to write to.
+ * @return            X_SUCCESS (0) if successful, or else X_NULL if an argument is NULL, or X_FAILURE if the
+ *                    arguments are invalid or there was a write error (errno set).
+ *
+ * @since 1.1
+ *
+ * @sa xarrowEncode()
+ */
+int xarrowWrite(const XStructure *s, int n, int format, FILE *fp) {
+  static const char *fn = "xarrowWrite";
+
+  ArrowWriter w = {{NULL}, NULL, 0};
+  int status;
+
+  if(!s) return x_error(X_NULL, EINVAL, fn, "input structure is NULL");
+  if(!fp) return x_error(X_NULL, EINVAL, fn, "output file is NULL");
+  if(n < 0) return x_error(X_FAILURE, EINVAL, fn, "invalid number of structures: %d", n);
+
+  w.fp = fp;
+  status = Encode(s, n, format, &w);
+  if(w.buf.data) free(w.buf.data);
+
+  prop_error(fn, status);
+  return X_SUCCESS;
+}
@@ -0,0 +1,501 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * @brief   A compact, platform-independent binary representation of structured data.
+ *
+ *  The binary format covers the full XField model, with names, types, subtypes, dimensions, nested structures,
+ *  and heterogeneous field arrays. All numbers are stored in little-endian byte order, and the payloads of
+ *  numerical arrays are 8-byte aligned relative to the start of the binary data, so they can be decoded with a
+ *  single `memcpy()` on little-endian platforms. The layout is:
+ *
+ *  ```
+ *   header:     'X' 'B' 'I' 'N', version (uint8 = 1), 3 reserved (zero) bytes
+ *   structure:  uint32 number of fields, followed by the fields
+ *   field:      uint32 name length, name bytes,
+ *               int32 XType,
+ *               uint32 subtype length + 1 (or 0 if no subtype), subtype bytes,
+ *               uint8 flags (bit 0: serialized, bit 1: NULL value),
+ *               uint8 ndim,
+ *               int32 sizes[ndim],
+ *               value (unless NULL)
+ *   value:      serialized:      uint32 length, string bytes
+ *               X_STRING, X_RAW: uint32 length + 1 (or 0 for NULL), string bytes, for each element
+ *               X_STRUCT:        structure, for each element
+ *               X_FIELD:         field, for each element
+ *               X_BOOLEAN:       uint8 (0 or 1) for each element
+ *               other types:     zero padding to 8-byte boundary, little-endian element data
+ *  ```
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define __XCHANGE_INTERNAL_API__        ///< Use internal definitions
+#include "xbin.h"
+
+#ifndef TRUE
+#define TRUE 1          ///< Boolean 'true' in case it isn't already defined
+#endif
+
+#ifndef FALSE
+#define FALSE 0         ///< Boolean 'false' in case it isn't already defined
+#endif
+
+/// \cond PRIVATE
+#define XBIN_MAGIC          "XBIN"      ///< Leading bytes of the binary representation
+#define XBIN_HEADER_SIZE    8           ///< (bytes) magic + version + 3 reserved
+#define XBIN_ALIGN          8           ///< (bytes) Alignment of numerical payloads
+
+#define XBIN_SERIALIZED     0x01        ///< Flag for serialized field values
+#define XBIN_NULL_VALUE     0x02        ///< Flag for NULL field values
+
+typedef struct {
+  const unsigned char *data;    ///< The binary data
+  size_t n;                     ///< (bytes) Number of bytes parsed so far
+  size_t size;                  ///< (bytes) Total number of bytes available
+} XBinReader;
+/// \endcond
+
+static int EncodeStruct(const XStructure *s, XBuffer *w);
+static int EncodeField(const XField *f, XBuffer *w);
+static int DecodeStruct(XBinReader *r, XStructure *s);
+static int DecodeField(XBinReader *r, XField *f);
+
+static void PutUInt8(XBuffer *w, unsigned char value) {
+  *x_buffer_reserve(w, 1) = value;
+  w->n++;
+}
+
+static void PutUInt32(XBuffer *w, unsigned int value) {
+  unsigned char *b = x_buffer_reserve(w, 4);
+  b[0] = value & 0xff;
+  b[1] = (value >> 8) & 0xff;
+  b[2] = (value >> 16) & 0xff;
+  b[3] = (value >> 24) & 0xff;
+  w->n += 4;
+}
+
+static void PutString(XBuffer *w, const char *str) {
+  if(!str) {
+    PutUInt32(w, 0);
+    return;
+  }
+
+  PutUInt32(w, strlen(str) + 1);
+  x_buffer_put(w, str, strlen(str));
+}
+
+static void PutPadding(XBuffer *w) {
+  const size_t m = (XBIN_ALIGN - (w->n % XBIN_ALIGN)) % XBIN_ALIGN;
+  memset(x_buffer_reserve(w, m), 0, m);
+  w->n += m;
+}
+
+static int EncodeValue(const XField *f, XBuffer *w) {
+  static const char *fn = "EncodeValue";
+
+  const long count = xGetFieldCount(f);
+  long i;
+
+  if(f->isSerialized) {
+    const char *str = (char *) f->value;
+    PutUInt32(w, strlen(str));
+    x_buffer_put(w, str, strlen(str));
+    return X_SUCCESS;
+  }
+
+  switch(f->type) {
+    case X_STRING:
+    case X_RAW:
+      for(i = 0; i < count; i++) PutString(w, ((char **) f->value)[i]);
+      return X_SUCCESS;
+
+    case X_STRUCT:
+      for(i = 0; i < count; i++) prop_error(fn, EncodeStruct(&((XStructure *) f->value)[i], w));
+      return X_SUCCESS;
+
+    case X_FIELD:
+      for(i = 0; i < count; i++) prop_error(fn, EncodeField(&((XField *) f->value)[i], w));
+      return X_SUCCESS;
+
+    case X_BOOLEAN:
+      for(i = 0; i < count; i++) PutUInt8(w, ((boolean *) f->value)[i] ? 1 : 0);
+      return X_SUCCESS;
+
+    default: {
+      const int eSize = xElementSizeOf(f->type);
+      unsigned char *data;
+
+      if(eSize <= 0) return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid type: %d", f->type);
+
+      PutPadding(w);
+      data = x_buffer_reserve(w, count * eSize);
+      memcpy(data, f->value, count * eSize);
+
+#ifdef X_BIG_ENDIAN_HOST
+      if(!xIsCharSequence(f->type)) x_swap_bytes(data, eSize, count);
+#endif
+
+      w->n += count * eSize;
+      return X_SUCCESS;
+    }
+  }
+}
+
+static int EncodeField(const XField *f, XBuffer *w) {
+  static const char *fn = "EncodeField";
+
+  const int *sizes = xGetFieldSizes(f);
+  int i;
+
+  if(!f->name) return x_error(X_NAME_INVALID, EINVAL, fn, "field->name is NULL");
+  if(f->ndim < 0 || f->ndim > X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid ndim: %d", f->ndim);
+
+  PutUInt32(w, strlen(f->name));
+  x_buffer_put(w, f->name, strlen(f->name));
+  PutUInt32(w, (unsigned int) f->type);
+  PutString(w, f->subtype);
+  PutUInt8(w, (f->isSerialized ? XBIN_SERIALIZED : 0) | (f->value ? 0 : XBIN_NULL_VALUE));
+  PutUInt8(w, f->ndim);
+  for(i = 0; i < f->ndim; i++) PutUInt32(w, (unsigned int) sizes[i]);
+
+  if(f->value) prop_error(fn, EncodeValue(f, w));
+
+  return X_SUCCESS;
+}
+
+static int EncodeStruct(const XStructure *s, XBuffer *w) {
+  const XField *f;
+
+  PutUInt32(w, xCountFields(s));
+  for(f = s->firstField; f != NULL; f = f->next) prop_error("EncodeStruct", EncodeField(f, w));
+
+  return X_SUCCESS;
+}
+
+/**
+ * Converts structured data into its compact binary representation. The binary format is platform-independent
+ * (little-endian), and preserves all properties of the fields, including their types, subtypes, and
+ * dimensions, and the exact binary values of all numerical data. Numerical array payloads are 8-byte aligned
+ * relative to the start of the returned buffer.
+ *
+ * @param s           Pointer to structured data
+ * @param[out] size   (bytes) Pointer to which to return the size of the binary representation.
+ * @return            A newly allocated buffer with the binary representation, or NULL if there was an
+ *                    error (errno will inform about the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xbinDecode()
+ * @sa xjsonToString()
+ */
+void *xbinEncode(const XStructure *s, size_t *size) {
+  static const char *fn = "xbinEncode";
+
+  XBuffer w = {NULL};
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(!size) {
+    x_error(0, EINVAL, fn, "output size pointer is NULL");
+    return NULL;
+  }
+
+  x_buffer_put(&w, XBIN_MAGIC, sizeof(XBIN_MAGIC) - 1);
+  PutUInt8(&w, XBIN_VERSION);
+  x_buffer_put(&w, "\0\0\0", XBIN_HEADER_SIZE - sizeof(XBIN_MAGIC));
+
+  if(EncodeStruct(s, &w) != X_SUCCESS) {
+    if(w.data) free(w.data);
+    return x_trace_null(fn, NULL);
+  }
+
+  *size = w.n;
+  return w.data;
+}
+
+static const unsigned char *GetBytes(XBinReader *r, size_t m) {
+  const unsigned char *b;
+
+  if(m > r->size - r->n) {
+    x_error(0, EINVAL, "GetBytes", "unexpected end of data at byte %ld", (long) r->n);
+    return NULL;
+  }
+
+  b = &r->data[r->n];
+  r->n += m;
+  return b;
+}
+
+static int GetUInt32(XBinReader *r, unsigned int *value) {
+  const unsigned char *b = GetBytes(r, 4);
+  if(!b) return X_PARSE_ERROR;
+  *value = b[0] | ((unsigned int) b[1] << 8) | ((unsigned int) b[2] << 16) | ((unsigned int) b[3] << 24);
+  return X_SUCCESS;
+}
+
+static int GetCount(XBinReader *r, unsigned int *value) {
+  prop_error("GetCount", GetUInt32(r, value));
+  if(*value > r->size - r->n) return x_error(X_PARSE_ERROR, EINVAL, "GetCount", "invalid length: %u", *value);
+  return X_SUCCESS;
+}
+
+static int GetString(XBinReader *r, char **str) {
+  const unsigned char *b;
+  unsigned int l = 0;
+
+  *str = NULL;
+
+  // The stored length includes the string terminator, so that 0 can designate NULL.
+  prop_error("GetString", GetUInt32(r, &l));
+  if(l == 0) return X_SUCCESS;
+  if(l - 1 > r->size - r->n) return x_error(X_PARSE_ERROR, EINVAL, "GetString", "invalid length: %u", l);
+
+  b = GetBytes(r, l - 1);
+  if(!b) return X_PARSE_ERROR;
+
+  *str = (char *) malloc(l);
+  x_check_alloc(*str);
+
+  memcpy(*str, b, l - 1);
+  (*str)[l - 1] = '\0';
+
+  return X_SUCCESS;
+}
+
+/**
+ * Returns the least number of bytes that an element of the given type occupies in the binary representation.
+ *
+ * @param type    The (valid) element type
+ * @return        (bytes) The minimum encoded size of an element of that type.
+ */
+static int GetMinEncodedSize(XType type) {
+  switch(type) {
+    case X_STRING:
+    case X_RAW:
+    case X_STRUCT:
+      return 4;                 // length or number of fields
+    case X_FIELD:
+      return 14;                // name length, type, subtype length, flags, and ndim
+    case X_BOOLEAN:
+      return 1;
+  }
+  return xElementSizeOf(type);
+}
+
+static int DecodeValue(XBinReader *r, XField *f) {
+  static const char *fn = "DecodeValue";
+
+  const long count = xGetFieldCount(f);
+  const int eSize = xElementSizeOf(f->type);
+  long i;
+
+  if(f->isSerialized) {
+    const unsigned char *b;
+    unsigned int l;
+
+    prop_error(fn, GetCount(r, &l));
+    if(!(b = GetBytes(r, l))) return X_PARSE_ERROR;
+
+    f->value = malloc(l + 1);
+    x_check_alloc(f->value);
+    memcpy(f->value, b, l);
+    ((char *) f->value)[l] = '\0';
+
+    return X_SUCCESS;
+  }
+
+  if(count < 0 || count > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid element count: %ld", count);
+  if(eSize <= 0) return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid type: %d", f->type);
+
+  // Make sure the data can hold all elements before allocating storage for them.
+  if(count > (long) ((r->size - r->n) / GetMinEncodedSize(f->type)))
+    return x_error(X_PARSE_ERROR, EINVAL, fn, "not enough data for %ld elements at byte %ld", count, (long) r->n);
+
+  f->value = calloc(count ? count : 1, eSize);
+  x_check_alloc(f->value);
+
+  switch(f->type) {
+    case X_STRING:
+    case X_RAW:
+      for(i = 0; i < count; i++) prop_error(fn, GetString(r, &((char **) f->value)[i]));
+      return X_SUCCESS;
+
+    case X_STRUCT:
+      for(i = 0; i < count; i++) prop_error(fn, DecodeStruct(r, &((XStructure *) f->value)[i]));
+      return X_SUCCESS;
+
+    case X_FIELD:
+      for(i = 0; i < count; i++) prop_error(fn, DecodeField(r, &((XField *) f->value)[i]));
+      return X_SUCCESS;
+
+    case X_BOOLEAN: {
+      const unsigned char *b = GetBytes(r, count);
+      if(!b) return X_PARSE_ERROR;
+      for(i = 0; i < count; i++) ((boolean *) f->value)[i] = b[i] ? TRUE : FALSE;
+      return X_SUCCESS;
+    }
+
+    default: {
+      const unsigned char *b;
+
+      if(!GetBytes(r, (XBIN_ALIGN - (r->n % XBIN_ALIGN)) % XBIN_ALIGN)) return X_PARSE_ERROR;
+      if(!(b = GetBytes(r, count * eSize))) return X_PARSE_ERROR;
+
+      memcpy(f->value, b, count * eSize);
+
+#ifdef X_BIG_ENDIAN_HOST
+      if(!xIsCharSequence(f->type)) x_swap_bytes(f->value, eSize, count);
+#endif
+
+      return X_SUCCESS;
+    }
+  }
+}
+
+static int DecodeField(XBinReader *r, XField *f) {
+  static const char *fn = "DecodeField";
+
+  const unsigned char *b;
+  unsigned int l;
+  long count = 1;
+  int i, flags, ndim, sizes[X_MAX_DIMS];
+
+  prop_error(fn, GetCount(r, &l));
+  if(!(b = GetBytes(r, l))) return X_PARSE_ERROR;
+
+  f->name = (char *) malloc(l + 1);
+  x_check_alloc(f->name);
+  memcpy(f->name, b, l);
+  f->name[l] = '\0';
+  f->name = x_adopt_name(f->name);
+
+  prop_error(fn, GetUInt32(r, &l));
+  f->type = (XType) (int) l;
+
+  if(f->type < 0) {
+    // Fixed-length character sequences cannot be longer than the binary data itself.
+    if(l == 0x80000000U || (size_t) -f->type > r->size)
+      return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid type: %d", f->type);
+  }
+  else if(f->type != X_UNKNOWN && xElementSizeOf(f->type) <= 0)
+    return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid type: %d", f->type);
+
+  prop_error(fn, GetString(r, &f->subtype));
+
+  if(!(b = GetBytes(r, 2))) return X_PARSE_ERROR;
+  flags = b[0];
+  ndim = b[1];
+  f->isSerialized = (flags & XBIN_SERIALIZED) ? TRUE : FALSE;
+
+  // Structures and heterogeneous arrays have no serialized form.
+  if(f->isSerialized && (f->type == X_STRUCT || f->type == X_FIELD))
+    return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid serialized type: %d", f->type);
+
+  if(ndim > X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid ndim: %d", ndim);
+
+  // Raw values are always scalar (as with xCreateField()), since only the first string is freed.
+  if(f->type == X_RAW && ndim > 0) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid ndim for raw value: %d", ndim);
+
+  for(i = 0; i < ndim; i++) {
+    prop_error(fn, GetUInt32(r, &l));
+    sizes[i] = (int) l;
+    if(sizes[i] < 0) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid size: %d", sizes[i]);
+
+    // Check the element count as we go, so it cannot overflow.
+    if(sizes[i] > 0 && count > X_MAX_ELEMENTS / sizes[i])
+      return x_error(X_SIZE_INVALID, EINVAL, fn, "too many elements");
+    count *= sizes[i];
+  }
+
+  prop_error(fn, xSetFieldDims(f, ndim, sizes));
+
+  if(flags & XBIN_NULL_VALUE) return X_SUCCESS;
+
+  prop_error(fn, DecodeValue(r, f));
+
+  return X_SUCCESS;
+}
+
+static int DecodeStruct(XBinReader *r, XStructure *s) {
+  static const char *fn = "DecodeStruct";
+
+  XField *last = NULL;
+  unsigned int i, nFields;
+
+  prop_error(fn, GetCount(r, &nFields));
+
+  for(i = 0; i < nFields; i++) {
+    XField *f = x_append_new_field(s, &last);
+    int status;
+
+    status = DecodeField(r, f);
+    prop_error(fn, status);
+
+    if(f->type == X_STRUCT && f->value && !f->isSerialized) {
+      XStructure *sub = (XStructure *) f->value;
+      long k;
+      for(k = xGetFieldCount(f); --k >= 0; ) sub[k].parent = s;
+    }
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Creates structured data from its binary representation, as was produced by xbinEncode(). The data is validated as
+ * it is decoded, so truncated or corrupted data (e.g. unknown types, or element counts that the data cannot hold)
+ * is rejected before any storage is allocated for it.
+ *
+ * @param data    Pointer to the binary representation
+ * @param size    (bytes) The number of bytes available in the buffer.
+ * @return        Newly created structured data, or NULL if there was an error (errno set to EINVAL).
+ *
+ * @since 1.1
+ *
+ * @sa xbinEncode()
+ * @sa xjsonParseString()
+ */
+XStructure *xbinDecode(const void *data, size_t size) {
+  static const char *fn = "xbinDecode";
+
+  XBinReader r = {NULL};
+  XStructure *s;
+
+  if(!data) {
+    x_error(0, EINVAL, fn, "input data is NULL");
+    return NULL;
+  }
+
+  if(size < XBIN_HEADER_SIZE || memcmp(data, XBIN_MAGIC, sizeof(XBIN_MAGIC) - 1) != 0) {
+    x_error(0, EINVAL, fn, "not an xchange binary");
+    return NULL;
+  }
+
+  r.data = (const unsigned char *) data;
+  r.size = size;
+
+  if(r.data[sizeof(XBIN_MAGIC) - 1] > XBIN_VERSION) {
+    x_error(0, EINVAL, fn, "unsupported binary version: %d", r.data[sizeof(XBIN_MAGIC) - 1]);
+    return NULL;
+  }
+
+  r.n = XBIN_HEADER_SIZE;
+
+  s = xCreateStruct();
+
+  if(DecodeStruct(&r, s) != X_SUCCESS) {
+    xDestroyStruct(s);
+    return x_trace_null(fn, NULL);
+  }
+
+  return s;
+}
@@ -0,0 +1,1020 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * @brief   CBOR (RFC 8949) encoder and decoder for structured data, with RFC 8746 typed arrays.
+ *
+ *  Structures are represented as CBOR maps, with the field names as (text string) keys. Scalar values map to
+ *  the matching CBOR types (null, booleans, integers, single and double precision floats, and text strings), while
+ *  arrays of booleans, strings, structures, and heterogeneous arrays map to (nested) CBOR arrays.
+ *
+ *  Arrays of the fixed-width numerical types (`X_BYTE`, `X_INT16`, `X_INT32`, `X_INT64`, `X_FLOAT`, and
+ *  `X_DOUBLE`) are written as RFC 8746 little-endian typed arrays (tags 72, 77, 78, 79, 85, and 86), i.e. as raw
+ *  little-endian binary data. Multi-dimensional numerical arrays are wrapped in the RFC 8746 row-major
+ *  multi-dimensional array tag (40), together with their dimensions.
+ *
+ *  The decoder accepts typed arrays of either endianness, including the unsigned integer and half-precision
+ *  float variants (which are promoted to the next wider signed integer type, or to `X_FLOAT`, respectively), as
+ *  well as indefinite-length strings, arrays, and maps. Other tags are ignored, and their content is decoded as is.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#define __XCHANGE_INTERNAL_API__        ///< Use internal definitions
+#include "xcbor.h"
+
+#ifndef TRUE
+#define TRUE 1          ///< Boolean 'true' in case it isn't already defined
+#endif
+
+#ifndef FALSE
+#define FALSE 0         ///< Boolean 'false' in case it isn't already defined
+#endif
+
+/// \cond PRIVATE
+#define CBOR_UINT           0       ///< CBOR major type: unsigned integer
+#define CBOR_NEGINT         1       ///< CBOR major type: negative integer
+#define CBOR_BYTES          2       ///< CBOR major type: byte string
+#define CBOR_TEXT           3       ///< CBOR major type: text string
+#define CBOR_ARRAY          4       ///< CBOR major type: array
+#define CBOR_MAP            5       ///< CBOR major type: map
+#define CBOR_TAG            6       ///< CBOR major type: tag
+#define CBOR_SIMPLE         7       ///< CBOR major type: simple values and floats
+
+#define CBOR_FALSE          0xf4    ///< CBOR false
+#define CBOR_TRUE           0xf5    ///< CBOR true
+#define CBOR_NULL           0xf6    ///< CBOR null
+#define CBOR_UNDEFINED      0xf7    ///< CBOR undefined
+#define CBOR_FLOAT16        0xf9    ///< CBOR half-precision float
+#define CBOR_FLOAT32        0xfa    ///< CBOR single-precision float
+#define CBOR_FLOAT64        0xfb    ///< CBOR double-precision float
+#define CBOR_BREAK          0xff    ///< CBOR break (end of indefinite-length item)
+
+#define CBOR_INDEFINITE     31      ///< Additional info for indefinite-length items
+
+#define CBOR_TAG_MULTI_DIM  40      ///< RFC 8746 multi-dimensional array (row-major)
+#define CBOR_TAG_TYPED_MIN  64      ///< First RFC 8746 typed array tag
+#define CBOR_TAG_TYPED_MAX  87      ///< Last RFC 8746 typed array tag
+
+typedef struct {
+  const unsigned char *data;    ///< The CBOR data
+  size_t n;                     ///< (bytes) Number of bytes parsed so far
+  size_t size;                  ///< (bytes) Total number of bytes available
+} CBORReader;
+
+/// A CBOR data item header, as read by ReadHeader()
+typedef struct {
+  int kind;                     ///< The CBOR type, as the XType it decodes to (or X_UNKNOWN for null)
+  long long i;                  ///< Integer value (integers and booleans)
+  double d;                     ///< Floating-point value
+  unsigned long long arg;       ///< The argument: length of strings, element count of containers, or tag number
+  boolean isIndefinite;         ///< Whether the string or container has indefinite length
+} CBORHeader;
+
+/// The element format of an RFC 8746 typed array
+typedef struct {
+  XType type;                   ///< The XType that the elements decode to
+  int size;                     ///< (bytes) Size of the encoded elements
+  boolean isUnsigned;           ///< Whether the elements are unsigned integers
+  boolean isFloat;              ///< Whether the elements are IEEE 754 floating-point values
+  boolean isBigEndian;          ///< Whether the elements are big-endian
+} CBORTypedArray;
+
+#define CB_KIND_BYTES   'b'     ///< CBOR byte string (header kind)
+#define CB_KIND_ARRAY   '['     ///< CBOR array (header kind)
+#define CB_KIND_MAP     '{'     ///< CBOR map (header kind)
+#define CB_KIND_TAG     'T'     ///< CBOR tag (header kind)
+#define CB_KIND_BREAK   ')'     ///< CBOR break (header kind)
+#define CB_KIND_BIGINT  'U'     ///< Integer beyond the signed 64-bit range (header kind)
+/// \endcond
+
+static int EncodeStruct(const XStructure *s, XBuffer *w);
+static int EncodeValue(const XField *f, XBuffer *w);
+static int DecodeStruct(CBORReader *r, const CBORHeader *h, XStructure *s);
+static void *DecodeValue(CBORReader *r, XType *type, int *ndim, int *sizes);
+
+static void PutByte(XBuffer *w, int value) {
+  *x_buffer_reserve(w, 1) = (unsigned char) value;
+  w->n++;
+}
+
+static void PutBigEndian(XBuffer *w, unsigned long long value, int nBytes) {
+  unsigned char *b = x_buffer_reserve(w, nBytes);
+  int i;
+
+  for(i = nBytes; --i >= 0; value >>= 8) b[i] = value & 0xff;
+  w->n += nBytes;
+}
+
+/// Writes the initial byte(s) of a data item, with the shortest form of the argument.
+static void PutHead(XBuffer *w, int major, unsigned long long arg) {
+  major <<= 5;
+
+  if(arg < 24) PutByte(w, major | (int) arg);
+  else if(arg <= 0xff) {
+    PutByte(w, major | 24);
+    PutBigEndian(w, arg, 1);
+  }
+  else if(arg <= 0xffff) {
+    PutByte(w, major | 25);
+    PutBigEndian(w, arg, 2);
+  }
+  else if(arg <= 0xffffffffULL) {
+    PutByte(w, major | 26);
+    PutBigEndian(w, arg, 4);
+  }
+  else {
+    PutByte(w, major | 27);
+    PutBigEndian(w, arg, 8);
+  }
+}
+
+static void PutInt(XBuffer *w, long long value) {
+  if(value >= 0) PutHead(w, CBOR_UINT, (unsigned long long) value);
+  else PutHead(w, CBOR_NEGINT, (unsigned long long) (-(value + 1)));
+}
+
+static void PutText(XBuffer *w, const char *str, size_t length) {
+  PutHead(w, CBOR_TEXT, length);
+  x_buffer_put(w, str, length);
+}
+
+/// Returns the RFC 8746 little-endian typed array tag for the XType, or -1 if the type has none.
+static int GetTypedArrayTag(XType type) {
+  switch(type) {
+    case X_BYTE: return 72;
+    case X_INT16: return 77;
+    case X_INT32: return 78;
+    case X_INT64: return 79;
+    case X_FLOAT: return 85;
+    case X_DOUBLE: return 86;
+  }
+  return -1;
+}
+
+static int EncodeTypedArray(const XField *f, XBuffer *w) {
+  const long count = xGetFieldCount(f);
+  const int eSize = xElementSizeOf(f->type);
+  const int *sizes = xGetFieldSizes(f);
+  int i;
+
+  if(f->ndim > 1) {
+    PutHead(w, CBOR_TAG, CBOR_TAG_MULTI_DIM);
+    PutHead(w, CBOR_ARRAY, 2);
+    PutHead(w, CBOR_ARRAY, f->ndim);
+    for(i = 0; i < f->ndim; i++) PutHead(w, CBOR_UINT, sizes[i]);
+  }
+
+  PutHead(w, CBOR_TAG, GetTypedArrayTag(f->type));
+  PutHead(w, CBOR_BYTES, count * eSize);
+
+  x_buffer_put(w, f->value, count * eSize);
+
+#ifdef X_BIG_ENDIAN_HOST
+  x_swap_bytes(&w->data[w->n - count * eSize], eSize, count);
+#endif
+
+  return X_SUCCESS;
+}
+
+static int EncodeElement(XType type, const void *ptr, XBuffer *w) {
+  static const char *fn = "EncodeElement";
+
+  if(xIsCharSequence(type)) {
+    const char *str = (char *) ptr;
+    size_t l = 0;
+    while(l < (size_t) xElementSizeOf(type) && str[l]) l++;
+    PutText(w, str, l);
+    return X_SUCCESS;
+  }
+
+  switch(type) {
+    case X_BOOLEAN: PutByte(w, *(boolean *) ptr ? CBOR_TRUE : CBOR_FALSE); break;
+    case X_BYTE: PutInt(w, *(int8_t *) ptr); break;
+    case X_INT16: PutInt(w, *(int16_t *) ptr); break;
+    case X_INT32: PutInt(w, *(int32_t *) ptr); break;
+    case X_INT64: PutInt(w, *(int64_t *) ptr); break;
+    case X_FLOAT: {
+      unsigned int u;
+      memcpy(&u, ptr, sizeof(u));
+      PutByte(w, CBOR_FLOAT32);
+      PutBigEndian(w, u, 4);
+      break;
+    }
+    case X_DOUBLE: {
+      unsigned long long u;
+      memcpy(&u, ptr, sizeof(u));
+      PutByte(w, CBOR_FLOAT64);
+      PutBigEndian(w, u, 8);
+      break;
+    }
+    case X_STRING:
+    case X_RAW: {
+      const char *str = *(char **) ptr;
+      if(str) PutText(w, str, strlen(str));
+      else PutByte(w, CBOR_NULL);
+      break;
+    }
+    case X_STRUCT: prop_error(fn, EncodeStruct((XStructure *) ptr, w)); break;
+    case X_FIELD: prop_error(fn, EncodeValue((XField *) ptr, w)); break;
+    default: return x_error(X_TYPE_INVALID, EINVAL, fn, "unsupported type: %d", type);
+  }
+
+  return X_SUCCESS;
+}
+
+static int EncodeArray(XType type, int ndim, const int *sizes, const char *data, XBuffer *w) {
+  const int eSize = xElementSizeOf(type);
+  const long rowCount = xGetElementCount(ndim - 1, &sizes[1]);
+  int i;
+
+  PutHead(w, CBOR_ARRAY, sizes[0]);
+
+  for(i = 0; i < sizes[0]; i++, data += rowCount * eSize) {
+    int status = (ndim > 1) ? EncodeArray(type, ndim - 1, &sizes[1], data, w) : EncodeElement(type, data, w);
+    prop_error("EncodeArray", status);
+  }
+
+  return X_SUCCESS;
+}
+
+static int EncodeValue(const XField *f, XBuffer *w) {
+  if(!f->value) {
+    PutByte(w, CBOR_NULL);
+    return X_SUCCESS;
+  }
+
+  if(f->isSerialized) {
+    PutText(w, (char *) f->value, strlen((char *) f->value));
+    return X_SUCCESS;
+  }
+
+  if(f->ndim == 0) return EncodeElement(f->type, f->value, w);
+  if(GetTypedArrayTag(f->type) > 0) return EncodeTypedArray(f, w);
+  return EncodeArray(f->type, f->ndim, xGetFieldSizes(f), (char *) f->value, w);
+}
+
+static int EncodeStruct(const XStructure *s, XBuffer *w) {
+  static const char *fn = "EncodeStruct";
+
+  const XField *f;
+
+  PutHead(w, CBOR_MAP, xCountFields(s));
+
+  for(f = s->firstField; f != NULL; f = f->next) {
+    if(!f->name) return x_error(X_NAME_INVALID, EINVAL, fn, "field->name is NULL");
+    PutText(w, f->name, strlen(f->name));
+    prop_error(fn, EncodeValue(f, w));
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Converts structured data into its CBOR (RFC 8949) representation, as a CBOR map. Numerical arrays are
+ * encoded as RFC 8746 little-endian typed arrays, which are wrapped in RFC 8746 multi-dimensional array tags
+ * if they have more than one dimension.
+ *
+ * @param s           Pointer to structured data
+ * @param[out] size   (bytes) Pointer to which to return the size of the CBOR representation.
+ * @return            A newly allocated buffer with the CBOR representation, or NULL if there was an
+ *                    error (errno will inform about the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xcborDecode()
+ * @sa xmsgpackEncode()
+ */
+void *xcborEncode(const XStructure *s, size_t *size) {
+  static const char *fn = "xcborEncode";
+
+  XBuffer w = {NULL};
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(!size) {
+    x_error(0, EINVAL, fn, "output size pointer is NULL");
+    return NULL;
+  }
+
+  if(EncodeStruct(s, &w) != X_SUCCESS) {
+    if(w.data) free(w.data);
+    return x_trace_null(fn, NULL);
+  }
+
+  *size = w.n;
+  return w.data;
+}
+
+static const unsigned char *GetBytes(CBORReader *r, size_t m) {
+  const unsigned char *b;
+
+  if(m > r->size - r->n) {
+    x_error(0, EINVAL, "GetBytes", "unexpected end of data at byte %ld", (long) r->n);
+    return NULL;
+  }
+
+  b = &r->data[r->n];
+  r->n += m;
+  return b;
+}
+
+static int GetBigEndian(CBORReader *r, int nBytes, unsigned long long *value) {
+  const unsigned char *b = GetBytes(r, nBytes);
+  int i;
+
+  if(!b) return X_PARSE_ERROR;
+
+  for(*value = 0, i = 0; i < nBytes; i++) *value = (*value << 8) | b[i];
+  return X_SUCCESS;
+}
+
+static double HalfToDouble(unsigned int h) {
+  const int e = (h >> 10) & 0x1f;
+  const int m = h & 0x3ff;
+  double x;
+
+  if(e == 0) x = ldexp(m, -24);
+  else if(e == 31) x = m ? NAN : INFINITY;
+  else x = ldexp(m + 1024, e - 25);
+
+  return (h & 0x8000) ? -x : x;
+}
+
+/// Returns TRUE and consumes the break code if it is next in the data.
+static boolean IsBreak(CBORReader *r) {
+  if(r->n >= r->size || r->data[r->n] != CBOR_BREAK) return FALSE;
+  r->n++;
+  return TRUE;
+}
+
+/// Reads the header of the next CBOR data item, including the value of scalars.
+static int ReadHeader(CBORReader *r, CBORHeader *h) {
+  static const char *fn = "ReadHeader";
+
+  const unsigned char *b = GetBytes(r, 1);
+  int major, info;
+
+  if(!b) return X_PARSE_ERROR;
+
+  memset(h, 0, sizeof(*h));
+
+  major = *b >> 5;
+  info = *b & 0x1f;
+
+  if(major == CBOR_SIMPLE) {
+    unsigned long long u = 0;
+
+    switch(*b) {
+      case CBOR_FALSE:
+      case CBOR_TRUE: h->kind = X_BOOLEAN; h->i = (*b == CBOR_TRUE); return X_SUCCESS;
+      case CBOR_NULL:
+      case CBOR_UNDEFINED: h->kind = X_UNKNOWN; return X_SUCCESS;
+      case CBOR_BREAK: h->kind = CB_KIND_BREAK; return X_SUCCESS;
+
+      case CBOR_FLOAT16:
+        prop_error(fn, GetBigEndian(r, 2, &u));
+        h->kind = X_FLOAT;
+        h->d = HalfToDouble((unsigned int) u);
+        return X_SUCCESS;
+
+      case CBOR_FLOAT32: {
+        unsigned int u32;
+        float x;
+        prop_error(fn, GetBigEndian(r, 4, &u));
+        u32 = (unsigned int) u;
+        memcpy(&x, &u32, sizeof(x));
+        h->kind = X_FLOAT;
+        h->d = x;
+        return X_SUCCESS;
+      }
+
+      case CBOR_FLOAT64:
+        prop_error(fn, GetBigEndian(r, 8, &u));
+        memcpy(&h->d, &u, sizeof(h->d));
+        h->kind = X_DOUBLE;
+        return X_SUCCESS;
+    }
+
+    return x_error(X_PARSE_ERROR, EINVAL, fn, "unsupported CBOR simple value 0x%02x at byte %ld", *b, (long) r->n - 1);
+  }
+
+  if(info < 24) h->arg = info;
+  else if(info < 28) {
+    prop_error(fn, GetBigEndian(r, 1 << (info - 24), &h->arg));
+  }
+  else if(info == CBOR_INDEFINITE && major >= CBOR_BYTES && major <= CBOR_MAP) h->isIndefinite = TRUE;
+  else return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid CBOR item 0x%02x at byte %ld", *b, (long) r->n - 1);
+
+  switch(major) {
+    case CBOR_UINT:
+      if(h->arg > (unsigned long long) INT64_MAX) {
+        h->kind = CB_KIND_BIGINT;
+        h->d = (double) h->arg;
+      }
+      else {
+        h->i = (long long) h->arg;
+        h->kind = (h->i == (int32_t) h->i) ? X_INT32 : X_INT64;
+      }
+      return X_SUCCESS;
+
+    case CBOR_NEGINT:
+      if(h->arg > (unsigned long long) INT64_MAX) {
+        h->kind = CB_KIND_BIGINT;
+        h->d = -1.0 - (double) h->arg;
+      }
+      else {
+        h->i = -1 - (long long) h->arg;
+        h->kind = (h->i == (int32_t) h->i) ? X_INT32 : X_INT64;
+      }
+      return X_SUCCESS;
+
+    case CBOR_BYTES: h->kind = CB_KIND_BYTES; return X_SUCCESS;
+    case CBOR_TEXT: h->kind = X_STRING; return X_SUCCESS;
+    case CBOR_ARRAY: h->kind = CB_KIND_ARRAY; return X_SUCCESS;
+    case CBOR_MAP: h->kind = CB_KIND_MAP; return X_SUCCESS;
+    default: h->kind = CB_KIND_TAG; return X_SUCCESS;
+  }
+}
+
+/**
+ * Reads a (possibly indefinite-length) byte or text string, and copies its content into the destination buffer,
+ * if not NULL.
+ */
+static int ReadString(CBORReader *r, const CBORHeader *h, char *dst, size_t *length) {
+  static const char *fn = "ReadString";
+
+  const unsigned char *b;
+  CBORHeader chunk;
+
+  *length = 0;
+
+  if(!h->isIndefinite) {
+    if(!(b = GetBytes(r, h->arg))) return X_PARSE_ERROR;
+    if(dst) memcpy(dst, b, h->arg);
+    *length = h->arg;
+    return X_SUCCESS;
+  }
+
+  while(!IsBreak(r)) {
+    prop_error(fn, ReadHeader(r, &chunk));
+    if(chunk.kind != h->kind || chunk.isIndefinite) return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid string chunk");
+    if(!(b = GetBytes(r, chunk.arg))) return X_PARSE_ERROR;
+    if(dst) memcpy(&dst[*length], b, chunk.arg);
+    *length += chunk.arg;
+  }
+
+  return X_SUCCESS;
+}
+
+/// Reads a complete string item as a newly allocated, 0-terminated, C string.
+static int ReadNewString(CBORReader *r, const CBORHeader *h, char **str) {
+  static const char *fn = "ReadNewString";
+
+  const size_t start = r->n;
+  size_t l;
+
+  prop_error(fn, ReadString(r, h, NULL, &l));
+  r->n = start;
+
+  *str = (char *) malloc(l + 1);
+  x_check_alloc(*str);
+
+  prop_error(fn, ReadString(r, h, *str, &l));
+  (*str)[l] = '\0';
+
+  return X_SUCCESS;
+}
+
+/// Parses an RFC 8746 typed array tag.
+static int GetTypedArray(unsigned long long tag, CBORTypedArray *a) {
+  static const char *fn = "GetTypedArray";
+
+  static const XType signedTypes[] = { X_BYTE, X_INT16, X_INT32, X_INT64 };
+  static const XType unsignedTypes[] = { X_INT16, X_INT32, X_INT64, X_DOUBLE };
+
+  const int ll = tag & 0x3;
+
+  if(tag < CBOR_TAG_TYPED_MIN || tag > CBOR_TAG_TYPED_MAX) return x_error(X_TYPE_INVALID, EINVAL, fn, "not a typed array tag: %llu", tag);
+
+  memset(a, 0, sizeof(*a));
+
+  a->isFloat = (tag & 0x10) != 0;
+  a->isBigEndian = !(tag & 0x4);
+
+  if(a->isFloat) {
+    if(ll == 3) return x_error(X_TYPE_INVALID, EINVAL, fn, "128-bit float typed arrays are not supported");
+    a->size = 2 << ll;
+    a->type = (ll == 2) ? X_DOUBLE : X_FLOAT;
+    return X_SUCCESS;
+  }
+
+  a->size = 1 << ll;
+  a->isUnsigned = !(tag & 0x8);
+  a->type = a->isUnsigned ? unsignedTypes[ll] : signedTypes[ll];
+
+  if(a->size == 1) {
+    // For single bytes, the endianness bit designates clamped (unsigned) arithmetic, which is irrelevant here.
+    a->isBigEndian = FALSE;
+    if(tag == 76) return x_error(X_TYPE_INVALID, EINVAL, fn, "reserved typed array tag: %llu", tag);
+  }
+
+  return X_SUCCESS;
+}
+
+static void StoreInt(XType type, void *dst, long long value) {
+  switch(type) {
+    case X_BOOLEAN: *(boolean *) dst = (value != 0); break;
+    case X_BYTE: *(int8_t *) dst = (int8_t) value; break;
+    case X_INT16: *(int16_t *) dst = (int16_t) value; break;
+    case X_INT32: *(int32_t *) dst = (int32_t) value; break;
+    case X_INT64: *(int64_t *) dst = (int64_t) value; break;
+    case X_FLOAT: *(float *) dst = (float) value; break;
+    case X_DOUBLE: *(double *) dst = (double) value; break;
+  }
+}
+
+static void StoreDouble(XType type, void *dst, double value) {
+  if(type == X_FLOAT) *(float *) dst = (float) value;
+  else *(double *) dst = value;
+}
+
+/// Decodes typed array data into native elements of the same or a wider type.
+static void DecodeTypedArray(const CBORTypedArray *a, const unsigned char *src, long count, XType to, char *dst) {
+  const int dSize = xElementSizeOf(to);
+  long k;
+
+#ifdef X_BIG_ENDIAN_HOST
+  const boolean isNative = a->isBigEndian || a->size == 1;
+#else
+  const boolean isNative = !a->isBigEndian;
+#endif
+
+  if(a->type == to && a->size == dSize && !a->isUnsigned && isNative) {
+    memcpy(dst, src, count * dSize);
+    return;
+  }
+
+  for(k = 0; k < count; k++, src += a->size, dst += dSize) {
+    unsigned long long u = 0;
+    int i;
+
+    if(a->isBigEndian) for(i = 0; i < a->size; i++) u = (u << 8) | src[i];
+    else for(i = a->size; --i >= 0; ) u = (u << 8) | src[i];
+
+    if(a->isFloat) {
+      if(a->size == 2) StoreDouble(to, dst, HalfToDouble((unsigned int) u));
+      else if(a->size == 4) {
+        unsigned int u32 = (unsigned int) u;
+        float x;
+        memcpy(&x, &u32, sizeof(x));
+        StoreDouble(to, dst, x);
+      }
+      else {
+        double x;
+        memcpy(&x, &u, sizeof(x));
+        StoreDouble(to, dst, x);
+      }
+    }
+    else if(a->isUnsigned) {
+      if(a->size == 8 && u > (unsigned long long) INT64_MAX) StoreDouble(to, dst, (double) u);
+      else StoreInt(to, dst, (long long) u);
+    }
+    else switch(a->size) {
+      case 1: StoreInt(to, dst, (int8_t) u); break;
+      case 2: StoreInt(to, dst, (int16_t) u); break;
+      case 4: StoreInt(to, dst, (int32_t) u); break;
+      default: StoreInt(to, dst, (int64_t) u);
+    }
+  }
+}
+
+static XType GetCommonType(XType t1, XType t2) {
+  if(t1 == t2) return t1;
+  if(t1 == X_UNKNOWN) return t2;
+  if(t2 == X_UNKNOWN) return t1;
+  if(t1 == X_FIELD || t2 == X_FIELD) return X_FIELD;
+  if(t1 == X_STRUCT || t2 == X_STRUCT) return X_FIELD;
+  if(t1 == X_STRING || t2 == X_STRING) return X_FIELD;
+  if(t1 == X_DOUBLE || t2 == X_DOUBLE) return X_DOUBLE;
+  if(t1 == X_FLOAT || t2 == X_FLOAT) return X_FLOAT;
+  if(t1 == X_INT64 || t2 == X_INT64) return X_INT64;
+  if(t1 == X_INT32 || t2 == X_INT32) return X_INT32;
+  if(t1 == X_INT16 || t2 == X_INT16) return X_INT16;
+  return X_BYTE;
+}
+
+static int Survey(CBORReader *r, XType *type, int *ndim, int *sizes);
+
+/// Surveys the byte string content of a typed array tag.
+static int SurveyTypedArray(CBORReader *r, unsigned long long tag, XType *type, int *ndim, int *sizes) {
+  static const char *fn = "SurveyTypedArray";
+
+  CBORTypedArray a;
+  CBORHeader h;
+  size_t l;
+
+  prop_error(fn, GetTypedArray(tag, &a));
+  prop_error(fn, ReadHeader(r, &h));
+
+  if(h.kind != CB_KIND_BYTES || h.isIndefinite) return x_error(X_PARSE_ERROR, EINVAL, fn, "typed array is not a definite-length byte string");
+  if(h.arg % a.size) return x_error(X_SIZE_INVALID, EINVAL, fn, "typed array size mismatch");
+  if(h.arg / a.size > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "typed array too large: %llu", h.arg / a.size);
+
+  *type = a.type;
+  *ndim = 1;
+  sizes[0] = (int) (h.arg / a.size);
+
+  return ReadString(r, &h, NULL, &l);
+}
+
+/// Surveys the content of an RFC 8746 (row-major) multi-dimensional array tag.
+static int SurveyMultiDim(CBORReader *r, XType *type, int *ndim, int *sizes) {
+  static const char *fn = "SurveyMultiDim";
+
+  CBORHeader h;
+  int i, n, s[X_MAX_DIMS];
+
+  prop_error(fn, ReadHeader(r, &h));
+  if(h.kind != CB_KIND_ARRAY || h.isIndefinite || h.arg != 2) return x_error(X_PARSE_ERROR, EINVAL, fn, "expected [ dims, data ]");
+
+  prop_error(fn, ReadHeader(r, &h));
+  if(h.kind != CB_KIND_ARRAY || h.isIndefinite || h.arg < 1 || h.arg > X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid dimensions");
+
+  *ndim = (int) h.arg;
+
+  for(i = 0; i < *ndim; i++) {
+    prop_error(fn, ReadHeader(r, &h));
+    if(h.kind != X_INT32 || h.i < 0) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid dimension");
+    sizes[i] = (int) h.i;
+  }
+
+  // The data is either a typed array or a classic array of scalars.
+  prop_error(fn, Survey(r, type, &n, s));
+  if(n != 1 || *type == X_FIELD || s[0] != xGetElementCount(*ndim, sizes)) return x_error(X_SIZE_INVALID, EINVAL, fn, "array data does not match dimensions");
+
+  return X_SUCCESS;
+}
+
+/**
+ * Determines the type and shape of the next CBOR data item, and skips over it, without allocating anything.
+ * Arrays, whose elements all have the same shape, and compatible types, are arrays of the common type. Otherwise
+ * they are heterogeneous (X_FIELD) arrays.
+ */
+static int Survey(CBORReader *r, XType *type, int *ndim, int *sizes) {
+  static const char *fn = "Survey";
+
+  CBORHeader h;
+  size_t i, l;
+
+  *ndim = 0;
+
+  prop_error(fn, ReadHeader(r, &h));
+
+  switch(h.kind) {
+    case CB_KIND_MAP:
+      *type = X_STRUCT;
+      for(i = 0; h.isIndefinite ? !IsBreak(r) : i < h.arg; i++) {
+        int n, s[X_MAX_DIMS];
+        XType t;
+        prop_error(fn, Survey(r, &t, &n, s));
+        prop_error(fn, Survey(r, &t, &n, s));
+      }
+      return X_SUCCESS;
+
+    case CB_KIND_ARRAY: {
+      int n, s[X_MAX_DIMS];
+      XType t;
+
+      *type = X_UNKNOWN;
+
+      for(i = 0; h.isIndefinite ? !IsBreak(r) : i < h.arg; i++) {
+        prop_error(fn, Survey(r, &t, &n, s));
+
+        if(*type == X_FIELD) continue;
+
+        if(n >= X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "too many array dimensions");
+
+        if(i == 0) {
+          *type = t;
+          *ndim = n;
+          memcpy(&sizes[1], s, n * sizeof(int));
+        }
+        else if(n != *ndim || memcmp(&sizes[1], s, n * sizeof(int))) *type = X_FIELD;
+        else *type = GetCommonType(*type, t);
+      }
+
+      if(i > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "array too large: %ld", (long) i);
+
+      if(*type == X_FIELD) *ndim = 0;
+
+      sizes[0] = i;
+      (*ndim)++;
+      return X_SUCCESS;
+    }
+
+    case CB_KIND_TAG:
+      if(h.arg >= CBOR_TAG_TYPED_MIN && h.arg <= CBOR_TAG_TYPED_MAX) return SurveyTypedArray(r, h.arg, type, ndim, sizes);
+      if(h.arg == CBOR_TAG_MULTI_DIM) return SurveyMultiDim(r, type, ndim, sizes);
+      return Survey(r, type, ndim, sizes);      // Other tags are transparent
+
+    case CB_KIND_BYTES:
+      prop_error(fn, ReadString(r, &h, NULL, &l));
+      if(l > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "byte string too large: %ld", (long) l);
+      *type = X_BYTE;
+      *ndim = 1;
+      sizes[0] = l;
+      return X_SUCCESS;
+
+    case X_STRING:
+      *type = X_STRING;
+      return ReadString(r, &h, NULL, &l);
+
+    case CB_KIND_BIGINT:
+      *type = X_DOUBLE;
+      return X_SUCCESS;
+
+    case CB_KIND_BREAK:
+      return x_error(X_PARSE_ERROR, EINVAL, fn, "unexpected break at byte %ld", (long) r->n - 1);
+
+    default:
+      *type = h.kind;
+      return X_SUCCESS;
+  }
+}
+
+/**
+ * Decodes the next CBOR data item into a pre-allocated typed buffer, as the elements of the given type, and
+ * advances the buffer pointer past the elements written. The item must have been surveyed before, to be
+ * compatible with the type.
+ */
+static int DecodeInto(CBORReader *r, XType type, char **dst) {
+  static const char *fn = "DecodeInto";
+
+  const int eSize = xElementSizeOf(type);
+  CBORHeader h;
+  size_t i;
+
+  prop_error(fn, ReadHeader(r, &h));
+
+  switch(h.kind) {
+    case X_UNKNOWN:
+      break;
+
+    case X_BOOLEAN:
+    case X_INT32:
+    case X_INT64:
+      StoreInt(type, *dst, h.i);
+      break;
+
+    case X_FLOAT:
+    case X_DOUBLE:
+    case CB_KIND_BIGINT:
+      StoreDouble(type, *dst, h.d);
+      break;
+
+    case X_STRING:
+      prop_error(fn, ReadNewString(r, &h, (char **) *dst));
+      break;
+
+    case CB_KIND_MAP:
+      prop_error(fn, DecodeStruct(r, &h, (XStructure *) *dst));
+      break;
+
+    case CB_KIND_ARRAY:
+      for(i = 0; h.isIndefinite ? !IsBreak(r) : i < h.arg; i++) prop_error(fn, DecodeInto(r, type, dst));
+      return X_SUCCESS;
+
+    case CB_KIND_BYTES: {
+      static const CBORTypedArray bytes = { X_BYTE, 1, FALSE, FALSE, FALSE };
+      const size_t start = r->n;
+      size_t l;
+
+      if(h.isIndefinite) {
+        // Chunked: collect the bytes first.
+        char *b;
+        prop_error(fn, ReadString(r, &h, NULL, &l));
+        r->n = start;
+        b = (char *) malloc(l ? l : 1);
+        x_check_alloc(b);
+        ReadString(r, &h, b, &l);
+        DecodeTypedArray(&bytes, (unsigned char *) b, l, type, *dst);
+        free(b);
+      }
+      else {
+        const unsigned char *b = GetBytes(r, h.arg);
+        if(!b) return X_PARSE_ERROR;
+        l = h.arg;
+        DecodeTypedArray(&bytes, b, l, type, *dst);
+      }
+
+      *dst += l * eSize;
+      return X_SUCCESS;
+    }
+
+    case CB_KIND_TAG:
+      if(h.arg >= CBOR_TAG_TYPED_MIN && h.arg <= CBOR_TAG_TYPED_MAX) {
+        CBORTypedArray a;
+        const unsigned char *b;
+        long count;
+
+        prop_error(fn, GetTypedArray(h.arg, &a));
+        prop_error(fn, ReadHeader(r, &h));
+        if(!(b = GetBytes(r, h.arg))) return X_PARSE_ERROR;
+
+        count = h.arg / a.size;
+        DecodeTypedArray(&a, b, count, type, *dst);
+        *dst += count * eSize;
+        return X_SUCCESS;
+      }
+
+      if(h.arg == CBOR_TAG_MULTI_DIM) {
+        int n, s[X_MAX_DIMS];
+        XType t;
+
+        prop_error(fn, ReadHeader(r, &h));      // [ dims, data ]
+        prop_error(fn, Survey(r, &t, &n, s));   // skip dims
+      }
+
+      return DecodeInto(r, type, dst);
+
+    default:
+      return x_error(X_TYPE_INVALID, EINVAL, fn, "unexpected CBOR data item");
+  }
+
+  *dst += eSize;
+  return X_SUCCESS;
+}
+
+/**
+ * Decodes the next CBOR data item as a newly allocated field value. It surveys the item first, and then decodes
+ * it straight into a buffer of the appropriate type and size.
+ */
+static void *DecodeValue(CBORReader *r, XType *type, int *ndim, int *sizes) {
+  static const char *fn = "DecodeValue";
+
+  const size_t start = r->n;
+  long count;
+  int eSize;
+  char *value, *next;
+
+  if(Survey(r, type, ndim, sizes) != X_SUCCESS) return x_trace_null(fn, NULL);
+  if(*ndim == 0) sizes[0] = 1;
+
+  count = xGetElementCount(*ndim, sizes);
+  eSize = xElementSizeOf(*type);
+
+  // null, or arrays without typed elements (e.g. empty arrays), have no value.
+  if(*type != X_FIELD && eSize <= 0) return NULL;
+
+  r->n = start;
+
+  if(*type == X_FIELD) {
+    // Heterogeneous array: decode each element as a field of its own
+    XField *array;
+    CBORHeader h;
+    int i;
+    int n, dims[X_MAX_DIMS];
+
+    // Skip any tags before the array
+    do if(ReadHeader(r, &h) != X_SUCCESS) return x_trace_null(fn, NULL);
+    while(h.kind == CB_KIND_TAG);
+
+    array = (XField *) calloc(sizes[0] ? sizes[0] : 1, sizeof(XField));
+    x_check_alloc(array);
+
+    for(i = 0; i < sizes[0]; i++) {
+      char idx[20];
+
+      // Name is . + 1-based index, e.g. ".1", ".2"...
+      sprintf(idx, ".%d", (i + 1));
+      array[i].name = x_copy_name(idx);
+
+      errno = 0;
+      array[i].value = DecodeValue(r, &array[i].type, &n, dims);
+
+      if((!array[i].value && errno == EINVAL) || xSetFieldDims(&array[i], n, dims) != X_SUCCESS) {
+        XField f = X_FIELD_INIT;
+        f.type = X_FIELD;
+        f.ndim = 1;
+        f.sizes[0] = i + 1;
+        f.value = array;
+        xClearField(&f);
+        return x_trace_null(fn, NULL);
+      }
+    }
+
+    if(h.isIndefinite) IsBreak(r);
+
+    return array;
+  }
+
+  value = next = (char *) calloc(count ? count : 1, eSize);
+  x_check_alloc(value);
+
+  if(DecodeInto(r, *type, &next) != X_SUCCESS) {
+    XField f = X_FIELD_INIT;
+    f.type = *type;
+    xSetFieldDims(&f, *ndim, sizes);
+    f.value = value;
+    xClearField(&f);
+    return x_trace_null(fn, NULL);
+  }
+
+  return value;
+}
+
+/// Decodes the entries of a CBOR map, after the map header, into the supplied structure.
+static int DecodeStruct(CBORReader *r, const CBORHeader *h, XStructure *s) {
+  static const char *fn = "DecodeStruct";
+
+  XField *last = NULL;
+  size_t i;
+  int ndim, sizes[X_MAX_DIMS];
+
+  for(i = 0; h->isIndefinite ? !IsBreak(r) : i < h->arg; i++) {
+    CBORHeader key;
+    XField *f;
+
+    prop_error(fn, ReadHeader(r, &key));
+    if(key.kind != X_STRING) return x_error(X_NAME_INVALID, EINVAL, fn, "map key is not a text string");
+
+    f = x_append_new_field(s, &last);
+
+    prop_error(fn, ReadNewString(r, &key, &f->name));
+    f->name = x_adopt_name(f->name);
+
+    errno = 0;
+    f->value = DecodeValue(r, &f->type, &ndim, sizes);
+    if(!f->value && errno == EINVAL) return x_trace(fn, f->name, X_PARSE_ERROR);
+    prop_error(fn, xSetFieldDims(f, ndim, sizes));
+  }
+
+  // Set the parent references of the immediate substructures
+  for(last = s->firstField; last != NULL; last = last->next) if(last->type == X_STRUCT && last->value) {
+    XStructure *sub = (XStructure *) last->value;
+    long k;
+    for(k = xGetFieldCount(last); --k >= 0; ) sub[k].parent = s;
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Creates structured data from its CBOR (RFC 8949) representation, which must be a CBOR map (optionally tagged,
+ * e.g. with the self-described CBOR tag). Integers are decoded as `X_INT32` if they fit, or else as `X_INT64`
+ * (or as `X_DOUBLE` beyond the range of a signed 64-bit integer). RFC 8746 typed arrays and multi-dimensional
+ * arrays are decoded straight into typed arrays, while untagged byte strings are decoded as 1D `X_BYTE` arrays.
+ * Arrays of compatible scalars, or of equal shape arrays, are decoded into a single typed array of the common
+ * type, while other arrays are decoded as heterogeneous arrays (type `X_FIELD`).
+ *
+ * @param data    Pointer to the CBOR representation
+ * @param size    (bytes) The number of bytes available in the buffer.
+ * @return        Newly created structured data, or NULL if there was an error (errno set to EINVAL).
+ *
+ * @since 1.1
+ *
+ * @sa xcborEncode()
+ * @sa xmsgpackDecode()
+ */
+XStructure *xcborDecode(const void *data, size_t size) {
+  static const char *fn = "xcborDecode";
+
+  CBORReader r = {NULL};
+  CBORHeader h;
+  XStructure *s;
+
+  if(!data) {
+    x_error(0, EINVAL, fn, "input data is NULL");
+    return NULL;
+  }
+
+  r.data = (const unsigned char *) data;
+  r.size = size;
+
+  do if(ReadHeader(&r, &h) != X_SUCCESS) return x_trace_null(fn, NULL);
+  while(h.kind == CB_KIND_TAG);
+
+  if(h.kind != CB_KIND_MAP) {
+    x_error(0, EINVAL, fn, "expected a CBOR map");
+    return NULL;
+  }
+
+  s = xCreateStruct();
+
+  if(DecodeStruct(&r, &h, s) != X_SUCCESS) {
+    xDestroyStruct(s);
+    return x_trace_null(fn, NULL);
+  }
+
+  return s;
+}
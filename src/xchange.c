@@ -125,6 +125,70 @@ int x_warn(const char *from, const char *desc, ...) {
   return 0;
 }
 
+/**
+ * (<i>for internal use</i>) Reverses the byte order of each element in an array in place, e.g. to convert
+ * between little-endian and big-endian representations of numerical data.
+ *
+ * @param data    Pointer to the array data.
+ * @param eSize   (bytes) The size of a single element.
+ * @param count   The number of elements in the array.
+ */
+void x_swap_bytes(void *data, int eSize, long count) {
+  unsigned char *e = (unsigned char *) data;
+  long i;
+
+  if(!data || eSize < 2) return;
+
+  for(i = 0; i < count; i++, e += eSize) {
+    int j, k;
+    for(j = 0, k = eSize - 1; j < k; j++, k--) {
+      const unsigned char b = e[j];
+      e[j] = e[k];
+      e[k] = b;
+    }
+  }
+}
+
+/**
+ * (<i>for internal use</i>) Makes room for the specified number of bytes at the end of a growable buffer,
+ * allocating it as necessary. The buffer size is at least doubled when it needs to grow, so appending to it
+ * takes amortized constant time.
+ *
+ * @param b     Pointer to the buffer.
+ * @param m     (bytes) The number of bytes to reserve.
+ * @return      Pointer to the reserved bytes, right after the `b->n` bytes already written. It is up to the caller
+ *              to fill them in and to advance `b->n` by the number of bytes actually used.
+ *
+ * @sa x_buffer_put()
+ */
+unsigned char *x_buffer_reserve(XBuffer *b, size_t m) {
+  if(!b->data || b->n + m > b->size) {
+    unsigned char *data;
+
+    b->size = (2 * b->size > b->n + m) ? 2 * b->size : b->n + m + 256;
+    data = (unsigned char *) realloc(b->data, b->size);
+    x_check_alloc(data);
+    b->data = data;
+  }
+
+  return &b->data[b->n];
+}
+
+/**
+ * (<i>for internal use</i>) Appends bytes to the end of a growable buffer.
+ *
+ * @param b     Pointer to the buffer.
+ * @param src   The bytes to append (may be NULL if `m` is 0).
+ * @param m     (bytes) The number of bytes to append.
+ *
+ * @sa x_buffer_reserve()
+ */
+void x_buffer_put(XBuffer *b, const void *src, size_t m) {
+  unsigned char *dst = x_buffer_reserve(b, m);
+  if(m) memcpy(dst, src, m);
+  b->n += m;
+}
+
 
 /**
  * Checks if verbosity is enabled for the xchange library.
@@ -612,9 +676,9 @@ double xParseDouble(const char *str, char **tail) {
  * will parse Infinity values even on older platforms that do not have built-in support for these.
  *
  * On older platforms, which do not have a builtin `strtof()` function, this will parse the string as as double,
- * before checking for range and returning the result recast as a float. The conversion may result in a decimal
- * rounding 'error' if the  returned value is then printed, whereby the last decimal digit may differ by one from the
- * original input string.
+ * before checking for range and returning the result recast as a float (rounded to nearest, including to subnormal
+ * values). The conversion may result in a decimal rounding 'error' if the  returned value is then printed, whereby
+ * the last decimal digit may differ by one from the original input string.
  *
  * @param str       String to parse floating-point value from
  * @param tail      (optional) reference to pointed in which to return the parse position after successfully
@@ -642,20 +706,19 @@ float xParseFloat(const char *str, char **tail) {
   return strtof(str, tail);
 #else
   {
+    // Values at or beyond halfway between FLT_MAX and the next (virtual) float up round to infinity.
+    const double overflow = 3.4028235677973366e+38;
     double d = xParseDouble(str, tail);
 
-    if(d > FLT_MAX) {
+    if(d >= overflow) {
       errno = ERANGE;
       return (float) INFINITY;
     }
-    if(d < -FLT_MAX) {
+    if(d <= -overflow) {
       errno = ERANGE;
       return (float) -INFINITY;
     }
-    if(d != 0.0 && d > -FLT_MIN && d < FLT_MIN) {
-      errno = ERANGE;
-      return 0.0F;
-    }
+    if(d != 0.0 && d > -FLT_MIN && d < FLT_MIN) errno = ERANGE;     // subnormal or underflow, like strtof()
 
     return (float) d;
   }
@@ -0,0 +1,594 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * @brief   CSV / TSV bulk export and import for arrays of structures.
+ *
+ *  Arrays of structures (records) are written as tables, with a header row of column names, followed by one row
+ *  per record. The columns are the scalar fields of the first record, including those of its embedded
+ *  substructures, which are named by their aggregate IDs (e.g. `sub:x`). Values are quoted as per RFC 4180 when
+ *  they contain the delimiter, quotes, or line breaks. Empty strings are written as `""`, so they remain distinct
+ *  from missing (null) values, which are written as empty cells.
+ *
+ *  When reading, each data row becomes a structure, in which embedded substructures are recreated from the
+ *  aggregate IDs of the column names. Column types are taken from an optional prototype structure, or else
+ *  inferred from the column's values: boolean (`true` / `false`), integer, floating-point, or string.
+ *
+ *  Both directions are buffered: rows are formatted directly into an output buffer, which is flushed to the file
+ *  when full, and the input is parsed from large blocks read from the file into a single text buffer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <stdint.h>
+
+#define __XCHANGE_INTERNAL_API__        ///< Use internal definitions
+#include "xcsv.h"
+
+#ifndef TRUE
+#define TRUE 1          ///< Boolean 'true' in case it isn't already defined
+#endif
+
+#ifndef FALSE
+#define FALSE 0         ///< Boolean 'false' in case it isn't already defined
+#endif
+
+/// \cond PRIVATE
+#define CSV_BUFFER_SIZE     65536       ///< (bytes) Size of the output and input buffers
+#define CSV_NULL            (-1L)       ///< Text offset of null (missing) values
+
+/// Buffered output to a file
+typedef struct {
+  FILE *fp;                     ///< The output file
+  char buf[CSV_BUFFER_SIZE];    ///< Buffered output
+  size_t n;                     ///< (bytes) Number of bytes in the buffer
+  int status;                   ///< X_SUCCESS, or the first write error
+} CSVSink;
+
+/// The cells of a parsed table
+typedef struct {
+  char *text;                   ///< Text of all cells, each terminated
+  size_t nText;                 ///< (bytes) Used size of the text buffer
+  size_t textSize;              ///< (bytes) Allocated size of the text buffer
+  long *cells;                  ///< Text offsets of the cells in row-major order, or CSV_NULL for nulls
+  long nCells;                  ///< Number of cells stored
+  long cellsSize;               ///< Allocated number of cells
+  int nCols;                    ///< Number of columns (from the header row)
+  long nRows;                   ///< Number of data rows
+} CSVTable;
+/// \endcond
+
+static void Flush(CSVSink *out) {
+  if(out->n && out->status == X_SUCCESS) {
+    if(fwrite(out->buf, 1, out->n, out->fp) != out->n)
+      out->status = x_error(X_FAILURE, errno, "Flush", "write error: %s", strerror(errno));
+  }
+  out->n = 0;
+}
+
+static void PutChar(CSVSink *out, char c) {
+  if(out->n >= CSV_BUFFER_SIZE) Flush(out);
+  out->buf[out->n++] = c;
+}
+
+static void PutBytes(CSVSink *out, const char *src, size_t l) {
+  while(l > 0) {
+    size_t m = CSV_BUFFER_SIZE - out->n;
+    if(!m) {
+      Flush(out);
+      continue;
+    }
+    if(m > l) m = l;
+    memcpy(&out->buf[out->n], src, m);
+    out->n += m;
+    src += m;
+    l -= m;
+  }
+}
+
+/// Writes a text value, quoted if necessary (or if empty, to distinguish it from nulls).
+static void PutText(CSVSink *out, const char *str, size_t l, char delim) {
+  size_t i;
+
+  for(i = 0; i < l; i++) {
+    const char c = str[i];
+    if(c == delim || c == '"' || c == '\r' || c == '\n') break;
+  }
+
+  if(l && i == l) {
+    PutBytes(out, str, l);
+    return;
+  }
+
+  PutChar(out, '"');
+  for(i = 0; i < l; i++) {
+    if(str[i] == '"') PutChar(out, '"');
+    PutChar(out, str[i]);
+  }
+  PutChar(out, '"');
+}
+
+static void PutCell(CSVSink *out, const XField *f, char delim) {
+  char num[40];
+
+  if(!f || !f->value) return;
+
+  if(f->isSerialized) {
+    PutText(out, (const char *) f->value, strlen((const char *) f->value), delim);
+    return;
+  }
+
+  if(f->type == X_STRING) {
+    const char *str = *(char **) f->value;
+    if(str) PutText(out, str, strlen(str), delim);
+  }
+  else if(xIsCharSequence(f->type)) {
+    const char *str = (const char *) f->value;
+    const char *end = (const char *) memchr(str, '\0', xElementSizeOf(f->type));
+    PutText(out, str, end ? (size_t) (end - str) : (size_t) xElementSizeOf(f->type), delim);
+  }
+  else {
+    char *end = x_print_scalar(num, f->type, f->value);
+    if(end > num) PutText(out, num, end - num, delim);
+  }
+}
+
+/// Whether the field can be a column.
+static boolean IsColumn(const XField *f) {
+  if(!f->name || xGetFieldCount(f) != 1) return FALSE;
+  if(f->isSerialized || xIsCharSequence(f->type)) return TRUE;
+
+  switch(f->type) {
+    case X_BOOLEAN:
+    case X_BYTE:
+    case X_INT16:
+    case X_INT32:
+    case X_INT64:
+    case X_FLOAT:
+    case X_DOUBLE:
+    case X_STRING:
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/// Adds the aggregate IDs of the scalar fields of a structure (recursively) to the list of column IDs.
+static void AddColumns(const XStructure *s, const char *prefix, char ***ids, int *n, int *capacity) {
+  const XField *f;
+
+  for(f = s->firstField; f != NULL; f = f->next) {
+    char *id;
+
+    if(f->type == X_STRUCT && f->ndim == 0 && !f->isSerialized && f->name) {
+      id = prefix ? xGetAggregateID(prefix, f->name) : xStringCopyOf(f->name);
+      AddColumns((const XStructure *) f->value, id, ids, n, capacity);
+      free(id);
+      continue;
+    }
+
+    if(!IsColumn(f)) continue;
+
+    if(*n >= *capacity) {
+      *capacity = *capacity ? 2 * *capacity : 16;
+      *ids = (char **) realloc(*ids, *capacity * sizeof(char *));
+      x_check_alloc(*ids);
+    }
+
+    (*ids)[(*n)++] = prefix ? xGetAggregateID(prefix, f->name) : xStringCopyOf(f->name);
+  }
+}
+
+/**
+ * Writes an array of structures (records) as a CSV or TSV table, with a header row of column names, and one row
+ * per record. The columns are the scalar fields of the first record, including those in its embedded
+ * substructures (named by their aggregate IDs, e.g. `sub:x`). Rows are terminated by CRLF, as per RFC 4180.
+ * Records, in which a column's field is missing, have an empty cell in that column.
+ *
+ * @param s       Pointer to an array of structures, e.g. the value of an `X_STRUCT` array field.
+ * @param n       Number of structures in the array.
+ * @param delim   The column delimiter, e.g. XCSV_COMMA (`,`) for CSV, or XCSV_TAB (`\t`) for TSV.
+ * @param fp      The file to write to.
+ * @return        X_SUCCESS (0) if successful, or else X_NULL if an argument is NULL, or X_FAILURE if the
+ *                arguments are invalid, or if there was a write error (errno set).
+ *
+ * @since 1.1
+ *
+ * @sa xcsvRead()
+ */
+int xcsvWrite(const XStructure *s, int n, char delim, FILE *fp) {
+  static const char *fn = "xcsvWrite";
+
+  CSVSink *out;
+  char **ids = NULL;
+  int i, k, nCols = 0, capacity = 0, status;
+
+  if(!s) return x_error(X_NULL, EINVAL, fn, "input structure is NULL");
+  if(!fp) return x_error(X_NULL, EINVAL, fn, "output file is NULL");
+  if(n < 0) return x_error(X_FAILURE, EINVAL, fn, "invalid number of structures: %d", n);
+  if(!delim || delim == '"' || delim == '\r' || delim == '\n') return x_error(X_FAILURE, EINVAL, fn, "invalid delimiter");
+
+  if(n > 0) AddColumns(&s[0], NULL, &ids, &nCols, &capacity);
+  if(!nCols) {
+    if(ids) free(ids);
+    return X_SUCCESS;
+  }
+
+  out = (CSVSink *) malloc(sizeof(CSVSink));
+  x_check_alloc(out);
+  out->fp = fp;
+  out->n = 0;
+  out->status = X_SUCCESS;
+
+  for(k = 0; k < nCols; k++) {
+    if(k) PutChar(out, delim);
+    PutText(out, ids[k], strlen(ids[k]), delim);
+  }
+  PutBytes(out, "\r\n", 2);
+
+  for(i = 0; i < n && out->status == X_SUCCESS; i++) {
+    for(k = 0; k < nCols; k++) {
+      if(k) PutChar(out, delim);
+      PutCell(out, xGetField(&s[i], ids[k]), delim);
+    }
+    PutBytes(out, "\r\n", 2);
+  }
+
+  Flush(out);
+  status = out->status;
+
+  free(out);
+  for(k = 0; k < nCols; k++) free(ids[k]);
+  free(ids);
+
+  prop_error(fn, status);
+  return X_SUCCESS;
+}
+
+static void AddText(CSVTable *t, char c) {
+  if(t->nText >= t->textSize) {
+    t->textSize = t->textSize ? 2 * t->textSize : CSV_BUFFER_SIZE;
+    t->text = (char *) realloc(t->text, t->textSize);
+    x_check_alloc(t->text);
+  }
+  t->text[t->nText++] = c;
+}
+
+static void AddCell(CSVTable *t, long offset) {
+  if(t->nCells >= t->cellsSize) {
+    t->cellsSize = t->cellsSize ? 2 * t->cellsSize : 1024;
+    t->cells = (long *) realloc(t->cells, t->cellsSize * sizeof(long));
+    x_check_alloc(t->cells);
+  }
+  t->cells[t->nCells++] = offset;
+}
+
+/// Reads the cells of a CSV / TSV table, with the header row as the first row.
+static int ReadTable(FILE *fp, char delim, CSVTable *t) {
+  static const char *fn = "ReadTable";
+
+  char *buf = (char *) malloc(CSV_BUFFER_SIZE);
+  size_t start = 0;
+  long rowStart = 0, line = 1;
+  int col = 0;
+  boolean inQuotes = FALSE, quotePending = FALSE, isQuoted = FALSE, hasText = FALSE, isHeader = TRUE;
+
+  x_check_alloc(buf);
+
+  for(;;) {
+    size_t i, n = fread(buf, 1, CSV_BUFFER_SIZE, fp);
+    const boolean isEOF = (n == 0);
+
+    if(isEOF) {
+      if(ferror(fp)) {
+        free(buf);
+        return x_error(X_FAILURE, errno, fn, "read error: %s", strerror(errno));
+      }
+      if(inQuotes && !quotePending) {
+        free(buf);
+        return x_error(X_PARSE_ERROR, EINVAL, fn, "[L.%ld] unterminated quoted value", line);
+      }
+      // Terminate the last row, if it has no line break at the end.
+      if(col == 0 && !hasText && !isQuoted) break;
+      buf[0] = '\n';
+      n = 1;
+      inQuotes = FALSE;
+    }
+
+    for(i = 0; i < n; i++) {
+      const char c = buf[i];
+
+      if(quotePending) {
+        quotePending = FALSE;
+        if(c == '"') {
+          AddText(t, c);       // Escaped quote
+          continue;
+        }
+        inQuotes = FALSE;
+      }
+
+      if(inQuotes) {
+        if(c == '"') quotePending = TRUE;
+        else {
+          if(c == '\n') line++;
+          AddText(t, c);
+        }
+        continue;
+      }
+
+      if(c == delim || c == '\n') {
+        // End of cell
+        if(isHeader || col < t->nCols) {
+          AddText(t, '\0');
+          AddCell(t, (hasText || isQuoted) ? (long) start : CSV_NULL);
+        }
+        else t->nText = start;       // Extra cell, beyond the header's columns
+
+        col++;
+        start = t->nText;
+        hasText = isQuoted = FALSE;
+
+        if(c == '\n') {
+          // End of row
+          line++;
+
+          if(isHeader) {
+            t->nCols = col;
+            isHeader = FALSE;
+          }
+          else if(col == 1 && t->cells[t->nCells - 1] == CSV_NULL) t->nCells--;    // Skip empty lines
+          else {
+            while(t->nCells - rowStart < t->nCols) AddCell(t, CSV_NULL);
+            t->nRows++;
+          }
+
+          rowStart = t->nCells;
+          col = 0;
+        }
+      }
+      else if(c == '\r') continue;
+      else if(c == '"' && !hasText && !isQuoted) inQuotes = isQuoted = TRUE;
+      else {
+        AddText(t, c);
+        hasText = TRUE;
+      }
+    }
+
+    if(isEOF) break;
+  }
+
+  free(buf);
+  return X_SUCCESS;
+}
+
+/// Infers the type of a column from its values.
+static XType InferType(const CSVTable *t, int col) {
+  boolean isInt = TRUE, isNumber = TRUE, isBoolean = TRUE, isShort = TRUE, isEmpty = TRUE;
+  long row;
+
+  for(row = 0; row < t->nRows; row++) {
+    const long offset = t->cells[(row + 1) * t->nCols + col];
+    const char *str;
+    int64_t l;
+    double d;
+
+    if(offset == CSV_NULL) continue;
+
+    str = &t->text[offset];
+    isEmpty = FALSE;
+
+    if(isBoolean) isBoolean = (!strcasecmp(str, "true") || !strcasecmp(str, "false"));
+    if(isInt) {
+      isInt = (x_parse_scalar(str, X_INT64, &l) == X_SUCCESS);
+      if(isInt && (l < INT32_MIN || l > INT32_MAX)) isShort = FALSE;
+    }
+    if(isNumber && !isInt) isNumber = (x_parse_scalar(str, X_DOUBLE, &d) == X_SUCCESS);
+
+    if(!isBoolean && !isNumber) return X_STRING;
+  }
+
+  if(isEmpty) return X_STRING;
+  if(isBoolean) return X_BOOLEAN;
+  if(isInt) return isShort ? X_INT : X_LLONG;
+  return X_DOUBLE;
+}
+
+/// Returns the column type given by the prototype, or X_UNKNOWN if there is none.
+static XType GetProtoType(const XStructure *proto, const char *id) {
+  const XField *f;
+
+  if(!proto) return X_UNKNOWN;
+
+  f = xGetField(proto, id);
+  if(!f || f->isSerialized || !IsColumn(f)) return X_UNKNOWN;
+
+  return f->type;
+}
+
+/// Returns the (embedded) structure to which the field of the given ID belongs, creating it if necessary.
+static XStructure *GetParent(XStructure *s, const char *id, const char **name) {
+  const char *next;
+
+  while((next = xNextIDToken(id)) != NULL) {
+    char *token = xCopyIDToken(id);
+    XStructure *sub;
+
+    if(!token) return x_trace_null("GetParent", id);
+    if(!*token) {
+      free(token);
+      x_error(0, EINVAL, "GetParent", "empty component in ID: %s", id);
+      return NULL;
+    }
+
+    sub = xGetSubstruct(s, token);
+    if(!sub) {
+      // Create the substructure (replacing any non-structure field by the same name).
+      XField *old;
+      sub = xCreateStruct();
+      old = xSetSubstruct(s, token, sub);
+      if(old) xDestroyField(old);
+    }
+
+    free(token);
+    s = sub;
+    id = next;
+  }
+
+  *name = id;
+  return s;
+}
+
+static XField *CreateCellField(const char *name, XType type, const char *str) {
+  static const char *fn = "CreateCellField";
+
+  union {
+    boolean b;
+    int8_t i8;
+    int16_t i16;
+    int32_t i32;
+    int64_t i64;
+    float f;
+    double d;
+  } value;
+
+  if(type == X_STRING) return xCreateStringField(name, str);
+
+  if(xIsCharSequence(type)) {
+    const size_t n = xElementSizeOf(type);
+    char *chars = (char *) calloc(1, n);
+    XField *f;
+
+    x_check_alloc(chars);
+    strncpy(chars, str, n);
+    f = xCreateScalarField(name, type, chars);
+    free(chars);
+    return f;
+  }
+
+  if(x_parse_scalar(str, type, &value) != X_SUCCESS) {
+    x_error(0, EINVAL, fn, "invalid value for '%s' (type '%c'): %s", name, xTypeChar(type), str);
+    return NULL;
+  }
+
+  return xCreateScalarField(name, type, &value);
+}
+
+/**
+ * Reads a CSV or TSV table into an array of structures, one structure per data row. The first row of the table
+ * must contain the column names, which may be aggregate IDs (e.g. `sub:x`), in which case the values are placed
+ * into (newly created) embedded substructures. Empty (unquoted) cells are treated as missing values, and do not
+ * produce fields. Rows with fewer cells than the header are padded with missing values, while extra cells are
+ * ignored.
+ *
+ * The column types are taken from the matching scalar fields of the optional prototype structure. Columns not in
+ * the prototype have their types inferred from their values: `X_BOOLEAN` if all values are `true` or `false`
+ * (case insensitive), `X_INT` or `X_LLONG` if all values are integers, `X_DOUBLE` if all values are numbers, or
+ * else `X_STRING`.
+ *
+ * @param name    The name of the returned field.
+ * @param fp      The file to read from.
+ * @param delim   The column delimiter, e.g. XCSV_COMMA (`,`) for CSV, or XCSV_TAB (`\t`) for TSV.
+ * @param proto   (optional) Prototype structure that defines column types, or NULL to infer all column types.
+ * @return        A newly created `X_STRUCT` array field, with a structure for each data row, or NULL if there was
+ *                an error (errno will indicate the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xcsvWrite()
+ */
+XField *xcsvRead(const char *name, FILE *fp, char delim, const XStructure *proto) {
+  static const char *fn = "xcsvRead";
+
+  CSVTable t = {NULL};
+  XStructure *records;
+  XType *types;
+  XField *f;
+  long row;
+  int col, status = X_SUCCESS, sizes[1];
+
+  if(!name) {
+    x_error(0, EINVAL, fn, "input name is NULL");
+    return NULL;
+  }
+
+  if(!fp) {
+    x_error(0, EINVAL, fn, "input file is NULL");
+    return NULL;
+  }
+
+  if(!delim || delim == '"' || delim == '\r' || delim == '\n') {
+    x_error(0, EINVAL, fn, "invalid delimiter");
+    return NULL;
+  }
+
+  if(ReadTable(fp, delim, &t) != X_SUCCESS) {
+    if(t.text) free(t.text);
+    if(t.cells) free(t.cells);
+    return x_trace_null(fn, name);
+  }
+
+  if(t.nRows > X_MAX_ELEMENTS) {
+    free(t.text);
+    free(t.cells);
+    x_error(0, ERANGE, fn, "too many rows: %ld", t.nRows);
+    return NULL;
+  }
+
+  types = (XType *) calloc(t.nCols + 1, sizeof(XType));
+  x_check_alloc(types);
+
+  for(col = 0; col < t.nCols; col++) {
+    if(t.cells[col] == CSV_NULL || !t.text[t.cells[col]]) {
+      status = x_error(X_NAME_INVALID, EINVAL, fn, "empty column name in column %d", col + 1);
+      break;
+    }
+    types[col] = GetProtoType(proto, &t.text[t.cells[col]]);
+    if(types[col] == X_UNKNOWN) types[col] = InferType(&t, col);
+  }
+
+  records = (XStructure *) calloc(t.nRows > 0 ? t.nRows : 1, sizeof(XStructure));
+  x_check_alloc(records);
+
+  for(row = 0; row < t.nRows && status == X_SUCCESS; row++) {
+    const long *cells = &t.cells[(row + 1) * t.nCols];
+
+    for(col = 0; col < t.nCols; col++) {
+      const char *leaf = NULL;
+      XStructure *parent;
+      XField *e;
+
+      if(cells[col] == CSV_NULL) continue;
+
+      parent = GetParent(&records[row], &t.text[t.cells[col]], &leaf);
+      e = parent ? CreateCellField(leaf, types[col], &t.text[cells[col]]) : NULL;
+      if(!e) {
+        status = x_trace(fn, &t.text[t.cells[col]], X_PARSE_ERROR);
+        break;
+      }
+
+      e = xSetField(parent, e);
+      if(e) xDestroyField(e);   // Duplicate column
+    }
+  }
+
+  free(types);
+  free(t.text);
+  free(t.cells);
+
+  sizes[0] = (int) t.nRows;
+
+  if(status == X_SUCCESS) {
+    f = xCreateField(name, X_STRUCT, 1, sizes, records);
+    if(f) return f;
+  }
+
+  for(row = 0; row < t.nRows; row++) xClearStruct(&records[row]);
+  free(records);
+
+  return x_trace_null(fn, name);
+}
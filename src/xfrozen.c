@@ -0,0 +1,1494 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * @brief   Frozen, read-in-place images of structured data.
+ *
+ *  A frozen image is a single contiguous block of memory containing an entire structure tree, in which every
+ *  link is a relative offset (from the location of the link itself) instead of a pointer. As such, an image may be
+ *  written to a file, and later memory mapped (e.g. by many processes, sharing the same physical pages), and queried
+ *  right away through the read-only accessors, without any deserialization.
+ *
+ *  All items in the image are 8-byte aligned, and numerical data are stored in their native binary format, so
+ *  element pointers can be used directly as typed C arrays. The images are meant for use on the platform (or a
+ *  compatible platform) on which they were created. Images created on a platform with different byte order are
+ *  rejected.
+ *
+ *  The fields of each structure are stored in an array, in their original order, together with an index of the
+ *  fields sorted by name, so fields can be looked up by binary search.
+ *
+ *  Frozen images may also be published into POSIX shared memory segments, from which co-located processes can obtain
+ *  consistent snapshots (or read them in place, if they can keep up with the publisher). Each segment has two image
+ *  slots, which are written alternately, and generation counters with which readers can verify that what they read
+ *  was a consistent snapshot.
+ */
+
+#define _POSIX_C_SOURCE 200112L         ///< For ftruncate() and shm_open()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#define __XCHANGE_INTERNAL_API__        ///< Use internal definitions
+#include "xfrozen.h"
+
+#ifndef TRUE
+#define TRUE 1          ///< Boolean 'true' in case it isn't already defined
+#endif
+
+#ifndef FALSE
+#define FALSE 0         ///< Boolean 'false' in case it isn't already defined
+#endif
+
+/// \cond PRIVATE
+#define FROZEN_MAGIC        "XFRZ"      ///< Leading bytes of frozen images
+#define FROZEN_ALIGN        8           ///< (bytes) Alignment of all items in a frozen image
+
+#if defined(X_BIG_ENDIAN_HOST)
+#  define FROZEN_BYTE_ORDER 2           ///< Byte order mark of frozen images created on this platform
+#else
+#  define FROZEN_BYTE_ORDER 1           ///< Byte order mark of frozen images created on this platform
+#endif
+
+/// The header of a frozen image
+typedef struct {
+  char magic[4];            ///< "XFRZ"
+  uint8_t version;          ///< XFROZEN_VERSION
+  uint8_t byteOrder;        ///< 1: little-endian, 2: big-endian
+  uint8_t reserved[2];      ///< (unused, zeroed)
+  uint64_t size;            ///< (bytes) Total size of the image, including this header
+  int64_t root;             ///< Relative offset of the root structure
+} FrozenHeader;
+
+/// A frozen structure
+struct XFrozenStruct {
+  int64_t fields;           ///< Relative offset of the array of fields, or 0 if there are no fields
+  int64_t index;            ///< Relative offset of the int32 array of field indices, sorted by field name
+  int32_t nFields;          ///< Number of fields in the structure
+  int32_t reserved;         ///< (unused, zeroed)
+};
+
+/// A frozen field
+struct XFrozenField {
+  int64_t name;             ///< Relative offset of the field name
+  int64_t subtype;          ///< Relative offset of the subtype, or 0 if none
+  int64_t sizes;            ///< Relative offset of the int32 array of dimensions, or 0 if scalar
+  int64_t value;            ///< Relative offset of the value, or 0 if NULL
+  int32_t type;             ///< The XType of the field
+  int16_t ndim;             ///< Number of dimensions
+  int8_t isSerialized;      ///< Whether the value is serialized (string) data
+  int8_t reserved;          ///< (unused, zeroed)
+};
+
+typedef struct {
+  char *data;               ///< The image buffer
+  size_t n;                 ///< (bytes) Number of bytes used in the image
+  size_t size;              ///< (bytes) Allocated size of the buffer
+} FrozenWriter;
+
+/// An entry for sorting the fields by name
+typedef struct {
+  const char *name;         ///< The field name
+  int32_t idx;              ///< The index of the field in the original order
+} FrozenIndexEntry;
+
+#define SEGMENT_MAGIC       "XSHM"      ///< Leading bytes of shared memory segments
+#define SEGMENT_VERSION     1           ///< Version of the shared segment layout
+#define SEGMENT_ALIGN       64          ///< (bytes) Alignment of the image slots in shared segments
+#define SEGMENT_RETRIES     1000        ///< Number of attempts to obtain a consistent snapshot
+
+/// The header of a shared memory segment, followed by two image slots
+typedef struct {
+  char magic[4];                ///< "XSHM"
+  uint8_t version;              ///< SEGMENT_VERSION
+  uint8_t reserved[3];          ///< (unused, zeroed)
+  uint64_t slotSize;            ///< (bytes) Size of each image slot
+  uint64_t generation;          ///< The latest published generation, or 0 if nothing was published yet
+  uint64_t slotGeneration[2];   ///< The generation of the image in each slot, or 0 while it is being written
+} SegmentHeader;
+
+/// The state of validating a frozen image, whose items must follow one another in the order xfrozenCreate() writes them
+typedef struct {
+  const char *base;         ///< Start of the image
+  size_t size;              ///< (bytes) Size of the image
+  size_t next;              ///< Offset in the image, at or after which the next item must start
+} FrozenVerifier;
+
+struct XFrozenSegment {
+  char *base;               ///< Start of the mapped segment
+  size_t size;              ///< (bytes) Size of the mapped segment
+  boolean isWritable;       ///< Whether we may publish to the segment
+};
+/// \endcond
+
+static int FreezeStruct(FrozenWriter *w, const XStructure *s, size_t at);
+static int FreezeField(FrozenWriter *w, const XField *f, size_t at);
+static int ThawStruct(const XFrozenStruct *src, XStructure *s);
+
+static const void *Resolve(const int64_t *link) {
+  return *link ? (const char *) link + *link : NULL;
+}
+
+/// Allocates a zeroed, 8-byte aligned block in the image, returning its offset.
+static size_t Alloc(FrozenWriter *w, size_t m) {
+  const size_t at = (w->n + FROZEN_ALIGN - 1) & ~((size_t) FROZEN_ALIGN - 1);
+
+  if(at + m > w->size) {
+    char *data;
+
+    w->size = (2 * w->size > at + m) ? 2 * w->size : at + m;
+    data = (char *) realloc(w->data, w->size);
+    x_check_alloc(data);
+    w->data = data;
+  }
+
+  memset(&w->data[w->n], 0, at + m - w->n);
+  w->n = at + m;
+
+  return at;
+}
+
+/// Sets the relative offset at the link location, to point to the target location in the image.
+static void Link(FrozenWriter *w, size_t at, size_t target) {
+  const int64_t offset = (int64_t) target - (int64_t) at;
+  memcpy(&w->data[at], &offset, sizeof(offset));
+}
+
+static void LinkString(FrozenWriter *w, size_t at, const char *str) {
+  size_t l, target;
+
+  if(!str) return;
+
+  l = strlen(str);
+  target = Alloc(w, l + 1);
+  memcpy(&w->data[target], str, l + 1);
+  Link(w, at, target);
+}
+
+static int CompareIndexEntries(const void *a, const void *b) {
+  return strcmp(((const FrozenIndexEntry *) a)->name, ((const FrozenIndexEntry *) b)->name);
+}
+
+static int FreezeValue(FrozenWriter *w, const XField *f, size_t at) {
+  static const char *fn = "FreezeValue";
+
+  const long count = xGetFieldCount(f);
+  const int eSize = xElementSizeOf(f->type);
+  size_t data;
+  long i;
+
+  if(f->isSerialized) {
+    LinkString(w, at, (char *) f->value);
+    return X_SUCCESS;
+  }
+
+  if(eSize <= 0) return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid type: %d", f->type);
+
+  switch(f->type) {
+    case X_STRING:
+    case X_RAW:
+      data = Alloc(w, count * sizeof(int64_t));
+      for(i = 0; i < count; i++) LinkString(w, data + i * sizeof(int64_t), ((char **) f->value)[i]);
+      break;
+
+    case X_STRUCT:
+      data = Alloc(w, count * sizeof(XFrozenStruct));
+      for(i = 0; i < count; i++) prop_error(fn, FreezeStruct(w, &((XStructure *) f->value)[i], data + i * sizeof(XFrozenStruct)));
+      break;
+
+    case X_FIELD:
+      data = Alloc(w, count * sizeof(XFrozenField));
+      for(i = 0; i < count; i++) prop_error(fn, FreezeField(w, &((XField *) f->value)[i], data + i * sizeof(XFrozenField)));
+      break;
+
+    default:
+      data = Alloc(w, count * eSize);
+      memcpy(&w->data[data], f->value, count * eSize);
+  }
+
+  Link(w, at, data);
+  return X_SUCCESS;
+}
+
+static int FreezeField(FrozenWriter *w, const XField *f, size_t at) {
+  static const char *fn = "FreezeField";
+
+  XFrozenField *e = (XFrozenField *) &w->data[at];
+
+  if(!f->name) return x_error(X_NAME_INVALID, EINVAL, fn, "field->name is NULL");
+  if(f->ndim < 0 || f->ndim > X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid ndim: %d", f->ndim);
+
+  e->type = f->type;
+  e->ndim = (int16_t) f->ndim;
+  e->isSerialized = f->isSerialized ? TRUE : FALSE;
+
+  // Note, the buffer may move with each allocation below, so we set the links by their offsets.
+  LinkString(w, at + offsetof(XFrozenField, name), f->name);
+  LinkString(w, at + offsetof(XFrozenField, subtype), f->subtype);
+
+  if(f->ndim > 0) {
+    size_t sizes = Alloc(w, f->ndim * sizeof(int32_t));
+    memcpy(&w->data[sizes], xGetFieldSizes(f), f->ndim * sizeof(int32_t));
+    Link(w, at + offsetof(XFrozenField, sizes), sizes);
+  }
+
+  if(f->value) prop_error(fn, FreezeValue(w, f, at + offsetof(XFrozenField, value)));
+
+  return X_SUCCESS;
+}
+
+static int FreezeStruct(FrozenWriter *w, const XStructure *s, size_t at) {
+  static const char *fn = "FreezeStruct";
+
+  const int n = xCountFields(s);
+  FrozenIndexEntry *entries;
+  const XField *f;
+  size_t fields, index;
+  int i;
+
+  ((XFrozenStruct *) &w->data[at])->nFields = n;
+  if(n == 0) return X_SUCCESS;
+
+  fields = Alloc(w, n * sizeof(XFrozenField));
+  index = Alloc(w, n * sizeof(int32_t));
+
+  Link(w, at + offsetof(XFrozenStruct, fields), fields);
+  Link(w, at + offsetof(XFrozenStruct, index), index);
+
+  entries = (FrozenIndexEntry *) calloc(n, sizeof(FrozenIndexEntry));
+  x_check_alloc(entries);
+
+  for(i = 0, f = s->firstField; f != NULL; f = f->next, i++) {
+    int status = FreezeField(w, f, fields + i * sizeof(XFrozenField));
+    if(status != X_SUCCESS) {
+      free(entries);
+      return x_trace(fn, f->name, status);
+    }
+    entries[i].name = f->name;
+    entries[i].idx = i;
+  }
+
+  qsort(entries, n, sizeof(FrozenIndexEntry), CompareIndexEntries);
+  for(i = 0; i < n; i++) ((int32_t *) &w->data[index])[i] = entries[i].idx;
+
+  free(entries);
+  return X_SUCCESS;
+}
+
+/**
+ * Creates a frozen image of a structure, in which all links are relative offsets. The image can be written to
+ * a file as is, and then memory mapped (e.g. with xfrozenMapFile()), or else used directly in memory, via the
+ * read-only accessors, such as xfrozenGetField(), without deserialization.
+ *
+ * @param s           Pointer to structured data
+ * @param[out] size   (bytes) Pointer to which to return the size of the image.
+ * @return            A newly allocated frozen image, or NULL if there was an error (errno will inform about
+ *                    the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenRoot()
+ * @sa xfrozenMapFile()
+ * @sa xfrozenThaw()
+ */
+void *xfrozenCreate(const XStructure *s, size_t *size) {
+  static const char *fn = "xfrozenCreate";
+
+  FrozenWriter w = {NULL};
+  FrozenHeader *h;
+  size_t root;
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(!size) {
+    x_error(0, EINVAL, fn, "output size pointer is NULL");
+    return NULL;
+  }
+
+  Alloc(&w, sizeof(FrozenHeader));
+  root = Alloc(&w, sizeof(XFrozenStruct));
+
+  if(FreezeStruct(&w, s, root) != X_SUCCESS) {
+    free(w.data);
+    return x_trace_null(fn, NULL);
+  }
+
+  // Pad to full alignment, so images may be concatenated...
+  Alloc(&w, 0);
+
+  h = (FrozenHeader *) w.data;
+  memcpy(h->magic, FROZEN_MAGIC, sizeof(h->magic));
+  h->version = XFROZEN_VERSION;
+  h->byteOrder = FROZEN_BYTE_ORDER;
+  h->size = w.n;
+  Link(&w, offsetof(FrozenHeader, root), root);
+
+  *size = w.n;
+  return w.data;
+}
+
+/**
+ * Checks a link in the image, and claims the block of `n` elements of `eSize` bytes each, to which it points. The
+ * block must be aligned, must lie entirely within the image, and must start at or after the end of the previously
+ * claimed block. Since xfrozenCreate() allocates every item after the item that links to it, this also rules out
+ * loops and items shared by several links.
+ *
+ * @param v       The verifier state
+ * @param link    The link to check
+ * @param n       Number of elements in the block
+ * @param eSize   (bytes) Size of each element (&gt;0)
+ * @return        Pointer to the block, or NULL if the link is invalid.
+ */
+static const void *Claim(FrozenVerifier *v, const int64_t *link, long n, size_t eSize) {
+  const int64_t at = (const char *) link - v->base;
+  const int64_t offset = __atomic_load_n(link, __ATOMIC_RELAXED);    // Read only once (it might be changing)
+  size_t to;
+
+  if(offset < (int64_t) v->next - at || offset > (int64_t) v->size - at) return NULL;
+
+  to = (size_t) (at + offset);
+  if(to % FROZEN_ALIGN || n < 0 || (size_t) n > (v->size - to) / eSize) return NULL;
+
+  v->next = to + n * eSize;
+  return v->base + to;
+}
+
+/// Claims a NUL-terminated string, to which the link points. Returns the string or NULL if the link is invalid.
+static const char *ClaimString(FrozenVerifier *v, const int64_t *link) {
+  const char *str = (const char *) Claim(v, link, 0, 1);
+  const char *end;
+
+  if(!str) return NULL;
+
+  end = (const char *) memchr(str, '\0', v->base + v->size - str);
+  if(!end) return NULL;
+
+  v->next += end - str + 1;
+  return str;
+}
+
+static int VerifyStruct(FrozenVerifier *v, const XFrozenStruct *s);
+
+static int VerifyField(FrozenVerifier *v, const XFrozenField *f) {
+  static const char *fn = "VerifyField";
+
+  // Each item is read just once, since the image may be changing while it is verified (see xfrozenBeginRead()).
+  const int ndim = f->ndim, type = f->type;
+  const int32_t *sizes;
+  long i, count = 1;
+  int eSize;
+
+  if(!ClaimString(v, &f->name)) return x_error(X_NAME_INVALID, EINVAL, fn, "invalid field name");
+  if(f->subtype && !ClaimString(v, &f->subtype)) return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid subtype");
+
+  if(ndim < 0 || ndim > X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid ndim: %d", ndim);
+
+  if(ndim > 0) {
+    sizes = (const int32_t *) Claim(v, &f->sizes, ndim, sizeof(int32_t));
+    if(!sizes) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid dimensions");
+
+    for(i = 0; i < ndim; i++) {
+      const int32_t l = sizes[i];
+      if(l < 0 || (l > 0 && count > X_MAX_ELEMENTS / l)) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid size: %d", l);
+      count *= l;
+    }
+  }
+  else if(__atomic_load_n(&f->sizes, __ATOMIC_RELAXED)) return x_error(X_SIZE_INVALID, EINVAL, fn, "dimensions for scalar");
+
+  if(type < 0) {
+    // Fixed-length character sequences cannot be longer than the image itself.
+    if((uint32_t) type == 0x80000000U || (size_t) -type > v->size)
+      return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid type: %d", type);
+  }
+  else if(type != X_UNKNOWN && xElementSizeOf(type) <= 0)
+    return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid type: %d", type);
+
+  if(!f->value) return X_SUCCESS;
+
+  if(f->isSerialized) {
+    if(type == X_STRUCT || type == X_FIELD)
+      return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid serialized type: %d", type);
+    if(!ClaimString(v, &f->value)) return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid serialized value");
+    return X_SUCCESS;
+  }
+
+  eSize = xElementSizeOf(type);
+  if(eSize <= 0) return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid type: %d", type);
+
+  switch(type) {
+    case X_STRING:
+    case X_RAW: {
+      const int64_t *links = (const int64_t *) Claim(v, &f->value, count, sizeof(int64_t));
+      if(!links) break;
+      for(i = 0; i < count; i++) if(links[i] && !ClaimString(v, &links[i]))
+        return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid string element %ld", i);
+      return X_SUCCESS;
+    }
+
+    case X_STRUCT: {
+      const XFrozenStruct *sub = (const XFrozenStruct *) Claim(v, &f->value, count, sizeof(XFrozenStruct));
+      if(!sub) break;
+      for(i = 0; i < count; i++) prop_error(fn, VerifyStruct(v, &sub[i]));
+      return X_SUCCESS;
+    }
+
+    case X_FIELD: {
+      const XFrozenField *e = (const XFrozenField *) Claim(v, &f->value, count, sizeof(XFrozenField));
+      if(!e) break;
+      for(i = 0; i < count; i++) prop_error(fn, VerifyField(v, &e[i]));
+      return X_SUCCESS;
+    }
+
+    default:
+      if(Claim(v, &f->value, count, eSize)) return X_SUCCESS;
+  }
+
+  return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid value");
+}
+
+static int VerifyStruct(FrozenVerifier *v, const XFrozenStruct *s) {
+  static const char *fn = "VerifyStruct";
+
+  const int n = s->nFields;
+  const XFrozenField *fields;
+  const int32_t *index;
+  int i;
+
+  if(n < 0) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid field count: %d", n);
+  if(n == 0) return X_SUCCESS;
+
+  fields = (const XFrozenField *) Claim(v, &s->fields, n, sizeof(XFrozenField));
+  index = (const int32_t *) Claim(v, &s->index, n, sizeof(int32_t));
+  if(!fields || !index) return x_error(X_STRUCT_INVALID, EINVAL, fn, "invalid fields");
+
+  for(i = 0; i < n; i++) {
+    const int32_t k = index[i];
+    if(k < 0 || k >= n) return x_error(X_STRUCT_INVALID, EINVAL, fn, "invalid field index: %d", k);
+  }
+
+  for(i = 0; i < n; i++) prop_error(fn, VerifyField(v, &fields[i]));
+
+  return X_SUCCESS;
+}
+
+/**
+ * Returns the root structure of a frozen image, after checking that the image is valid for use on this platform.
+ * The image must be 8-byte aligned in memory (as are dynamically allocated or memory mapped images). The entire image
+ * is verified (every link, field index, dimension, type, and string), so the structures and fields in it may be
+ * accessed safely afterwards, even if the image came from an untrusted source. Verification takes time proportional
+ * to the size of the image.
+ *
+ * @param image   Pointer to the frozen image, e.g. as returned by xfrozenCreate() or xfrozenMapFile().
+ * @param size    (bytes) The number of bytes available in the image buffer.
+ * @return        The root structure in the image, or NULL if the image is invalid or corrupted (errno set to
+ *                EINVAL).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenGetField()
+ */
+const XFrozenStruct *xfrozenRoot(const void *image, size_t size) {
+  static const char *fn = "xfrozenRoot";
+
+  const FrozenHeader *h = (const FrozenHeader *) image;
+  FrozenVerifier v = {NULL};
+  const XFrozenStruct *root;
+
+  if(!image) {
+    x_error(0, EINVAL, fn, "input image is NULL");
+    return NULL;
+  }
+
+  if((size_t) image % FROZEN_ALIGN) {
+    x_error(0, EINVAL, fn, "image is not %d-byte aligned", FROZEN_ALIGN);
+    return NULL;
+  }
+
+  if(size < sizeof(FrozenHeader) || memcmp(h->magic, FROZEN_MAGIC, sizeof(h->magic)) != 0) {
+    x_error(0, EINVAL, fn, "not a frozen image");
+    return NULL;
+  }
+
+  if(h->version != XFROZEN_VERSION || h->byteOrder != FROZEN_BYTE_ORDER) {
+    x_error(0, EINVAL, fn, "incompatible frozen image (version %d, byte order %d)", h->version, h->byteOrder);
+    return NULL;
+  }
+
+  v.base = (const char *) image;
+  v.size = h->size;
+
+  if(v.size > size || v.size < sizeof(FrozenHeader)) {
+    x_error(0, EINVAL, fn, "truncated frozen image");
+    return NULL;
+  }
+  v.next = sizeof(FrozenHeader);
+
+  root = (const XFrozenStruct *) Claim(&v, &h->root, 1, sizeof(XFrozenStruct));
+  if(!root) {
+    x_error(0, EINVAL, fn, "invalid root structure");
+    return NULL;
+  }
+
+  if(VerifyStruct(&v, root) != X_SUCCESS) return x_trace_null(fn, NULL);
+
+  return root;
+}
+
+/**
+ * Maps a file containing a frozen image into memory, read-only. The mapping is shared, so multiple processes
+ * mapping the same file will share the same physical memory pages.
+ *
+ * @param fileName    The file name / path of the frozen image.
+ * @param[out] size   (bytes) Pointer to which to return the size of the mapped image.
+ * @return            Pointer to the mapped image, or NULL if there was an error (errno will indicate the type of
+ *                    error). Call xfrozenUnmapFile() when done using it.
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenUnmapFile()
+ * @sa xfrozenRoot()
+ */
+const void *xfrozenMapFile(const char *fileName, size_t *size) {
+  static const char *fn = "xfrozenMapFile";
+
+  struct stat st;
+  void *image;
+  int fd;
+
+  if(!fileName) {
+    x_error(0, EINVAL, fn, "input file name is NULL");
+    return NULL;
+  }
+
+  if(!size) {
+    x_error(0, EINVAL, fn, "output size pointer is NULL");
+    return NULL;
+  }
+
+  fd = open(fileName, O_RDONLY);
+  if(fd < 0) {
+    x_error(0, errno, fn, "could not open %s: %s", fileName, strerror(errno));
+    return NULL;
+  }
+
+  if(fstat(fd, &st) != 0) {
+    x_error(0, errno, fn, "could not stat %s: %s", fileName, strerror(errno));
+    close(fd);
+    return NULL;
+  }
+
+  if(st.st_size == 0) {
+    x_error(0, EINVAL, fn, "%s is empty", fileName);
+    close(fd);
+    return NULL;
+  }
+
+  image = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if(image == MAP_FAILED) {
+    x_error(0, errno, fn, "could not map %s: %s", fileName, strerror(errno));
+    return NULL;
+  }
+
+  *size = st.st_size;
+  return image;
+}
+
+/**
+ * Unmaps a frozen image that was mapped by xfrozenMapFile().
+ *
+ * @param image   Pointer to the mapped image
+ * @param size    (bytes) Size of the mapped image, as returned by xfrozenMapFile()
+ * @return        X_SUCCESS (0) if successful, or else X_FAILURE (errno will indicate the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenMapFile()
+ */
+int xfrozenUnmapFile(const void *image, size_t size) {
+  static const char *fn = "xfrozenUnmapFile";
+
+  if(!image) return x_error(X_NULL, EINVAL, fn, "input image is NULL");
+  if(munmap((void *) image, size) != 0) return x_error(X_FAILURE, errno, fn, "munmap() failed: %s", strerror(errno));
+  return X_SUCCESS;
+}
+
+/**
+ * Returns the number of fields in a frozen structure.
+ *
+ * @param s   Pointer to a frozen structure
+ * @return    The number of fields in the structure, or 0 if the structure is NULL.
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenGetFieldByIndex()
+ */
+int xfrozenCountFields(const XFrozenStruct *s) {
+  return s ? s->nFields : 0;
+}
+
+/**
+ * Returns the field at the specified index in a frozen structure. The fields are in the same order as they were
+ * in the structure, from which the image was created.
+ *
+ * @param s     Pointer to a frozen structure
+ * @param idx   The (0-based) index of the field
+ * @return      The field at the index, or NULL if there was an error (errno set to EINVAL).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenCountFields()
+ * @sa xfrozenGetField()
+ */
+const XFrozenField *xfrozenGetFieldByIndex(const XFrozenStruct *s, int idx) {
+  static const char *fn = "xfrozenGetFieldByIndex";
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(idx < 0 || idx >= s->nFields) {
+    x_error(0, EINVAL, fn, "index %d is out of bounds for field count %d", idx, s->nFields);
+    return NULL;
+  }
+
+  return (const XFrozenField *) Resolve(&s->fields) + idx;
+}
+
+/**
+ * Returns a field from a frozen structure, by its name or aggregate ID, such as "system:subsystem:field". It is
+ * the frozen equivalent of xGetField(). Fields are looked up by binary search, in O(log n) time.
+ *
+ * @param s     Pointer to a frozen structure
+ * @param id    The field name or aggregate ID, relative to the structure.
+ * @return      The matching field, or NULL if there is no such field (or if there was an error).
+ *
+ * @since 1.1
+ *
+ * @sa xGetField()
+ * @sa xfrozenGetFieldByIndex()
+ */
+const XFrozenField *xfrozenGetField(const XFrozenStruct *s, const char *id) {
+  static const char *fn = "xfrozenGetField";
+
+  const XFrozenField *fields;
+  const int32_t *index;
+  const char *next;
+  size_t L;
+  int lo, hi;
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(!id) {
+    x_error(0, EINVAL, fn, "input id is NULL");
+    return NULL;
+  }
+
+  // Ignore leading separator.
+  if(!strncmp(id, X_SEP, X_SEP_LENGTH)) id += X_SEP_LENGTH;
+
+  next = xNextIDToken(id);
+  L = next ? (size_t) (next - id - X_SEP_LENGTH) : strlen(id);
+
+  fields = (const XFrozenField *) Resolve(&s->fields);
+  index = (const int32_t *) Resolve(&s->index);
+
+  for(lo = 0, hi = s->nFields - 1; lo <= hi; ) {
+    const int mid = (lo + hi) >> 1;
+    const XFrozenField *f = &fields[index[mid]];
+    const char *name = (const char *) Resolve(&f->name);
+    int cmp = strncmp(name, id, L);
+
+    if(cmp == 0 && name[L]) cmp = 1;
+
+    if(cmp < 0) lo = mid + 1;
+    else if(cmp > 0) hi = mid - 1;
+    else if(!next) return f;
+    else if(f->type != X_STRUCT || f->isSerialized || !f->value) return NULL;
+    else return xfrozenGetField((const XFrozenStruct *) Resolve(&f->value), next);
+  }
+
+  return NULL;
+}
+
+/**
+ * Returns the name of a frozen field.
+ *
+ * @param f   Pointer to a frozen field
+ * @return    The name of the field, or NULL if the field is NULL.
+ *
+ * @since 1.1
+ */
+const char *xfrozenGetName(const XFrozenField *f) {
+  return f ? (const char *) Resolve(&f->name) : NULL;
+}
+
+/**
+ * Returns the type of a frozen field.
+ *
+ * @param f   Pointer to a frozen field
+ * @return    The XType of the field, or X_UNKNOWN if the field is NULL.
+ *
+ * @since 1.1
+ */
+XType xfrozenGetType(const XFrozenField *f) {
+  return f ? (XType) f->type : X_UNKNOWN;
+}
+
+/**
+ * Returns the subtype of a frozen field, if any.
+ *
+ * @param f   Pointer to a frozen field
+ * @return    The subtype of the field, or NULL if the field has no subtype (or if the field is NULL).
+ *
+ * @since 1.1
+ */
+const char *xfrozenGetSubtype(const XFrozenField *f) {
+  return f ? (const char *) Resolve(&f->subtype) : NULL;
+}
+
+/**
+ * Checks if a frozen field has a serialized (string) value, which may be obtained via xfrozenGetValue().
+ *
+ * @param f   Pointer to a frozen field
+ * @return    TRUE (1) if the field has a serialized value, or else FALSE (0).
+ *
+ * @since 1.1
+ */
+boolean xfrozenIsSerialized(const XFrozenField *f) {
+  return f ? f->isSerialized : FALSE;
+}
+
+/**
+ * Returns the dimensions of a frozen field.
+ *
+ * @param f           Pointer to a frozen field
+ * @param[out] sizes  (optional) Array of X_MAX_DIMS to which to return the dimensions, or NULL if not requested.
+ * @return            The number of dimensions of the field (0 for scalars), or else X_NULL if the field is NULL.
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenGetFieldCount()
+ */
+int xfrozenGetDims(const XFrozenField *f, int *sizes) {
+  if(!f) return x_error(X_NULL, EINVAL, "xfrozenGetDims", "input field is NULL");
+  if(sizes && f->ndim > 0) memcpy(sizes, Resolve(&f->sizes), f->ndim * sizeof(int32_t));
+  return f->ndim;
+}
+
+/**
+ * Returns the total number of primitive elements in a frozen field.
+ *
+ * @param f     Pointer to a frozen field
+ * @return      The total number of primitive elements contained in the field.
+ *
+ * @since 1.1
+ *
+ * @sa xGetFieldCount()
+ */
+long xfrozenGetFieldCount(const XFrozenField *f) {
+  if(!f) {
+    x_error(0, EINVAL, "xfrozenGetFieldCount", "input field is NULL");
+    return 0;
+  }
+  return f->ndim > 0 ? xGetElementCount(f->ndim, (const int *) Resolve(&f->sizes)) : 1;
+}
+
+/**
+ * Returns the raw value of a frozen field. For fields of fixed-size types (numbers, booleans, and fixed-length
+ * character arrays), it is a pointer to the element data, in native binary format. For serialized fields, it is the
+ * serialized string. For other types, use xfrozenGetStringAtIndex(), xfrozenGetStructAtIndex(), or
+ * xfrozenGetFieldAtIndex() instead.
+ *
+ * @param f   Pointer to a frozen field
+ * @return    Pointer to the value, or NULL if the field has no value (or if the field is NULL).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenGetElementAtIndex()
+ */
+const void *xfrozenGetValue(const XFrozenField *f) {
+  return f ? Resolve(&f->value) : NULL;
+}
+
+/// Returns the address of an element in the value of a frozen field, after checking the type and index.
+static const void *GetElement(const XFrozenField *f, int idx, const char *fn) {
+  long n;
+
+  if(!f) {
+    x_error(0, EINVAL, fn, "input field is NULL");
+    return NULL;
+  }
+
+  if(f->isSerialized) {
+    x_error(0, EINVAL, fn, "field is serialized");
+    return NULL;
+  }
+
+  if(!f->value) {
+    x_error(0, EFAULT, fn, "field has NULL value");
+    return NULL;
+  }
+
+  n = xfrozenGetFieldCount(f);
+
+  if(idx < 0 || idx >= n) {
+    x_error(0, EINVAL, fn, "index %d is out of bounds for element count %ld", idx, n);
+    return NULL;
+  }
+
+  return Resolve(&f->value);
+}
+
+/**
+ * Returns a pointer to the array element at the specified index, for fields of fixed-size types (numbers, booleans,
+ * and fixed-length character arrays). It is the frozen equivalent of xGetElementAtIndex().
+ *
+ * @param f     Pointer to a frozen field
+ * @param idx   the array index of the requested element
+ * @return      A pointer to the element at the given index, or NULL if there was an error.
+ *
+ * @since 1.1
+ *
+ * @sa xGetElementAtIndex()
+ * @sa xfrozenGetStringAtIndex()
+ * @sa xfrozenGetStructAtIndex()
+ * @sa xfrozenGetFieldAtIndex()
+ */
+const void *xfrozenGetElementAtIndex(const XFrozenField *f, int idx) {
+  static const char *fn = "xfrozenGetElementAtIndex";
+
+  const char *data = (const char *) GetElement(f, idx, fn);
+
+  if(!data) return NULL;
+
+  switch(f->type) {
+    case X_STRING:
+    case X_RAW:
+    case X_STRUCT:
+    case X_FIELD:
+      x_error(0, EINVAL, fn, "not a fixed-size type: %d", f->type);
+      return NULL;
+  }
+
+  return data + idx * xElementSizeOf(f->type);
+}
+
+/**
+ * Returns the string element at the specified index, for fields of type X_STRING or X_RAW.
+ *
+ * @param f     Pointer to a frozen field
+ * @param idx   the array index of the requested element
+ * @return      The string at the given index, or NULL if it is NULL or if there was an error (errno set).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenGetElementAtIndex()
+ */
+const char *xfrozenGetStringAtIndex(const XFrozenField *f, int idx) {
+  static const char *fn = "xfrozenGetStringAtIndex";
+
+  const int64_t *links = (const int64_t *) GetElement(f, idx, fn);
+
+  if(!links) return NULL;
+
+  if(f->type != X_STRING && f->type != X_RAW) {
+    x_error(0, EINVAL, fn, "not a string type: %d", f->type);
+    return NULL;
+  }
+
+  return (const char *) Resolve(&links[idx]);
+}
+
+/**
+ * Returns the structure at the specified index, for fields of type X_STRUCT.
+ *
+ * @param f     Pointer to a frozen field
+ * @param idx   the array index of the requested element
+ * @return      The frozen structure at the given index, or NULL if there was an error.
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenGetField()
+ */
+const XFrozenStruct *xfrozenGetStructAtIndex(const XFrozenField *f, int idx) {
+  static const char *fn = "xfrozenGetStructAtIndex";
+
+  const XFrozenStruct *s = (const XFrozenStruct *) GetElement(f, idx, fn);
+
+  if(!s) return NULL;
+
+  if(f->type != X_STRUCT) {
+    x_error(0, EINVAL, fn, "not a structure: %d", f->type);
+    return NULL;
+  }
+
+  return &s[idx];
+}
+
+/**
+ * Returns the field element at the specified index, for heterogeneous arrays (type X_FIELD).
+ *
+ * @param f     Pointer to a frozen field
+ * @param idx   the array index of the requested element
+ * @return      The frozen field at the given index, or NULL if there was an error.
+ *
+ * @since 1.1
+ */
+const XFrozenField *xfrozenGetFieldAtIndex(const XFrozenField *f, int idx) {
+  static const char *fn = "xfrozenGetFieldAtIndex";
+
+  const XFrozenField *e = (const XFrozenField *) GetElement(f, idx, fn);
+
+  if(!e) return NULL;
+
+  if(f->type != X_FIELD) {
+    x_error(0, EINVAL, fn, "not a heterogeneous array: %d", f->type);
+    return NULL;
+  }
+
+  return &e[idx];
+}
+
+static int ThawField(const XFrozenField *src, XField *f) {
+  static const char *fn = "ThawField";
+
+  const void *value = Resolve(&src->value);
+  long i, count;
+
+  f->name = x_copy_name((const char *) Resolve(&src->name));
+  f->subtype = xStringCopyOf((const char *) Resolve(&src->subtype));
+  f->type = src->type;
+  f->isSerialized = src->isSerialized;
+  prop_error(fn, xSetFieldDims(f, src->ndim, (const int *) Resolve(&src->sizes)));
+
+  if(!value) return X_SUCCESS;
+
+  if(f->isSerialized) {
+    f->value = xStringCopyOf((const char *) value);
+    return X_SUCCESS;
+  }
+
+  count = xGetFieldCount(f);
+  f->value = calloc(count ? count : 1, xElementSizeOf(f->type));
+  x_check_alloc(f->value);
+
+  switch(f->type) {
+    case X_STRING:
+    case X_RAW:
+      for(i = 0; i < count; i++) ((char **) f->value)[i] = xStringCopyOf((const char *) Resolve(&((const int64_t *) value)[i]));
+      break;
+
+    case X_STRUCT: {
+      XStructure *s = (XStructure *) f->value;
+      for(i = 0; i < count; i++) prop_error(fn, ThawStruct(&((const XFrozenStruct *) value)[i], &s[i]));
+      break;
+    }
+
+    case X_FIELD:
+      for(i = 0; i < count; i++) prop_error(fn, ThawField(&((const XFrozenField *) value)[i], &((XField *) f->value)[i]));
+      break;
+
+    default:
+      memcpy(f->value, value, count * xElementSizeOf(f->type));
+  }
+
+  return X_SUCCESS;
+}
+
+static int ThawStruct(const XFrozenStruct *src, XStructure *s) {
+  static const char *fn = "ThawStruct";
+
+  const XFrozenField *fields = (const XFrozenField *) Resolve(&src->fields);
+  XField *last = NULL;
+  int i;
+
+  for(i = 0; i < src->nFields; i++) {
+    XField *f = x_append_new_field(s, &last);
+
+    prop_error(fn, ThawField(&fields[i], f));
+
+    if(f->type == X_STRUCT && f->value && !f->isSerialized) {
+      XStructure *sub = (XStructure *) f->value;
+      long k;
+      for(k = xGetFieldCount(f); --k >= 0; ) sub[k].parent = s;
+    }
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Creates a regular (dynamically allocated) copy of a frozen structure, e.g. for modifying it.
+ *
+ * @param s   Pointer to a frozen structure
+ * @return    A newly created structure, with the same content as the frozen structure, or NULL if there was an
+ *            error.
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenCreate()
+ */
+XStructure *xfrozenThaw(const XFrozenStruct *s) {
+  static const char *fn = "xfrozenThaw";
+
+  XStructure *thawed;
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  thawed = xCreateStruct();
+
+  if(ThawStruct(s, thawed) != X_SUCCESS) {
+    xDestroyStruct(thawed);
+    return x_trace_null(fn, NULL);
+  }
+
+  return thawed;
+}
+
+static SegmentHeader *GetSegmentHeader(const XFrozenSegment *seg) {
+  return (SegmentHeader *) seg->base;
+}
+
+static char *GetSlot(const XFrozenSegment *seg, uint64_t generation) {
+  return seg->base + SEGMENT_ALIGN + (generation & 1) * GetSegmentHeader(seg)->slotSize;
+}
+
+/**
+ * Creates a new POSIX shared memory segment, into which frozen images of structures can be published for other
+ * processes on the same host. The segment is accessible to processes of the same user only. It persists until it
+ * is removed by xfrozenRemoveSegment() (or until the host is rebooted), even after all processes have closed it.
+ *
+ * @param name        The name of the shared memory segment, starting with '/', e.g. "/myapp-status".
+ * @param capacity    (bytes) The size of the largest frozen image that may be published to the segment. (The segment
+ *                    will take about twice as much memory, since it holds two images.)
+ * @return            The new shared memory segment, or NULL if there was an error (errno will indicate the type of
+ *                    error, e.g. EEXIST if a segment by the same name already exists).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenPublish()
+ * @sa xfrozenAttachSegment()
+ * @sa xfrozenCloseSegment()
+ * @sa xfrozenRemoveSegment()
+ */
+XFrozenSegment *xfrozenCreateSegment(const char *name, size_t capacity) {
+  static const char *fn = "xfrozenCreateSegment";
+
+  XFrozenSegment *seg;
+  SegmentHeader *h;
+  size_t slotSize, size;
+  void *base;
+  int fd;
+
+  if(!name) {
+    x_error(0, EINVAL, fn, "segment name is NULL");
+    return NULL;
+  }
+
+  if(capacity < sizeof(FrozenHeader)) {
+    x_error(0, EINVAL, fn, "capacity too small: %ld", (long) capacity);
+    return NULL;
+  }
+
+  slotSize = (capacity + SEGMENT_ALIGN - 1) & ~((size_t) SEGMENT_ALIGN - 1);
+  size = SEGMENT_ALIGN + 2 * slotSize;
+
+  fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if(fd < 0) {
+    x_error(0, errno, fn, "could not create %s: %s", name, strerror(errno));
+    return NULL;
+  }
+
+  if(ftruncate(fd, size) != 0) {
+    x_error(0, errno, fn, "could not size %s: %s", name, strerror(errno));
+    close(fd);
+    shm_unlink(name);
+    return NULL;
+  }
+
+  base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if(base == MAP_FAILED) {
+    x_error(0, errno, fn, "could not map %s: %s", name, strerror(errno));
+    shm_unlink(name);
+    return NULL;
+  }
+
+  // The new segment is zeroed, so only the identification and the slot size need to be set.
+  h = (SegmentHeader *) base;
+  memcpy(h->magic, SEGMENT_MAGIC, sizeof(h->magic));
+  h->version = SEGMENT_VERSION;
+  h->slotSize = slotSize;
+
+  seg = (XFrozenSegment *) calloc(1, sizeof(XFrozenSegment));
+  x_check_alloc(seg);
+
+  seg->base = (char *) base;
+  seg->size = size;
+  seg->isWritable = TRUE;
+
+  return seg;
+}
+
+/**
+ * Attaches to an existing shared memory segment, created by another process (or by this one) with
+ * xfrozenCreateSegment(), for reading the structures published to it.
+ *
+ * @param name    The name of the shared memory segment, starting with '/', e.g. "/myapp-status".
+ * @return        The shared memory segment, or NULL if there was an error (errno will indicate the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenBeginRead()
+ * @sa xfrozenSnapshot()
+ * @sa xfrozenCloseSegment()
+ */
+XFrozenSegment *xfrozenAttachSegment(const char *name) {
+  static const char *fn = "xfrozenAttachSegment";
+
+  XFrozenSegment *seg;
+  const SegmentHeader *h;
+  struct stat st;
+  void *base;
+  int fd;
+
+  if(!name) {
+    x_error(0, EINVAL, fn, "segment name is NULL");
+    return NULL;
+  }
+
+  fd = shm_open(name, O_RDONLY, 0);
+  if(fd < 0) {
+    x_error(0, errno, fn, "could not open %s: %s", name, strerror(errno));
+    return NULL;
+  }
+
+  if(fstat(fd, &st) != 0) {
+    x_error(0, errno, fn, "could not stat %s: %s", name, strerror(errno));
+    close(fd);
+    return NULL;
+  }
+
+  if(st.st_size < SEGMENT_ALIGN) {
+    x_error(0, EINVAL, fn, "%s is not a frozen image segment", name);
+    close(fd);
+    return NULL;
+  }
+
+  base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if(base == MAP_FAILED) {
+    x_error(0, errno, fn, "could not map %s: %s", name, strerror(errno));
+    return NULL;
+  }
+
+  h = (const SegmentHeader *) base;
+  if(memcmp(h->magic, SEGMENT_MAGIC, sizeof(h->magic)) != 0 || h->version != SEGMENT_VERSION
+          || SEGMENT_ALIGN + 2 * h->slotSize > (uint64_t) st.st_size) {
+    x_error(0, EINVAL, fn, "%s is not a compatible frozen image segment", name);
+    munmap(base, st.st_size);
+    return NULL;
+  }
+
+  seg = (XFrozenSegment *) calloc(1, sizeof(XFrozenSegment));
+  x_check_alloc(seg);
+
+  seg->base = (char *) base;
+  seg->size = st.st_size;
+
+  return seg;
+}
+
+/**
+ * Closes (unmaps) a shared memory segment, and frees up the local resources associated with it. The segment itself
+ * remains available to other processes (see xfrozenRemoveSegment()).
+ *
+ * @param seg   The shared memory segment, as returned by xfrozenCreateSegment() or xfrozenAttachSegment().
+ * @return      X_SUCCESS (0) if successful, or else X_NULL if the segment is NULL, or X_FAILURE if it could not be
+ *              unmapped (errno set).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenRemoveSegment()
+ */
+int xfrozenCloseSegment(XFrozenSegment *seg) {
+  static const char *fn = "xfrozenCloseSegment";
+
+  int status = X_SUCCESS;
+
+  if(!seg) return x_error(X_NULL, EINVAL, fn, "segment is NULL");
+
+  if(munmap(seg->base, seg->size) != 0) status = x_error(X_FAILURE, errno, fn, "munmap() failed: %s", strerror(errno));
+  free(seg);
+
+  return status;
+}
+
+/**
+ * Removes a shared memory segment from the system. Processes that have it open may continue to use it until they
+ * close it, but no new process may attach to it.
+ *
+ * @param name    The name of the shared memory segment, starting with '/', e.g. "/myapp-status".
+ * @return        X_SUCCESS (0) if successful, or else X_NULL if the name is NULL, or X_FAILURE if it could not be
+ *                removed (errno set, e.g. to ENOENT if no such segment exists).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenCreateSegment()
+ */
+int xfrozenRemoveSegment(const char *name) {
+  static const char *fn = "xfrozenRemoveSegment";
+
+  if(!name) return x_error(X_NULL, EINVAL, fn, "segment name is NULL");
+  if(shm_unlink(name) != 0) return x_error(X_FAILURE, errno, fn, "could not remove %s: %s", name, strerror(errno));
+  return X_SUCCESS;
+}
+
+/**
+ * Publishes a structure into a shared memory segment, as a frozen image. Each publication increments the
+ * generation of the segment, and overwrites the image of the generation before the previous one (the two most
+ * recent images are kept). Only one process (or thread) may publish to a segment at any time.
+ *
+ * @param seg   A shared memory segment, created by xfrozenCreateSegment().
+ * @param s     The structure to publish.
+ * @return      X_SUCCESS (0) if successful, or else X_NULL if an argument is NULL, or X_FAILURE if the segment
+ *              was not created by this process (errno set to EPERM), or if the frozen image does not fit into the
+ *              segment (errno set to ENOSPC).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenCreateSegment()
+ * @sa xfrozenGetGeneration()
+ */
+int xfrozenPublish(XFrozenSegment *seg, const XStructure *s) {
+  static const char *fn = "xfrozenPublish";
+
+  SegmentHeader *h;
+  uint64_t g;
+  size_t size = 0;
+  void *image;
+
+  if(!seg) return x_error(X_NULL, EINVAL, fn, "segment is NULL");
+  if(!s) return x_error(X_NULL, EINVAL, fn, "input structure is NULL");
+  if(!seg->isWritable) return x_error(X_FAILURE, EPERM, fn, "segment is read-only");
+
+  image = xfrozenCreate(s, &size);
+  if(!image) return x_trace(fn, NULL, X_FAILURE);
+
+  h = GetSegmentHeader(seg);
+
+  if(size > h->slotSize) {
+    free(image);
+    return x_error(X_FAILURE, ENOSPC, fn, "frozen image (%ld bytes) exceeds segment capacity (%ld bytes)", (long) size, (long) h->slotSize);
+  }
+
+  g = h->generation + 1;
+
+  // Invalidate the slot before overwriting it, so readers of the old image can tell.
+  __atomic_store_n(&h->slotGeneration[g & 1], 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  memcpy(GetSlot(seg, g), image, size);
+
+  __atomic_store_n(&h->slotGeneration[g & 1], g, __ATOMIC_RELEASE);
+  __atomic_store_n(&h->generation, g, __ATOMIC_RELEASE);
+
+  free(image);
+  return X_SUCCESS;
+}
+
+/**
+ * Returns the latest published generation of a shared memory segment.
+ *
+ * @param seg   A shared memory segment.
+ * @return      The latest published generation, or 0 if nothing has been published yet, or if the segment is NULL.
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenPublish()
+ */
+uint64_t xfrozenGetGeneration(const XFrozenSegment *seg) {
+  if(!seg) return 0;
+  return __atomic_load_n(&GetSegmentHeader(seg)->generation, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Starts reading the latest published structure in a shared memory segment in place, without copying. The
+ * returned structure may be queried with any of the xfrozen...() accessors, after which xfrozenEndRead() tells
+ * whether the data read was a consistent snapshot. The image is verified (as by xfrozenRoot()) before it is
+ * returned, and it is returned only if it was not modified while it was being verified.
+ *
+ * IMPORTANT: The accessors, and the pointers they return, refer to the shared memory itself, which the publisher
+ * overwrites once it has published two more generations. They do not guard against the data changing while it is
+ * being read, so a reader that is overtaken by the publisher may crash before xfrozenEndRead() could report the
+ * inconsistency. Therefore, read in place only if the publisher is certain to publish fewer than two more
+ * generations before the matching xfrozenEndRead() (e.g. if it publishes at a known, much slower rate than it takes
+ * to read). In all other cases, use xfrozenSnapshot() instead, which is always safe.
+ *
+ * @param seg               A shared memory segment.
+ * @param[out] generation   Pointer to which to return the generation of the structure, to pass to xfrozenEndRead().
+ * @return                  The latest published structure, or NULL if there was an error (errno set to EAGAIN if
+ *                          nothing has been published yet).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenEndRead()
+ * @sa xfrozenSnapshot()
+ */
+const XFrozenStruct *xfrozenBeginRead(const XFrozenSegment *seg, uint64_t *generation) {
+  static const char *fn = "xfrozenBeginRead";
+
+  SegmentHeader *h;
+  int k;
+
+  if(!seg) {
+    x_error(0, EINVAL, fn, "segment is NULL");
+    return NULL;
+  }
+
+  if(!generation) {
+    x_error(0, EINVAL, fn, "output generation pointer is NULL");
+    return NULL;
+  }
+
+  h = GetSegmentHeader(seg);
+
+  for(k = 0; k < SEGMENT_RETRIES; k++) {
+    const uint64_t g = __atomic_load_n(&h->generation, __ATOMIC_ACQUIRE);
+
+    if(!g) {
+      x_error(0, EAGAIN, fn, "nothing was published yet");
+      return NULL;
+    }
+
+    if(__atomic_load_n(&h->slotGeneration[g & 1], __ATOMIC_ACQUIRE) == g) {
+      const XFrozenStruct *root = xfrozenRoot(GetSlot(seg, g), h->slotSize);
+
+      // If the image was overwritten during verification, the verdict is meaningless.
+      if(!xfrozenEndRead(seg, g)) continue;
+
+      if(!root) return x_trace_null(fn, NULL);
+      *generation = g;
+      return root;
+    }
+  }
+
+  x_error(0, EAGAIN, fn, "segment is being updated too fast");
+  return NULL;
+}
+
+/**
+ * Completes reading a structure in place from a shared memory segment, and checks that the data read was a
+ * consistent snapshot.
+ *
+ * @param seg           A shared memory segment.
+ * @param generation    The generation that was returned by xfrozenBeginRead().
+ * @return              TRUE (1) if the data read since xfrozenBeginRead() was consistent, or else FALSE (0) if it
+ *                      may have been overwritten by the publisher while it was being read (in which case, the
+ *                      data read should be discarded), or if the segment is NULL.
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenBeginRead()
+ */
+boolean xfrozenEndRead(const XFrozenSegment *seg, uint64_t generation) {
+  if(!seg) return FALSE;
+
+  // Make sure the data was read before checking that it was not invalidated.
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&GetSegmentHeader(seg)->slotGeneration[generation & 1], __ATOMIC_RELAXED) == generation;
+}
+
+/**
+ * Returns a consistent, private copy of the latest published structure in a shared memory segment. It is the
+ * recommended way of reading from shared memory. The image is copied out of the segment first, and verified and
+ * converted only after the copy is confirmed to be consistent. Thus, unlike reading in place, it is safe regardless
+ * of how long reading takes, or how frequently the publisher publishes.
+ *
+ * @param seg               A shared memory segment.
+ * @param[out] generation   (optional) Pointer to which to return the generation of the structure, or NULL if not
+ *                          needed.
+ * @return                  A newly allocated copy of the latest published structure, or NULL if there was an error
+ *                          (errno set to EAGAIN if nothing has been published yet, or if no consistent snapshot
+ *                          could be obtained).
+ *
+ * @since 1.1
+ *
+ * @sa xfrozenBeginRead()
+ */
+XStructure *xfrozenSnapshot(const XFrozenSegment *seg, uint64_t *generation) {
+  static const char *fn = "xfrozenSnapshot";
+
+  const SegmentHeader *h;
+  char *copy;
+  int k;
+
+  if(!seg) {
+    x_error(0, EINVAL, fn, "segment is NULL");
+    return NULL;
+  }
+
+  h = GetSegmentHeader(seg);
+  copy = (char *) malloc(h->slotSize);
+  x_check_alloc(copy);
+
+  for(k = 0; k < SEGMENT_RETRIES; k++) {
+    const uint64_t g = __atomic_load_n(&h->generation, __ATOMIC_ACQUIRE);
+    const XFrozenStruct *root;
+    XStructure *s;
+    uint64_t size;
+
+    if(!g) {
+      free(copy);
+      x_error(0, EAGAIN, fn, "nothing was published yet");
+      return NULL;
+    }
+
+    if(__atomic_load_n(&h->slotGeneration[g & 1], __ATOMIC_ACQUIRE) != g) continue;
+
+    // The image is only accessed once it is copied. The size, as read, may be stale, but the copy is discarded in
+    // that case.
+    size = __atomic_load_n(&((const FrozenHeader *) GetSlot(seg, g))->size, __ATOMIC_RELAXED);
+    if(size > h->slotSize) size = h->slotSize;
+
+    memcpy(copy, GetSlot(seg, g), size);
+    if(!xfrozenEndRead(seg, g)) continue;
+
+    root = xfrozenRoot(copy, size);
+    s = root ? xfrozenThaw(root) : NULL;
+    free(copy);
+
+    if(!s) return x_trace_null(fn, NULL);
+
+    if(generation) *generation = g;
+    return s;
+  }
+
+  free(copy);
+
+  x_error(0, EAGAIN, fn, "segment is being updated too fast");
+  return NULL;
+}
@@ -0,0 +1,300 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * \brief
+ *      A process-wide table of interned field names (atoms). Equal names, such as "value" or ".1", which recur across
+ *      many structures, can share a single immutable copy, instead of each field allocating its own. Lookups in the
+ *      table are lock-free, while new names are added under a mutex. Atoms are never freed.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#define __XCHANGE_INTERNAL_API__      ///< Use internal definitions
+#include "xchange.h"
+
+#ifndef TRUE
+#  define TRUE  1                     ///< Boolean TRUE
+#endif
+
+#ifndef FALSE
+#  define FALSE 0                     ///< Boolean FALSE
+#endif
+
+/// \cond PRIVATE
+#define MIN_TABLE_SIZE      256       ///< Initial number of slots in the table (power of 2)
+#define CHUNK_SIZE          65536     ///< (bytes) Size of the storage chunks for atoms
+#define MAX_AUTO_LENGTH     64        ///< (bytes) Longest name that is interned automatically
+
+/// An open-addressing hash table of atoms.
+typedef struct XAtomTable {
+  const char **slots;                 ///< The atoms, or NULL for empty slots
+  unsigned int mask;                  ///< Table size - 1 (the table size is a power of 2)
+  int n;                              ///< Number of atoms in the table
+  struct XAtomTable *prior;           ///< The table that this one replaced (kept for concurrent readers)
+} XAtomTable;
+
+/// A chunk of storage for atoms, each stored as its hash followed by the NUL-terminated string.
+typedef struct XAtomChunk {
+  struct XAtomChunk *prior;           ///< The previously allocated chunk
+  size_t size;                        ///< (words) Storage available in the chunk
+  size_t used;                        ///< (words) Storage used in the chunk
+  unsigned int data[];                ///< The storage of atoms
+} XAtomChunk;
+/// \endcond
+
+static XAtomTable *table;             ///< The current table (NULL until the first name is interned)
+static XAtomChunk *chunk;             ///< The chunk from which atoms are currently allocated
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static boolean useAtoms = FALSE;
+
+/**
+ * Enables or disables the automatic interning of field names. When enabled, the names of fields created by
+ * xCreateField(), xCopyOfField() and the parsers / decoders of the library (up to 64 bytes long) refer to a single
+ * shared copy of each distinct name, rather than to individually allocated copies. This can save a lot of memory and
+ * allocations, when the same names (such as "value", "unit", or ".1") recur in many structures. Equal interned names
+ * are also matched by their address in xGetField(), xSetField() and the like.
+ *
+ * Interning is disabled by default, since interned names are immutable, and must not be freed. When enabled, the
+ * application must not modify, free, or replace the names of library created fields directly. Interned names persist
+ * until the program exits. Names are released appropriately by xClearField() / xDestroyField(), regardless of
+ * whether interning was enabled when they were assigned, so interning may be enabled or disabled at any time.
+ *
+ * @param value     TRUE (non-zero) to intern field names automatically, or FALSE (0) to disable it.
+ *
+ * @since 1.1
+ *
+ * @sa xIsNameInterning()
+ * @sa xInternName()
+ */
+void xSetNameInterning(boolean value) {
+  __atomic_store_n(&useAtoms, value ? TRUE : FALSE, __ATOMIC_RELAXED);
+}
+
+/**
+ * Checks if the automatic interning of field names is currently enabled.
+ *
+ * @return    TRUE (1) if field names are interned automatically, or else FALSE (0).
+ *
+ * @since 1.1
+ *
+ * @sa xSetNameInterning()
+ */
+boolean xIsNameInterning() {
+  return __atomic_load_n(&useAtoms, __ATOMIC_RELAXED);
+}
+
+static unsigned int HashOf(const char *name) {
+  unsigned int h = 2166136261U;         // FNV-1a
+  for(; *name; name++) h = (h ^ (unsigned char) *name) * 16777619U;
+  return h;
+}
+
+static unsigned int AtomHash(const char *atom) {
+  return ((const unsigned int *) atom)[-1];
+}
+
+static const char *Find(const XAtomTable *t, const char *name, unsigned int hash) {
+  const char *atom;
+  unsigned int i;
+
+  for(i = hash & t->mask; (atom = __atomic_load_n(&t->slots[i], __ATOMIC_ACQUIRE)) != NULL; i = (i + 1) & t->mask)
+    if(atom == name || (AtomHash(atom) == hash && strcmp(atom, name) == 0)) return atom;
+
+  return NULL;
+}
+
+static void Put(XAtomTable *t, const char *atom) {
+  unsigned int i;
+
+  for(i = AtomHash(atom) & t->mask; t->slots[i]; i = (i + 1) & t->mask);
+  __atomic_store_n(&t->slots[i], atom, __ATOMIC_RELEASE);
+  t->n++;
+}
+
+/**
+ * Makes sure the table has room for another atom, replacing it with a larger one as necessary. The caller must hold
+ * the mutex.
+ *
+ * @return    X_SUCCESS (0) if successful, or else X_FAILURE.
+ */
+static int Reserve() {
+  XAtomTable *t;
+  unsigned int size = MIN_TABLE_SIZE, i;
+
+  if(table && 2 * (table->n + 1) <= (int) (table->mask + 1)) return X_SUCCESS;
+  if(table) size = 2 * (table->mask + 1);
+
+  t = (XAtomTable *) calloc(1, sizeof(XAtomTable));
+  if(!t) return X_FAILURE;
+
+  t->slots = (const char **) calloc(size, sizeof(char *));
+  if(!t->slots) {
+    free(t);
+    return X_FAILURE;
+  }
+
+  t->mask = size - 1;
+  t->prior = table;
+
+  if(table) for(i = 0; i <= table->mask; i++) if(table->slots[i]) Put(t, table->slots[i]);
+
+  // Readers may still be using the prior table, so it is retained.
+  __atomic_store_n(&table, t, __ATOMIC_RELEASE);
+  return X_SUCCESS;
+}
+
+/**
+ * Stores a new atom. The caller must hold the mutex.
+ *
+ * @param name    The name to store
+ * @param hash    The hash of the name
+ * @return        The stored atom, or NULL if the storage could not be allocated.
+ */
+static const char *NewAtom(const char *name, unsigned int hash) {
+  size_t len = strlen(name) + 1;
+  size_t words = 1 + (len + sizeof(int) - 1) / sizeof(int);
+  unsigned int *a;
+
+  if(!chunk || chunk->used + words > chunk->size) {
+    size_t size = words > CHUNK_SIZE / sizeof(int) ? words : CHUNK_SIZE / sizeof(int);
+    XAtomChunk *c = (XAtomChunk *) malloc(sizeof(XAtomChunk) + size * sizeof(int));
+    if(!c) return NULL;
+
+    c->prior = chunk;
+    c->size = size;
+    c->used = 0;
+    chunk = c;
+  }
+
+  a = &chunk->data[chunk->used];
+  chunk->used += words;
+
+  a[0] = hash;
+  memcpy(&a[1], name, len);
+
+  return (const char *) &a[1];
+}
+
+/**
+ * Returns the interned (shared) copy of a name, adding it to the process-wide table of interned names as necessary.
+ * Interned names are immutable, and they persist until the program exits. Thus, the returned pointer must never be
+ * modified or freed. Interned names may be used as field names (e.g. for fields that are assembled by the
+ * application), or as arguments to xGetField() and the like, where they match the names of fields interned the same
+ * way by their address.
+ *
+ * @param name    The name to intern
+ * @return        The interned name, or NULL if the name was NULL, or if the name could not be added to the table
+ *                (errno set to ENOMEM).
+ *
+ * @since 1.1
+ *
+ * @sa xIsInternedName()
+ * @sa xSetNameInterning()
+ */
+const char *xInternName(const char *name) {
+  static const char *fn = "xInternName";
+
+  const XAtomTable *t;
+  const char *atom;
+  unsigned int hash;
+
+  if(!name) {
+    x_error(0, EINVAL, fn, "input name is NULL");
+    return NULL;
+  }
+
+  hash = HashOf(name);
+
+  t = __atomic_load_n(&table, __ATOMIC_ACQUIRE);
+  if(t) {
+    atom = Find(t, name, hash);
+    if(atom) return atom;
+  }
+
+  pthread_mutex_lock(&mutex);
+
+  atom = table ? Find(table, name, hash) : NULL;   // It may have been added meanwhile.
+  if(!atom && Reserve() == X_SUCCESS) {
+    atom = NewAtom(name, hash);
+    if(atom) Put(table, atom);
+  }
+
+  pthread_mutex_unlock(&mutex);
+
+  if(!atom) x_error(0, ENOMEM, fn, "alloc error");
+  return atom;
+}
+
+/**
+ * Checks if a string is an interned name, i.e. one that was returned by xInternName(), or assigned to a field while
+ * name interning was enabled.
+ *
+ * @param name    The string to check, or NULL.
+ * @return        TRUE (1) if the string is an interned name, or else FALSE (0).
+ *
+ * @since 1.1
+ *
+ * @sa xInternName()
+ */
+boolean xIsInternedName(const char *name) {
+  const XAtomTable *t = __atomic_load_n(&table, __ATOMIC_ACQUIRE);
+  return name && t && Find(t, name, HashOf(name)) == name;
+}
+
+/**
+ * (<i>for internal use</i>) Returns a new field name, which is an interned name if automatic interning is enabled, or
+ * else an individually allocated copy of the name.
+ *
+ * @param name    The name to copy
+ * @return        The new field name, which must be released with x_free_name(), or NULL if the name was NULL or
+ *                could not be allocated.
+ *
+ * @sa x_adopt_name()
+ * @sa x_free_name()
+ */
+char *x_copy_name(const char *name) {
+  if(name && xIsNameInterning() && strlen(name) <= MAX_AUTO_LENGTH) {
+    const char *atom = xInternName(name);
+    if(atom) return (char *) atom;
+  }
+  return xStringCopyOf(name);
+}
+
+/**
+ * (<i>for internal use</i>) Takes ownership of a dynamically allocated name, returning the interned equivalent (and
+ * freeing the original) if automatic interning is enabled, or else returning the name as is.
+ *
+ * @param name    The dynamically allocated name, or NULL.
+ * @return        The name to assign to a field, which must be released with x_free_name().
+ *
+ * @sa x_copy_name()
+ */
+char *x_adopt_name(char *name) {
+  if(name && xIsNameInterning() && strlen(name) <= MAX_AUTO_LENGTH) {
+    const char *atom = xInternName(name);
+    if(atom) {
+      free(name);
+      return (char *) atom;
+    }
+  }
+  return name;
+}
+
+/**
+ * (<i>for internal use</i>) Releases a field name, unless it is an interned name.
+ *
+ * @param name    The name to release, or NULL.
+ *
+ * @sa x_copy_name()
+ * @sa x_adopt_name()
+ */
+void x_free_name(char *name) {
+  if(name && !xIsInternedName(name)) free(name);
+}
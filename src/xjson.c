@@ -13,9 +13,13 @@
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
-#include <limits.h>
+#include <pthread.h>
 #include <sys/stat.h>
 
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
 #define __XCHANGE_INTERNAL_API__        ///< Use internal definitions
 #include "xjson.h"
 
@@ -45,33 +49,106 @@
 
 #define UNICODE_BYTES   6         ///< '\u####'
 
+#define PARALLEL_MIN_CHUNK  (1 << 18)   ///< (bytes) Minimum estimated output size per thread for parallel emitting
+
+#define IOV_MIN_REF_LENGTH  256         ///< (bytes) Minimum string length to reference in place in I/O vectors
+
+#define PATCH_LOOKUP_MIN_FIELDS   16    ///< Minimum number of fields for using a lookup when matching names for patches
+
+#define BASE64_TYPE_KEY     "$type"     ///< Key for the element type in base64-encoded array objects
+#define BASE64_DIMS_KEY     "$dims"     ///< Key for the dimensions in base64-encoded array objects
+#define BASE64_DATA_KEY     "$base64"   ///< Key for the base64-encoded little-endian data in array objects
+
+/// Static content of base64-encoded array objects
+#define BASE64_WRAPPER_TEMPLATE  "{ \"" BASE64_TYPE_KEY "\": \"T\", \"" BASE64_DIMS_KEY "\": [ ], \"" BASE64_DATA_KEY "\": \"\" }"
+
 
 #define Error(format, ARGS...)      fprintf(xerr ? xerr : stderr, ERROR_PREFIX format, ##ARGS)
 #define Warning(format, ARGS...)    fprintf(xerr ? xerr : stderr, WARNING_PREFIX format, ##ARGS)
+
+#define PLAN_VALUE      0       ///< Plan operation for printing a field value
+#define PLAN_BEGIN      1       ///< Plan operation for descending into an embedded structure
+#define PLAN_END        2       ///< Plan operation for closing a structure
+
+typedef struct {
+  int op;                   ///< PLAN_VALUE, PLAN_BEGIN, or PLAN_END
+  int text;                 ///< Offset of the static text preceding the operation
+  int textLength;           ///< (bytes) Length of the static text preceding the operation
+  char *name;               ///< Expected field name (not for PLAN_END)
+  XType type;               ///< Expected field type
+  int ndim;                 ///< Expected field dimensions
+  int sizes[X_MAX_DIMS];    ///< Expected field shape
+  int prefixSize;           ///< (bytes) Indentation of the field value
+  int size;                 ///< (bytes) Fixed size estimate for the value, or -1 if it depends on the data
+} JsonPlanOp;
+
+typedef struct {
+  int offset;               ///< Offset in the scratch buffer, where the referenced string is to be inserted
+  const char *data;         ///< The referenced string, which needs no escaping
+  int length;               ///< (bytes) The length of the referenced string
+} JsonRef;
+
+typedef struct {
+  const char *base;         ///< The start of the scratch buffer
+  JsonRef *refs;            ///< The strings that are referenced in place, in order of appearance
+  int nRefs;                ///< The number of referenced strings
+  int capacity;             ///< The number of references for which space has been allocated
+} JsonIO;
+
+typedef struct {
+  char *str;                ///< The buffer
+  int n;                    ///< (bytes) The number of characters printed into the buffer
+  int size;                 ///< (bytes) The allocated size of the buffer
+  int count;                ///< The number of patch operations in the buffer
+} JsonPatch;
+
+typedef struct {
+  char *text;               ///< All static text, concatenated
+  int textLength;           ///< (bytes) Total length of the static text
+  JsonPlanOp *ops;          ///< The sequence of plan operations
+  int nOps;                 ///< The number of plan operations
+  int indent;               ///< The indentation used when the plan was compiled
+  int base64Threshold;      ///< The base64 encoding threshold used when the plan was compiled
+} JsonPlan;
 /// \endcond
 
 static XStructure *ParseObject(char **pos, int *lineNumber);
 static XField *ParseField(char **pos, int *lineNumber);
-static void *ParseValue(char **pos, XType *type, int *ndim, int sizes[X_MAX_DIMS], int *lineNumber);
+static void *ParseValue(char **pos, XField *f, int *lineNumber);
 static void *ParseArray(char **pos, XType *type, int *ndim, int sizes[X_MAX_DIMS], int *lineNumber);
 static char *ParseString(char **pos, int *lineNumber);
-static void *ParsePrimitive(char **pos, XType *type, int *lineNumber);
+static void *ParsePrimitive(char **pos, XField *f, int *lineNumber);
+static boolean IsBase64Object(const XStructure *s);
+static int DecodeBase64Field(XField *f);
 
 static int GetObjectStringSize(int prefixSize, const XStructure *s);
 static int GetFieldStringSize(int prefixSize, const XField *f, boolean ignoreName);
 static int GetArrayStringSize(int prefixSize,char *ptr, XType type, int ndim, const int *sizes);
 static int GetJsonStringSize(const char *src, int maxLength);
 
-static int PrintObject(const char *prefix, const XStructure *s, char *str);
-static int PrintField(const char *prefix, const XField *f, char *str);
-static int PrintArray(const char *prefix, char *ptr, XType type, int ndim, const int *sizes, char *str);
-static int PrintPrimitive(const void *ptr, XType type, char *str);
+static int PrintObject(int prefixSize, const XStructure *s, char *str, JsonIO *io);
+static int PrintObjectParallel(const XStructure *s, int size, char *str);
+static int PrintField(int prefixSize, const XField *f, char *str, JsonIO *io);
+static int PrintArray(int prefixSize, char *ptr, XType type, int ndim, const int *sizes, char *str, JsonIO *io);
+static int PrintPrimitive(const void *ptr, XType type, char *str, JsonIO *io);
 static int PrintString(const char *src, int maxLength, char *json);
+static int GetFieldValueStringSize(int prefixSize, const XField *f);
+static boolean AddStringRef(const char *src, const char *str, JsonIO *io);
+static char *ReservePatch(JsonPatch *p, int m);
+static boolean IsEqualStruct(const XStructure *a, const XStructure *b);
+static int DiffObject(const char *path, const XStructure *old, const XStructure *updated, JsonPatch *p);
+static int PrintFieldValue(int prefixSize, const XField *f, char *str, JsonIO *io);
+
+static int CompileObject(int prefixSize, const XStructure *s, JsonPlan *p, int *mark);
+static int AddPlanOp(int op, const XField *f, int prefixSize, JsonPlan *p, int *mark);
+static int RenderObject(const JsonPlan *p, int *k, const XStructure *s, char *str);
+static void DestroyPlanPrivate(JsonPlan *p);
 
 static FILE *xerr;     ///< File / stream, which errors are printed to. A NULL will print to stderr
 
-static char *indent;   ///< use xjsonGetIndent() for non-null access.
-static int ilen = XJSON_DEFAULT_INDENT;
+static int ilen = XJSON_DEFAULT_INDENT;   ///< Number of spaces per level of indentation.
+static int nThreads = 1;                  ///< Maximum number of threads to use for emitting JSON.
+static int base64Threshold = 0;           ///< Minimum number of elements for emitting numerical arrays in base64.
 
 /**
  * Sets the number of spaces per indentation when emitting JSON formatted output.
@@ -83,22 +160,7 @@ static int ilen = XJSON_DEFAULT_INDENT;
  * @sa xjsonToString()
  */
 void xjsonSetIndent(int nchars) {
-  char *old = indent;
-
-  if(nchars < 0) nchars = 0;
-
-  indent = (char *) realloc(indent, nchars + 1);
-
-  if(indent) {
-    if(nchars > 0) memset(indent, ' ', nchars);
-    indent[nchars] = '\0';
-    ilen = nchars;
-  }
-  else {
-    x_error(0, errno, "xjsonSetIndent", "alloc error (%d bytes)", (nchars + 1));
-    indent = old;
-    ilen = old ? strlen(old) : 0;
-  }
+  ilen = nchars < 0 ? 0 : nchars;
 }
 
 /**
@@ -113,9 +175,78 @@ int xjsonGetIndent() {
   return ilen;
 }
 
-static char *GetIndent() {
-  if(!indent) xjsonSetIndent(XJSON_DEFAULT_INDENT);
-  return indent;
+/**
+ * Sets the maximum number of threads that may be used for converting large structures to JSON. When more than
+ * one thread is allowed, xjsonToString() will split the top-level fields of large structures into contiguous
+ * chunks of roughly equal (estimated) size, and render these concurrently, directly into the output buffer.
+ * The result is identical to that of the single-threaded conversion. Structures, whose JSON representation is
+ * expected to be small, are always converted in the calling thread.
+ *
+ * @param n     The maximum number of threads to use for emitting JSON. Values &lt;1 map to 1, i.e. emitting
+ *              everything in the calling thread (default).
+ *
+ * @since 1.1
+ *
+ * @sa xjsonGetThreads()
+ * @sa xjsonToString()
+ */
+void xjsonSetThreads(int n) {
+  nThreads = n < 1 ? 1 : n;
+}
+
+/**
+ * Returns the maximum number of threads that may be used for converting large structures to JSON.
+ *
+ * @return    The maximum number of threads used for emitting JSON (1 if emitting single-threaded).
+ *
+ * @since 1.1
+ *
+ * @sa xjsonSetThreads()
+ */
+int xjsonGetThreads() {
+  return nThreads;
+}
+
+/**
+ * Sets the minimum number of elements, for which numerical array fields are emitted in a compact base64
+ * encoded binary form, rather than as a JSON array of decimal numbers. Such fields are written as a JSON
+ * object with the element type, the dimensions, and the little-endian binary data encoded as base64, e.g.:
+ *
+ * ```json
+ *   "my-array": { "$type": "D", "$dims": [ 3, 1000 ], "$base64": "AAAAAAAA8D8AAAAAAAAAQA..." }
+ * ```
+ *
+ * where the type is the `XType` character of the element type. The encoded form is both smaller and much
+ * faster to emit and parse than the decimal representation, and it also preserves the exact binary values
+ * of floating-point data. xjsonParseString() and the other parse functions decode such objects into the
+ * original array fields. Objects with the same keys that do not name a numerical type, or whose data cannot be
+ * decoded, are parsed as ordinary structures instead. The encoding applies only to the values of structure fields (not to elements of
+ * heterogeneous `X_FIELD` arrays), and only to integer (excluding `boolean`) and floating-point types.
+ *
+ * @param nElements   The minimum number of array elements for base64 encoding, or &lt;=0 to never use the
+ *                    base64 encoding (default).
+ *
+ * @since 1.1
+ *
+ * @sa xjsonGetBase64Threshold()
+ * @sa xjsonToString()
+ */
+void xjsonSetBase64Threshold(int nElements) {
+  base64Threshold = nElements < 0 ? 0 : nElements;
+}
+
+/**
+ * Returns the minimum number of elements, for which numerical array fields are emitted in base64 encoded
+ * binary form.
+ *
+ * @return    The minimum number of elements for base64 encoding, or 0 if base64 encoding is disabled.
+ *
+ * @since 1.1
+ *
+ * @sa xjsonSetBase64Threshold()
+ */
+int xjsonGetBase64Threshold() {
+  return base64Threshold;
 }
 
 /**
@@ -134,6 +265,7 @@ static char *GetIndent() {
 char *xjsonToString(const XStructure *s) {
   char *str;
   int n;
+  boolean parallel;
 
   if(!s) return xStringCopyOf(JSON_NULL);
   if(!xerr) xerr = stderr;
@@ -145,13 +277,17 @@ char *xjsonToString(const XStructure *s) {
     return NULL;
   }
 
-  str = (char *) malloc(n + 2);     // + '\n' + '\0'
+  parallel = (nThreads > 1 && n >= 2 * PARALLEL_MIN_CHUNK);
+
+  str = (char *) malloc(n + 2 + (parallel ? nThreads : 0));     // + '\n' + '\0' (+ gaps between parallel chunks)
   if(!str) {
     Error("Out of memory (need %ld bytes).\n", (long) (n+1));
     return NULL;
   }
 
-  n = PrintObject("", s, str);
+  if(parallel) n = PrintObjectParallel(s, n, str);
+  else n = PrintObject(0, s, str, NULL);
+
   if (n < 0) {
     free(str);
     return NULL;
@@ -176,7 +312,7 @@ char *xjsonToString(const XStructure *s) {
 char *xjsonFieldToIndentedString(int indent, const XField *f) {
   static const char *fn = "xjsonFieldToIndentedString";
 
-  char *prefix, *str;
+  char *str;
   int n;
 
   if(!f) return xStringCopyOf(JSON_NULL);
@@ -190,23 +326,13 @@ char *xjsonFieldToIndentedString(int indent, const XField *f) {
     return NULL;
   }
 
-  prefix = malloc(indent + 1);
-  if(!prefix) {
-    x_error(0, errno, fn, "alloc error (%d) bytes", (n + 1));
-    return NULL;
-  }
-  if(indent > 0) memset(prefix, ' ', indent);
-  prefix[indent] = '\0';
-
   str = (char *) malloc(n + 1);  // + '\0'
   if(!str) {
     x_error(0, errno, fn, "alloc error (%d) bytes", (n + 1));
-    free(prefix);
     return NULL;
   }
 
-  n = PrintField(prefix, f, str);
-  free(prefix);
+  n = PrintField(indent, f, str, NULL);
 
   if (n < 0) {
     free(str);
@@ -233,6 +359,330 @@ char *xjsonFieldToString(const XField *f) {
   return xjsonFieldToIndentedString(0, f);
 }
 
+/**
+ * Converts structured data into its JSON representation, as a list of I/O vectors, which may be written to a
+ * file descriptor or a socket directly, e.g. via `writev()` or `sendmsg()`. Long string values (of `X_STRING`
+ * or `X_RAW` type), which need no escaping, are referenced in place, without copying, while everything else is
+ * generated into a private scratch buffer. The concatenation of the I/O vectors is the same as the string
+ * returned by xjsonToString().
+ *
+ * Since the I/O vectors may reference the string values in the structure itself, the structure should not be
+ * modified or destroyed until the I/O vectors are no longer used. Note also, that the number of I/O vectors
+ * may exceed `IOV_MAX`, in which case they should be written in multiple `writev()` calls.
+ *
+ * Once the I/O vectors are no longer used, the caller should destroy them with xjsonDestroyIOVector().
+ *
+ * @param s     Pointer to structured data
+ * @return      The JSON representation as a list of I/O vectors, or NULL if there was an error (errno set to
+ *              EINVAL).
+ *
+ * @since 1.1
+ *
+ * @sa xjsonToString()
+ * @sa xjsonDestroyIOVector()
+ */
+XJsonIOVector *xjsonToIOVector(const XStructure *s) {
+  static const char *fn = "xjsonToIOVector";
+
+  XJsonIOVector *v;
+  JsonIO io = {NULL};
+  char *str;
+  int i, n, pos = 0;
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(!xerr) xerr = stderr;
+
+  n = GetObjectStringSize(0, s);
+  if(n < 0) {
+    Error("%s\n", xErrorDescription(n));
+    errno = EINVAL;
+    return NULL;
+  }
+
+  str = (char *) malloc(n + 2);     // + '\n' + '\0'
+  if(!str) {
+    x_error(0, errno, fn, "alloc error (%d) bytes", (n + 2));
+    return NULL;
+  }
+
+  io.base = str;
+
+  n = PrintObject(0, s, str, &io);
+  if(n < 0) {
+    free(str);
+    if(io.refs) free(io.refs);
+    return x_trace_null(fn, NULL);
+  }
+
+  n += sprintf(&str[n], "\n");
+
+  v = (XJsonIOVector *) calloc(1, sizeof(XJsonIOVector));
+  x_check_alloc(v);
+
+  v->iov = (struct iovec *) calloc(2 * io.nRefs + 1, sizeof(struct iovec));
+  x_check_alloc(v->iov);
+
+  for(i = 0; i < io.nRefs; i++) {
+    const JsonRef *ref = &io.refs[i];
+
+    if(ref->offset > pos) {
+      v->iov[v->n].iov_base = &str[pos];
+      v->iov[v->n++].iov_len = ref->offset - pos;
+      pos = ref->offset;
+    }
+
+    v->iov[v->n].iov_base = (void *) ref->data;
+    v->iov[v->n++].iov_len = ref->length;
+  }
+
+  if(n > pos) {
+    v->iov[v->n].iov_base = &str[pos];
+    v->iov[v->n++].iov_len = n - pos;
+  }
+
+  if(io.refs) free(io.refs);
+
+  v->priv = str;
+
+  return v;
+}
+
+/**
+ * Destroys I/O vectors created by xjsonToIOVector(), freeing up all associated resources (but not the
+ * structure data they may reference).
+ *
+ * @param v     The I/O vectors to destroy.
+ *
+ * @since 1.1
+ *
+ * @sa xjsonToIOVector()
+ */
+void xjsonDestroyIOVector(XJsonIOVector *v) {
+  if(!v) return;
+
+  if(v->priv) free(v->priv);
+  if(v->iov) free(v->iov);
+  free(v);
+}
+
+/**
+ * Returns a JSON Patch (RFC 6902), which describes the changes from one structure to another, as a sequence of
+ * "add", "remove", and "replace" operations. Each operation refers to a field via a JSON Pointer (RFC 6901), with
+ * one path component for each level of embedding, i.e. in place of the `X_SEP` separators of the aggregate field
+ * IDs. Embedded substructures are compared recursively, so that only the fields that actually changed are
+ * included in the patch. All other changed values (including arrays) are replaced in full. For example:
+ *
+ * ```json
+ * [
+ *   { "op": "replace", "path": "/system/temperature", "value": 21.5 },
+ *   { "op": "add", "path": "/system/status", "value": "OK" }
+ * ]
+ * ```
+ *
+ * Field names are matched via hash lookups for larger structures, and numerical arrays are compared in their
+ * binary form, so generating patches is efficient also for large structures. For structures that change only
+ * a little at a time, sending patches rather than full snapshots can reduce the amount of data substantially.
+ *
+ * @param old       The original structure
+ * @param updated   The changed structure
+ * @return          The JSON patch that transforms `old` into `updated` (or "[ ]" if the two are equivalent),
+ *                  or NULL if there was an error (errno will inform about the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xjsonToString()
+ */
+char *xjsonDiff(const XStructure *old, const XStructure *updated) {
+  static const char *fn = "xjsonDiff";
+
+  JsonPatch p = {NULL};
+  char *str;
+
+  if(!old || !updated) {
+    x_error(0, EINVAL, fn, "input structure is NULL: old=%p, updated=%p", old, updated);
+    return NULL;
+  }
+
+  if(!xerr) xerr = stderr;
+
+  str = ReservePatch(&p, 1);
+  p.n += sprintf(str, "[");
+
+  if(DiffObject("", old, updated, &p) < 0) {
+    if(p.str) free(p.str);
+    return x_trace_null(fn, NULL);
+  }
+
+  str = ReservePatch(&p, 4);
+  p.n += sprintf(str, p.count ? "\n]\n" : " ]\n");
+
+  return p.str;
+}
+
+/**
+ * Compiles an emission plan for the JSON representation of structures with the same layout as the argument.
+ * The plan contains all the static text (field names, punctuation, and indentation) of the JSON representation
+ * pre-rendered, together with typed slots for the field values, such that xjsonRender() can generate the JSON
+ * for structures of the same layout with only the values formatted at runtime. This can substantially speed up
+ * the repeated emission of structures, which have a fixed layout but changing values.
+ *
+ * The plan uses the indentation that was set at the time of compilation. Plans cannot be used after the
+ * indentation is changed via xjsonSetIndent(), and should be recompiled instead.
+ *
+ * Once the plan is no longer used, the caller should destroy it with xjsonDestroyPlan().
+ *
+ * @param s     Pointer to a structure, whose layout is to be used for the plan.
+ * @return      The emission plan, or NULL if there was an error (errno will inform about the type of
+ *              error).
+ *
+ * @since 1.1
+ *
+ * @sa xjsonRender()
+ * @sa xjsonDestroyPlan()
+ */
+XJsonPlan *xjsonCompile(const XStructure *s) {
+  static const char *fn = "xjsonCompile";
+
+  XJsonPlan *plan;
+  JsonPlan *p;
+  long nFields;
+  int n, mark = 0;
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(!xerr) xerr = stderr;
+
+  nFields = xDeepCountFields(s);
+  if(nFields < 0) return x_trace_null(fn, NULL);
+
+  n = GetObjectStringSize(0, s);     // The static text is always shorter than the full JSON.
+  if(n < 0) return x_trace_null(fn, NULL);
+
+  p = (JsonPlan *) calloc(1, sizeof(JsonPlan));
+  x_check_alloc(p);
+
+  p->indent = ilen;
+  p->base64Threshold = base64Threshold;
+
+  p->text = (char *) malloc(n + 1);
+  x_check_alloc(p->text);
+
+  p->ops = (JsonPlanOp *) calloc(2 * nFields + 1, sizeof(JsonPlanOp));
+  x_check_alloc(p->ops);
+
+  if(CompileObject(0, s, p, &mark) < 0 || AddPlanOp(PLAN_END, NULL, 0, p, &mark) < 0) {
+    DestroyPlanPrivate(p);
+    return x_trace_null(fn, NULL);
+  }
+
+  plan = (XJsonPlan *) calloc(1, sizeof(XJsonPlan));
+  x_check_alloc(plan);
+
+  plan->priv = p;
+
+  return plan;
+}
+
+/**
+ * Returns the JSON representation of a structure using a precompiled emission plan. The structure must have
+ * the same layout (i.e. the same fields, in the same order, with the same names, types and dimensions,
+ * recursively) as the one used for compiling the plan. Only the field values may differ. The result is the
+ * same as what xjsonToString() would return for the structure, but faster, since the names, punctuation, and
+ * indentation need not be generated anew.
+ *
+ * The plan is not modified, so the same plan may be used by concurrent threads.
+ *
+ * @param plan    An emission plan, which was created by xjsonCompile().
+ * @param s       Pointer to structured data with the same layout as the one used to compile the plan.
+ * @return        String JSON representation, or NULL if there was an error (errno set to EINVAL). It is an
+ *                error if the structure does not match the layout for which the plan was compiled, or if the
+ *                indentation was changed since the plan was created.
+ *
+ * @since 1.1
+ *
+ * @sa xjsonCompile()
+ * @sa xjsonToString()
+ */
+char *xjsonRender(const XJsonPlan *plan, const XStructure *s) {
+  static const char *fn = "xjsonRender";
+
+  const JsonPlan *p;
+  char *str;
+  int n, k = 0;
+
+  if(!plan) {
+    x_error(0, EINVAL, fn, "plan is NULL");
+    return NULL;
+  }
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(!xerr) xerr = stderr;
+
+  p = (const JsonPlan *) plan->priv;
+  if(!p) {
+    x_error(0, EINVAL, fn, "plan was destroyed");
+    return NULL;
+  }
+
+  if(p->indent != ilen) {
+    x_error(0, EINVAL, fn, "indentation changed since plan was compiled");
+    return NULL;
+  }
+
+  if(p->base64Threshold != base64Threshold) {
+    x_error(0, EINVAL, fn, "base64 threshold changed since plan was compiled");
+    return NULL;
+  }
+
+  n = RenderObject(p, &k, s, NULL);
+  if(n < 0) return x_trace_null(fn, NULL);
+
+  str = (char *) malloc(n + 2);     // + '\n' + '\0'
+  if(!str) {
+    x_error(0, errno, fn, "alloc error (%d) bytes", (n + 2));
+    return NULL;
+  }
+
+  k = 0;
+  n = RenderObject(p, &k, s, str);
+  if(n < 0) {
+    free(str);
+    return x_trace_null(fn, NULL);
+  }
+
+  sprintf(&str[n], "\n");
+
+  return str;
+}
+
+/**
+ * Destroys an emission plan, freeing up all associated resources.
+ *
+ * @param plan    An emission plan, which was created by xjsonCompile().
+ *
+ * @since 1.1
+ *
+ * @sa xjsonCompile()
+ */
+void xjsonDestroyPlan(XJsonPlan *plan) {
+  if(!plan) return;
+
+  DestroyPlanPrivate((JsonPlan *) plan->priv);
+  plan->priv = NULL;
+  free(plan);
+}
+
 /**
  * Parses a JSON object from the given parse position, returning the structured data
  * and updating the parse position. Parse errors are reported to stderr or the alternate
@@ -351,8 +801,8 @@ XStructure *xjsonParsePath(const char *path) {
  *
  * @param[in]  fp           File pointer, opened with read permission ("r").
  * @param[in]  length       [bytes] The number of bytes to parse / available, or 0 to read to the end
- *                          of the file. (In the latter case the file must support `fseek()` with `SEEK_END` to automatically
- *                          determine the length, or else this function will return NULL).
+ *                          of the file. (In the latter case, if the file does not support `fseek()`, such as a pipe or
+ *                          a decompressing stream from xlz4Open(), the input is read until the end of file.)
  *
  * @return     Structured data created from the JSON description, or NULL if there was an error parsing the data
  *             (errno is set to EINVAL). The lineNumber argument can be used to determine where the error occurred).
@@ -366,8 +816,8 @@ XStructure *xjsonParseFile(FILE *fp, size_t length) {
 
   XStructure *s;
   int lineNumber = 0;
-  long L;
-  char *str;
+  long L = 0;
+  char *str = NULL;
   volatile char *pos;
 
   if(fp == NULL) {
@@ -379,47 +829,78 @@ XStructure *xjsonParseFile(FILE *fp, size_t length) {
 
   if(length == 0) {
     long p = ftell(fp);
-    if(fseek(fp, 0, SEEK_END) != 0) {
-      x_error(0, errno, fn, "fseek() error");
-      return NULL;
-    }
-    length = ftell(fp) - p;
-    if(fseek(fp, p, SEEK_SET) != 0) {
-      x_error(0, errno, fn, "ftell() error");
-      return NULL;
+    if(p >= 0 && fseek(fp, 0, SEEK_END) == 0) {
+      length = ftell(fp) - p;
+      if(fseek(fp, p, SEEK_SET) != 0) {
+        x_error(0, errno, fn, "fseek() error");
+        return NULL;
+      }
     }
-  }
+    else {
+      // Not seekable (e.g. a pipe or a decompressing stream): read to the end in chunks.
+      size_t capacity = 4096;
 
-  pos = str = malloc(length + 1);
-  if(!str){
-    Error("Out of memory (read %ld bytes).\n", (long) (length + 1));
-    fclose(fp);
-    return NULL;
-  }
+      clearerr(fp);
 
-  for(L=0; L < (long) length; L++) {
-    int m = fread(str, L, 1, fp);
+      str = malloc(capacity);
+      if(!str) {
+        Error("Out of memory (read %ld bytes).\n", (long) capacity);
+        return NULL;
+      }
 
-    if(m < 0) {
-      Error("Read error: %s (pos = %ld).\n", strerror(errno), L);
-      L = -1;
-      break;
+      for(L = 0; ; ) {
+        L += fread(str + L, 1, capacity - L - 1, fp);
+        if((size_t) L < capacity - 1) break;
+
+        char *more;
+
+        capacity <<= 1;
+        more = realloc(str, capacity);
+        if(!more) {
+          Error("Out of memory (read %ld bytes).\n", (long) capacity);
+          free(str);
+          return NULL;
+        }
+        str = more;
+      }
+
+      if(ferror(fp)) {
+        Error("Read error: %s (pos = %ld).\n", strerror(errno), L);
+        free(str);
+        return NULL;
+      }
+
+      length = L;
     }
+  }
 
-    if(!m) {
-      Error("Incomplete read (%ld of %ld bytes).\n", L, (long) length);
-      L = -1;
-      break;
+  if(!str) {
+    str = malloc(length + 1);
+    if(!str){
+      Error("Out of memory (read %ld bytes).\n", (long) (length + 1));
+      return NULL;
     }
 
-    L += m;
-  }
+    for(L=0; L < (long) length; ) {
+      size_t m = fread(str + L, 1, length - L, fp);
 
-  if(L < 0) {
-    free(str);
-    return NULL;
+      if(!m) {
+        if(ferror(fp)) Error("Read error: %s (pos = %ld).\n", strerror(errno), L);
+        else Error("Incomplete read (%ld of %ld bytes).\n", L, (long) length);
+        L = -1;
+        break;
+      }
+
+      L += m;
+    }
+
+    if(L < 0) {
+      free(str);
+      return NULL;
+    }
   }
 
+  pos = str;
   str[L] = '\0';
 
   s = ParseObject((char **) &pos, &lineNumber);
@@ -500,10 +981,10 @@ static XField *ParseField(char **pos, int *lineNumber) {
 
   *pos = SkipSpaces(*pos, lineNumber);
 
-  f = calloc(1, sizeof(XField));
+  f = x_alloc_field();
   x_check_alloc(f);
 
-  f->name = ParseString(pos, lineNumber);
+  f->name = x_adopt_name(ParseString(pos, lineNumber));
   *pos = SkipSpaces(*pos, lineNumber);
 
   if(**pos != ':') {
@@ -521,12 +1002,21 @@ static XField *ParseField(char **pos, int *lineNumber) {
     case '{':
       f->type = X_STRUCT;
       f->value = (void *) ParseObject(pos, lineNumber);
+      // Objects that cannot be decoded as base64 arrays are kept as they are.
+      if(IsBase64Object((XStructure *) f->value)) DecodeBase64Field(f);
       break;
-    case '[':
-      f->value = ParseArray(pos, &f->type, &f->ndim, f->sizes, lineNumber);
+    case '[': {
+      int ndim, sizes[X_MAX_DIMS];
+
+      f->value = ParseArray(pos, &f->type, &ndim, sizes, lineNumber);
+      if(xSetFieldDims(f, ndim, sizes) != X_SUCCESS) {
+        xDestroyField(f);
+        return NULL;
+      }
       break;
+    }
     case '"': {
-      char **str = malloc(sizeof(char *));
+      char **str = (char **) x_alloc_value(f, sizeof(char *));
       x_check_alloc(str);
 
       *str = ParseString(pos, lineNumber);
@@ -535,30 +1025,154 @@ static XField *ParseField(char **pos, int *lineNumber) {
       break;
     }
     default:
-      f->value = ParsePrimitive(pos, &f->type, lineNumber);
+      f->value = ParsePrimitive(pos, f, lineNumber);
   }
 
   return f;
 }
 
-static XStructure *ParseObject(char **pos, int *lineNumber) {
-  XStructure *s;
+/// Returns the numerical element type named by a base64 array type specification, or X_UNKNOWN if not numerical.
+static XType GetBase64Type(const XField *t) {
+  const char *name;
 
-  *pos = SkipSpaces(*pos, lineNumber);
+  if(!t || t->type != X_STRING || t->ndim != 0 || !t->value) return X_UNKNOWN;
 
-  if(**pos != '{') {
-    char *bad = GetToken(*pos);
-    Error("[L.%d] Expected '{', got \"%s\"\n", *lineNumber, bad);
-    free(bad);
-    return NULL;
+  name = *(char **) t->value;
+  if(!name || !name[0] || name[1]) return X_UNKNOWN;
+
+  switch(name[0]) {
+    case X_BYTE:
+    case X_INT16:
+    case X_INT32:
+    case X_INT64:
+    case X_FLOAT:
+    case X_DOUBLE:
+      return name[0];
   }
 
-  (*pos)++; // Opening {
+  return X_UNKNOWN;
+}
 
-  s = (XStructure *) calloc(1, sizeof(XStructure));
-  x_check_alloc(s);
+static boolean IsBase64Object(const XStructure *s) {
+  const XField *f;
 
-  while(**pos) {
+  if(!s) return FALSE;
+
+  f = xGetField(s, BASE64_DATA_KEY);
+  if(!f || f->type != X_STRING || f->ndim != 0 || !f->value || !*(char **) f->value) return FALSE;
+
+  return GetBase64Type(xGetField(s, BASE64_TYPE_KEY)) != X_UNKNOWN && xGetField(s, BASE64_DIMS_KEY);
+}
+
+
+static int Base64Value(char c) {
+  if(c >= 'A' && c <= 'Z') return c - 'A';
+  if(c >= 'a' && c <= 'z') return c - 'a' + 26;
+  if(c >= '0' && c <= '9') return c - '0' + 52;
+  if(c == '+') return 62;
+  if(c == '/') return 63;
+  return -1;
+}
+
+
+static long Base64Decode(const char *src, unsigned char *dst, long maxBytes) {
+  long n = 0;
+  unsigned long v = 0;
+  int bits = 0;
+
+  for(; *src && *src != '='; src++) {
+    const int d = Base64Value(*src);
+    if(d < 0) return -1;
+
+    v = (v << 6) | d;
+    bits += 6;
+
+    if(bits >= 8) {
+      bits -= 8;
+      if(n >= maxBytes) return -1;
+      dst[n++] = (unsigned char) (v >> bits);
+    }
+  }
+
+  return n;
+}
+
+
+static int DecodeBase64Field(XField *f) {
+  static const char *fn = "DecodeBase64Field";
+
+  XStructure *s = (XStructure *) f->value;
+  const XField *t = xGetField(s, BASE64_TYPE_KEY);
+  const XField *d = xGetField(s, BASE64_DIMS_KEY);
+  const char *b64 = *(char **) xGetField(s, BASE64_DATA_KEY)->value;
+  int sizes[X_MAX_DIMS] = {0};
+  int i, ndim, eSize;
+  long count;
+  XType type;
+  unsigned char *data;
+
+  type = GetBase64Type(t);
+  if(type == X_UNKNOWN) return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid element type");
+
+  if(!xIsInteger(d->type) || d->ndim > 1) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid dimensions");
+
+  ndim = d->ndim ? d->sizes[0] : 1;
+  if(ndim < 1 || ndim > X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid ndim: %d", ndim);
+
+  for(i = 0; i < ndim; i++) {
+    sizes[i] = (int) xGetAsLongAtIndex(d, i, -1);
+    if(sizes[i] < 0) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid dimension: %d", sizes[i]);
+  }
+
+  eSize = xElementSizeOf(type);
+  count = xGetElementCount(ndim, sizes);
+  if(count < 0 || count > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid element count: %ld", count);
+
+  data = (unsigned char *) malloc(count * eSize + 1);
+  x_check_alloc(data);
+
+  if(Base64Decode(b64, data, count * eSize) != count * eSize) {
+    free(data);
+    return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid base64 data");
+  }
+
+  // The field is changed only once the array is fully decoded.
+  if(xSetFieldDims(f, ndim, sizes) != X_SUCCESS) {
+    free(data);
+    return x_trace(fn, NULL, X_SIZE_INVALID);
+  }
+
+#ifdef X_BIG_ENDIAN_HOST
+  x_swap_bytes(data, eSize, count);
+#endif
+
+  xDestroyStruct(s);
+
+  f->value = (char *) data;
+  f->type = type;
+
+  return X_SUCCESS;
+}
+
+
+static XStructure *ParseObject(char **pos, int *lineNumber) {
+  XStructure *s;
+
+  *pos = SkipSpaces(*pos, lineNumber);
+
+  if(**pos != '{') {
+    char *bad = GetToken(*pos);
+    Error("[L.%d] Expected '{', got \"%s\"\n", *lineNumber, bad);
+    free(bad);
+    return NULL;
+  }
+
+  (*pos)++; // Opening {
+
+  s = x_alloc_struct();
+  x_check_alloc(s);
+
+  while(**pos) {
     XField *f;
 
     *pos = SkipSpaces(*pos, lineNumber);
@@ -687,7 +1301,7 @@ static char *ParseString(char **pos, int *lineNumber) {
   return dst;
 }
 
-static void *ParsePrimitive(char **pos, XType *type, int *lineNumber) {
+static void *ParsePrimitive(char **pos, XField *f, int *lineNumber) {
   int l;
   long long ll;
   char *next, *end;
@@ -700,24 +1314,24 @@ static void *ParsePrimitive(char **pos, XType *type, int *lineNumber) {
 
   // Check for null
   if(l == JSON_NULL_LEN) if(!strncmp(next, JSON_NULL, JSON_NULL_LEN)) {
-    *type = X_UNKNOWN;
+    f->type = X_UNKNOWN;
     return NULL;
   }
 
   // Check if boolean
   if(l == JSON_TRUE_LEN) if(!strncmp(next, JSON_TRUE, JSON_TRUE_LEN)) {
-    boolean *value = malloc(sizeof(boolean));
+    boolean *value = (boolean *) x_alloc_value(f, sizeof(boolean));
     x_check_alloc(value);
     *value = TRUE;
-    *type = X_BOOLEAN;
+    f->type = X_BOOLEAN;
     return value;
   }
 
   if(l == JSON_FALSE_LEN) if(!strncmp(next, JSON_FALSE, JSON_FALSE_LEN)) {
-    boolean *value = malloc(sizeof(boolean));
+    boolean *value = (boolean *) x_alloc_value(f, sizeof(boolean));
     x_check_alloc(value);
     *value = FALSE;
-    *type = X_BOOLEAN;
+    f->type = X_BOOLEAN;
     return value;
   }
 
@@ -727,25 +1341,25 @@ static void *ParsePrimitive(char **pos, XType *type, int *lineNumber) {
   if(end == *pos && !errno) {
     if(ll == (int) ll) {
       // If we can represent as int, then prefer it.
-      int *value = (int *) malloc(sizeof(int));
+      int *value = (int *) x_alloc_value(f, sizeof(int));
       x_check_alloc(value);
       *value = (int) ll;
-      *type = X_INT;
+      f->type = X_INT;
       return value;
     }
     else if(ll == (long) ll) {
       // If we can represent as long, then prefer it.
-      long *value = (long *) malloc(sizeof(long));
+      long *value = (long *) x_alloc_value(f, sizeof(long));
       x_check_alloc(value);
       *value = (long) ll;
-      *type = X_LONG;
+      f->type = X_LONG;
       return value;
     }
     else {
-      long long *value = (long long *) malloc(sizeof(long long));
+      long long *value = (long long *) x_alloc_value(f, sizeof(long long));
       x_check_alloc(value);
       *value = ll;
-      *type = X_LLONG;
+      f->type = X_LLONG;
       return value;
     }
   }
@@ -754,10 +1368,10 @@ static void *ParsePrimitive(char **pos, XType *type, int *lineNumber) {
   errno = 0;
   d = strtod(next, &end);
   if(end == *pos && !errno) {
-    double *value = (double *) malloc(sizeof(double));
+    double *value = (double *) x_alloc_value(f, sizeof(double));
     x_check_alloc(value);
     *value = d;
-    *type = X_DOUBLE;
+    f->type = X_DOUBLE;
     return value;
   }
 
@@ -771,33 +1385,36 @@ static void *ParsePrimitive(char **pos, XType *type, int *lineNumber) {
 }
 
 
-static void *ParseValue(char **pos, XType *type, int *ndim, int sizes[X_MAX_DIMS], int *lineNumber) {
+static void *ParseValue(char **pos, XField *f, int *lineNumber) {
   const char *next;
 
   next = *pos = SkipSpaces(*pos, lineNumber);
 
-  memset(sizes, 0, X_MAX_DIMS * sizeof(int));
-  *ndim = 0;
-
   // Is value an object?
   if(*next == '{') {
-    *type = X_STRUCT;
+    f->type = X_STRUCT;
     return ParseObject(pos, lineNumber);
   }
 
   // Is value an array?
-  if(*next == '[') return ParseArray(pos, type, ndim, sizes, lineNumber);
+  if(*next == '[') {
+    int ndim, sizes[X_MAX_DIMS];
+    void *value = ParseArray(pos, &f->type, &ndim, sizes, lineNumber);
+
+    if(xSetFieldDims(f, ndim, sizes) != X_SUCCESS) Error("[L.%d] Out of memory (array dimensions).\n", *lineNumber);
+    return value;
+  }
 
   // Is value a string?
   if(*next == '"') {
-    char **ptr = (char **) calloc(1, sizeof(char *));
+    char **ptr = (char **) x_alloc_value(f, sizeof(char *));
     x_check_alloc(ptr);
     *ptr = ParseString(pos, lineNumber);
-    *type = X_STRING;
+    f->type = X_STRING;
     return ptr;
   }
 
-  return ParsePrimitive(pos, type, lineNumber);
+  return ParsePrimitive(pos, f, lineNumber);
 }
 
 
@@ -842,10 +1459,10 @@ static void *ParseArray(char **pos, XType *type, int *ndim, int sizes[X_MAX_DIMS
     XField *e;
     boolean isValid;
 
-    e = (XField *) calloc(1, sizeof(XField));
+    e = x_alloc_field();
     x_check_alloc(e);
 
-    e->value = ParseValue(&next, &e->type, &e->ndim, e->sizes, lineNumber);
+    e->value = ParseValue(&next, e, lineNumber);
     isValid = (e->value || errno != EINVAL);
 
     if(isValid) n++;
@@ -863,14 +1480,14 @@ static void *ParseArray(char **pos, XType *type, int *ndim, int sizes[X_MAX_DIMS
 
       if(*ndim == 0) {
         *ndim = e->ndim;
-        memcpy(sizes, e->sizes, e->ndim * sizeof(int));
+        memcpy(sizes, xGetFieldSizes(e), e->ndim * sizeof(int));
       }
 
       // Heterogeneous arrays are treated as an array of fields.
       else if(*ndim != e->ndim) {
         *type = X_FIELD;
       }
-      else if(memcmp(sizes, e->sizes, e->ndim * sizeof(int))) {
+      else if(memcmp(sizes, xGetFieldSizes(e), e->ndim * sizeof(int))) {
         *type = X_FIELD;
       }
     }
@@ -914,10 +1531,12 @@ static void *ParseArray(char **pos, XType *type, int *ndim, int sizes[X_MAX_DIMS
       sprintf(idx, ".%d", (i + 1));
 
       array[i] = *e;
-      array[i].name = xStringCopyOf(idx);
+      array[i].name = x_copy_name(idx);
       array[i].next = NULL;
+      array[i].pool = NULL;
+      x_rebase_value(&array[i], e);
 
-      free(e);
+      x_free_field(e);
       e = nextField;
     }
 
@@ -971,7 +1590,8 @@ static void *ParseArray(char **pos, XType *type, int *ndim, int sizes[X_MAX_DIMS
 
       if(e->value) {
         memcpy(data + i * rowSize, *type == X_FIELD ? (char *) e : e->value, rowSize);
-        free(e->value);
+        if(*type == X_STRUCT) x_free_struct((XStructure *) e->value);
+        else x_free_value(e, e->value);
         e->value = NULL;
       }
       xDestroyField(e);
@@ -1009,7 +1629,7 @@ static int GetObjectStringSize(int prefixSize, const XStructure *s) {
   n = prefixSize + 4;       // "{\n" + .... + <prefix> + "}\n";
 
   for(f = s->firstField; f != NULL; f = f->next) {
-    int m = GetFieldStringSize(prefixSize + ilen, f, f->type == X_FIELD);
+    int m = GetFieldStringSize(prefixSize + ilen, f, FALSE);
     prop_error("GetObjectStringSize", m);
     n += m;
   }
@@ -1018,42 +1638,509 @@ static int GetObjectStringSize(int prefixSize, const XStructure *s) {
 }
 
 
-static int PrintObject(const char *prefix, const XStructure *s, char *str) {
+/**
+ * Writes white-space indentation of the specified width into the output buffer, so that we do
+ * not need to allocate prefix strings for every level of nesting.
+ *
+ * @param prefixSize    (bytes) The number of spaces to indent with.
+ * @param str           The output buffer.
+ * @return              The number of characters written into the buffer.
+ */
+static __inline__ int PrintIndent(int prefixSize, char *str) {
+  if(prefixSize <= 0) return 0;
+  memset(str, ' ', prefixSize);
+  return prefixSize;
+}
+
+static int PrintObject(int prefixSize, const XStructure *s, char *str, JsonIO *io) {
   static const char *fn = "PrintObject";
 
-  char *fieldPrefix;
   XField *f;
   int n = 0;
 
   if(!s) return X_SUCCESS;
   if(!str) return x_error(X_NULL, EINVAL, fn, "output string buffer is NULL");
-  if(!prefix) return x_error(X_NULL, EINVAL, fn, "prefix is NULL");
 
   if(!s->firstField) return sprintf(&str[n], "{ }");
 
-  fieldPrefix = (char *) malloc(strlen(prefix) + xjsonGetIndent() + 1);
-  x_check_alloc(fieldPrefix);
-
-  sprintf(fieldPrefix, "%s%s", prefix, GetIndent());
-
   n += sprintf(str, "{\n");
 
   for(f = s->firstField; f != NULL; f = f->next) {
-    int m = PrintField(fieldPrefix, f, &str[n]);
+    int m = PrintField(prefixSize + ilen, f, &str[n], io);
+    if(m < 0) return x_trace(fn, NULL, m);     // Error code;
+    n += m;
+  }
+
+  n += PrintIndent(prefixSize, &str[n]);
+  str[n++] = '}';
+  str[n] = '\0';
+
+  return n;
+}
+
+
+/// \cond PRIVATE
+typedef struct {
+  const XField *first;      ///< The first field to print
+  int count;                ///< The number of fields to print
+  char *str;                ///< Where to start printing
+  int n;                    ///< The number of characters printed, or else an error code
+} EmitChunk;
+/// \endcond
+
+static void *EmitChunkThread(void *arg) {
+  EmitChunk *c = (EmitChunk *) arg;
+  const XField *f = c->first;
+  int k;
+
+  c->n = 0;
+
+  for(k = 0; k < c->count; k++, f = f->next) {
+    int m = PrintField(ilen, f, &c->str[c->n], NULL);
     if(m < 0) {
-      free(fieldPrefix);
-      return x_trace(fn, NULL, m);     // Error code;
+      c->n = m;
+      break;
+    }
+    c->n += m;
+  }
+
+  return NULL;
+}
+
+/**
+ * Prints a structure's top-level fields on multiple threads. The fields are split into contiguous chunks of
+ * similar estimated size, and each chunk is printed into the output buffer at the estimated offset for it.
+ * Since the estimates are upper bounds, the chunks are then moved together into their final place.
+ *
+ * @param s       Pointer to the structure
+ * @param size    (bytes) The estimated size of the JSON representation of the structure, as returned by
+ *                GetObjectStringSize().
+ * @param str     The output buffer, with at least size + nThreads bytes available (we leave a byte gap
+ *                between chunks for the string termination that is printed at the end of each).
+ * @return        The number of characters printed into the buffer, or else an error code &lt;0.
+ */
+static int PrintObjectParallel(const XStructure *s, int size, char *str) {
+  static const char *fn = "PrintObjectParallel";
+
+  EmitChunk *chunks;
+  pthread_t *tids;
+  boolean *started;
+  const XField *f;
+  int i, n, nChunks, nFields = 0, target, offset, status = X_SUCCESS;
+
+  for(f = s->firstField; f != NULL; f = f->next) nFields++;
+
+  nChunks = size / PARALLEL_MIN_CHUNK;
+  if(nChunks > nThreads) nChunks = nThreads;
+  if(nChunks > nFields) nChunks = nFields;
+  if(nChunks < 2) return PrintObject(0, s, str, NULL);
+
+  chunks = (EmitChunk *) calloc(nChunks, sizeof(EmitChunk));
+  tids = (pthread_t *) calloc(nChunks, sizeof(pthread_t));
+  started = (boolean *) calloc(nChunks, sizeof(boolean));
+  x_check_alloc(chunks);
+  x_check_alloc(tids);
+  x_check_alloc(started);
+
+  // Assign contiguous runs of fields to chunks, with roughly equal estimated sizes
+  n = sprintf(str, "{\n");
+  target = (size + nChunks - 1) / nChunks;
+  offset = n;
+
+  for(i = 0, f = s->firstField; i < nChunks && f; i++) {
+    int m = 0;
+
+    chunks[i].first = f;
+    chunks[i].str = &str[offset];
+
+    // The last chunk takes all remaining fields, while the others leave at least one for each chunk after.
+    while(f && (i == nChunks - 1 || ((chunks[i].count == 0 || m < target) && nFields > nChunks - i - 1))) {
+      int l = GetFieldStringSize(ilen, f, FALSE);
+      if(l < 0) {
+        status = x_trace(fn, f->name, l);
+        goto cleanup; // @suppress("Goto statement used")
+      }
+      m += l;
+      chunks[i].count++;
+      nFields--;
+      f = f->next;
+    }
+
+    offset += m + 1;
+  }
+  nChunks = i;
+
+  // Render chunks concurrently. The first chunk is printed by the calling thread.
+  for(i = 1; i < nChunks; i++) started[i] = (pthread_create(&tids[i], NULL, EmitChunkThread, &chunks[i]) == 0);
+  for(i = 0; i < nChunks; i++) if(!started[i]) EmitChunkThread(&chunks[i]);
+  for(i = 1; i < nChunks; i++) if(started[i]) pthread_join(tids[i], NULL);
+
+  // Move chunks together
+  for(i = 0; i < nChunks; i++) {
+    if(chunks[i].n < 0) {
+      status = x_trace(fn, NULL, chunks[i].n);
+      goto cleanup; // @suppress("Goto statement used")
+    }
+    if(chunks[i].str != &str[n]) memmove(&str[n], chunks[i].str, chunks[i].n);
+    n += chunks[i].n;
+  }
+
+  n += sprintf(&str[n], "}");
+
+  // -------------------------------------------------------------------------
+  cleanup:
+
+  free(chunks);
+  free(tids);
+  free(started);
+
+  return status ? status : n;
+}
+
+static void DestroyPlanPrivate(JsonPlan *p) {
+  int i;
+
+  if(!p) return;
+
+  for(i = p->nOps; --i >= 0; ) if(p->ops[i].name) free(p->ops[i].name);
+
+  if(p->ops) free(p->ops);
+  if(p->text) free(p->text);
+  free(p);
+}
+
+static int AddPlanOp(int op, const XField *f, int prefixSize, JsonPlan *p, int *mark) {
+  JsonPlanOp *o = &p->ops[p->nOps++];
+
+  o->op = op;
+  o->text = *mark;
+  o->textLength = p->textLength - *mark;
+  o->prefixSize = prefixSize;
+  o->size = -1;
+
+  *mark = p->textLength;
+
+  if(!f) return X_SUCCESS;
+
+  o->name = xStringCopyOf(f->name);
+  if(!o->name) return x_trace("AddPlanOp", f->name, X_FAILURE);
+
+  o->type = f->type;
+  o->ndim = f->ndim;
+  if(f->ndim > 0) memcpy(o->sizes, xGetFieldSizes(f), f->ndim * sizeof(int));
+
+  if(op == PLAN_VALUE && f->value) switch(f->type) {
+    case X_STRING:
+    case X_RAW:
+    case X_STRUCT:
+    case X_FIELD:
+      break;
+    default:
+      // Fixed-width types: the size estimate depends only on the shape.
+      o->size = GetFieldValueStringSize(prefixSize, f);
+      prop_error("AddPlanOp", o->size);
+  }
+
+  return X_SUCCESS;
+}
+
+static int CompileObject(int prefixSize, const XStructure *s, JsonPlan *p, int *mark) {
+  static const char *fn = "CompileObject";
+
+  const XField *f;
+  char *str = p->text;
+
+  if(!s->firstField) {
+    p->textLength += sprintf(&str[p->textLength], "{ }");
+    return X_SUCCESS;
+  }
+
+  p->textLength += sprintf(&str[p->textLength], "{\n");
+
+  for(f = s->firstField; f != NULL; f = f->next) {
+    const int fieldPrefix = prefixSize + ilen;
+
+    if(f->name == NULL) return x_error(X_NAME_INVALID, EINVAL, fn, "field->name is NULL");
+    if(*f->name == '\0') return x_error(X_NAME_INVALID, EINVAL, fn, "field->name is empty");
+    if(f->isSerialized) return x_error(X_PARSE_ERROR, ENOMSG, fn, "field is serialized (unknown format)");
+
+    p->textLength += PrintIndent(fieldPrefix, &str[p->textLength]);
+    p->textLength += PrintString(f->name, -1, &str[p->textLength]);
+    p->textLength += sprintf(&str[p->textLength], ": ");
+
+    if(f->type == X_STRUCT && f->ndim == 0 && f->value) {
+      prop_error(fn, AddPlanOp(PLAN_BEGIN, f, fieldPrefix, p, mark));
+      prop_error(fn, CompileObject(fieldPrefix, (XStructure *) f->value, p, mark));
+      prop_error(fn, AddPlanOp(PLAN_END, NULL, fieldPrefix, p, mark));
     }
+    else prop_error(fn, AddPlanOp(PLAN_VALUE, f, fieldPrefix, p, mark));
+
+    if(f->next) p->textLength += sprintf(&str[p->textLength], ",");
+    p->textLength += sprintf(&str[p->textLength], "\n");
+  }
+
+  p->textLength += PrintIndent(prefixSize, &str[p->textLength]);
+  str[p->textLength++] = '}';
+  str[p->textLength] = '\0';
+
+  return X_SUCCESS;
+}
+
+static __inline__ int PrintPlanText(const JsonPlan *p, const JsonPlanOp *op, char *str) {
+  if(str) memcpy(str, &p->text[op->text], op->textLength);
+  return op->textLength;
+}
+
+static boolean IsMatchingField(const JsonPlanOp *op, const XField *f) {
+  if(op->op == PLAN_END) return FALSE;
+  if(f->type != op->type || f->ndim != op->ndim || f->isSerialized) return FALSE;
+  if(op->op == PLAN_BEGIN && !f->value) return FALSE;
+  if(f->ndim > 0 && memcmp(xGetFieldSizes(f), op->sizes, f->ndim * sizeof(int)) != 0) return FALSE;
+  return f->name && strcmp(f->name, op->name) == 0;
+}
+
+/**
+ * Renders the JSON representation of a structure following a precompiled plan, or else just returns
+ * the required buffer size for it, if the output buffer is NULL.
+ *
+ * @param p     The emission plan.
+ * @param k     Pointer to the index of the next plan operation, which is updated by the call.
+ * @param s     The structure to render, which must match the plan's layout.
+ * @param str   The output buffer, or NULL to return the required size only.
+ * @return      The number of characters printed (or the upper bound of it if str is NULL), or else
+ *              an error code &lt;0.
+ */
+static int RenderObject(const JsonPlan *p, int *k, const XStructure *s, char *str) {
+  static const char *fn = "RenderObject";
+
+  const XField *f;
+  const JsonPlanOp *op;
+  int n = 0;
+
+  for(f = s->firstField; f != NULL; f = f->next) {
+    int m;
+
+    op = &p->ops[(*k)++];
+    if(!IsMatchingField(op, f)) return x_error(X_STRUCT_INVALID, EINVAL, fn, "layout mismatch at field '%s'", f->name);
+
+    n += PrintPlanText(p, op, str ? &str[n] : NULL);
+
+    if(op->op == PLAN_BEGIN) m = RenderObject(p, k, (XStructure *) f->value, str ? &str[n] : NULL);
+    else if(str) m = PrintFieldValue(op->prefixSize, f, &str[n], NULL);
+    else if(op->size >= 0 && f->value) m = op->size;
+    else m = GetFieldValueStringSize(op->prefixSize, f);
+
+    prop_error(fn, m);
     n += m;
   }
 
-  free(fieldPrefix);
-  n += sprintf(&str[n], "%s}", prefix);
+  op = &p->ops[(*k)++];
+  if(op->op != PLAN_END) return x_error(X_STRUCT_INVALID, EINVAL, fn, "layout mismatch: missing field '%s'", op->name);
+
+  n += PrintPlanText(p, op, str ? &str[n] : NULL);
+  if(str) str[n] = '\0';
 
   return n;
 }
 
 
+static char *ReservePatch(JsonPatch *p, int m) {
+  if(p->n + m + 1 > p->size) {
+    char *str;
+
+    p->size = 2 * p->size > p->n + m + 1 ? 2 * p->size : p->n + m + 1;
+    str = (char *) realloc(p->str, p->size);
+    x_check_alloc(str);
+    p->str = str;
+  }
+
+  return &p->str[p->n];
+}
+
+/**
+ * Returns a new JSON pointer (RFC 6901), by appending a field name to a parent pointer, with '~' and '/'
+ * characters in the name escaped as "~0" and "~1" respectively.
+ *
+ * @param path    The JSON pointer of the parent structure, "" for the root.
+ * @param name    The field name to append.
+ * @return        The new JSON pointer, which should be freed after use.
+ */
+static char *GetPatchPath(const char *path, const char *name) {
+  const int l = strlen(path);
+  char *pointer, *next;
+  int i;
+
+  pointer = (char *) malloc(l + 2 * strlen(name) + 2);
+  x_check_alloc(pointer);
+
+  memcpy(pointer, path, l);
+  next = &pointer[l];
+  *(next++) = '/';
+
+  for(i = 0; name[i]; i++) switch(name[i]) {
+    case '~': *(next++) = '~'; *(next++) = '0'; break;
+    case '/': *(next++) = '~'; *(next++) = '1'; break;
+    default: *(next++) = name[i];
+  }
+
+  *next = '\0';
+  return pointer;
+}
+
+static int AddPatchOp(JsonPatch *p, const char *op, const char *path, const XField *value) {
+  static const char *fn = "AddPatchOp";
+
+  int n = 0, m = 2 * ilen + strlen(op) + 40;     // ",\n" + "{ \"op\": \"<op>\", \"path\": <path>, \"value\": <value> }"
+  char *str;
+
+  n = GetJsonStringSize(path, TERMINATED_STRING);
+  prop_error(fn, n);
+  m += n;
+
+  if(value) {
+    n = GetFieldValueStringSize(ilen, value);
+    prop_error(fn, n);
+    m += n;
+  }
+
+  str = ReservePatch(p, m);
+
+  n = sprintf(str, "%s", p->count ? ",\n" : "\n");
+  n += PrintIndent(ilen, &str[n]);
+  n += sprintf(&str[n], "{ \"op\": \"%s\", \"path\": ", op);
+  n += PrintString(path, TERMINATED_STRING, &str[n]);
+
+  if(value) {
+    n += sprintf(&str[n], ", \"value\": ");
+    m = PrintFieldValue(ilen, value, &str[n], NULL);
+    prop_error(fn, m);
+    n += m;
+  }
+
+  n += sprintf(&str[n], " }");
+
+  p->n += n;
+  p->count++;
+
+  return X_SUCCESS;
+}
+
+static boolean IsEqualValue(const XField *a, const XField *b) {
+  long i, count;
+  int eSize;
+
+  if(a->type != b->type || a->ndim != b->ndim || a->isSerialized != b->isSerialized) return FALSE;
+  if(a->ndim > 0 && memcmp(xGetFieldSizes(a), xGetFieldSizes(b), a->ndim * sizeof(int)) != 0) return FALSE;
+  if(a->value == b->value) return TRUE;
+  if(!a->value || !b->value) return FALSE;
+
+  count = xGetFieldCount(a);
+
+  if(a->isSerialized) return strcmp((char *) a->value, (char *) b->value) == 0;     // serialized string value
+
+  switch(a->type) {
+    case X_STRING:
+    case X_RAW:
+      for(i = 0; i < count; i++) {
+        const char *sa = ((char **) a->value)[i], *sb = ((char **) b->value)[i];
+        if(sa == sb) continue;
+        if(!sa || !sb || strcmp(sa, sb) != 0) return FALSE;
+      }
+      return TRUE;
+
+    case X_STRUCT:
+      for(i = 0; i < count; i++) if(!IsEqualStruct(&((XStructure *) a->value)[i], &((XStructure *) b->value)[i])) return FALSE;
+      return TRUE;
+
+    case X_FIELD:
+      for(i = 0; i < count; i++) {
+        const XField *fa = &((XField *) a->value)[i], *fb = &((XField *) b->value)[i];
+        if(fa->name != fb->name && (!fa->name || !fb->name || strcmp(fa->name, fb->name) != 0)) return FALSE;
+        if(!IsEqualValue(fa, fb)) return FALSE;
+      }
+      return TRUE;
+  }
+
+  eSize = xElementSizeOf(a->type);
+  return memcmp(a->value, b->value, count * eSize) == 0;
+}
+
+static const XField *FindPatchField(const XStructure *s, const XLookupTable *lookup, const char *name) {
+  const XField *f;
+
+  if(lookup) return xLookupField(lookup, name);
+
+  for(f = s->firstField; f != NULL; f = f->next) if(f->name && strcmp(f->name, name) == 0) return f;
+  return NULL;
+}
+
+static boolean IsEqualStruct(const XStructure *a, const XStructure *b) {
+  const XField *f, *g;
+
+  if(a == b) return TRUE;
+  if(!a || !b) return FALSE;
+  if(xCountFields(a) != xCountFields(b)) return FALSE;
+
+  for(f = a->firstField, g = b->firstField; f != NULL; f = f->next) {
+    if(!f->name) return FALSE;      // Unnamed fields cannot be matched (and are invalid, see DiffObject())
+
+    // Try the same position first, before searching by name
+    if(!g || !g->name || strcmp(f->name, g->name) != 0) g = FindPatchField(b, NULL, f->name);
+    if(!g || !IsEqualValue(f, g)) return FALSE;
+    g = g->next;
+  }
+
+  return TRUE;
+}
+
+static int DiffObject(const char *path, const XStructure *old, const XStructure *updated, JsonPatch *p) {
+  static const char *fn = "DiffObject";
+
+  XLookupTable *oldLookup = NULL, *newLookup = NULL;
+  const XField *f;
+  int status = X_SUCCESS;
+
+  // Match names via hash lookups for larger structures.
+  if(xCountFields(old) > PATCH_LOOKUP_MIN_FIELDS) oldLookup = xCreateLookup(old, FALSE);
+  if(xCountFields(updated) > PATCH_LOOKUP_MIN_FIELDS) newLookup = xCreateLookup(updated, FALSE);
+
+  for(f = old->firstField; f != NULL && !status; f = f->next) {
+    const XField *g;
+    char *fieldPath;
+
+    if(!f->name) {
+      status = x_error(X_NAME_INVALID, EINVAL, fn, "field->name is NULL");
+      break;
+    }
+
+    g = FindPatchField(updated, newLookup, f->name);
+    fieldPath = GetPatchPath(path, f->name);
+
+    if(!g) status = AddPatchOp(p, "remove", fieldPath, NULL);
+    else if(f->type == X_STRUCT && g->type == X_STRUCT && f->ndim == 0 && g->ndim == 0 && f->value && g->value)
+      status = DiffObject(fieldPath, (XStructure *) f->value, (XStructure *) g->value, p);
+    else if(!IsEqualValue(f, g)) status = AddPatchOp(p, "replace", fieldPath, g);
+
+    free(fieldPath);
+  }
+
+  for(f = updated->firstField; f != NULL && !status; f = f->next) if(!f->name) {
+    status = x_error(X_NAME_INVALID, EINVAL, fn, "field->name is NULL");
+  }
+  else if(!FindPatchField(old, oldLookup, f->name)) {
+    char *fieldPath = GetPatchPath(path, f->name);
+    status = AddPatchOp(p, "add", fieldPath, f);
+    free(fieldPath);
+  }
+
+  if(oldLookup) xDestroyLookup(oldLookup);
+  if(newLookup) xDestroyLookup(newLookup);
+
+  prop_error(fn, status);
+  return X_SUCCESS;
+}
+
+
 static int GetFieldStringSize(int prefixSize, const XField *f, boolean ignoreName) {
   static const char *fn = "GetFieldStringSize";
 
@@ -1070,14 +2157,109 @@ static int GetFieldStringSize(int prefixSize, const XField *f, boolean ignoreNam
     n += m;
   }
 
-  m = GetArrayStringSize(prefixSize, f->value, f->type, f->ndim, f->sizes);
+  m = GetFieldValueStringSize(prefixSize, f);
   prop_error(fn, m);
 
   return n + m; // termination
 }
 
 
-static int PrintField(const char *prefix, const XField *f, char *str) {
+static boolean IsBase64Field(const XField *f) {
+  if(base64Threshold <= 0 || !f->value || f->ndim < 1) return FALSE;
+
+  switch(f->type) {
+    case X_BYTE:
+    case X_INT16:
+    case X_INT32:
+    case X_INT64:
+    case X_FLOAT:
+    case X_DOUBLE:
+      return xGetFieldCount(f) >= base64Threshold;
+  }
+
+  return FALSE;
+}
+
+
+static int Base64Encode(const unsigned char *src, long n, char *dst) {
+  static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  char *next = dst;
+  long i;
+
+  for(i = 0; i + 3 <= n; i += 3, next += 4) {
+    const unsigned long v = ((unsigned long) src[i] << 16) | ((unsigned long) src[i+1] << 8) | src[i+2];
+    next[0] = table[v >> 18];
+    next[1] = table[(v >> 12) & 0x3f];
+    next[2] = table[(v >> 6) & 0x3f];
+    next[3] = table[v & 0x3f];
+  }
+
+  if(i < n) {
+    const unsigned long v = ((unsigned long) src[i] << 16) | (i + 1 < n ? (unsigned long) src[i+1] << 8 : 0);
+    *(next++) = table[v >> 18];
+    *(next++) = table[(v >> 12) & 0x3f];
+    *(next++) = (i + 1 < n) ? table[(v >> 6) & 0x3f] : '=';
+    *(next++) = '=';
+  }
+
+  return next - dst;
+}
+
+
+static int GetBase64StringSize(const XField *f) {
+  const long bytes = xElementSizeOf(f->type) * xGetFieldCount(f);
+  return sizeof(BASE64_WRAPPER_TEMPLATE) + f->ndim * (xStringElementSizeOf(X_INT) + 1) + 4 * ((bytes + 2) / 3);
+}
+
+
+static int PrintBase64(const XField *f, char *str) {
+  const int eSize = xElementSizeOf(f->type);
+  const long count = xGetFieldCount(f);
+  const unsigned char *data = (unsigned char *) f->value;
+  int i, n;
+
+#ifdef X_BIG_ENDIAN_HOST
+  unsigned char *swapped = NULL;
+
+  if(eSize > 1) {
+    swapped = (unsigned char *) malloc(count * eSize);
+    if(!swapped) return x_error(X_FAILURE, errno, "PrintBase64", "alloc error (%ld bytes)", count * eSize);
+    memcpy(swapped, data, count * eSize);
+    x_swap_bytes(swapped, eSize, count);
+    data = swapped;
+  }
+#endif
+
+  n = sprintf(str, "{ \"" BASE64_TYPE_KEY "\": \"%c\", \"" BASE64_DIMS_KEY "\": [", xTypeChar(f->type));
+  for(i = 0; i < f->ndim; i++) n += sprintf(&str[n], "%s %d", (i ? "," : ""), xGetFieldSizes(f)[i]);
+  n += sprintf(&str[n], " ], \"" BASE64_DATA_KEY "\": \"");
+  n += Base64Encode(data, count * eSize, &str[n]);
+  n += sprintf(&str[n], "\" }");
+
+#ifdef X_BIG_ENDIAN_HOST
+  if(swapped) free(swapped);
+#endif
+
+  return n;
+}
+
+
+static int GetFieldValueStringSize(int prefixSize, const XField *f) {
+  if(f->isSerialized && f->value) return GetJsonStringSize((char *) f->value, TERMINATED_STRING);
+  if(IsBase64Field(f)) return GetBase64StringSize(f);
+  return GetArrayStringSize(prefixSize, f->value, f->type, f->ndim, xGetFieldSizes(f));
+}
+
+
+static int PrintFieldValue(int prefixSize, const XField *f, char *str, JsonIO *io) {
+  if(f->isSerialized && f->value) return PrintString((char *) f->value, TERMINATED_STRING, str);   // as is, in quotes
+  if(IsBase64Field(f)) return PrintBase64(f, str);
+  return PrintArray(prefixSize, f->value, f->type, f->ndim, xGetFieldSizes(f), str, io);
+}
+
+
+static int PrintField(int prefixSize, const XField *f, char *str, JsonIO *io) {
   static const char *fn = "PrintField";
 
   int n = 0, m;
@@ -1088,11 +2270,11 @@ static int PrintField(const char *prefix, const XField *f, char *str) {
   if(*f->name == '\0') return x_error(X_NAME_INVALID, EINVAL, fn, "field->name is empty");
   if(f->isSerialized) return x_error(X_PARSE_ERROR, ENOMSG, fn, "field is serialized (unknown format)");        // We don't know what format, so return an error
 
-  n = sprintf(str, "%s", prefix);
+  n = PrintIndent(prefixSize, str);
   n += PrintString(f->name, -1, &str[n]);
   n += sprintf(&str[n], ": ");
 
-  m = PrintArray(prefix, f->value, f->type, f->ndim, f->sizes, &str[n]);
+  m = PrintFieldValue(prefixSize, f, &str[n], io);
   prop_error(fn, m);
 
   n += m;
@@ -1171,13 +2353,12 @@ static int GetArrayStringSize(int prefixSize, char *ptr, XType type, int ndim, c
 }
 
 
-static int PrintArray(const char *prefix, char *ptr, XType type, int ndim, const int *sizes, char *str) {
+static int PrintArray(int prefixSize, char *ptr, XType type, int ndim, const int *sizes, char *str, JsonIO *io) {
   static const char *fn = "PrintArray";
 
   const char *str0 = str;
 
   if(!str) return x_error(X_NULL, EINVAL, fn, "output string buffer is NULL");
-  if(!prefix) return x_error(X_NULL, EINVAL, fn, "prefix is NULL");
 
   if(ndim < 0) return x_error(X_SIZE_INVALID, ERANGE, fn, "invalid ndim: %d", ndim);
 
@@ -1186,15 +2367,13 @@ static int PrintArray(const char *prefix, char *ptr, XType type, int ndim, const
 
     switch(type) {
       case X_STRUCT:
-        n = PrintObject(prefix, (XStructure *) ptr, str);
+        n = PrintObject(prefixSize, (XStructure *) ptr, str, io);
         break;
-      case X_FIELD: {
-        XField *f = (XField *) ptr;
-        n = PrintArray(prefix, f->value, f->type, f->ndim, f->sizes, str);
+      case X_FIELD:
+        n = PrintFieldValue(prefixSize, (XField *) ptr, str, io);
         break;
-      }
       default:
-        n = PrintPrimitive(ptr, type, str);
+        n = PrintPrimitive(ptr, type, str, io);
     }
 
     prop_error(fn, n);
@@ -1206,7 +2385,6 @@ static int PrintArray(const char *prefix, char *ptr, XType type, int ndim, const
     const boolean newLine = ptr ? IsNewLine(type, ndim) : FALSE;
 
     int k;
-    char *rowPrefix;
 
     // Special case: empty array
     if(N == 0) {
@@ -1216,12 +2394,6 @@ static int PrintArray(const char *prefix, char *ptr, XType type, int ndim, const
       return str - str0;
     }
 
-    // Indentation for elements...
-    rowPrefix = (char *) malloc(strlen(prefix) + xjsonGetIndent() + 2);
-    x_check_alloc(rowPrefix);
-
-    sprintf(rowPrefix, "%s%s", prefix, GetIndent());
-
     *(str++) = '[';                                     // Opening bracket at current position...
 
     // Print elements as required.
@@ -1232,37 +2404,38 @@ static int PrintArray(const char *prefix, char *ptr, XType type, int ndim, const
       if(k) str += sprintf(str, ",");
 
       // " ", or row indented new line
-      if(newLine) str += sprintf(str, "\n%s", rowPrefix);
+      if(newLine) {
+        *(str++) = '\n';
+        str += PrintIndent(prefixSize + ilen, str);
+      }
       else *(str++) = ' ';
 
       // The next element...
       if (type == X_STRUCT) {
-        m = PrintObject(rowPrefix, (XStructure *) ptr, str);
+        m = PrintObject(prefixSize + ilen, (XStructure *) ptr, str, io);
       }
       else {
-        m = PrintArray(rowPrefix, ptr, type, ndim-1, &sizes[1], str);
-      }
-      if(m < 0) {
-        free(rowPrefix);
-        return x_trace(fn, NULL, m);       // Error code
+        m = PrintArray(prefixSize + ilen, ptr, type, ndim-1, &sizes[1], str, io);
       }
+      if(m < 0) return x_trace(fn, NULL, m);       // Error code
       str += m;
     }
 
     // " ", or indented new line
-    if(newLine) str += sprintf(str, "\n%s", prefix);    // For newLine type elemments, close on an indented new line....
+    if(newLine) {                                       // For newLine type elemments, close on an indented new line....
+      *(str++) = '\n';
+      str += PrintIndent(prefixSize, str);
+    }
     else *(str++) = ' ';                                // Otherwise, just add a space...
 
     *(str++) = ']';                                     // Close bracket.
 
-    free(rowPrefix);
-
     return str - str0;
   }
 }
 
 
-static int PrintPrimitive(const void *ptr, XType type, char *str) {
+static int PrintPrimitive(const void *ptr, XType type, char *str, JsonIO *io) {
   static const char *fn = "PrintPrimitive";
 
   if(!ptr) return sprintf(str, JSON_NULL);
@@ -1279,7 +2452,9 @@ static int PrintPrimitive(const void *ptr, XType type, char *str) {
     case X_FLOAT: return sprintf(str, "%.8g , ", *(float *) ptr);
     case X_DOUBLE: return xPrintDouble(str, *(double *) ptr);
     case X_STRING:
-    case X_RAW: return PrintString(*(char **) ptr, TERMINATED_STRING, str);
+    case X_RAW:
+      if(io && AddStringRef(*(char **) ptr, str, io)) return sprintf(str, "\"\"");    // Referenced in place
+      return PrintString(*(char **) ptr, TERMINATED_STRING, str);
     default:
       if(type == X_SHORT) return sprintf(str, "%hd", *(short *) ptr);
       else if(type == X_INT) return sprintf(str, "%d", *(int *) ptr);
@@ -1291,34 +2466,114 @@ static int PrintPrimitive(const void *ptr, XType type, char *str) {
 }
 
 
+/**
+ * Checks if a character needs escaping in JSON strings, i.e. if it is a double quote, a backslash, or an
+ * ASCII control character.
+ *
+ * @param c     The character to check
+ * @return      TRUE (1) if the character must be escaped in JSON, or else FALSE (0).
+ */
+static __inline__ boolean IsJsonSpecial(char c) {
+  return ((unsigned char) c < 0x20 || c == 0x7f || c == '"' || c == '\\');
+}
+
+#if !defined(__SSE2__)
+/// \cond PRIVATE
+#  define SWAR_ONES         (~0ULL / 255)         ///< 0x0101...01
+#  define SWAR_HIGHS        (SWAR_ONES * 0x80)    ///< 0x8080...80
+#  define SWAR_HAS_ZERO(x)  (((x) - SWAR_ONES) & ~(x) & SWAR_HIGHS)
+/// \endcond
+#endif
+
+/**
+ * Returns the number of leading characters in a string, which can be copied into JSON verbatim, without
+ * escaping. It checks 16 bytes at a time with SSE2, if available, or else 8 bytes at a time in a 64-bit
+ * word, before locating the exact position of the first special character byte by byte.
+ *
+ * @param src     The native string
+ * @param n       (bytes) The number of characters available in the string
+ * @return        (bytes) The length of the leading run that needs no escaping (&lt;= n).
+ */
+static int GetPlainLength(const char *src, int n) {
+  int i = 0;
+
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i bslash = _mm_set1_epi8('\\');
+  const __m128i del = _mm_set1_epi8(0x7f);
+  const __m128i ctrl = _mm_set1_epi8(0x1f);
+
+  for(; i + 16 <= n; i += 16) {
+    const __m128i v = _mm_loadu_si128((const __m128i *) &src[i]);
+    __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bslash));
+    int mask;
+
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, del));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(v, ctrl), v));    // v <= 0x1f (unsigned)
+
+    mask = _mm_movemask_epi8(m);
+    if(mask) return i + __builtin_ctz(mask);
+  }
+#else
+  for(; i + 8 <= n; i += 8) {
+    unsigned long long w;
+
+    memcpy(&w, &src[i], sizeof(w));
+
+    if(((w - SWAR_ONES * 0x20) & ~w & SWAR_HIGHS)         // any byte < 0x20
+            || SWAR_HAS_ZERO(w ^ (SWAR_ONES * '"'))
+            || SWAR_HAS_ZERO(w ^ (SWAR_ONES * '\\'))
+            || SWAR_HAS_ZERO(w ^ (SWAR_ONES * 0x7f))) break;
+  }
+#endif
+
+  for(; i < n; i++) if(IsJsonSpecial(src[i])) break;
+
+  return i;
+}
+
+/**
+ * Returns the number of characters in a native string, which is either '\0' terminated, or else
+ * limited to the specified maximum length.
+ *
+ * @param src         The native string
+ * @param maxLength   The maximum number of characters, or &lt;0 for a '\0'-terminated string.
+ * @return            (bytes) The number of characters in the string.
+ */
+static __inline__ int GetRawLength(const char *src, int maxLength) {
+  const char *end;
+
+  if(maxLength < 0) return (int) strlen(src);
+
+  end = (const char *) memchr(src, '\0', maxLength);
+  return end ? (int) (end - src) : maxLength;
+}
+
 static int GetJsonBytes(char c) {
-  if(iscntrl(c)) switch(c) {
+  switch(c) {
     case '\b':
     case '\f':
     case '\n':
     case '\t':
-    case '\r': return 2;
-    default: return UNICODE_BYTES;
-  }
-
-  switch(c) {
+    case '\r':
     case '\\':
     case '"': return 2;
   }
 
-  return 1;
+  return IsJsonSpecial(c) ? UNICODE_BYTES : 1;
 }
 
 
 static int GetJsonStringSize(const char *src, int maxLength) {
-  int i, n = 2; // ""
-
-  if(maxLength < 0) {
-    for(i = 0; src[i]; i++)
-      n += GetJsonBytes(src[i]);
+  const int L = GetRawLength(src, maxLength);
+  int i = 0, n = 2; // ""
+
+  while(i < L) {
+    int k = GetPlainLength(&src[i], L - i);
+    n += k;
+    i += k;
+    if(i < L) n += GetJsonBytes(src[i++]);
   }
-  else for(i = 0; i < maxLength && src[i]; i++)
-    n += GetJsonBytes(src[i]);
 
   return n;
 }
@@ -1339,35 +2594,81 @@ static char GetEscapedChar(char c) {
 }
 
 
+static int PrintEscapedChar(char c, char *json) {
+  static const char hex[] = "0123456789abcdef";
+
+  if(GetJsonBytes(c) == 2) {
+    json[0] = '\\';
+    json[1] = GetEscapedChar(c);
+    return 2;
+  }
+
+  // \u00XX
+  json[0] = '\\';
+  json[1] = 'u';
+  json[2] = '0';
+  json[3] = '0';
+  json[4] = hex[((unsigned char) c) >> 4];
+  json[5] = hex[c & 0xf];
+  return UNICODE_BYTES;
+}
+
+
 static int raw2json(const char *src, int maxlen, char *json) {
+  const int L = GetRawLength(src, maxlen);
   char *next = json;
-  int i;
+  int i = 0;
+
+  while(i < L) {
+    int k = GetPlainLength(&src[i], L - i);   // Bulk copy the characters that need no escaping.
+    memcpy(next, &src[i], k);
+    next += k;
+    i += k;
+    if(i < L) next += PrintEscapedChar(src[i++], next);
+  }
 
-  for(i = 0; i < maxlen && src[i]; i++) switch(GetJsonBytes(src[i])) {
-    case UNICODE_BYTES:
-      *(next++) = '\\';
-      *(next++) = 'u';
-      next += sprintf(next, "00%02hhx", (unsigned char) src[i]);
-      break;
-    case 2:
-      *(next++) = '\\';
-      *(next++) = GetEscapedChar(src[i]);
-       break;
-    case 1:
-      *(next++) = src[i];
-      break;
+  *next = '\0';
+
+  return next - json;
+}
+
+/**
+ * Registers a string value to be referenced in place in the I/O vector output, if it is long enough to be
+ * worth it, and if it needs no escaping.
+ *
+ * @param src     The string value
+ * @param str     The position in the scratch buffer, where the quoted string value would be printed.
+ * @param io      The I/O vector context
+ * @return        TRUE (1) if the string is to be referenced in place, or else FALSE (0).
+ */
+static boolean AddStringRef(const char *src, const char *str, JsonIO *io) {
+  JsonRef *ref;
+  int L;
+
+  if(!src) return FALSE;
+
+  L = (int) strlen(src);
+  if(L < IOV_MIN_REF_LENGTH || GetPlainLength(src, L) < L) return FALSE;
+
+  if(io->nRefs >= io->capacity) {
+    JsonRef *refs;
+    io->capacity = io->capacity ? 2 * io->capacity : 16;
+    refs = (JsonRef *) realloc(io->refs, io->capacity * sizeof(JsonRef));
+    x_check_alloc(refs);
+    io->refs = refs;
   }
 
-  *(next++) = '\0';
+  ref = &io->refs[io->nRefs++];
+  ref->offset = (str - io->base) + 1;     // after the opening quote
+  ref->data = src;
+  ref->length = L;
 
-  return next - json - 1;
+  return TRUE;
 }
 
 static int PrintString(const char *src, int maxLength, char *json) {
   char *next = json;
 
-  if(maxLength < 0) maxLength = INT_MAX;
-
   *(next++) = '"';
 
   next += raw2json(src, maxLength, next);
@@ -1401,7 +2702,7 @@ char *xjsonEscape(const char *src, int maxLength) {
     return NULL;
   }
 
-  if(maxLength <= 0) maxLength = INT_MAX;
+  if(maxLength <= 0) maxLength = TERMINATED_STRING;
 
   size = GetJsonStringSize(src, maxLength);
 
@@ -94,10 +94,15 @@ static XField *xLookupRemoveAsync(XLookupTable *tab, const char *id) {
 
   for(e = p->table[idx]; e != NULL; e=e->next) {
     if(strcmp(e->key, id) == 0) {
+      XField *f = e->field;
+
       p->nEntries--;
       if(last) last->next = e->next;
       else p->table[idx] = e->next;
-      return e->field;
+
+      free(e->key);
+      free(e);
+      return f;
     }
     last = e;
   }
@@ -469,6 +474,27 @@ XField *xLookupField(const XLookupTable *tab, const char *id) {
 
 
 
+/**
+ * Checks if the field of a lookup entry is nested inside another field that is also in the lookup table, such as
+ * the fields of substructures in recursive lookups.
+ *
+ * @param tab   Pointer to the lookup table
+ * @param e     The lookup entry to check
+ * @return      TRUE (1) if the field is contained in another field in the lookup table, or else FALSE (0).
+ */
+static boolean IsNestedEntry(const XLookupTable *tab, const XLookupEntry *e) {
+  char *id = xStringCopyOf(e->key), *sep;
+  boolean isNested = FALSE;
+
+  while(!isNested && (sep = xLastSeparator(id)) != NULL) {
+    *sep = '\0';
+    isNested = xGetLookupEntryAsync(tab, id, xGetHash(id)) != NULL;
+  }
+
+  free(id);
+  return isNested;
+}
+
 /**
  * Destroys a lookup table, freeing up it's in-memory resources. Depending on the option
  * argument, the fields referenced by the lookup table may also be destroyed, or else
@@ -487,11 +513,16 @@ static void xDestroyLookupOption(XLookupTable *tab, boolean destroyFields) {
   if(!tab) return;
 
   p = (XLookupPrivate *) tab->priv;
-  p->nEntries = 0;
-  p->nBins = 0;
 
-  if(p->table) {
+  if(p && p->table) {
     int i;
+
+    // Nested fields are destroyed along with the fields that contain them.
+    if(destroyFields) for (i = 0; i < p->nBins; i++) {
+      XLookupEntry *e;
+      for(e = p->table[i]; e != NULL; e = e->next) if(IsNestedEntry(tab, e)) e->field = NULL;
+    }
+
     for (i = 0; i < p->nBins; i++) {
       XLookupEntry *e = p->table[i];
 
@@ -508,12 +539,15 @@ static void xDestroyLookupOption(XLookupTable *tab, boolean destroyFields) {
     pthread_mutex_destroy(&p->mutex);
   }
 
+  if(p) free(p);
   free(tab);
 }
 
 /**
  * Destroys a lookup table, freeing up it's in-memory resources, including the data
- * that is referenced in the lookup table.
+ * that is referenced in the lookup table. Fields that are nested inside other fields
+ * of the lookup (e.g. in recursive lookups) are destroyed along with the fields that
+ * contain them.
  *
  * @param tab     Pointer to the lookup table to destroy.
  *
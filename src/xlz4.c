@@ -0,0 +1,919 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * @brief   Streaming LZ4 frame compression and decompression, without external dependencies.
+ *
+ *  Data is compressed into the standard LZ4 frame format (v1.6.x), and is thus interchangeable with the `lz4`
+ *  command-line tool and with the LZ4 libraries of other languages (e.g. `lz4.frame` in Python). Frames are
+ *  written with independent 64 kB blocks, and with a content checksum. The decoder accepts all block sizes, both
+ *  independent and linked blocks, block and content checksums, as well as concatenated and skippable frames.
+ *  Only frames that require an external dictionary are not supported.
+ *
+ *  Compression and decompression both proceed one block at a time, while the data is written or read, with
+ *  memory use bounded by the block size. On platforms that support it (glibc's `fopencookie()` or BSD's
+ *  `funopen()`), xlz4Open() wraps a compressing or decompressing stream into a regular `FILE` pointer, so that
+ *  any code writing or reading files (e.g. xcsvWrite(), xarrowWrite(), or xjsonParseFile()) can compress or
+ *  decompress on the fly.
+ */
+
+#define _GNU_SOURCE                     ///< For fopencookie()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define __XCHANGE_INTERNAL_API__        ///< Use internal definitions
+#include "xlz4.h"
+
+#ifndef TRUE
+#define TRUE 1          ///< Boolean 'true' in case it isn't already defined
+#endif
+
+#ifndef FALSE
+#define FALSE 0         ///< Boolean 'false' in case it isn't already defined
+#endif
+
+/// \cond PRIVATE
+#define LZ4_MAGIC               0x184D2204U     ///< LZ4 frame magic number
+#define LZ4_SKIPPABLE_MAGIC     0x184D2A50U     ///< Skippable frame magic number (lowest 4 bits are any)
+#define LZ4_UNCOMPRESSED_BIT    0x80000000U     ///< Block size flag for uncompressed blocks
+
+#define LZ4_FLG_VERSION         0x40            ///< Frame format version 01
+#define LZ4_FLG_INDEPENDENT     0x20            ///< Blocks are independent
+#define LZ4_FLG_BLOCK_CHECKSUM  0x10            ///< Blocks are followed by checksums
+#define LZ4_FLG_CONTENT_SIZE    0x08            ///< Frame header contains the content size
+#define LZ4_FLG_CONTENT_CHECKSUM 0x04           ///< Frame ends with a content checksum
+#define LZ4_FLG_DICT_ID         0x01            ///< Frame header contains a dictionary ID
+
+#define LZ4_BLOCK_SIZE          65536           ///< (bytes) Size of the blocks we write
+#define LZ4_BD_64KB             0x40            ///< BD byte for 64 kB blocks
+#define LZ4_WINDOW              65536           ///< (bytes) Largest match offset, and history kept for linked blocks
+
+#define LZ4_MIN_MATCH           4               ///< Shortest match
+#define LZ4_MF_LIMIT            12              ///< Last match must start at least this many bytes before the end
+#define LZ4_LAST_LITERALS       5               ///< The last bytes of a block are always literals
+#define LZ4_HASH_BITS           14              ///< Number of bits in the compressor's hash table index
+#define LZ4_SKIP_TRIGGER        6               ///< Search acceleration for incompressible data
+
+#define LZ4_BOUND(n)            ((n) + (n) / 255 + 16)      ///< Worst-case compressed size of a block
+
+#define XXH_PRIME1              2654435761U     ///< xxHash32 prime 1
+#define XXH_PRIME2              2246822519U     ///< xxHash32 prime 2
+#define XXH_PRIME3              3266489917U     ///< xxHash32 prime 3
+#define XXH_PRIME4              668265263U      ///< xxHash32 prime 4
+#define XXH_PRIME5              374761393U      ///< xxHash32 prime 5
+
+/// Streaming xxHash32 state
+typedef struct {
+  uint32_t v[4];                ///< Accumulators
+  uint64_t total;               ///< (bytes) Total length hashed
+  unsigned char mem[16];        ///< Pending bytes of an incomplete stripe
+  int nMem;                     ///< Number of pending bytes
+} XXH32State;
+
+struct XLZ4Stream {
+  boolean isWriter;             ///< Whether compressing (TRUE) or decompressing (FALSE)
+  FILE *fp;                     ///< The underlying file, or NULL if using memory
+  const unsigned char *src;     ///< Compressed input in memory (decompressing from memory)
+  size_t srcSize;               ///< (bytes) Size of the compressed input in memory
+  size_t srcPos;                ///< (bytes) Bytes of the compressed input in memory consumed so far
+  unsigned char *dst;           ///< Compressed output in memory (compressing to memory)
+  size_t dstSize;               ///< (bytes) Used size of the compressed output in memory
+  size_t dstCapacity;           ///< (bytes) Allocated size of the compressed output in memory
+  unsigned char *buf;           ///< Uncompressed data: pending input, or decoded output (after history)
+  size_t n;                     ///< (bytes) Bytes in buf (including history for readers)
+  size_t pos;                   ///< (bytes) Read position in buf (readers)
+  size_t history;               ///< (bytes) Bytes of history at the start of buf (readers with linked blocks)
+  size_t blockSize;             ///< (bytes) Maximum block size
+  unsigned char *block;         ///< Compressed block buffer
+  int flags;                    ///< Frame FLG byte (readers)
+  boolean inFrame;              ///< Whether a frame is open (a frame header has been processed / written)
+  boolean atEnd;                ///< Whether the end of input has been reached (readers)
+  XXH32State hash;              ///< Checksum of the uncompressed content of the current frame
+  int status;                   ///< X_SUCCESS, or the first error
+};
+/// \endcond
+
+static uint32_t ReadLE32(const unsigned char *p) {
+  return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static void WriteLE32(unsigned char *p, uint32_t value) {
+  p[0] = value & 0xff;
+  p[1] = (value >> 8) & 0xff;
+  p[2] = (value >> 16) & 0xff;
+  p[3] = value >> 24;
+}
+
+static uint32_t Rotate(uint32_t x, int r) {
+  return (x << r) | (x >> (32 - r));
+}
+
+static uint32_t XXH32Round(uint32_t acc, uint32_t input) {
+  return Rotate(acc + input * XXH_PRIME2, 13) * XXH_PRIME1;
+}
+
+static void XXH32Reset(XXH32State *h) {
+  memset(h, 0, sizeof(*h));
+  h->v[0] = XXH_PRIME1 + XXH_PRIME2;
+  h->v[1] = XXH_PRIME2;
+  h->v[2] = 0;
+  h->v[3] = 0U - XXH_PRIME1;
+}
+
+static void XXH32Update(XXH32State *h, const unsigned char *p, size_t len) {
+  const unsigned char *end = p + len;
+
+  h->total += len;
+
+  if(h->nMem + len < 16) {
+    memcpy(&h->mem[h->nMem], p, len);
+    h->nMem += (int) len;
+    return;
+  }
+
+  if(h->nMem) {
+    int i, m = 16 - h->nMem;
+    memcpy(&h->mem[h->nMem], p, m);
+    for(i = 0; i < 4; i++) h->v[i] = XXH32Round(h->v[i], ReadLE32(&h->mem[4 * i]));
+    p += m;
+    h->nMem = 0;
+  }
+
+  for(; p + 16 <= end; p += 16) {
+    h->v[0] = XXH32Round(h->v[0], ReadLE32(p));
+    h->v[1] = XXH32Round(h->v[1], ReadLE32(p + 4));
+    h->v[2] = XXH32Round(h->v[2], ReadLE32(p + 8));
+    h->v[3] = XXH32Round(h->v[3], ReadLE32(p + 12));
+  }
+
+  h->nMem = (int) (end - p);
+  memcpy(h->mem, p, h->nMem);
+}
+
+static uint32_t XXH32Digest(const XXH32State *h) {
+  const unsigned char *p = h->mem, *end = p + h->nMem;
+  uint32_t acc;
+
+  if(h->total >= 16) acc = Rotate(h->v[0], 1) + Rotate(h->v[1], 7) + Rotate(h->v[2], 12) + Rotate(h->v[3], 18);
+  else acc = h->v[2] + XXH_PRIME5;
+
+  acc += (uint32_t) h->total;
+
+  for(; p + 4 <= end; p += 4) acc = Rotate(acc + ReadLE32(p) * XXH_PRIME3, 17) * XXH_PRIME4;
+  for(; p < end; p++) acc = Rotate(acc + (*p) * XXH_PRIME5, 11) * XXH_PRIME1;
+
+  acc ^= acc >> 15;
+  acc *= XXH_PRIME2;
+  acc ^= acc >> 13;
+  acc *= XXH_PRIME3;
+  acc ^= acc >> 16;
+
+  return acc;
+}
+
+static uint32_t XXH32(const unsigned char *p, size_t len) {
+  XXH32State h;
+  XXH32Reset(&h);
+  XXH32Update(&h, p, len);
+  return XXH32Digest(&h);
+}
+
+static unsigned char *PutLength(unsigned char *op, size_t len) {
+  for(; len >= 255; len -= 255) *(op++) = 255;
+  *(op++) = (unsigned char) len;
+  return op;
+}
+
+static unsigned char *PutSequence(unsigned char *op, const unsigned char *literals, size_t nLiterals, size_t offset, size_t matchLength) {
+  unsigned char *token = op++;
+  const size_t m = matchLength - LZ4_MIN_MATCH;
+
+  *token = (unsigned char) (((nLiterals < 15 ? nLiterals : 15) << 4) | (m < 15 ? m : 15));
+  if(nLiterals >= 15) op = PutLength(op, nLiterals - 15);
+
+  memcpy(op, literals, nLiterals);
+  op += nLiterals;
+
+  *(op++) = offset & 0xff;
+  *(op++) = offset >> 8;
+
+  if(m >= 15) op = PutLength(op, m - 15);
+
+  return op;
+}
+
+/**
+ * Compresses a block (of at most 64 kB) into the LZ4 block format, with a greedy single-probe hash search, and
+ * returns the compressed size.
+ */
+static size_t CompressBlock(const unsigned char *src, size_t n, unsigned char *dst) {
+  uint16_t table[1 << LZ4_HASH_BITS];
+  unsigned char *op = dst;
+  size_t ip = 1, anchor = 0;
+
+  if(n >= LZ4_MF_LIMIT + 1) {
+    const size_t limit = n - LZ4_MF_LIMIT, matchLimit = n - LZ4_LAST_LITERALS;
+
+    memset(table, 0, sizeof(table));
+
+    while(ip < limit) {
+      const uint32_t seq = ReadLE32(&src[ip]);
+      const uint32_t h = (seq * XXH_PRIME1) >> (32 - LZ4_HASH_BITS);
+      const size_t ref = table[h];
+      size_t len;
+
+      table[h] = (uint16_t) ip;
+
+      if(ref >= ip || ReadLE32(&src[ref]) != seq) {
+        // Skip ahead faster through incompressible data.
+        ip += 1 + ((ip - anchor) >> LZ4_SKIP_TRIGGER);
+        continue;
+      }
+
+      for(len = LZ4_MIN_MATCH; ip + len < matchLimit && src[ref + len] == src[ip + len]; len++);
+
+      op = PutSequence(op, &src[anchor], ip - anchor, ip - ref, len);
+      ip += len;
+      anchor = ip;
+
+      // Index a position inside the match, to help find the next one.
+      if(ip < limit) table[(ReadLE32(&src[ip - 2]) * XXH_PRIME1) >> (32 - LZ4_HASH_BITS)] = (uint16_t) (ip - 2);
+    }
+  }
+
+  // Last literals
+  {
+    const size_t nLiterals = n - anchor;
+
+    *(op++) = (unsigned char) ((nLiterals < 15 ? nLiterals : 15) << 4);
+    if(nLiterals >= 15) op = PutLength(op, nLiterals - 15);
+    memcpy(op, &src[anchor], nLiterals);
+    op += nLiterals;
+  }
+
+  return op - dst;
+}
+
+/**
+ * Decompresses an LZ4 block into dst, starting at offset `start`. Matches may reach back into the `start` bytes of
+ * history before the block. Returns the decompressed size, or -1 if the block is corrupt or would overflow.
+ */
+static long DecompressBlock(const unsigned char *src, size_t n, unsigned char *dst, size_t start, size_t capacity) {
+  const unsigned char *ip = src, *end = src + n;
+  size_t op = start;
+
+  while(ip < end) {
+    const int token = *(ip++);
+    size_t len = token >> 4, offset;
+
+    if(len == 15) {
+      int b;
+      do {
+        if(ip >= end) return -1;
+        b = *(ip++);
+        len += b;
+      } while(b == 255);
+    }
+
+    if(len > (size_t) (end - ip) || len > capacity - op) return -1;
+    memcpy(&dst[op], ip, len);
+    ip += len;
+    op += len;
+
+    if(ip == end) break;            // The last sequence has literals only
+
+    if(end - ip < 2) return -1;
+    offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if(offset == 0 || offset > op) return -1;
+
+    len = token & 0xf;
+    if(len == 15) {
+      int b;
+      do {
+        if(ip >= end) return -1;
+        b = *(ip++);
+        len += b;
+      } while(b == 255);
+    }
+    len += LZ4_MIN_MATCH;
+
+    if(len > capacity - op) return -1;
+
+    if(offset >= len) memcpy(&dst[op], &dst[op - offset], len);
+    else {
+      // Overlapping match (repeating pattern)
+      size_t i;
+      for(i = 0; i < len; i++) dst[op + i] = dst[op - offset + i];
+    }
+    op += len;
+  }
+
+  return (long) (op - start);
+}
+
+static XLZ4Stream *CreateStream(boolean isWriter) {
+  XLZ4Stream *z = (XLZ4Stream *) calloc(1, sizeof(XLZ4Stream));
+  x_check_alloc(z);
+
+  z->isWriter = isWriter;
+
+  if(isWriter) {
+    z->blockSize = LZ4_BLOCK_SIZE;
+    z->buf = (unsigned char *) malloc(LZ4_BLOCK_SIZE);
+    x_check_alloc(z->buf);
+    z->block = (unsigned char *) malloc(LZ4_BOUND(LZ4_BLOCK_SIZE) + 4);
+    x_check_alloc(z->block);
+  }
+
+  return z;
+}
+
+static void DestroyStream(XLZ4Stream *z) {
+  if(z->buf) free(z->buf);
+  if(z->block) free(z->block);
+  if(z->dst) free(z->dst);
+  free(z);
+}
+
+static void Output(XLZ4Stream *z, const void *data, size_t n) {
+  if(z->status != X_SUCCESS) return;
+
+  if(z->fp) {
+    if(fwrite(data, 1, n, z->fp) != n) z->status = x_error(X_FAILURE, errno, "Output", "write error: %s", strerror(errno));
+    return;
+  }
+
+  if(z->dstSize + n > z->dstCapacity) {
+    z->dstCapacity = (2 * z->dstCapacity > z->dstSize + n) ? 2 * z->dstCapacity : z->dstSize + n;
+    z->dst = (unsigned char *) realloc(z->dst, z->dstCapacity);
+    x_check_alloc(z->dst);
+  }
+
+  memcpy(&z->dst[z->dstSize], data, n);
+  z->dstSize += n;
+}
+
+static void WriteFrameHeader(XLZ4Stream *z) {
+  unsigned char h[7];
+
+  WriteLE32(h, LZ4_MAGIC);
+  h[4] = LZ4_FLG_VERSION | LZ4_FLG_INDEPENDENT | LZ4_FLG_CONTENT_CHECKSUM;
+  h[5] = LZ4_BD_64KB;
+  h[6] = (XXH32(&h[4], 2) >> 8) & 0xff;
+
+  Output(z, h, sizeof(h));
+  XXH32Reset(&z->hash);
+  z->inFrame = TRUE;
+}
+
+static void WriteBlock(XLZ4Stream *z) {
+  size_t m;
+
+  if(!z->n) return;
+  if(!z->inFrame) WriteFrameHeader(z);
+
+  XXH32Update(&z->hash, z->buf, z->n);
+
+  m = CompressBlock(z->buf, z->n, &z->block[4]);
+  if(m < z->n) WriteLE32(z->block, (uint32_t) m);
+  else {
+    // Store incompressible data as is.
+    m = z->n;
+    memcpy(&z->block[4], z->buf, m);
+    WriteLE32(z->block, (uint32_t) m | LZ4_UNCOMPRESSED_BIT);
+  }
+
+  Output(z, z->block, m + 4);
+  z->n = 0;
+}
+
+/**
+ * Creates a new compressing stream, which writes an LZ4 frame to the specified file, as data is written to it with
+ * xlz4Write(). The stream must be closed with xlz4Close(), to complete the frame.
+ *
+ * @param fp    The file to which to write the compressed data.
+ * @return      A new compressing stream, or NULL if the file is NULL (errno set to EINVAL).
+ *
+ * @since 1.1
+ *
+ * @sa xlz4Write()
+ * @sa xlz4Close()
+ * @sa xlz4Open()
+ */
+XLZ4Stream *xlz4OpenWriter(FILE *fp) {
+  XLZ4Stream *z;
+
+  if(!fp) {
+    x_error(0, EINVAL, "xlz4OpenWriter", "output file is NULL");
+    return NULL;
+  }
+
+  z = CreateStream(TRUE);
+  z->fp = fp;
+  return z;
+}
+
+/**
+ * Compresses data into a compressing stream. Data is compressed and written one 64 kB block at a time, as it
+ * accumulates.
+ *
+ * @param z       A compressing stream.
+ * @param data    Data to compress.
+ * @param size    (bytes) Number of bytes of data.
+ * @return        X_SUCCESS (0) if successful, or else X_NULL if an argument is NULL, or X_FAILURE if the stream
+ *                is not a compressing stream, or if there was a write error (errno set).
+ *
+ * @since 1.1
+ *
+ * @sa xlz4OpenWriter()
+ */
+int xlz4Write(XLZ4Stream *z, const void *data, size_t size) {
+  static const char *fn = "xlz4Write";
+
+  const unsigned char *p = (const unsigned char *) data;
+
+  if(!z) return x_error(X_NULL, EINVAL, fn, "stream is NULL");
+  if(!z->isWriter) return x_error(X_FAILURE, EPERM, fn, "not a compressing stream");
+  if(!data && size) return x_error(X_NULL, EINVAL, fn, "input data is NULL");
+
+  while(size > 0 && z->status == X_SUCCESS) {
+    size_t m = z->blockSize - z->n;
+    if(m > size) m = size;
+
+    memcpy(&z->buf[z->n], p, m);
+    z->n += m;
+    p += m;
+    size -= m;
+
+    if(z->n == z->blockSize) WriteBlock(z);
+  }
+
+  prop_error(fn, z->status);
+  return X_SUCCESS;
+}
+
+static int FinishFrame(XLZ4Stream *z) {
+  unsigned char end[8];
+
+  WriteBlock(z);
+  if(!z->inFrame) WriteFrameHeader(z);
+
+  WriteLE32(end, 0);                            // EndMark
+  WriteLE32(&end[4], XXH32Digest(&z->hash));    // Content checksum
+  Output(z, end, sizeof(end));
+
+  return z->status;
+}
+
+static size_t Input(XLZ4Stream *z, void *dst, size_t n) {
+  if(z->fp) return fread(dst, 1, n, z->fp);
+
+  if(n > z->srcSize - z->srcPos) n = z->srcSize - z->srcPos;
+  memcpy(dst, &z->src[z->srcPos], n);
+  z->srcPos += n;
+  return n;
+}
+
+static int ReadExactly(XLZ4Stream *z, void *dst, size_t n) {
+  if(Input(z, dst, n) != n) return x_error(X_PARSE_ERROR, EINVAL, "ReadExactly", "truncated LZ4 frame");
+  return X_SUCCESS;
+}
+
+/// Reads the next frame header, skipping skippable frames. Sets atEnd if there are no more frames.
+static int ReadFrameHeader(XLZ4Stream *z) {
+  static const char *fn = "ReadFrameHeader";
+
+  unsigned char h[16];
+  size_t m, bufSize;
+  uint32_t magic;
+  int k;
+
+  for(;;) {
+    m = Input(z, h, 4);
+
+    if(m == 0) {
+      z->atEnd = TRUE;
+      return X_SUCCESS;
+    }
+    if(m != 4) return x_error(X_PARSE_ERROR, EINVAL, fn, "truncated LZ4 frame");
+
+    magic = ReadLE32(h);
+    if(magic == LZ4_MAGIC) break;
+    if((magic & 0xfffffff0U) != LZ4_SKIPPABLE_MAGIC) return x_error(X_PARSE_ERROR, EINVAL, fn, "not an LZ4 frame");
+
+    // Skippable frame
+    prop_error(fn, ReadExactly(z, h, 4));
+    for(m = ReadLE32(h); m > 0; ) {
+      size_t l = m < sizeof(h) ? m : sizeof(h);
+      prop_error(fn, ReadExactly(z, h, l));
+      m -= l;
+    }
+  }
+
+  prop_error(fn, ReadExactly(z, h, 2));
+  z->flags = h[0];
+
+  if((z->flags & 0xc0) != LZ4_FLG_VERSION) return x_error(X_PARSE_ERROR, EINVAL, fn, "unsupported LZ4 frame version");
+  if(z->flags & LZ4_FLG_DICT_ID) return x_error(X_FAILURE, ENOTSUP, fn, "LZ4 dictionaries are not supported");
+
+  k = (h[1] >> 4) & 0x7;
+  if(k < 4) return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid LZ4 block size");
+
+  // Optional content size (ignored), and the header checksum
+  m = 2 + ((z->flags & LZ4_FLG_CONTENT_SIZE) ? 8 : 0);
+  prop_error(fn, ReadExactly(z, &h[2], m - 1));
+  if(h[m] != ((XXH32(h, m) >> 8) & 0xff)) return x_error(X_PARSE_ERROR, EINVAL, fn, "LZ4 frame header checksum mismatch");
+
+  bufSize = (size_t) 1 << (2 * k + 8);
+
+  if(bufSize != z->blockSize) {
+    // Decoded data buffer, with room for history (for linked blocks)
+    z->blockSize = bufSize;
+    z->buf = (unsigned char *) realloc(z->buf, LZ4_WINDOW + z->blockSize);
+    x_check_alloc(z->buf);
+    z->block = (unsigned char *) realloc(z->block, z->blockSize + 4);
+    x_check_alloc(z->block);
+  }
+
+  z->n = z->pos = z->history = 0;
+  XXH32Reset(&z->hash);
+  z->inFrame = TRUE;
+
+  return X_SUCCESS;
+}
+
+/// Reads and decodes the next block of the current frame, or completes the frame if it has no more blocks.
+static int ReadBlock(XLZ4Stream *z) {
+  static const char *fn = "ReadBlock";
+
+  unsigned char b[4];
+  uint32_t size;
+  boolean isRaw;
+  long m;
+
+  prop_error(fn, ReadExactly(z, b, 4));
+  size = ReadLE32(b);
+
+  if(size == 0) {
+    // EndMark
+    if(z->flags & LZ4_FLG_CONTENT_CHECKSUM) {
+      prop_error(fn, ReadExactly(z, b, 4));
+      if(ReadLE32(b) != XXH32Digest(&z->hash)) return x_error(X_PARSE_ERROR, EINVAL, fn, "LZ4 content checksum mismatch");
+    }
+    z->inFrame = FALSE;
+    return X_SUCCESS;
+  }
+
+  isRaw = (size & LZ4_UNCOMPRESSED_BIT) != 0;
+  size &= ~LZ4_UNCOMPRESSED_BIT;
+  if(size > z->blockSize) return x_error(X_PARSE_ERROR, EINVAL, fn, "LZ4 block too large");
+
+  prop_error(fn, ReadExactly(z, z->block, size));
+
+  if(z->flags & LZ4_FLG_BLOCK_CHECKSUM) {
+    prop_error(fn, ReadExactly(z, b, 4));
+    if(ReadLE32(b) != XXH32(z->block, size)) return x_error(X_PARSE_ERROR, EINVAL, fn, "LZ4 block checksum mismatch");
+  }
+
+  // Keep up to 64 kB of history before the block for linked blocks.
+  if(z->flags & LZ4_FLG_INDEPENDENT) z->history = 0;
+  else {
+    z->history = z->n < LZ4_WINDOW ? z->n : LZ4_WINDOW;
+    memmove(z->buf, &z->buf[z->n - z->history], z->history);
+  }
+
+  if(isRaw) {
+    memcpy(&z->buf[z->history], z->block, size);
+    m = size;
+  }
+  else {
+    m = DecompressBlock(z->block, size, z->buf, z->history, z->history + z->blockSize);
+    if(m < 0) return x_error(X_PARSE_ERROR, EINVAL, fn, "corrupt LZ4 block");
+  }
+
+  XXH32Update(&z->hash, &z->buf[z->history], m);
+
+  z->pos = z->history;
+  z->n = z->history + m;
+
+  return X_SUCCESS;
+}
+
+/**
+ * Creates a new decompressing stream, which reads LZ4 frames from the specified file, as data is read from it with
+ * xlz4Read(). Concatenated frames are decompressed as one continuous stream.
+ *
+ * @param fp    The file from which to read the compressed data.
+ * @return      A new decompressing stream, or NULL if the file is NULL (errno set to EINVAL).
+ *
+ * @since 1.1
+ *
+ * @sa xlz4Read()
+ * @sa xlz4Close()
+ * @sa xlz4Open()
+ */
+XLZ4Stream *xlz4OpenReader(FILE *fp) {
+  XLZ4Stream *z;
+
+  if(!fp) {
+    x_error(0, EINVAL, "xlz4OpenReader", "input file is NULL");
+    return NULL;
+  }
+
+  z = CreateStream(FALSE);
+  z->fp = fp;
+  return z;
+}
+
+/**
+ * Reads decompressed data from a decompressing stream. Data is read and decompressed one block at a time, as
+ * needed.
+ *
+ * @param z       A decompressing stream.
+ * @param[out] buf  Buffer to which to read the decompressed data.
+ * @param size    (bytes) Maximum number of bytes to read.
+ * @return        The number of bytes read, which is less than requested only at the end of the compressed data, or
+ *                else X_NULL if an argument is NULL, X_PARSE_ERROR if the compressed data is invalid or
+ *                corrupt, or X_FAILURE if the stream is not a decompressing stream (errno set).
+ *
+ * @since 1.1
+ *
+ * @sa xlz4OpenReader()
+ */
+long xlz4Read(XLZ4Stream *z, void *buf, size_t size) {
+  static const char *fn = "xlz4Read";
+
+  unsigned char *p = (unsigned char *) buf;
+  size_t n = 0;
+
+  if(!z) return x_error(X_NULL, EINVAL, fn, "stream is NULL");
+  if(z->isWriter) return x_error(X_FAILURE, EPERM, fn, "not a decompressing stream");
+  if(!buf && size) return x_error(X_NULL, EINVAL, fn, "output buffer is NULL");
+
+  while(n < size && z->status == X_SUCCESS) {
+    size_t m = z->n - z->pos;
+
+    if(m == 0) {
+      if(z->atEnd) break;
+      z->status = z->inFrame ? ReadBlock(z) : ReadFrameHeader(z);
+      continue;
+    }
+
+    if(m > size - n) m = size - n;
+    memcpy(&p[n], &z->buf[z->pos], m);
+    z->pos += m;
+    n += m;
+  }
+
+  if(z->status != X_SUCCESS) return x_trace(fn, NULL, z->status);
+
+  return (long) n;
+}
+
+/**
+ * Closes a compressing or decompressing stream, and frees up its resources. For compressing streams, the remaining
+ * data is compressed and written, and the frame is completed. The underlying file is not closed.
+ *
+ * @param z     A compressing or decompressing stream.
+ * @return      X_SUCCESS (0) if successful, or else X_NULL if the stream is NULL, or the error, if any, that
+ *              occurred while writing or reading the stream.
+ *
+ * @since 1.1
+ *
+ * @sa xlz4OpenWriter()
+ * @sa xlz4OpenReader()
+ */
+int xlz4Close(XLZ4Stream *z) {
+  int status;
+
+  if(!z) return x_error(X_NULL, EINVAL, "xlz4Close", "stream is NULL");
+
+  if(z->isWriter && z->status == X_SUCCESS) {
+    FinishFrame(z);
+    if(z->fp && fflush(z->fp) != 0 && z->status == X_SUCCESS) z->status = x_error(X_FAILURE, errno, "xlz4Close", "flush error: %s", strerror(errno));
+  }
+  status = z->status;
+
+  DestroyStream(z);
+
+  prop_error("xlz4Close", status);
+  return X_SUCCESS;
+}
+
+/**
+ * Compresses data in memory into a single LZ4 frame.
+ *
+ * @param data        Data to compress.
+ * @param size        (bytes) Size of the data.
+ * @param[out] outSize  (bytes) Pointer to which to return the size of the compressed frame.
+ * @return            A newly allocated buffer with the compressed frame, or NULL if there was an error (errno set).
+ *
+ * @since 1.1
+ *
+ * @sa xlz4Decompress()
+ */
+void *xlz4Compress(const void *data, size_t size, size_t *outSize) {
+  static const char *fn = "xlz4Compress";
+
+  XLZ4Stream *z;
+  void *out;
+
+  if(!data && size) {
+    x_error(0, EINVAL, fn, "input data is NULL");
+    return NULL;
+  }
+
+  if(!outSize) {
+    x_error(0, EINVAL, fn, "output size pointer is NULL");
+    return NULL;
+  }
+
+  z = CreateStream(TRUE);
+  z->dstCapacity = LZ4_BOUND(size) + 32;
+  z->dst = (unsigned char *) malloc(z->dstCapacity);
+  x_check_alloc(z->dst);
+
+  if(xlz4Write(z, data, size) != X_SUCCESS || FinishFrame(z) != X_SUCCESS) {
+    DestroyStream(z);
+    return x_trace_null(fn, NULL);
+  }
+
+  out = z->dst;
+  *outSize = z->dstSize;
+  z->dst = NULL;
+  DestroyStream(z);
+
+  return out;
+}
+
+/**
+ * Decompresses one or more (concatenated) LZ4 frames in memory. The decompressed data is terminated with an extra
+ * '\0' (not included in the returned size), so that decompressed text can be used as a string directly.
+ *
+ * @param data        The compressed LZ4 frame(s).
+ * @param size        (bytes) Size of the compressed data.
+ * @param[out] outSize  (bytes) Pointer to which to return the size of the decompressed data.
+ * @return            A newly allocated buffer with the decompressed data, or NULL if there was an error (errno set).
+ *
+ * @since 1.1
+ *
+ * @sa xlz4Compress()
+ */
+void *xlz4Decompress(const void *data, size_t size, size_t *outSize) {
+  static const char *fn = "xlz4Decompress";
+
+  XLZ4Stream *z;
+  unsigned char *out = NULL;
+  size_t n = 0, capacity = 0;
+
+  if(!data) {
+    x_error(0, EINVAL, fn, "input data is NULL");
+    return NULL;
+  }
+
+  if(!outSize) {
+    x_error(0, EINVAL, fn, "output size pointer is NULL");
+    return NULL;
+  }
+
+  z = CreateStream(FALSE);
+  z->src = (const unsigned char *) data;
+  z->srcSize = size;
+
+  for(;;) {
+    long m;
+
+    if(n + LZ4_BLOCK_SIZE + 1 > capacity) {
+      capacity = 2 * capacity + LZ4_BLOCK_SIZE + 1;
+      out = (unsigned char *) realloc(out, capacity);
+      x_check_alloc(out);
+    }
+
+    m = xlz4Read(z, &out[n], capacity - n - 1);
+    if(m < 0) {
+      free(out);
+      DestroyStream(z);
+      return x_trace_null(fn, NULL);
+    }
+    if(m == 0) break;
+    n += m;
+  }
+
+  DestroyStream(z);
+
+  out[n] = '\0';
+  *outSize = n;
+  return out;
+}
+
+#if defined(__GLIBC__) || defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#  define HAVE_COOKIES  1        ///< Whether custom stdio streams are supported
+#endif
+
+#ifdef HAVE_COOKIES
+static ssize_t CookieRead(void *cookie, char *buf, size_t size) {
+  long n = xlz4Read((XLZ4Stream *) cookie, buf, size);
+  return n < 0 ? -1 : n;
+}
+
+static ssize_t CookieWrite(void *cookie, const char *buf, size_t size) {
+  // A short write signals an error to stdio
+  return xlz4Write((XLZ4Stream *) cookie, buf, size) == X_SUCCESS ? (ssize_t) size : 0;
+}
+
+static int CookieClose(void *cookie) {
+  return xlz4Close((XLZ4Stream *) cookie) == X_SUCCESS ? 0 : EOF;
+}
+
+#if !defined(__GLIBC__)
+static int FunRead(void *cookie, char *buf, int size) {
+  return (int) CookieRead(cookie, buf, size);
+}
+
+static int FunWrite(void *cookie, const char *buf, int size) {
+  return (int) CookieWrite(cookie, buf, size);
+}
+#endif
+#endif // HAVE_COOKIES
+
+/**
+ * Opens a regular `FILE` stream that compresses the data written to it, or decompresses the data read from it, on
+ * the fly, using the LZ4 frame format on the underlying file. It allows any code that writes or reads files to
+ * produce or consume compressed data, without a separate pass over a full buffer. E.g.:
+ *
+ * ```c
+ *   FILE *fp = fopen("data.json.lz4", "w");
+ *   FILE *z = xlz4Open(fp, "w");
+ *   char *json = xjsonToString(s);
+ *
+ *   fputs(json, z);
+ *   fclose(z);        // completes the compressed frame
+ *   fclose(fp);
+ *   free(json);
+ * ```
+ *
+ * Closing the returned stream (with `fclose()`) completes the compressed frame (when writing), but leaves the
+ * underlying file open. The returned stream does not support seeking.
+ *
+ * This function is available only on platforms that support custom stdio streams (glibc, and the BSDs including
+ * macOS). On other platforms, use xlz4OpenWriter() / xlz4OpenReader() instead.
+ *
+ * @param fp      The underlying file, to which to write compressed data, or from which to read compressed data.
+ * @param mode    "w" to compress data written to the returned stream, or "r" to decompress data read from it.
+ * @return        A new stdio stream, or NULL if there was an error (errno set, e.g. to ENOSYS if the platform
+ *                does not support custom streams).
+ *
+ * @since 1.1
+ *
+ * @sa xlz4OpenWriter()
+ * @sa xlz4OpenReader()
+ */
+FILE *xlz4Open(FILE *fp, const char *mode) {
+  static const char *fn = "xlz4Open";
+
+  XLZ4Stream *z;
+  FILE *f;
+  boolean isWriter;
+
+  if(!fp) {
+    x_error(0, EINVAL, fn, "file is NULL");
+    return NULL;
+  }
+
+  if(!mode || (*mode != 'r' && *mode != 'w')) {
+    x_error(0, EINVAL, fn, "invalid mode: %s", mode ? mode : "(null)");
+    return NULL;
+  }
+
+  isWriter = (*mode == 'w');
+  z = isWriter ? xlz4OpenWriter(fp) : xlz4OpenReader(fp);
+
+#if defined(__GLIBC__)
+  {
+    cookie_io_functions_t io = { CookieRead, CookieWrite, NULL, CookieClose };
+    f = fopencookie(z, isWriter ? "w" : "r", io);
+  }
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+  f = funopen(z, isWriter ? NULL : FunRead, isWriter ? FunWrite : NULL, NULL, CookieClose);
+#else
+  f = NULL;
+  errno = ENOSYS;
+#endif
+
+  if(!f) {
+    int err = errno;
+    xlz4Close(z);
+    x_error(0, err, fn, "cannot create stream: %s", strerror(err));
+    return NULL;
+  }
+
+  return f;
+}
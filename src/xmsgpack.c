@@ -0,0 +1,918 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * @brief   MessagePack encoder and decoder for structured data.
+ *
+ *  Structures are represented as MessagePack maps, with the field names as keys. Scalar values map to the matching
+ *  MessagePack types (nil, boolean, integer, float 32, float 64, and str), while arrays of booleans, strings,
+ *  structures, and heterogeneous arrays map to (nested) MessagePack arrays.
+ *
+ *  Homogeneous numerical arrays (`X_BYTE`, `X_INT16`, `X_INT32`, `X_INT64`, `X_FLOAT`, and `X_DOUBLE`) are
+ *  written as MessagePack extension objects, whose extension type is the XType character itself (e.g. `'D'` for
+ *  an array of doubles). The extension payload is:
+ *
+ *  ```
+ *   uint8 ndim, uint32 sizes[ndim] (little-endian), little-endian element data
+ *  ```
+ *
+ *  so these arrays are decoded straight into typed buffers, with a single `memcpy()` on little-endian hosts.
+ *  MessagePack `bin` objects are decoded as 1D `X_BYTE` arrays.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define __XCHANGE_INTERNAL_API__        ///< Use internal definitions
+#include "xmsgpack.h"
+
+#ifndef TRUE
+#define TRUE 1          ///< Boolean 'true' in case it isn't already defined
+#endif
+
+#ifndef FALSE
+#define FALSE 0         ///< Boolean 'false' in case it isn't already defined
+#endif
+
+/// \cond PRIVATE
+#define MP_NIL          0xc0    ///< MessagePack nil
+#define MP_FALSE        0xc2    ///< MessagePack false
+#define MP_TRUE         0xc3    ///< MessagePack true
+#define MP_BIN8         0xc4    ///< MessagePack bin 8
+#define MP_BIN16        0xc5    ///< MessagePack bin 16
+#define MP_BIN32        0xc6    ///< MessagePack bin 32
+#define MP_EXT8         0xc7    ///< MessagePack ext 8
+#define MP_EXT16        0xc8    ///< MessagePack ext 16
+#define MP_EXT32        0xc9    ///< MessagePack ext 32
+#define MP_FLOAT32      0xca    ///< MessagePack float 32
+#define MP_FLOAT64      0xcb    ///< MessagePack float 64
+#define MP_UINT8        0xcc    ///< MessagePack uint 8
+#define MP_UINT16       0xcd    ///< MessagePack uint 16
+#define MP_UINT32       0xce    ///< MessagePack uint 32
+#define MP_UINT64       0xcf    ///< MessagePack uint 64
+#define MP_INT8         0xd0    ///< MessagePack int 8
+#define MP_INT16        0xd1    ///< MessagePack int 16
+#define MP_INT32        0xd2    ///< MessagePack int 32
+#define MP_INT64        0xd3    ///< MessagePack int 64
+#define MP_FIXEXT1      0xd4    ///< MessagePack fixext 1
+#define MP_FIXEXT16     0xd8    ///< MessagePack fixext 16
+#define MP_STR8         0xd9    ///< MessagePack str 8
+#define MP_STR16        0xda    ///< MessagePack str 16
+#define MP_STR32        0xdb    ///< MessagePack str 32
+#define MP_ARRAY16      0xdc    ///< MessagePack array 16
+#define MP_ARRAY32      0xdd    ///< MessagePack array 32
+#define MP_MAP16        0xde    ///< MessagePack map 16
+#define MP_MAP32        0xdf    ///< MessagePack map 32
+
+typedef struct {
+  const unsigned char *data;    ///< The MessagePack data
+  size_t n;                     ///< (bytes) Number of bytes parsed so far
+  size_t size;                  ///< (bytes) Total number of bytes available
+} MPReader;
+
+/// A MessagePack object header, as read by ReadHeader()
+typedef struct {
+  int kind;                     ///< The MessagePack type, as the XType it decodes to (or X_UNKNOWN for nil)
+  long long i;                  ///< Integer value (integers and booleans)
+  double d;                     ///< Floating-point value
+  size_t length;                ///< Element count (arrays, maps), or byte length (str, bin, ext)
+  char extType;                 ///< Extension type (ext only)
+} MPHeader;
+
+#define MP_KIND_ARRAY   '['     ///< MessagePack array (header kind)
+#define MP_KIND_MAP     '{'     ///< MessagePack map (header kind)
+#define MP_KIND_EXT     'E'     ///< MessagePack extension (header kind)
+#define MP_KIND_BIN     'b'     ///< MessagePack bin (header kind)
+#define MP_KIND_UINT64  'U'     ///< Unsigned integer beyond the signed 64-bit range (header kind)
+/// \endcond
+
+static int EncodeStruct(const XStructure *s, XBuffer *w);
+static int EncodeValue(const XField *f, XBuffer *w);
+static int DecodeStruct(MPReader *r, size_t nFields, XStructure *s);
+static void *DecodeValue(MPReader *r, XType *type, int *ndim, int *sizes);
+
+static void PutByte(XBuffer *w, int value) {
+  *x_buffer_reserve(w, 1) = (unsigned char) value;
+  w->n++;
+}
+
+static void PutUInt(XBuffer *w, int code, unsigned long long value, int nBytes) {
+  unsigned char *b = x_buffer_reserve(w, nBytes + 1);
+  int i;
+
+  *(b++) = code;
+  for(i = nBytes; --i >= 0; value >>= 8) b[i] = value & 0xff;
+
+  w->n += nBytes + 1;
+}
+
+static void PutInt(XBuffer *w, long long value) {
+  if(value >= 0) {
+    if(value < 0x80) PutByte(w, (int) value);     // positive fixint
+    else if(value <= 0xff) PutUInt(w, MP_UINT8, value, 1);
+    else if(value <= 0xffff) PutUInt(w, MP_UINT16, value, 2);
+    else if(value <= 0xffffffffLL) PutUInt(w, MP_UINT32, value, 4);
+    else PutUInt(w, MP_UINT64, value, 8);
+  }
+  else {
+    if(value >= -32) PutByte(w, value & 0xff);    // negative fixint
+    else if(value >= -0x80) PutUInt(w, MP_INT8, value & 0xff, 1);
+    else if(value >= -0x8000) PutUInt(w, MP_INT16, value & 0xffff, 2);
+    else if(value >= -0x80000000LL) PutUInt(w, MP_INT32, value & 0xffffffffLL, 4);
+    else PutUInt(w, MP_INT64, (unsigned long long) value, 8);
+  }
+}
+
+static void PutFloat(XBuffer *w, float value) {
+  unsigned int u;
+  memcpy(&u, &value, sizeof(u));
+  PutUInt(w, MP_FLOAT32, u, 4);
+}
+
+static void PutDouble(XBuffer *w, double value) {
+  unsigned long long u;
+  memcpy(&u, &value, sizeof(u));
+  PutUInt(w, MP_FLOAT64, u, 8);
+}
+
+/// Writes a container or string header: fixed form if length < fixLimit, or else 8/16/32-bit length.
+static void PutHeader(XBuffer *w, int fixCode, size_t fixLimit, int code8, int code16, size_t length) {
+  if(length < fixLimit) PutByte(w, fixCode | (int) length);
+  else if(code8 && length <= 0xff) PutUInt(w, code8, length, 1);
+  else if(length <= 0xffff) PutUInt(w, code16, length, 2);
+  else PutUInt(w, code16 + 1, length, 4);
+}
+
+static void PutString(XBuffer *w, const char *str, size_t length) {
+  PutHeader(w, 0xa0, 32, MP_STR8, MP_STR16, length);
+  x_buffer_put(w, str, length);
+}
+
+static int EncodeNumericArray(const XField *f, XBuffer *w) {
+  const long count = xGetFieldCount(f);
+  const int eSize = xElementSizeOf(f->type);
+  const size_t length = 1 + 4 * f->ndim + count * eSize;
+  const int *sizes = xGetFieldSizes(f);
+  unsigned char *b;
+  int i;
+
+  // ext header: fixext if possible, or else ext 8/16/32.
+  if(length == 1 || length == 2 || length == 4 || length == 8 || length == 16) {
+    int code = MP_FIXEXT1;
+    for(i = 1; i < (int) length; i <<= 1) code++;
+    PutByte(w, code);
+  }
+  else if(length <= 0xff) PutUInt(w, MP_EXT8, length, 1);
+  else if(length <= 0xffff) PutUInt(w, MP_EXT16, length, 2);
+  else PutUInt(w, MP_EXT32, length, 4);
+
+  b = x_buffer_reserve(w, 1 + length);
+  *(b++) = (unsigned char) f->type;
+  *(b++) = (unsigned char) f->ndim;
+
+  for(i = 0; i < f->ndim; i++, b += 4) {
+    b[0] = sizes[i] & 0xff;
+    b[1] = (sizes[i] >> 8) & 0xff;
+    b[2] = (sizes[i] >> 16) & 0xff;
+    b[3] = (sizes[i] >> 24) & 0xff;
+  }
+
+  memcpy(b, f->value, count * eSize);
+
+#ifdef X_BIG_ENDIAN_HOST
+  x_swap_bytes(b, eSize, count);
+#endif
+
+  w->n += 1 + length;
+  return X_SUCCESS;
+}
+
+static int EncodeElement(XType type, const void *ptr, XBuffer *w) {
+  static const char *fn = "EncodeElement";
+
+  if(xIsCharSequence(type)) {
+    const char *str = (char *) ptr;
+    size_t l = 0;
+    while(l < (size_t) xElementSizeOf(type) && str[l]) l++;
+    PutString(w, str, l);
+    return X_SUCCESS;
+  }
+
+  switch(type) {
+    case X_BOOLEAN: PutByte(w, *(boolean *) ptr ? MP_TRUE : MP_FALSE); break;
+    case X_BYTE: PutInt(w, *(int8_t *) ptr); break;
+    case X_INT16: PutInt(w, *(int16_t *) ptr); break;
+    case X_INT32: PutInt(w, *(int32_t *) ptr); break;
+    case X_INT64: PutInt(w, *(int64_t *) ptr); break;
+    case X_FLOAT: PutFloat(w, *(float *) ptr); break;
+    case X_DOUBLE: PutDouble(w, *(double *) ptr); break;
+    case X_STRING:
+    case X_RAW: {
+      const char *str = *(char **) ptr;
+      if(str) PutString(w, str, strlen(str));
+      else PutByte(w, MP_NIL);
+      break;
+    }
+    case X_STRUCT: prop_error(fn, EncodeStruct((XStructure *) ptr, w)); break;
+    case X_FIELD: prop_error(fn, EncodeValue((XField *) ptr, w)); break;
+    default: return x_error(X_TYPE_INVALID, EINVAL, fn, "unsupported type: %d", type);
+  }
+
+  return X_SUCCESS;
+}
+
+static int EncodeArray(XType type, int ndim, const int *sizes, const char *data, XBuffer *w) {
+  const int eSize = xElementSizeOf(type);
+  const long rowCount = xGetElementCount(ndim - 1, &sizes[1]);
+  int i;
+
+  PutHeader(w, 0x90, 16, 0, MP_ARRAY16, sizes[0]);
+
+  for(i = 0; i < sizes[0]; i++, data += rowCount * eSize) {
+    int status = (ndim > 1) ? EncodeArray(type, ndim - 1, &sizes[1], data, w) : EncodeElement(type, data, w);
+    prop_error("EncodeArray", status);
+  }
+
+  return X_SUCCESS;
+}
+
+static int EncodeValue(const XField *f, XBuffer *w) {
+  if(!f->value) {
+    PutByte(w, MP_NIL);
+    return X_SUCCESS;
+  }
+
+  if(f->isSerialized) {
+    PutString(w, (char *) f->value, strlen((char *) f->value));
+    return X_SUCCESS;
+  }
+
+  if(f->ndim == 0) return EncodeElement(f->type, f->value, w);
+
+  switch(f->type) {
+    case X_BYTE:
+    case X_INT16:
+    case X_INT32:
+    case X_INT64:
+    case X_FLOAT:
+    case X_DOUBLE:
+      return EncodeNumericArray(f, w);
+    default:
+      return EncodeArray(f->type, f->ndim, xGetFieldSizes(f), (char *) f->value, w);
+  }
+}
+
+static int EncodeStruct(const XStructure *s, XBuffer *w) {
+  static const char *fn = "EncodeStruct";
+
+  const XField *f;
+
+  PutHeader(w, 0x80, 16, 0, MP_MAP16, xCountFields(s));
+
+  for(f = s->firstField; f != NULL; f = f->next) {
+    if(!f->name) return x_error(X_NAME_INVALID, EINVAL, fn, "field->name is NULL");
+    PutString(w, f->name, strlen(f->name));
+    prop_error(fn, EncodeValue(f, w));
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Converts structured data into its MessagePack representation, as a MessagePack map.
+ *
+ * @param s           Pointer to structured data
+ * @param[out] size   (bytes) Pointer to which to return the size of the MessagePack representation.
+ * @return            A newly allocated buffer with the MessagePack representation, or NULL if there was an
+ *                    error (errno will inform about the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xmsgpackDecode()
+ * @sa xjsonToString()
+ */
+void *xmsgpackEncode(const XStructure *s, size_t *size) {
+  static const char *fn = "xmsgpackEncode";
+
+  XBuffer w = {NULL};
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(!size) {
+    x_error(0, EINVAL, fn, "output size pointer is NULL");
+    return NULL;
+  }
+
+  if(EncodeStruct(s, &w) != X_SUCCESS) {
+    if(w.data) free(w.data);
+    return x_trace_null(fn, NULL);
+  }
+
+  *size = w.n;
+  return w.data;
+}
+
+static const unsigned char *GetBytes(MPReader *r, size_t m) {
+  const unsigned char *b;
+
+  if(m > r->size - r->n) {
+    x_error(0, EINVAL, "GetBytes", "unexpected end of data at byte %ld", (long) r->n);
+    return NULL;
+  }
+
+  b = &r->data[r->n];
+  r->n += m;
+  return b;
+}
+
+static int GetUInt(MPReader *r, int nBytes, unsigned long long *value) {
+  const unsigned char *b = GetBytes(r, nBytes);
+  int i;
+
+  if(!b) return X_PARSE_ERROR;
+
+  for(*value = 0, i = 0; i < nBytes; i++) *value = (*value << 8) | b[i];
+  return X_SUCCESS;
+}
+
+static int GetLength(MPReader *r, int nBytes, size_t *length) {
+  unsigned long long l = 0;
+  prop_error("GetLength", GetUInt(r, nBytes, &l));
+  *length = (size_t) l;
+  return X_SUCCESS;
+}
+
+/// Reads the header of the next MessagePack object, including the value of scalars.
+static int ReadHeader(MPReader *r, MPHeader *h) {
+  static const char *fn = "ReadHeader";
+
+  const unsigned char *b = GetBytes(r, 1);
+  unsigned long long u = 0;
+  int code;
+
+  if(!b) return X_PARSE_ERROR;
+
+  code = *b;
+  memset(h, 0, sizeof(*h));
+
+  if(code < 0x80 || code >= 0xe0) {
+    h->kind = X_INT32;
+    h->i = (code < 0x80) ? code : code - 0x100;
+    return X_SUCCESS;
+  }
+  if(code < 0x90) {
+    h->kind = MP_KIND_MAP;
+    h->length = code & 0xf;
+    return X_SUCCESS;
+  }
+  if(code < 0xa0) {
+    h->kind = MP_KIND_ARRAY;
+    h->length = code & 0xf;
+    return X_SUCCESS;
+  }
+  if(code < 0xc0) {
+    h->kind = X_STRING;
+    h->length = code & 0x1f;
+    return X_SUCCESS;
+  }
+
+  switch(code) {
+    case MP_NIL: h->kind = X_UNKNOWN; return X_SUCCESS;
+    case MP_FALSE:
+    case MP_TRUE: h->kind = X_BOOLEAN; h->i = (code == MP_TRUE); return X_SUCCESS;
+
+    case MP_BIN8:
+    case MP_BIN16:
+    case MP_BIN32:
+      h->kind = MP_KIND_BIN;
+      return GetLength(r, 1 << (code - MP_BIN8), &h->length);
+
+    case MP_EXT8:
+    case MP_EXT16:
+    case MP_EXT32:
+      h->kind = MP_KIND_EXT;
+      prop_error(fn, GetLength(r, 1 << (code - MP_EXT8), &h->length));
+      if(!(b = GetBytes(r, 1))) return X_PARSE_ERROR;
+      h->extType = (char) *b;
+      return X_SUCCESS;
+
+    case MP_FLOAT32: {
+      unsigned int u32;
+      float x;
+      prop_error(fn, GetUInt(r, 4, &u));
+      u32 = (unsigned int) u;
+      memcpy(&x, &u32, sizeof(x));
+      h->kind = X_FLOAT;
+      h->d = x;
+      return X_SUCCESS;
+    }
+
+    case MP_FLOAT64:
+      prop_error(fn, GetUInt(r, 8, &u));
+      memcpy(&h->d, &u, sizeof(h->d));
+      h->kind = X_DOUBLE;
+      return X_SUCCESS;
+
+    case MP_UINT8:
+    case MP_UINT16:
+    case MP_UINT32:
+    case MP_UINT64:
+      prop_error(fn, GetUInt(r, 1 << (code - MP_UINT8), &u));
+      if(u > (unsigned long long) INT64_MAX) {
+        h->kind = MP_KIND_UINT64;
+        h->d = (double) u;
+      }
+      else {
+        h->i = (long long) u;
+        h->kind = (h->i == (int32_t) h->i) ? X_INT32 : X_INT64;
+      }
+      return X_SUCCESS;
+
+    case MP_INT8:
+    case MP_INT16:
+    case MP_INT32:
+    case MP_INT64: {
+      const int nBytes = 1 << (code - MP_INT8);
+      prop_error(fn, GetUInt(r, nBytes, &u));
+      if(nBytes < 8 && (u & (1ULL << (8 * nBytes - 1)))) u |= ~0ULL << (8 * nBytes);    // sign extend
+      h->i = (long long) u;
+      h->kind = (h->i == (int32_t) h->i) ? X_INT32 : X_INT64;
+      return X_SUCCESS;
+    }
+
+    case MP_STR8:
+    case MP_STR16:
+    case MP_STR32:
+      h->kind = X_STRING;
+      return GetLength(r, 1 << (code - MP_STR8), &h->length);
+
+    case MP_ARRAY16:
+    case MP_ARRAY32:
+      h->kind = MP_KIND_ARRAY;
+      return GetLength(r, 2 << (code - MP_ARRAY16), &h->length);
+
+    case MP_MAP16:
+    case MP_MAP32:
+      h->kind = MP_KIND_MAP;
+      return GetLength(r, 2 << (code - MP_MAP16), &h->length);
+
+    default:
+      if(code >= MP_FIXEXT1 && code <= MP_FIXEXT16) {
+        h->kind = MP_KIND_EXT;
+        h->length = 1 << (code - MP_FIXEXT1);
+        if(!(b = GetBytes(r, 1))) return X_PARSE_ERROR;
+        h->extType = (char) *b;
+        return X_SUCCESS;
+      }
+  }
+
+  return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid MessagePack code 0x%02x at byte %ld", code, (long) r->n - 1);
+}
+
+/// Parses the dimensions in the payload of our typed array extension.
+static int ReadExtDims(MPReader *r, const MPHeader *h, int *ndim, int *sizes) {
+  static const char *fn = "ReadExtDims";
+
+  const int eSize = xElementSizeOf(h->extType);
+  const unsigned char *b;
+  long count;
+  int i;
+
+  switch(h->extType) {
+    case X_BYTE:
+    case X_INT16:
+    case X_INT32:
+    case X_INT64:
+    case X_FLOAT:
+    case X_DOUBLE:
+      break;
+    default:
+      return x_error(X_TYPE_INVALID, EINVAL, fn, "unsupported MessagePack extension type %d", h->extType);
+  }
+
+  if(h->length < 1 || !(b = GetBytes(r, 1))) return x_error(X_PARSE_ERROR, EINVAL, fn, "missing extension dimensions");
+
+  *ndim = *b;
+  if(*ndim < 1 || *ndim > X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid ndim: %d", *ndim);
+  if(h->length < (size_t) (1 + 4 * *ndim)) return x_error(X_PARSE_ERROR, EINVAL, fn, "truncated extension dimensions");
+
+  if(!(b = GetBytes(r, 4 * *ndim))) return X_PARSE_ERROR;
+
+  for(i = 0; i < *ndim; i++, b += 4) {
+    sizes[i] = b[0] | (b[1] << 8) | (b[2] << 16) | ((unsigned int) b[3] << 24);
+    if(sizes[i] < 0) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid size: %d", sizes[i]);
+  }
+
+  count = xGetElementCount(*ndim, sizes);
+  if(count < 0 || count > X_MAX_ELEMENTS || h->length != (size_t) (1 + 4 * *ndim + count * eSize))
+    return x_error(X_SIZE_INVALID, EINVAL, fn, "extension size mismatch");
+
+  return X_SUCCESS;
+}
+
+static int Skip(MPReader *r, size_t m) {
+  return GetBytes(r, m) ? X_SUCCESS : X_PARSE_ERROR;
+}
+
+static XType GetCommonType(XType t1, XType t2) {
+  if(t1 == t2) return t1;
+  if(t1 == X_UNKNOWN) return t2;
+  if(t2 == X_UNKNOWN) return t1;
+  if(t1 == X_FIELD || t2 == X_FIELD) return X_FIELD;
+  if(t1 == X_STRUCT || t2 == X_STRUCT) return X_FIELD;
+  if(t1 == X_STRING || t2 == X_STRING) return X_FIELD;
+  if(t1 == X_DOUBLE || t2 == X_DOUBLE) return X_DOUBLE;
+  if(t1 == X_FLOAT || t2 == X_FLOAT) return X_FLOAT;
+  if(t1 == X_INT64 || t2 == X_INT64) return X_INT64;
+  if(t1 == X_INT32 || t2 == X_INT32) return X_INT32;
+  if(t1 == X_INT16 || t2 == X_INT16) return X_INT16;
+  return X_BYTE;
+}
+
+/**
+ * Determines the type and shape of the next MessagePack object, and skips over it, without allocating anything.
+ * Arrays, whose elements all have the same shape, and compatible types, are arrays of the common type. Otherwise
+ * they are heterogeneous (X_FIELD) arrays.
+ */
+static int Survey(MPReader *r, XType *type, int *ndim, int *sizes) {
+  static const char *fn = "Survey";
+
+  MPHeader h;
+  size_t i;
+
+  *ndim = 0;
+
+  prop_error(fn, ReadHeader(r, &h));
+
+  switch(h.kind) {
+    case MP_KIND_MAP:
+      *type = X_STRUCT;
+      for(i = 0; i < 2 * h.length; i++) {
+        int n, s[X_MAX_DIMS];
+        XType t;
+        prop_error(fn, Survey(r, &t, &n, s));
+      }
+      return X_SUCCESS;
+
+    case MP_KIND_ARRAY: {
+      int n, s[X_MAX_DIMS];
+      XType t;
+
+      *type = X_UNKNOWN;
+
+      for(i = 0; i < h.length; i++) {
+        prop_error(fn, Survey(r, &t, &n, s));
+
+        if(*type == X_FIELD) continue;
+
+        if(n >= X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "too many array dimensions");
+
+        if(i == 0) {
+          *type = t;
+          *ndim = n;
+          memcpy(&sizes[1], s, n * sizeof(int));
+        }
+        else if(n != *ndim || memcmp(&sizes[1], s, n * sizeof(int))) *type = X_FIELD;
+        else *type = GetCommonType(*type, t);
+      }
+
+      if(h.length > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "array too large: %ld", (long) h.length);
+
+      if(*type == X_FIELD) *ndim = 0;
+
+      sizes[0] = h.length;
+      (*ndim)++;
+      return X_SUCCESS;
+    }
+
+    case MP_KIND_EXT:
+      *type = h.extType;
+      prop_error(fn, ReadExtDims(r, &h, ndim, sizes));
+      return Skip(r, h.length - 1 - 4 * *ndim);
+
+    case MP_KIND_BIN:
+      *type = X_BYTE;
+      *ndim = 1;
+      sizes[0] = h.length;
+      if(h.length > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "bin too large: %ld", (long) h.length);
+      return Skip(r, h.length);
+
+    case X_STRING:
+      *type = X_STRING;
+      return Skip(r, h.length);
+
+    case MP_KIND_UINT64:
+      *type = X_DOUBLE;
+      return X_SUCCESS;
+
+    default:
+      *type = h.kind;
+      return X_SUCCESS;
+  }
+}
+
+static void StoreInt(XType type, void *dst, long long value) {
+  switch(type) {
+    case X_BOOLEAN: *(boolean *) dst = (value != 0); break;
+    case X_BYTE: *(int8_t *) dst = (int8_t) value; break;
+    case X_INT16: *(int16_t *) dst = (int16_t) value; break;
+    case X_INT32: *(int32_t *) dst = (int32_t) value; break;
+    case X_INT64: *(int64_t *) dst = (int64_t) value; break;
+    case X_FLOAT: *(float *) dst = (float) value; break;
+    case X_DOUBLE: *(double *) dst = (double) value; break;
+  }
+}
+
+static void StoreDouble(XType type, void *dst, double value) {
+  if(type == X_FLOAT) *(float *) dst = (float) value;
+  else *(double *) dst = value;
+}
+
+/// Converts little-endian data of one numerical type into native data of the same or a wider type.
+static void ConvertElements(XType from, const unsigned char *src, long count, XType to, char *dst) {
+  const int eSize = xElementSizeOf(from);
+  const int dSize = xElementSizeOf(to);
+  long k;
+
+  for(k = 0; k < count; k++, src += eSize, dst += dSize) {
+    unsigned long long u = 0;
+    int i;
+
+    for(i = eSize; --i >= 0; ) u = (u << 8) | src[i];
+
+    switch(from) {
+      case X_BYTE: StoreInt(to, dst, (int8_t) u); break;
+      case X_INT16: StoreInt(to, dst, (int16_t) u); break;
+      case X_INT32: StoreInt(to, dst, (int32_t) u); break;
+      case X_INT64: StoreInt(to, dst, (int64_t) u); break;
+      case X_FLOAT: {
+        unsigned int u32 = (unsigned int) u;
+        float x;
+        memcpy(&x, &u32, sizeof(x));
+        StoreDouble(to, dst, x);
+        break;
+      }
+      case X_DOUBLE: {
+        double x;
+        memcpy(&x, &u, sizeof(x));
+        StoreDouble(to, dst, x);
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * Decodes the next MessagePack object into a pre-allocated typed buffer, as the elements of the given type, and
+ * advances the buffer pointer past the elements written. The object must have been surveyed before, to be
+ * compatible with the type.
+ */
+static int DecodeInto(MPReader *r, XType type, char **dst) {
+  static const char *fn = "DecodeInto";
+
+  const int eSize = xElementSizeOf(type);
+  const unsigned char *b;
+  MPHeader h;
+  size_t i;
+
+  prop_error(fn, ReadHeader(r, &h));
+
+  switch(h.kind) {
+    case X_UNKNOWN:
+      break;
+
+    case X_BOOLEAN:
+    case X_INT32:
+    case X_INT64:
+      StoreInt(type, *dst, h.i);
+      break;
+
+    case X_FLOAT:
+    case X_DOUBLE:
+    case MP_KIND_UINT64:
+      StoreDouble(type, *dst, h.d);
+      break;
+
+    case X_STRING:
+      if(!(b = GetBytes(r, h.length))) return X_PARSE_ERROR;
+      *(char **) *dst = (char *) malloc(h.length + 1);
+      x_check_alloc(*(char **) *dst);
+      memcpy(*(char **) *dst, b, h.length);
+      (*(char **) *dst)[h.length] = '\0';
+      break;
+
+    case MP_KIND_MAP:
+      prop_error(fn, DecodeStruct(r, h.length, (XStructure *) *dst));
+      break;
+
+    case MP_KIND_ARRAY:
+      for(i = 0; i < h.length; i++) prop_error(fn, DecodeInto(r, type, dst));
+      return X_SUCCESS;
+
+    case MP_KIND_BIN:
+      if(!(b = GetBytes(r, h.length))) return X_PARSE_ERROR;
+      if(type == X_BYTE) memcpy(*dst, b, h.length);
+      else ConvertElements(X_BYTE, b, h.length, type, *dst);
+      *dst += h.length * eSize;
+      return X_SUCCESS;
+
+    case MP_KIND_EXT: {
+      int ndim, sizes[X_MAX_DIMS];
+      long count;
+
+      prop_error(fn, ReadExtDims(r, &h, &ndim, sizes));
+      count = xGetElementCount(ndim, sizes);
+      if(!(b = GetBytes(r, count * xElementSizeOf(h.extType)))) return X_PARSE_ERROR;
+
+      if(h.extType == type) {
+        memcpy(*dst, b, count * eSize);
+#ifdef X_BIG_ENDIAN_HOST
+        x_swap_bytes(*dst, eSize, count);
+#endif
+      }
+      else ConvertElements(h.extType, b, count, type, *dst);
+
+      *dst += count * eSize;
+      return X_SUCCESS;
+    }
+
+    default:
+      return x_error(X_TYPE_INVALID, EINVAL, fn, "unexpected MessagePack object");
+  }
+
+  *dst += eSize;
+  return X_SUCCESS;
+}
+
+/**
+ * Decodes the next MessagePack object as a newly allocated field value. It surveys the object first, and then
+ * decodes it straight into a buffer of the appropriate type and size.
+ */
+static void *DecodeValue(MPReader *r, XType *type, int *ndim, int *sizes) {
+  static const char *fn = "DecodeValue";
+
+  const size_t start = r->n;
+  long count;
+  int eSize;
+  char *value, *next;
+
+  if(Survey(r, type, ndim, sizes) != X_SUCCESS) return x_trace_null(fn, NULL);
+  if(*ndim == 0) sizes[0] = 1;
+
+  count = xGetElementCount(*ndim, sizes);
+  eSize = xElementSizeOf(*type);
+
+  // nil, or arrays without typed elements (e.g. empty arrays), have no value.
+  if(*type != X_FIELD && eSize <= 0) return NULL;
+
+  r->n = start;
+
+  if(*type == X_FIELD) {
+    // Heterogeneous array: decode each element as a field of its own
+    XField *array;
+    MPHeader h;
+    size_t i;
+    int n, dims[X_MAX_DIMS];
+
+    if(ReadHeader(r, &h) != X_SUCCESS) return x_trace_null(fn, NULL);
+
+    *ndim = 1;
+    sizes[0] = h.length;
+
+    array = (XField *) calloc(h.length ? h.length : 1, sizeof(XField));
+    x_check_alloc(array);
+
+    for(i = 0; i < h.length; i++) {
+      char idx[20];
+
+      // Name is . + 1-based index, e.g. ".1", ".2"...
+      sprintf(idx, ".%ld", (long) (i + 1));
+      array[i].name = x_copy_name(idx);
+
+      errno = 0;
+      array[i].value = DecodeValue(r, &array[i].type, &n, dims);
+
+      if((!array[i].value && errno == EINVAL) || xSetFieldDims(&array[i], n, dims) != X_SUCCESS) {
+        XField f = X_FIELD_INIT;
+        f.type = X_FIELD;
+        f.ndim = 1;
+        f.sizes[0] = i + 1;
+        f.value = array;
+        xClearField(&f);
+        return x_trace_null(fn, NULL);
+      }
+    }
+
+    return array;
+  }
+
+  value = next = (char *) calloc(count ? count : 1, eSize);
+  x_check_alloc(value);
+
+  if(DecodeInto(r, *type, &next) != X_SUCCESS) {
+    XField f = X_FIELD_INIT;
+    f.type = *type;
+    xSetFieldDims(&f, *ndim, sizes);
+    f.value = value;
+    xClearField(&f);
+    return x_trace_null(fn, NULL);
+  }
+
+  return value;
+}
+
+/// Decodes the fields of a MessagePack map, after the map header, into the supplied structure.
+static int DecodeStruct(MPReader *r, size_t nFields, XStructure *s) {
+  static const char *fn = "DecodeStruct";
+
+  XField *last = NULL;
+  size_t i;
+  int ndim, sizes[X_MAX_DIMS];
+
+  for(i = 0; i < nFields; i++) {
+    const unsigned char *b;
+    MPHeader key;
+    XField *f;
+
+    prop_error(fn, ReadHeader(r, &key));
+    if(key.kind != X_STRING) return x_error(X_NAME_INVALID, EINVAL, fn, "map key is not a string");
+    if(!(b = GetBytes(r, key.length))) return X_PARSE_ERROR;
+
+    f = x_append_new_field(s, &last);
+
+    f->name = (char *) malloc(key.length + 1);
+    x_check_alloc(f->name);
+    memcpy(f->name, b, key.length);
+    f->name[key.length] = '\0';
+    f->name = x_adopt_name(f->name);
+
+    errno = 0;
+    f->value = DecodeValue(r, &f->type, &ndim, sizes);
+    if(!f->value && errno == EINVAL) return x_trace(fn, f->name, X_PARSE_ERROR);
+    prop_error(fn, xSetFieldDims(f, ndim, sizes));
+  }
+
+  // Set the parent references of the immediate substructures
+  for(last = s->firstField; last != NULL; last = last->next) if(last->type == X_STRUCT && last->value) {
+    XStructure *sub = (XStructure *) last->value;
+    long k;
+    for(k = xGetFieldCount(last); --k >= 0; ) sub[k].parent = s;
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Creates structured data from its MessagePack representation, which must be a MessagePack map. Integers are
+ * decoded as `X_INT32` if they fit, or else as `X_INT64` (unsigned integers beyond the range of a signed 64-bit
+ * integer are decoded as `X_DOUBLE`). MessagePack `bin` objects are decoded as 1D `X_BYTE` arrays, and arrays
+ * of compatible scalars, or of equal shape arrays, are decoded into a single typed array of the common type.
+ * Other arrays are decoded as heterogeneous arrays (type `X_FIELD`).
+ *
+ * @param data    Pointer to the MessagePack representation
+ * @param size    (bytes) The number of bytes available in the buffer.
+ * @return        Newly created structured data, or NULL if there was an error (errno set to EINVAL).
+ *
+ * @since 1.1
+ *
+ * @sa xmsgpackEncode()
+ * @sa xjsonParseString()
+ */
+XStructure *xmsgpackDecode(const void *data, size_t size) {
+  static const char *fn = "xmsgpackDecode";
+
+  MPReader r = {NULL};
+  MPHeader h;
+  XStructure *s;
+
+  if(!data) {
+    x_error(0, EINVAL, fn, "input data is NULL");
+    return NULL;
+  }
+
+  r.data = (const unsigned char *) data;
+  r.size = size;
+
+  if(ReadHeader(&r, &h) != X_SUCCESS) return x_trace_null(fn, NULL);
+
+  if(h.kind != MP_KIND_MAP) {
+    x_error(0, EINVAL, fn, "expected a MessagePack map");
+    return NULL;
+  }
+
+  s = xCreateStruct();
+
+  if(DecodeStruct(&r, h.length, s) != X_SUCCESS) {
+    xDestroyStruct(s);
+    return x_trace_null(fn, NULL);
+  }
+
+  return s;
+}
@@ -0,0 +1,630 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * @brief   NumPy `.npy` file import / export for array fields.
+ *
+ *  The `.npy` format consists of a short magic string and version, a Python dictionary literal describing the
+ *  data type (`descr`), memory order (`fortran_order`), and dimensions (`shape`) of the array, padded to a
+ *  multiple of 64 bytes, followed by the raw binary array data. The XTypes are mapped to NumPy dtypes as:
+ *
+ *  | XType           | dtype      |
+ *  |-----------------|------------|
+ *  | `X_BOOLEAN`     | `b1`       |
+ *  | `X_BYTE`        | `i1`       |
+ *  | `X_INT16`       | `i2`       |
+ *  | `X_INT32`       | `i4`       |
+ *  | `X_INT64`       | `i8`       |
+ *  | `X_FLOAT`       | `f4`       |
+ *  | `X_DOUBLE`      | `f8`       |
+ *  | `X_CHARS(n)`    | `S<n>`     |
+ *
+ *  Arrays are written in the native byte order, and in C (row-major) order. When reading, unsigned integers are
+ *  promoted to the next wider signed type (or to `X_DOUBLE` for `u8`), non-native byte order is swapped, and
+ *  Fortran-ordered arrays are transposed into C order, as necessary.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define __XCHANGE_INTERNAL_API__        ///< Use internal definitions
+#include "xnpy.h"
+
+#ifndef TRUE
+#define TRUE 1          ///< Boolean 'true' in case it isn't already defined
+#endif
+
+#ifndef FALSE
+#define FALSE 0         ///< Boolean 'false' in case it isn't already defined
+#endif
+
+/// \cond PRIVATE
+#define NPY_MAGIC           "\x93NUMPY"     ///< Leading bytes of .npy files
+#define NPY_MAGIC_LEN       6               ///< Length of the magic string
+#define NPY_ALIGN           64              ///< (bytes) Alignment of the array data in .npy files
+#define NPY_MAX_HEADER      (1<<20)         ///< (bytes) Largest header we accept
+
+#if defined(X_BIG_ENDIAN_HOST)
+#  define NPY_NATIVE_ORDER  '>'             ///< Native byte order character
+#else
+#  define NPY_NATIVE_ORDER  '<'             ///< Native byte order character
+#endif
+
+/// Description of the array data in a .npy file
+typedef struct {
+  char kind;                ///< 'b' (boolean), 'i' (signed int), 'u' (unsigned int), 'f' (float), 'S' (bytes)
+  int size;                 ///< (bytes) Element size in the file
+  boolean swap;             ///< Whether the elements are in non-native byte order
+  boolean fortranOrder;     ///< Whether the array is stored in Fortran (column-major) order
+  XType type;               ///< The XType the elements are loaded as
+  int ndim;                 ///< Number of dimensions
+  int sizes[X_MAX_DIMS];    ///< Dimensions
+  size_t offset;            ///< (bytes) Offset of the array data in the file
+} NpyInfo;
+
+/// A field, whose value points into a memory mapped .npy file
+typedef struct {
+  XField field;             ///< The field (must be first)
+  void *base;               ///< Start of the memory mapped file, or NULL if the value was loaded into memory
+  size_t size;              ///< (bytes) Size of the memory mapping
+} NpyMapping;
+/// \endcond
+
+static const char *GetDescr(XType type, char *buf) {
+  char order = NPY_NATIVE_ORDER;
+  char kind = 'i';
+  int size = xElementSizeOf(type);
+
+  switch(type) {
+    case X_BOOLEAN: return "|b1";
+    case X_BYTE: return "|i1";
+    case X_INT16:
+    case X_INT32:
+    case X_INT64: break;
+    case X_FLOAT:
+    case X_DOUBLE: kind = 'f'; break;
+    default:
+      if(!xIsCharSequence(type)) return NULL;
+      order = '|';
+      kind = 'S';
+  }
+
+  sprintf(buf, "%c%c%d", order, kind, size);
+  return buf;
+}
+
+static int WriteData(const XField *f, FILE *fp) {
+  static const char *fn = "WriteData";
+
+  const long count = xGetFieldCount(f);
+  char buf[20], header[256 + 22 * X_MAX_DIMS + NPY_ALIGN];
+  const char *descr = GetDescr(f->type, buf);
+  unsigned char preamble[10];
+  const int nPre = 10;          // Our headers are short, so the 16-bit header length of version 1.0 suffices.
+  int i, n, total, pad;
+
+  if(!descr) return x_error(X_TYPE_INVALID, EINVAL, fn, "type '%c' has no NumPy equivalent", xTypeChar(f->type));
+
+  n = sprintf(header, "{'descr': '%s', 'fortran_order': False, 'shape': (", descr);
+  for(i = 0; i < f->ndim; i++) n += sprintf(&header[n], (i > 0) ? ", %d" : "%d", xGetFieldSizes(f)[i]);
+  n += sprintf(&header[n], "%s), }", f->ndim == 1 ? "," : "");
+
+  total = nPre + n + 1;
+  pad = (NPY_ALIGN - total % NPY_ALIGN) % NPY_ALIGN;
+  memset(&header[n], ' ', pad);
+  n += pad;
+  header[n++] = '\n';
+
+  memcpy(preamble, NPY_MAGIC, NPY_MAGIC_LEN);
+  preamble[6] = 1;
+  preamble[7] = 0;
+  preamble[8] = n & 0xff;         // little-endian header length
+  preamble[9] = n >> 8;
+
+  if(fwrite(preamble, 1, nPre, fp) != (size_t) nPre || fwrite(header, 1, n, fp) != (size_t) n)
+    return x_error(X_FAILURE, errno, fn, "write error: %s", strerror(errno));
+
+  if(f->type == X_BOOLEAN) {
+    // NumPy booleans are single bytes...
+    const boolean *b = (const boolean *) f->value;
+    unsigned char *bytes = (unsigned char *) malloc(count > 0 ? count : 1);
+    long k;
+
+    x_check_alloc(bytes);
+    for(k = 0; k < count; k++) bytes[k] = b[k] ? 1 : 0;
+
+    n = (fwrite(bytes, 1, count, fp) == (size_t) count);
+    free(bytes);
+  }
+  else n = (fwrite(f->value, xElementSizeOf(f->type), count, fp) == (size_t) count);
+
+  if(!n) return x_error(X_FAILURE, errno, fn, "write error: %s", strerror(errno));
+
+  return X_SUCCESS;
+}
+
+/**
+ * Writes a numerical, boolean, or fixed-length character array field into a NumPy `.npy` file, which can then be
+ * loaded in Python with `numpy.load()`. Serialized fields are deserialized (on a copy) before writing.
+ *
+ * @param f           Pointer to a field
+ * @param fileName    The name / path of the file to write.
+ * @return            X_SUCCESS (0) if successful, or else X_NULL if an argument is NULL, X_TYPE_INVALID if the
+ *                    type of the field has no NumPy equivalent, or X_FAILURE if the file could not be written
+ *                    (errno set).
+ *
+ * @since 1.1
+ *
+ * @sa xnpyRead()
+ * @sa xnpyMap()
+ */
+int xnpyWrite(const XField *f, const char *fileName) {
+  static const char *fn = "xnpyWrite";
+
+  XField *copy = NULL;
+  FILE *fp;
+  int status;
+
+  if(!f) return x_error(X_NULL, EINVAL, fn, "input field is NULL");
+  if(!fileName) return x_error(X_NULL, EINVAL, fn, "input file name is NULL");
+  if(!f->value) return x_error(X_NULL, EINVAL, fn, "field has NULL value");
+
+  if(f->isSerialized) {
+    copy = xCopyOfField(f);
+    if(!copy) return x_trace(fn, f->name, X_FAILURE);
+
+    status = xDeserializeField(copy);
+    if(status != X_SUCCESS) {
+      xDestroyField(copy);
+      return x_trace(fn, f->name, status);
+    }
+    f = copy;
+  }
+
+  fp = fopen(fileName, "wb");
+  if(!fp) {
+    if(copy) xDestroyField(copy);
+    return x_error(X_FAILURE, errno, fn, "could not open %s: %s", fileName, strerror(errno));
+  }
+
+  status = WriteData(f, fp);
+  if(fclose(fp) != 0 && status == X_SUCCESS) status = x_error(X_FAILURE, errno, fn, "write error: %s", strerror(errno));
+  if(copy) xDestroyField(copy);
+
+  prop_error(fn, status);
+  return X_SUCCESS;
+}
+
+/// Returns a pointer to the value of the specified key in the header dictionary, or NULL if not found.
+static const char *FindKey(const char *header, const char *key) {
+  const size_t l = strlen(key);
+  const char *p;
+
+  for(p = strstr(header, key); p != NULL; p = strstr(p + 1, key)) {
+    if(p > header && (p[-1] == '\'' || p[-1] == '"') && p[l] == p[-1]) {
+      p += l + 1;
+      while(*p == ' ') p++;
+      if(*p != ':') return NULL;
+      p++;
+      while(*p == ' ') p++;
+      return p;
+    }
+  }
+
+  return NULL;
+}
+
+static int ParseHeader(const char *header, NpyInfo *info) {
+  static const char *fn = "ParseHeader";
+
+  const char *p;
+  char quote, order;
+  char *end;
+
+  // descr, e.g. '<f8'
+  p = FindKey(header, "descr");
+  if(!p || (*p != '\'' && *p != '"')) return x_error(X_PARSE_ERROR, EINVAL, fn, "missing or unsupported 'descr'");
+  quote = *(p++);
+
+  order = '|';
+  if(*p == '<' || *p == '>' || *p == '|' || *p == '=') order = *(p++);
+  info->kind = *(p++);
+  info->size = (int) strtol(p, &end, 10);
+  if(end == p || *end != quote || info->size <= 0) return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid 'descr'");
+
+  info->swap = (info->size > 1 && (order == '<' || order == '>') && order != NPY_NATIVE_ORDER);
+
+  switch(info->kind) {
+    case 'b':
+      if(info->size != 1) return x_error(X_TYPE_INVALID, EINVAL, fn, "unsupported boolean size: %d", info->size);
+      info->type = X_BOOLEAN;
+      break;
+    case 'i':
+      switch(info->size) {
+        case 1: info->type = X_BYTE; break;
+        case 2: info->type = X_INT16; break;
+        case 4: info->type = X_INT32; break;
+        case 8: info->type = X_INT64; break;
+        default: return x_error(X_TYPE_INVALID, EINVAL, fn, "unsupported integer size: %d", info->size);
+      }
+      break;
+    case 'u':
+      switch(info->size) {
+        case 1: info->type = X_INT16; break;
+        case 2: info->type = X_INT32; break;
+        case 4: info->type = X_INT64; break;
+        case 8: info->type = X_DOUBLE; break;
+        default: return x_error(X_TYPE_INVALID, EINVAL, fn, "unsupported unsigned size: %d", info->size);
+      }
+      break;
+    case 'f':
+      if(info->size == 4) info->type = X_FLOAT;
+      else if(info->size == 8) info->type = X_DOUBLE;
+      else return x_error(X_TYPE_INVALID, EINVAL, fn, "unsupported float size: %d", info->size);
+      break;
+    case 'S':
+    case 'a':
+      info->kind = 'S';
+      info->swap = FALSE;
+      info->type = X_CHARS(info->size);
+      break;
+    default:
+      return x_error(X_TYPE_INVALID, EINVAL, fn, "unsupported dtype kind: '%c'", info->kind);
+  }
+
+  // fortran_order
+  p = FindKey(header, "fortran_order");
+  if(!p) return x_error(X_PARSE_ERROR, EINVAL, fn, "missing 'fortran_order'");
+  if(!strncmp(p, "True", 4)) info->fortranOrder = TRUE;
+  else if(!strncmp(p, "False", 5)) info->fortranOrder = FALSE;
+  else return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid 'fortran_order'");
+
+  // shape, e.g. (2, 3)
+  p = FindKey(header, "shape");
+  if(!p || *p != '(') return x_error(X_PARSE_ERROR, EINVAL, fn, "missing 'shape'");
+
+  for(p++, info->ndim = 0; ; ) {
+    long l;
+
+    while(*p == ' ') p++;
+    if(*p == ')') break;
+
+    if(info->ndim >= X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "too many dimensions");
+
+    l = strtol(p, &end, 10);
+    if(end == p || l < 0 || l > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "invalid 'shape'");
+    info->sizes[info->ndim++] = (int) l;
+
+    for(p = end; *p == ' '; p++);
+    if(*p == ',') p++;
+    else if(*p != ')') return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid 'shape'");
+  }
+
+  if(xGetElementCount(info->ndim, info->sizes) > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "array too large");
+
+  return X_SUCCESS;
+}
+
+/// Reads and parses the preamble and header of a .npy file.
+static int ReadHeader(FILE *fp, NpyInfo *info) {
+  static const char *fn = "ReadHeader";
+
+  unsigned char preamble[12];
+  size_t nPre, len = 0, i;
+  char *header;
+  int status;
+
+  if(fread(preamble, 1, 10, fp) != 10 || memcmp(preamble, NPY_MAGIC, NPY_MAGIC_LEN) != 0)
+    return x_error(X_PARSE_ERROR, EINVAL, fn, "not a .npy file");
+
+  switch(preamble[6]) {
+    case 1: nPre = 10; break;
+    case 2:
+    case 3: nPre = 12; break;
+    default: return x_error(X_PARSE_ERROR, EINVAL, fn, "unsupported .npy version %d.%d", preamble[6], preamble[7]);
+  }
+
+  if(nPre > 10 && fread(&preamble[10], 1, 2, fp) != 2) return x_error(X_PARSE_ERROR, EINVAL, fn, "truncated .npy file");
+  for(i = nPre; --i >= 8; ) len = (len << 8) | preamble[i];
+
+  if(len > NPY_MAX_HEADER) return x_error(X_PARSE_ERROR, EINVAL, fn, "header too large: %zu bytes", len);
+
+  header = (char *) malloc(len + 1);
+  x_check_alloc(header);
+
+  if(fread(header, 1, len, fp) != len) {
+    free(header);
+    return x_error(X_PARSE_ERROR, EINVAL, fn, "truncated .npy header");
+  }
+  header[len] = '\0';
+
+  status = ParseHeader(header, info);
+  free(header);
+  prop_error(fn, status);
+
+  info->offset = nPre + len;
+  return X_SUCCESS;
+}
+
+/// Whether the file data can be used as is, without conversion.
+static boolean IsDirect(const NpyInfo *info) {
+  return !info->swap && !info->fortranOrder && (info->kind == 'i' || info->kind == 'f' || info->kind == 'S');
+}
+
+/// Converts raw file data (in place, where possible) to a native C-ordered array of the field's type.
+static void *Convert(void *raw, const NpyInfo *info) {
+  const long count = xGetElementCount(info->ndim, info->sizes);
+  const int eSize = xElementSizeOf(info->type);
+  void *data = raw;
+  long i;
+
+  if(info->swap) x_swap_bytes(raw, info->size, count);
+
+  if(info->kind == 'b' || info->kind == 'u') {
+    data = calloc(count > 0 ? count : 1, eSize);
+    x_check_alloc(data);
+
+    for(i = 0; i < count; i++) {
+      const unsigned char *src = (const unsigned char *) raw + i * info->size;
+
+      switch(info->type) {
+        case X_BOOLEAN: ((boolean *) data)[i] = (*src != 0); break;
+        case X_INT16: ((int16_t *) data)[i] = *src; break;
+        case X_INT32: ((int32_t *) data)[i] = *(const uint16_t *) src; break;
+        case X_INT64: ((int64_t *) data)[i] = *(const uint32_t *) src; break;
+        case X_DOUBLE: ((double *) data)[i] = (double) *(const uint64_t *) src; break;
+      }
+    }
+
+    free(raw);
+  }
+
+  if(info->fortranOrder && info->ndim > 1) {
+    // Transpose to C order: element (i0, i1, ...) is at offset i0 + n0 * (i1 + n1 * (...)) in Fortran order.
+    char *c = (char *) malloc(count > 0 ? count * eSize : 1);
+    int idx[X_MAX_DIMS] = {0};
+
+    x_check_alloc(c);
+
+    for(i = 0; i < count; i++) {
+      long offset = 0;
+      int k;
+
+      for(k = info->ndim; --k >= 0; ) offset = offset * info->sizes[k] + idx[k];
+      memcpy(&c[i * eSize], (char *) data + offset * eSize, eSize);
+
+      // Next C-order index (last index varies fastest)
+      for(k = info->ndim; --k >= 0; ) {
+        if(++idx[k] < info->sizes[k]) break;
+        idx[k] = 0;
+      }
+    }
+
+    free(data);
+    data = c;
+  }
+
+  return data;
+}
+
+static XField *CreateField(const char *name, const NpyInfo *info, void *value) {
+  XField *f = xCreateField(name, info->type, info->ndim, info->sizes, NULL);
+  if(!f) {
+    if(value) free(value);
+    return x_trace_null("CreateField", name);
+  }
+  f->value = value;
+  return f;
+}
+
+/**
+ * Loads a NumPy `.npy` file into a new field. The array data is read into a single buffer of the exact size,
+ * and converted as necessary (for byte order, unsigned types, booleans, or Fortran order).
+ *
+ * @param fileName    The name / path of the .npy file.
+ * @param name        The name of the returned field.
+ * @return            A newly created field containing the array from the file, or NULL if there was an error
+ *                    (errno will indicate the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xnpyMap()
+ * @sa xnpyWrite()
+ */
+XField *xnpyRead(const char *fileName, const char *name) {
+  static const char *fn = "xnpyRead";
+
+  NpyInfo info = {0};
+  XField *f;
+  FILE *fp;
+  void *raw;
+  long count;
+
+  if(!fileName) {
+    x_error(0, EINVAL, fn, "input file name is NULL");
+    return NULL;
+  }
+
+  if(!name) {
+    x_error(0, EINVAL, fn, "input name is NULL");
+    return NULL;
+  }
+
+  fp = fopen(fileName, "rb");
+  if(!fp) {
+    x_error(0, errno, fn, "could not open %s: %s", fileName, strerror(errno));
+    return NULL;
+  }
+
+  if(ReadHeader(fp, &info) != X_SUCCESS) {
+    fclose(fp);
+    return x_trace_null(fn, fileName);
+  }
+
+  count = xGetElementCount(info.ndim, info.sizes);
+  raw = malloc(count > 0 ? count * info.size : 1);
+  x_check_alloc(raw);
+
+  if(fread(raw, info.size, count, fp) != (size_t) count) {
+    free(raw);
+    fclose(fp);
+    x_error(0, EINVAL, fn, "truncated .npy data in %s", fileName);
+    return NULL;
+  }
+
+  fclose(fp);
+
+  f = CreateField(name, &info, IsDirect(&info) ? raw : Convert(raw, &info));
+  if(!f) return x_trace_null(fn, fileName);
+
+  return f;
+}
+
+/**
+ * Maps a NumPy `.npy` file into memory, and returns a field whose value points directly into the mapped array data,
+ * without reading or copying it. The mapping is private (copy-on-write), so the field's data may be modified in
+ * memory, without affecting the file. If the data cannot be used in place (booleans, unsigned types, non-native byte
+ * order, or Fortran order), the data is loaded into memory (as with xnpyRead()) instead.
+ *
+ * The returned field must be destroyed with xnpyUnmap(), and not with xDestroyField().
+ *
+ * @param fileName    The name / path of the .npy file.
+ * @param name        The name of the returned field.
+ * @return            A newly created field, with the array data from the file, or NULL if there was an error
+ *                    (errno will indicate the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xnpyUnmap()
+ * @sa xnpyRead()
+ */
+XField *xnpyMap(const char *fileName, const char *name) {
+  static const char *fn = "xnpyMap";
+
+  NpyInfo info = {0};
+  NpyMapping *m;
+  XField *f;
+  struct stat st;
+  FILE *fp;
+  char *base;
+  size_t payload;
+  int fd;
+
+  if(!fileName) {
+    x_error(0, EINVAL, fn, "input file name is NULL");
+    return NULL;
+  }
+
+  if(!name) {
+    x_error(0, EINVAL, fn, "input name is NULL");
+    return NULL;
+  }
+
+  fp = fopen(fileName, "rb");
+  if(!fp) {
+    x_error(0, errno, fn, "could not open %s: %s", fileName, strerror(errno));
+    return NULL;
+  }
+
+  if(ReadHeader(fp, &info) != X_SUCCESS) {
+    fclose(fp);
+    return x_trace_null(fn, fileName);
+  }
+  fclose(fp);
+
+  fd = open(fileName, O_RDONLY);
+  if(fd < 0) {
+    x_error(0, errno, fn, "could not open %s: %s", fileName, strerror(errno));
+    return NULL;
+  }
+
+  if(fstat(fd, &st) != 0) {
+    x_error(0, errno, fn, "could not stat %s: %s", fileName, strerror(errno));
+    close(fd);
+    return NULL;
+  }
+
+  payload = xGetElementCount(info.ndim, info.sizes) * info.size;
+  if((size_t) st.st_size < info.offset + payload) {
+    close(fd);
+    x_error(0, EINVAL, fn, "truncated .npy data in %s", fileName);
+    return NULL;
+  }
+
+  base = (char *) mmap(NULL, info.offset + payload, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if(base == MAP_FAILED) {
+    x_error(0, errno, fn, "could not map %s: %s", fileName, strerror(errno));
+    return NULL;
+  }
+
+  m = (NpyMapping *) calloc(1, sizeof(NpyMapping));
+  x_check_alloc(m);
+
+  f = CreateField(name, &info, NULL);
+  if(!f) {
+    munmap(base, info.offset + payload);
+    free(m);
+    return x_trace_null(fn, fileName);
+  }
+
+  m->field = *f;
+  m->field.pool = NULL;
+  x_free_field(f);
+
+  if(IsDirect(&info) && info.offset % info.size == 0) {
+    m->base = base;
+    m->size = info.offset + payload;
+    m->field.value = &base[info.offset];
+  }
+  else {
+    void *raw = malloc(payload > 0 ? payload : 1);
+    x_check_alloc(raw);
+    memcpy(raw, &base[info.offset], payload);
+    munmap(base, info.offset + payload);
+
+    m->field.value = IsDirect(&info) ? raw : Convert(raw, &info);
+  }
+
+  return &m->field;
+}
+
+/**
+ * Destroys a field that was returned by xnpyMap(), unmapping the underlying file (or freeing the data if it was
+ * loaded into memory instead).
+ *
+ * @param f     Pointer to a field returned by xnpyMap().
+ * @return      X_SUCCESS (0) if successful, or else X_NULL if the field is NULL, or X_FAILURE if the file could not
+ *              be unmapped (errno set).
+ *
+ * @since 1.1
+ *
+ * @sa xnpyMap()
+ */
+int xnpyUnmap(XField *f) {
+  static const char *fn = "xnpyUnmap";
+
+  NpyMapping *m = (NpyMapping *) f;
+  int status = X_SUCCESS;
+
+  if(!f) return x_error(X_NULL, EINVAL, fn, "input field is NULL");
+
+  if(m->base) {
+    if(munmap(m->base, m->size) != 0) status = x_error(X_FAILURE, errno, fn, "munmap() failed: %s", strerror(errno));
+    f->value = NULL;
+  }
+
+  xClearField(f);
+  free(m);
+
+  return status;
+}
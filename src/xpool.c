@@ -0,0 +1,495 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * \brief
+ *      Storage for the nodes (XField and XStructure) of structures: thread-local slab pools for the fast allocation
+ *      and release of individual nodes, contiguous blocks for the fields of packed structures, and the storage of
+ *      small values inside the fields themselves.
+ *
+ *      Each node records the storage it was allocated from in its private 'pool' member, so that it can be released
+ *      appropriately, regardless of whether pooling was enabled at the time the node was created.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <pthread.h>
+
+#define __XCHANGE_INTERNAL_API__      ///< Use internal definitions
+#include "xchange.h"
+
+#ifndef TRUE
+#  define TRUE  1                     ///< Boolean TRUE
+#endif
+
+#ifndef FALSE
+#  define FALSE 0                     ///< Boolean FALSE
+#endif
+
+/// \cond PRIVATE
+#define SLAB_NODES        256         ///< Number of nodes in a newly allocated slab
+#define BATCH_NODES       64          ///< Number of free nodes moved between a thread and the global pool at once
+
+/// A contiguous storage area for nodes: either a slab of a node pool, or the block of a packed structure.
+typedef struct XNodeStore {
+  char *start;                        ///< Address of the first node in the store
+  char *end;                          ///< Address just after the last node in the store
+  int refs;                           ///< Number of nodes still in use (blocks), or -1 for slabs, which are retained
+  struct XNodeStore *next;            ///< The next slab of the same pool
+} XNodeStore;
+
+/// (bytes) Size of the store header, such that nodes that follow it are suitably aligned
+#define STORE_HEADER      ((sizeof(XNodeStore) + 15) & ~((size_t) 15))
+
+/// A free node in a pool. It must not overlap with the 'pool' member of the nodes, which is retained while free.
+typedef struct XFreeNode {
+  struct XFreeNode *next;             ///< The next free node in the same batch / list
+  struct XFreeNode *nextBatch;        ///< (first node of a batch only) The next batch in the global pool
+  int count;                          ///< (first node of a batch only) The number of nodes in the batch
+} XFreeNode;
+
+/// The global pool of nodes of a given type
+typedef struct {
+  size_t size;                        ///< (bytes) Size of a node
+  size_t poolOffset;                  ///< (bytes) Offset of the node's 'pool' member
+  pthread_mutex_t mutex;              ///< Mutex for accessing the global batches and slabs
+  XFreeNode *batches;                 ///< Batches of free nodes returned by threads
+  XNodeStore *slabs;                  ///< All the slabs allocated for the pool
+} XNodePool;
+
+/// A thread's local cache of nodes of a given type
+typedef struct {
+  XFreeNode *free;                    ///< List of free nodes
+  int nFree;                          ///< Number of free nodes in the list
+  XNodeStore *slab;                   ///< The slab from which new nodes are carved
+  char *next;                         ///< The next unused node in the slab
+} XNodeCache;
+
+enum { FIELD_POOL, STRUCT_POOL, POOLS };
+/// \endcond
+
+static XNodePool pools[POOLS] = {
+        { sizeof(XField), offsetof(XField, pool), PTHREAD_MUTEX_INITIALIZER, NULL, NULL },
+        { sizeof(XStructure), offsetof(XStructure, pool), PTHREAD_MUTEX_INITIALIZER, NULL, NULL }
+};
+
+static boolean usePools = FALSE;
+static boolean useInline = FALSE;
+
+static __thread XNodeCache caches[POOLS];
+static __thread boolean isRegistered;
+
+static pthread_key_t cacheKey;
+static pthread_once_t keyOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * Enables or disables the pooled allocation of the nodes of structures (XField and XStructure). When enabled,
+ * xCreateField(), xCreateStruct(), xCopyOfField(), xCopyOfStruct() and the parsers / decoders of the library take
+ * new nodes from thread-local slabs, with good locality, and xDestroyField() / xDestroyStruct() return them to the
+ * pool for reuse (in batches to a global pool, if the thread accumulates many), rather than calling malloc() and
+ * free() for every node.
+ *
+ * Pooling is disabled by default, since pooled nodes must not be passed to free() directly. When enabled, the
+ * application must destroy fields only via xDestroyField() (or e.g. via xDestroyStruct()), and structures only via
+ * xDestroyStruct(), and never call free() on them. Nodes always remember where they were allocated from, so pooling
+ * may be enabled or disabled at any time.
+ *
+ * @param value     TRUE (non-zero) to enable pooled allocation of nodes, or FALSE (0) to disable it.
+ *
+ * @since 1.1
+ *
+ * @sa xIsNodePooling()
+ */
+void xSetNodePooling(boolean value) {
+  __atomic_store_n(&usePools, value ? TRUE : FALSE, __ATOMIC_RELAXED);
+}
+
+/**
+ * Checks if the pooled allocation of the nodes of structures is currently enabled.
+ *
+ * @return    TRUE (1) if pooled allocation of nodes is enabled, or else FALSE (0).
+ *
+ * @since 1.1
+ *
+ * @sa xSetNodePooling()
+ */
+boolean xIsNodePooling() {
+  return __atomic_load_n(&usePools, __ATOMIC_RELAXED);
+}
+
+static void **PoolOf(const XNodePool *p, void *node) {
+  return (void **) ((char *) node + p->poolOffset);
+}
+
+static void PushBatch(XNodePool *p, XFreeNode *first, int count) {
+  first->count = count;
+
+  pthread_mutex_lock(&p->mutex);
+  first->nextBatch = p->batches;
+  p->batches = first;
+  pthread_mutex_unlock(&p->mutex);
+}
+
+/**
+ * Returns all nodes cached by an exiting thread (including the unused remainder of its current slabs) to the global
+ * pools.
+ *
+ * @param arg   The thread's array of node caches
+ */
+static void FlushCaches(void *arg) {
+  XNodeCache *c = (XNodeCache *) arg;
+  int i;
+
+  for(i = 0; i < POOLS; i++) {
+    XNodePool *p = &pools[i];
+
+    if(c[i].slab) for(; c[i].next < c[i].slab->end; c[i].next += p->size) {
+      XFreeNode *n = (XFreeNode *) c[i].next;
+      *PoolOf(p, n) = c[i].slab;
+      n->next = c[i].free;
+      c[i].free = n;
+      c[i].nFree++;
+    }
+
+    if(c[i].free) PushBatch(p, c[i].free, c[i].nFree);
+    memset(&c[i], 0, sizeof(XNodeCache));
+  }
+
+  isRegistered = FALSE;
+}
+
+static void CreateCacheKey() {
+  pthread_key_create(&cacheKey, FlushCaches);
+}
+
+static XNodeCache *GetCache(int type) {
+  if(!isRegistered) {
+    // Make sure the thread returns its nodes when it exits.
+    pthread_once(&keyOnce, CreateCacheKey);
+    pthread_setspecific(cacheKey, caches);
+    isRegistered = TRUE;
+  }
+  return &caches[type];
+}
+
+static int Refill(XNodePool *p, XNodeCache *c) {
+  XNodeStore *slab;
+
+  // Take a batch of free nodes from the global pool, if available.
+  pthread_mutex_lock(&p->mutex);
+  c->free = p->batches;
+  if(c->free) p->batches = c->free->nextBatch;
+  pthread_mutex_unlock(&p->mutex);
+
+  if(c->free) {
+    c->nFree = c->free->count;
+    return X_SUCCESS;
+  }
+
+  // Otherwise, allocate a new slab.
+  slab = (XNodeStore *) malloc(STORE_HEADER + SLAB_NODES * p->size);
+  if(!slab) return X_FAILURE;
+
+  slab->start = (char *) slab + STORE_HEADER;
+  slab->end = slab->start + SLAB_NODES * p->size;
+  slab->refs = -1;
+
+  pthread_mutex_lock(&p->mutex);
+  slab->next = p->slabs;
+  p->slabs = slab;
+  pthread_mutex_unlock(&p->mutex);
+
+  c->slab = slab;
+  c->next = slab->start;
+
+  return X_SUCCESS;
+}
+
+static void *AllocNode(int type) {
+  XNodePool *p = &pools[type];
+  XNodeCache *c = GetCache(type);
+  void *node, *store;
+
+  if(!c->free && !(c->slab && c->next < c->slab->end)) if(Refill(p, c) != X_SUCCESS) return NULL;
+
+  if(c->free) {
+    node = c->free;
+    c->free = c->free->next;
+    c->nFree--;
+    store = *PoolOf(p, node);
+  }
+  else {
+    node = c->next;
+    c->next += p->size;
+    store = c->slab;
+  }
+
+  memset(node, 0, p->size);
+  *PoolOf(p, node) = store;
+
+  return node;
+}
+
+static void FreeNode(int type, void *node) {
+  XNodeCache *c = GetCache(type);
+  XFreeNode *n = (XFreeNode *) node;
+
+  n->next = c->free;
+  c->free = n;
+
+  if(++c->nFree >= 2 * BATCH_NODES) {
+    // Return a batch of free nodes to the global pool, for other threads to use.
+    XFreeNode *last = n;
+    int i;
+
+    for(i = 1; i < BATCH_NODES; i++) last = last->next;
+
+    c->free = last->next;
+    c->nFree -= BATCH_NODES;
+    last->next = NULL;
+
+    PushBatch(&pools[type], n, BATCH_NODES);
+  }
+}
+
+static boolean IsInStore(const XNodeStore *store, const void *node) {
+  return store && (const char *) node >= store->start && (const char *) node < store->end;
+}
+
+/**
+ * (<i>for internal use</i>) Allocates a new, zeroed, field node, from the thread's pool if pooling is enabled, or
+ * else individually.
+ *
+ * @return    A new zeroed field, or NULL if the allocation failed.
+ *
+ * @sa x_free_field()
+ * @sa xSetNodePooling()
+ */
+XField *x_alloc_field() {
+  if(!xIsNodePooling()) return (XField *) calloc(1, sizeof(XField));
+  return (XField *) AllocNode(FIELD_POOL);
+}
+
+/**
+ * (<i>for internal use</i>) Allocates a new, zeroed, field and appends it to a structure that is being built by a
+ * decoder, keeping the original order of fields. Decoders should append the field before filling it in, so that it
+ * is cleaned up together with the structure if decoding fails.
+ *
+ * @param s       The structure being built, which does not have an index yet.
+ * @param last    Pointer to the last field in the structure so far (NULL for an empty structure), which is
+ *                updated to the new field.
+ * @return        The new field, which is now the last field of the structure.
+ *
+ * @sa x_alloc_field()
+ */
+XField *x_append_new_field(XStructure *s, XField **last) {
+  XField *f = x_alloc_field();
+  x_check_alloc(f);
+
+  if(*last) (*last)->next = f;
+  else s->firstField = f;
+
+  *last = f;
+  return f;
+}
+
+/**
+ * (<i>for internal use</i>) Allocates a new, zeroed, structure node, from the thread's pool if pooling is enabled,
+ * or else individually.
+ *
+ * @return    A new zeroed structure, or NULL if the allocation failed.
+ *
+ * @sa x_free_struct()
+ * @sa xSetNodePooling()
+ */
+XStructure *x_alloc_struct() {
+  if(!xIsNodePooling()) return (XStructure *) calloc(1, sizeof(XStructure));
+  return (XStructure *) AllocNode(STRUCT_POOL);
+}
+
+/**
+ * (<i>for internal use</i>) Allocates a contiguous block of zeroed fields, e.g. for packing the fields of a
+ * structure. The block is freed once all the fields in it have been released with x_free_field().
+ *
+ * @param n   The number of fields in the block (&gt;0).
+ * @return    Pointer to the first field in the block, or NULL if the allocation failed.
+ *
+ * @sa xPackStruct()
+ */
+XField *x_alloc_fields(int n) {
+  XNodeStore *b = (XNodeStore *) malloc(STORE_HEADER + n * sizeof(XField));
+  XField *fields;
+  int i;
+
+  if(!b) return NULL;
+
+  fields = (XField *) ((char *) b + STORE_HEADER);
+  memset(fields, 0, n * sizeof(XField));
+
+  b->start = (char *) fields;
+  b->end = (char *) &fields[n];
+  b->refs = n;
+  b->next = NULL;
+
+  for(i = n; --i >= 0; ) fields[i].pool = b;
+
+  return fields;
+}
+
+/**
+ * (<i>for internal use</i>) Releases the storage of a field node, whose contents have already been cleared or moved
+ * elsewhere, according to how it was allocated.
+ *
+ * @param f   The field node
+ *
+ * @sa x_alloc_field()
+ * @sa x_alloc_fields()
+ */
+void x_free_field(XField *f) {
+  XNodeStore *store = (XNodeStore *) f->pool;
+
+  if(!IsInStore(store, f)) free(f);
+  else if(store->refs < 0) FreeNode(FIELD_POOL, f);
+  else if(__atomic_sub_fetch(&store->refs, 1, __ATOMIC_ACQ_REL) == 0) free(store);
+}
+
+/**
+ * (<i>for internal use</i>) Releases the storage of a structure node (or of an array of structures), whose contents
+ * have already been cleared or moved elsewhere, according to how it was allocated.
+ *
+ * @param s   The structure node, or the first structure in an array of structures.
+ *
+ * @sa x_alloc_struct()
+ */
+void x_free_struct(XStructure *s) {
+  if(IsInStore((XNodeStore *) s->pool, s)) FreeNode(STRUCT_POOL, s);
+  else free(s);
+}
+
+/**
+ * Enables or disables the storage of small values inside the fields themselves. When enabled, xCreateField() (and
+ * the convenience functions built on it, such as xCreateIntField() or xCreateStringField()), xCopyOfField() and the
+ * JSON parser store values of up to X_INLINE_VALUE_SIZE bytes (e.g. scalars), and single strings of up to
+ * X_INLINE_VALUE_SIZE - sizeof(char *) - 1 characters, in the private storage of the field, rather than in
+ * separately allocated memory. The field's `value` pointer then points inside the field, so values are accessed the
+ * same way regardless.
+ *
+ * Inline storage is disabled by default, since inline values must not be freed directly, and fields with inline
+ * values must not be moved or copied by assignment (e.g. `XField copy = *f;`), which would leave the copy pointing
+ * to the original's storage. When enabled, the application should release and replace field values only via the
+ * library functions, such as xClearField() or xDestroyField(), and use xCopyOfField() to copy fields. Values are
+ * released appropriately, regardless of whether inlining was enabled when they were assigned, so inlining may be
+ * enabled or disabled at any time.
+ *
+ * @param value     TRUE (non-zero) to store small values inside fields, or FALSE (0) to disable it.
+ *
+ * @since 1.1
+ *
+ * @sa xIsValueInlining()
+ */
+void xSetValueInlining(boolean value) {
+  __atomic_store_n(&useInline, value ? TRUE : FALSE, __ATOMIC_RELAXED);
+}
+
+/**
+ * Checks if small values are currently stored inside the fields themselves.
+ *
+ * @return    TRUE (1) if small values are stored inside new fields, or else FALSE (0).
+ *
+ * @since 1.1
+ *
+ * @sa xSetValueInlining()
+ */
+boolean xIsValueInlining() {
+  return __atomic_load_n(&useInline, __ATOMIC_RELAXED);
+}
+
+/**
+ * (<i>for internal use</i>) Checks if a pointer points inside the inline storage of a field.
+ *
+ * @param f     The field
+ * @param ptr   The pointer to check, e.g. the field's value.
+ * @return      TRUE (1) if the pointer points to the field's inline storage, or else FALSE (0).
+ *
+ * @sa x_alloc_value()
+ */
+boolean x_is_inline(const XField *f, const void *ptr) {
+  return (const char *) ptr >= f->local.bytes && (const char *) ptr < &f->local.bytes[X_INLINE_VALUE_SIZE];
+}
+
+/**
+ * (<i>for internal use</i>) Returns storage for the value of a field. Values that fit are stored inside the field
+ * itself if inlining is enabled. Otherwise, the storage is allocated dynamically, like with malloc().
+ *
+ * @param f     The field, which will hold the value.
+ * @param n     (bytes) The size of the value
+ * @return      Pointer to the (uninitialized) storage for the value, which must be released with x_free_value(), or
+ *              NULL if it could not be allocated.
+ *
+ * @sa x_free_value()
+ * @sa xSetValueInlining()
+ */
+void *x_alloc_value(XField *f, int n) {
+  if(n > 0 && n <= X_INLINE_VALUE_SIZE && xIsValueInlining()) return f->local.bytes;
+  return malloc(n);
+}
+
+/**
+ * (<i>for internal use</i>) Returns a copy of a string element for a field, whose value was obtained from
+ * x_alloc_value(). If the field holds a single inline string pointer, and the string fits in the remaining inline
+ * storage, the copy is also placed inside the field. Otherwise the copy is allocated dynamically.
+ *
+ * @param f     The field, whose (only) string element is assigned the copy.
+ * @param str   The string to copy, or NULL.
+ * @return      The copy of the string, which must be released with x_free_value(), or NULL if the string was NULL or
+ *              could not be allocated.
+ *
+ * @sa x_alloc_value()
+ */
+char *x_copy_element_string(XField *f, const char *str) {
+  if(str && f->value == f->local.bytes && xGetFieldCount(f) == 1) {
+    size_t l = strlen(str) + 1;
+    if(l <= X_INLINE_VALUE_SIZE - sizeof(char *)) {
+      char *dst = &f->local.bytes[sizeof(char *)];
+      memcpy(dst, str, l);
+      return dst;
+    }
+  }
+  return xStringCopyOf(str);
+}
+
+/**
+ * (<i>for internal use</i>) Releases the value of a field, or a string element in it, unless it is stored inside
+ * the field itself.
+ *
+ * @param f     The field that holds the value
+ * @param ptr   The value (or string element) to release, or NULL.
+ *
+ * @sa x_alloc_value()
+ */
+void x_free_value(const XField *f, void *ptr) {
+  if(ptr && !x_is_inline(f, ptr)) free(ptr);
+}
+
+/**
+ * (<i>for internal use</i>) Updates the references to inline storage in a field, whose contents (including the
+ * inline storage) were copied from another field, e.g. by assignment, such that they point to its own inline
+ * storage rather than to that of the original.
+ *
+ * @param f       The field, whose contents were copied from another
+ * @param from    The field, from which the contents were copied.
+ */
+void x_rebase_value(XField *f, const XField *from) {
+  if(!x_is_inline(from, f->value)) return;
+
+  f->value = &f->local.bytes[(const char *) f->value - from->local.bytes];
+
+  if((f->type == X_STRING || f->type == X_RAW) && !f->isSerialized) {
+    char **str = (char **) f->value;
+    if(x_is_inline(from, *str)) *str = &f->local.bytes[*str - from->local.bytes];
+  }
+}
@@ -0,0 +1,685 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ * @brief   RESP (Redis serialization protocol) encoder and decoder for structured data.
+ *
+ *  Structures are encoded as pipelined `HSET` commands, one per (sub)structure, following the Redis convention of
+ *  hierarchical keys. I.e., the fields of a structure are stored in a hash table keyed by the structure's aggregate
+ *  ID, and the fields of a substructure 'sub' under `<id>:sub` etc. Field values are stored in their string
+ *  representation: numerical and boolean arrays as space-separated lists of elements, and string arrays (and
+ *  references to the hash tables of substructure arrays) as `'\r'`-separated lists.
+ *
+ *  The decoder parses RESP2 and RESP3 replies (or commands) into fields, in a single pass over the raw data, copying
+ *  only the string payloads into the fields. Replies may be decoded one after the other from a buffer of pipelined
+ *  replies, and incomplete replies are detected, so more data may be read before trying again.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#define __XCHANGE_INTERNAL_API__        ///< Use internal definitions
+#include "xresp.h"
+
+#ifndef TRUE
+#define TRUE 1          ///< Boolean 'true' in case it isn't already defined
+#endif
+
+#ifndef FALSE
+#define FALSE 0         ///< Boolean 'false' in case it isn't already defined
+#endif
+
+/// \cond PRIVATE
+#define RESP_MAX_DEPTH      64          ///< Maximum nesting depth of aggregate replies
+#define RESP_ARRAY_SEP      '\r'        ///< Separator of string elements in field values
+
+typedef struct {
+  const char *data;         ///< The RESP data
+  size_t n;                 ///< (bytes) Number of bytes parsed so far
+  size_t size;              ///< (bytes) Total number of bytes available
+  int depth;                ///< Current nesting depth
+} RESPReader;
+/// \endcond
+
+static int DecodeItem(RESPReader *r, XField *f);
+
+static void PutHeader(XBuffer *w, char type, long long n) {
+  char buf[30];
+  x_buffer_put(w, buf, sprintf(buf, "%c%lld\r\n", type, n));
+}
+
+static void PutBulk(XBuffer *w, const char *str, size_t length) {
+  PutHeader(w, '$', (long long) length);
+  x_buffer_put(w, str, length);
+  x_buffer_put(w, "\r\n", 2);
+}
+
+static void PutElement(XBuffer *w, XType type, const void *ptr) {
+  char *buf;
+  int n = 0;
+
+  if(type < 0) {
+    const char *end = (const char *) memchr(ptr, '\0', -type);
+    x_buffer_put(w, ptr, end ? (size_t) (end - (const char *) ptr) : (size_t) -type);
+    return;
+  }
+
+  buf = (char *) x_buffer_reserve(w, 32);
+
+  switch(type) {
+    case X_BOOLEAN: n = sprintf(buf, "%s", *(const boolean *) ptr ? "true" : "false"); break;
+    case X_BYTE: n = sprintf(buf, "%d", *(const char *) ptr); break;
+    case X_INT16: n = sprintf(buf, "%d", *(const int16_t *) ptr); break;
+    case X_INT32: n = sprintf(buf, "%d", *(const int32_t *) ptr); break;
+    case X_INT64: n = sprintf(buf, "%lld", (long long) *(const int64_t *) ptr); break;
+    case X_FLOAT: n = xPrintFloat(buf, *(const float *) ptr); break;
+    case X_DOUBLE: n = xPrintDouble(buf, *(const double *) ptr); break;
+  }
+
+  w->n += n;
+}
+
+/// Prints the string representation of a field value into the writer.
+static int PrintValue(XBuffer *w, const XField *f, const char *id) {
+  static const char *fn = "PrintValue";
+
+  const long count = xGetFieldCount(f);
+  long i;
+
+  if(!f->value) return X_SUCCESS;
+
+  if(f->isSerialized) {
+    x_buffer_put(w, f->value, strlen((char *) f->value));
+    return X_SUCCESS;
+  }
+
+  switch(f->type) {
+    case X_STRING:
+    case X_RAW:
+      for(i = 0; i < count; i++) {
+        const char *str = ((char **) f->value)[i];
+        if(i) x_buffer_put(w, &(char){RESP_ARRAY_SEP}, 1);
+        if(str) x_buffer_put(w, str, strlen(str));
+      }
+      return X_SUCCESS;
+
+    case X_STRUCT:
+      // Reference(s) to the hash table(s) of the substructure(s)
+      for(i = 0; i < count; i++) {
+        char *buf;
+
+        if(i) x_buffer_put(w, &(char){RESP_ARRAY_SEP}, 1);
+
+        buf = (char *) x_buffer_reserve(w, strlen(id) + strlen(f->name) + 2 * X_SEP_LENGTH + 22);
+        if(f->ndim == 0) w->n += sprintf(buf, "%s" X_SEP "%s", id, f->name);
+        else w->n += sprintf(buf, "%s" X_SEP "%s" X_SEP "%ld", id, f->name, i);
+      }
+      return X_SUCCESS;
+
+    case X_FIELD: {
+      char *buf = (char *) x_buffer_reserve(w, strlen(id) + strlen(f->name) + X_SEP_LENGTH + 1);
+      w->n += sprintf(buf, "%s" X_SEP "%s", id, f->name);
+      return X_SUCCESS;
+    }
+
+    default:
+      if(xElementSizeOf(f->type) <= 0) return x_error(X_TYPE_INVALID, EINVAL, fn, "invalid type: %d", f->type);
+  }
+
+  for(i = 0; i < count; i++) {
+    if(i) x_buffer_put(w, xIsCharSequence(f->type) ? &(char){RESP_ARRAY_SEP} : " ", 1);
+    PutElement(w, f->type, (const char *) f->value + i * xElementSizeOf(f->type));
+  }
+
+  return X_SUCCESS;
+}
+
+/// Returns the first field in a structure's list, or in an array of fields.
+static const XField *FirstField(const XField *list, const XField *array, int count) {
+  if(array) return count > 0 ? array : NULL;
+  return list;
+}
+
+/// Returns the next field in a structure's list, or in an array of fields.
+static const XField *NextField(const XField *f, const XField *array, int count) {
+  if(array) return (f + 1 < array + count) ? f + 1 : NULL;
+  return f->next;
+}
+
+static int EncodeTable(XBuffer *w, XBuffer *scratch, const char *id, const XField *list, const XField *array,
+        int count, int *nCommands) {
+  static const char *fn = "EncodeTable";
+
+  const XField *f;
+  int n = 0;
+
+  for(f = FirstField(list, array, count); f != NULL; f = NextField(f, array, count)) n++;
+  if(n == 0) return X_SUCCESS;      // HSET needs at least one field.
+
+  PutHeader(w, '*', 2 + 2 * n);
+  PutBulk(w, "HSET", 4);
+  PutBulk(w, id, strlen(id));
+
+  for(f = FirstField(list, array, count); f != NULL; f = NextField(f, array, count)) {
+    if(!f->name) return x_error(X_NAME_INVALID, EINVAL, fn, "field->name is NULL");
+
+    scratch->n = 0;
+    prop_error(fn, PrintValue(scratch, f, id));
+
+    PutBulk(w, f->name, strlen(f->name));
+    PutBulk(w, (const char *) scratch->data, scratch->n);
+  }
+
+  (*nCommands)++;
+
+  // The hash tables of substructures, and of heterogeneous arrays
+  for(f = FirstField(list, array, count); f != NULL; f = NextField(f, array, count)) {
+    char *sub;
+    int status = X_SUCCESS;
+
+    if(!f->value || f->isSerialized || (f->type != X_STRUCT && f->type != X_FIELD)) continue;
+
+    sub = xGetAggregateID(id, f->name);
+    if(!sub) return x_trace(fn, f->name, X_FAILURE);
+
+    if(f->type == X_FIELD) {
+      status = EncodeTable(w, scratch, sub, NULL, (const XField *) f->value, xGetFieldCount(f), nCommands);
+    }
+    else if(f->ndim == 0) {
+      status = EncodeTable(w, scratch, sub, ((const XStructure *) f->value)->firstField, NULL, 0, nCommands);
+    }
+    else {
+      char *element = (char *) malloc(strlen(sub) + X_SEP_LENGTH + 22);
+      long i, nStructs = xGetFieldCount(f);
+
+      x_check_alloc(element);
+
+      for(i = 0; i < nStructs && status == X_SUCCESS; i++) {
+        sprintf(element, "%s" X_SEP "%ld", sub, i);
+        status = EncodeTable(w, scratch, element, ((const XStructure *) f->value)[i].firstField, NULL, 0, nCommands);
+      }
+
+      free(element);
+    }
+
+    free(sub);
+    if(status != X_SUCCESS) return x_trace(fn, f->name, status);
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Encodes a structure as a buffer of pipelined RESP `HSET` commands, ready to be sent to a Redis server. The fields
+ * of the structure are stored in the hash table of the given ID, while the fields of substructures are stored in
+ * separate hash tables, under the aggregate IDs of the substructures, e.g. `<id>:<name>` (or `<id>:<name>:<index>`
+ * for the elements of substructure arrays). The elements of heterogeneous arrays are stored as the fields of a hash
+ * table, in the same way as substructures.
+ *
+ * Field values are stored as strings. Numerical and boolean arrays are stored as space-separated lists of elements,
+ * whereas arrays of strings, as well as the IDs of the hash tables for substructure arrays, are separated by `'\r'`.
+ * Empty structures are not stored, since Redis has no empty hash tables.
+ *
+ * @param s               Pointer to structured data
+ * @param id              The Redis key (hash table name) for the structure, e.g. "system:subsystem".
+ * @param[out] size       (bytes) Pointer to which to return the number of bytes in the returned buffer.
+ * @param[out] nCommands  (optional) Pointer to which to return the number of commands in the buffer, i.e. the
+ *                        number of replies to expect from the server. It may be NULL if not needed.
+ * @return                A newly allocated buffer of pipelined RESP commands, or NULL if there was an error (errno
+ *                        will inform about the type of error).
+ *
+ * @since 1.1
+ *
+ * @sa xrespDecode()
+ */
+char *xrespEncodeHSET(const XStructure *s, const char *id, size_t *size, int *nCommands) {
+  static const char *fn = "xrespEncodeHSET";
+
+  XBuffer w = {NULL}, scratch = {NULL};
+  int n = 0, status;
+
+  if(!s) {
+    x_error(0, EINVAL, fn, "input structure is NULL");
+    return NULL;
+  }
+
+  if(!id || !id[0]) {
+    x_error(0, EINVAL, fn, "input id is NULL or empty");
+    return NULL;
+  }
+
+  if(!size) {
+    x_error(0, EINVAL, fn, "output size pointer is NULL");
+    return NULL;
+  }
+
+  x_buffer_reserve(&w, 0);     // Allocate, even if there is nothing to encode.
+
+  status = EncodeTable(&w, &scratch, id, s->firstField, NULL, 0, &n);
+  free(scratch.data);
+
+  if(status != X_SUCCESS) {
+    free(w.data);
+    return x_trace_null(fn, NULL);
+  }
+
+  *size = w.n;
+  if(nCommands) *nCommands = n;
+
+  return (char *) w.data;
+}
+
+/// Reads the rest of the current line (without the CRLF termination).
+static int ReadLine(RESPReader *r, const char **line, size_t *length) {
+  const char *start = &r->data[r->n];
+  const char *end = (const char *) memchr(start, '\r', r->size - r->n);
+
+  if(!end || end + 1 >= &r->data[r->size]) return X_INCOMPLETE;
+  if(end[1] != '\n') return x_error(X_PARSE_ERROR, EINVAL, "ReadLine", "missing LF after CR");
+
+  *line = start;
+  *length = end - start;
+  r->n += *length + 2;
+
+  return X_SUCCESS;
+}
+
+static int ParseInteger(const char *str, size_t length, long long *value) {
+  unsigned long long v = 0;
+  boolean isNegative = FALSE;
+  size_t i = 0;
+
+  if(length > 0 && (str[0] == '-' || str[0] == '+')) {
+    isNegative = (str[0] == '-');
+    i++;
+  }
+
+  if(i >= length || length - i > 19) return x_error(X_PARSE_ERROR, EINVAL, "ParseInteger", "invalid integer");
+
+  for(; i < length; i++) {
+    if(str[i] < '0' || str[i] > '9') return x_error(X_PARSE_ERROR, EINVAL, "ParseInteger", "invalid integer");
+    v = 10 * v + (str[i] - '0');
+  }
+
+  if(v > (unsigned long long) INT64_MAX + isNegative) return x_error(X_PARSE_ERROR, ERANGE, "ParseInteger", "integer out of range");
+
+  *value = isNegative ? (long long) (0 - v) : (long long) v;
+  return X_SUCCESS;
+}
+
+/// Sets a scalar string value (and optional subtype) for a field.
+static void SetString(XField *f, const char *str, size_t length, const char *subtype) {
+  char **value = (char **) malloc(sizeof(char *));
+  x_check_alloc(value);
+
+  value[0] = (char *) malloc(length + 1);
+  x_check_alloc(value[0]);
+  memcpy(value[0], str, length);
+  value[0][length] = '\0';
+
+  f->type = X_STRING;
+  f->value = value;
+  if(subtype) f->subtype = xStringCopyOf(subtype);
+}
+
+static void *NewScalar(XField *f, XType type) {
+  f->type = type;
+  f->value = malloc(xElementSizeOf(type));
+  x_check_alloc(f->value);
+  return f->value;
+}
+
+static void ClearFields(XField *array, long count) {
+  while(--count >= 0) xClearField(&array[count]);
+  free(array);
+}
+
+/// Determines the common type into which all elements of an array may be collapsed, or X_FIELD if none.
+static XType GetArrayType(const XField *e, long count) {
+  XType type = X_UNKNOWN;
+  boolean hasNull = FALSE;
+  long i;
+
+  for(i = 0; i < count; i++) {
+    if(e[i].ndim != 0 || e[i].subtype) return X_FIELD;
+
+    switch(e[i].type) {
+      case X_UNKNOWN: hasNull = TRUE; break;
+      case X_STRING:
+      case X_BOOLEAN:
+      case X_INT64:
+      case X_DOUBLE:
+        if(type == X_UNKNOWN) type = e[i].type;
+        else if(type == e[i].type) break;
+        else if((type == X_INT64 || type == X_DOUBLE) && (e[i].type == X_INT64 || e[i].type == X_DOUBLE)) type = X_DOUBLE;
+        else return X_FIELD;
+        break;
+      default: return X_FIELD;
+    }
+  }
+
+  // Only strings may have NULL elements
+  if(type == X_UNKNOWN || (hasNull && type != X_STRING)) return X_FIELD;
+
+  return type;
+}
+
+static int DecodeArray(RESPReader *r, long count, XField *f) {
+  static const char *fn = "DecodeArray";
+
+  XField *e;
+  XType type;
+  long i;
+
+  if(count > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "too many elements: %ld", count);
+
+  e = (XField *) calloc(count > 0 ? count : 1, sizeof(XField));
+  x_check_alloc(e);
+
+  for(i = 0; i < count; i++) {
+    char idx[20];
+    int status;
+
+    sprintf(idx, ".%ld", (i + 1));
+    e[i].name = x_copy_name(idx);
+
+    status = DecodeItem(r, &e[i]);
+    if(status != X_SUCCESS) {
+      ClearFields(e, i + 1);
+      return status;
+    }
+  }
+
+  f->ndim = 1;
+  f->sizes[0] = count;
+
+  type = GetArrayType(e, count);
+  if(type == X_FIELD) {
+    f->type = X_FIELD;
+    f->value = e;
+    return X_SUCCESS;
+  }
+
+  // Collapse into a typed array.
+  f->type = type;
+  f->value = calloc(count, xElementSizeOf(type));
+  x_check_alloc(f->value);
+
+  for(i = 0; i < count; i++) {
+    if(!e[i].value) continue;
+
+    switch(type) {
+      case X_STRING:
+        // Take over the string from the element
+        ((char **) f->value)[i] = *(char **) e[i].value;
+        *(char **) e[i].value = NULL;
+        break;
+      case X_DOUBLE:
+        ((double *) f->value)[i] = (e[i].type == X_INT64) ? (double) *(int64_t *) e[i].value : *(double *) e[i].value;
+        break;
+      default:
+        memcpy((char *) f->value + i * xElementSizeOf(type), e[i].value, xElementSizeOf(type));
+    }
+  }
+
+  ClearFields(e, count);
+  return X_SUCCESS;
+}
+
+/// Converts a decoded map key to a field name, taking over the string if possible.
+static char *GetKeyName(XField *key) {
+  char buf[30];
+
+  if(key->ndim == 0 && key->value) {
+    if(key->type == X_STRING) {
+      char *name = *(char **) key->value;
+      *(char **) key->value = NULL;
+      return name;
+    }
+    if(key->type == X_INT64) {
+      sprintf(buf, "%lld", (long long) *(int64_t *) key->value);
+      return xStringCopyOf(buf);
+    }
+  }
+
+  return NULL;
+}
+
+static int DecodeMap(RESPReader *r, long count, XStructure *s) {
+  static const char *fn = "DecodeMap";
+
+  XField *last = NULL;
+  long i;
+
+  for(i = 0; i < count; i++) {
+    XField key = X_FIELD_INIT, *f;
+    int status;
+
+    status = DecodeItem(r, &key);
+    if(status != X_SUCCESS) {
+      xClearField(&key);
+      return status;
+    }
+
+    f = x_append_new_field(s, &last);
+
+    f->name = x_adopt_name(GetKeyName(&key));
+    xClearField(&key);
+
+    if(!f->name || !f->name[0]) return x_error(X_NAME_INVALID, EINVAL, fn, "invalid map key");
+
+    prop_error(fn, DecodeItem(r, f));
+
+    if(f->type == X_STRUCT && f->value) ((XStructure *) f->value)->parent = s;
+  }
+
+  return X_SUCCESS;
+}
+
+static int DecodeAggregate(RESPReader *r, char type, long long count, XField *f) {
+  static const char *fn = "DecodeAggregate";
+
+  int status;
+
+  if(r->depth >= RESP_MAX_DEPTH) return x_error(X_PARSE_ERROR, EINVAL, fn, "nesting too deep");
+  r->depth++;
+
+  if(type == '%') {
+    XStructure *s;
+
+    if(count > X_MAX_ELEMENTS) return x_error(X_SIZE_INVALID, EINVAL, fn, "too many map entries: %lld", count);
+
+    f->type = X_STRUCT;
+    f->value = s = x_alloc_struct();
+    x_check_alloc(s);
+
+    status = DecodeMap(r, (long) count, s);
+  }
+  else if(type == '|') {
+    // Attributes precede the actual reply, and are skipped.
+    XStructure attr = {NULL};
+
+    status = DecodeMap(r, (long) count, &attr);
+    xClearStruct(&attr);
+    if(status == X_SUCCESS) status = DecodeItem(r, f);
+  }
+  else status = DecodeArray(r, (long) count, f);
+
+  r->depth--;
+  return status;
+}
+
+/// Decodes the next RESP item into the (empty) field.
+static int DecodeItem(RESPReader *r, XField *f) {
+  static const char *fn = "DecodeItem";
+
+  const char *line = NULL;
+  size_t length = 0;
+  long long n = 0;
+  char type;
+
+  if(r->n >= r->size) return X_INCOMPLETE;
+
+  prop_error(fn, ReadLine(r, &line, &length));
+  if(length < 1) return x_error(X_PARSE_ERROR, EINVAL, fn, "empty RESP header");
+
+  type = *(line++);
+  length--;
+
+  switch(type) {
+    case '+':
+      SetString(f, line, length, NULL);
+      return X_SUCCESS;
+
+    case '-':
+      SetString(f, line, length, XRESP_ERROR_SUBTYPE);
+      return X_SUCCESS;
+
+    case '(':
+      SetString(f, line, length, XRESP_BIGNUM_SUBTYPE);
+      return X_SUCCESS;
+
+    case ':':
+      prop_error(fn, ParseInteger(line, length, &n));
+      *(int64_t *) NewScalar(f, X_INT64) = n;
+      return X_SUCCESS;
+
+    case ',': {
+      char buf[64], *end;
+
+      if(length >= sizeof(buf)) return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid double");
+      memcpy(buf, line, length);
+      buf[length] = '\0';
+
+      *(double *) NewScalar(f, X_DOUBLE) = strtod(buf, &end);
+      if(end == buf || *end) return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid double: %s", buf);
+      return X_SUCCESS;
+    }
+
+    case '#':
+      if(length != 1 || (*line != 't' && *line != 'f')) return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid boolean");
+      *(boolean *) NewScalar(f, X_BOOLEAN) = (*line == 't');
+      return X_SUCCESS;
+
+    case '_':
+      f->type = X_UNKNOWN;
+      return X_SUCCESS;
+
+    case '$':
+    case '!':
+    case '=':
+      prop_error(fn, ParseInteger(line, length, &n));
+      if(n < 0) {
+        if(type != '$' || n != -1) return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid length: %lld", n);
+        f->type = X_UNKNOWN;        // RESP2 null bulk string
+        return X_SUCCESS;
+      }
+
+      if((unsigned long long) n + 2 > r->size - r->n) return X_INCOMPLETE;
+
+      line = &r->data[r->n];
+      if(line[n] != '\r' || line[n + 1] != '\n') return x_error(X_PARSE_ERROR, EINVAL, fn, "missing CRLF after bulk data");
+      r->n += n + 2;
+
+      if(type == '!') SetString(f, line, n, XRESP_ERROR_SUBTYPE);
+      else if(type == '$') SetString(f, line, n, NULL);
+      else {
+        // Verbatim string: format is the first 3 bytes, followed by ':'
+        char format[4] = {'\0'};
+
+        if(n < 4 || line[3] != ':') return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid verbatim string");
+        memcpy(format, line, 3);
+        SetString(f, &line[4], n - 4, format);
+      }
+      return X_SUCCESS;
+
+    case '*':
+    case '~':
+    case '>':
+    case '%':
+    case '|':
+      prop_error(fn, ParseInteger(line, length, &n));
+      if(n < 0) {
+        if(type != '*' || n != -1) return x_error(X_PARSE_ERROR, EINVAL, fn, "invalid count: %lld", n);
+        f->type = X_UNKNOWN;        // RESP2 null array
+        return X_SUCCESS;
+      }
+      return DecodeAggregate(r, type, n, f);
+  }
+
+  return x_error(X_PARSE_ERROR, EINVAL, fn, "unknown RESP type: '%c'", type);
+}
+
+/**
+ * Decodes the next RESP2 or RESP3 reply (or command) from a buffer into a new field. It may be called repeatedly
+ * to decode the replies of pipelined commands, one after the other, from the same buffer. The reply types are
+ * mapped to fields as:
+ *
+ *  - simple strings, bulk strings, and verbatim strings: `X_STRING` (with the format, e.g. "txt", as the subtype
+ *    of verbatim strings)
+ *  - errors (simple and bulk): `X_STRING` with subtype XRESP_ERROR_SUBTYPE.
+ *  - integers: `X_INT64`
+ *  - doubles: `X_DOUBLE`
+ *  - booleans: `X_BOOLEAN`
+ *  - big numbers: `X_STRING` with subtype XRESP_BIGNUM_SUBTYPE.
+ *  - nulls (including RESP2 null bulk strings and null arrays): `X_UNKNOWN`, with a NULL value.
+ *  - maps: `X_STRUCT`, with the map keys as field names.
+ *  - arrays, sets, and pushes: 1D arrays of `X_STRING`, `X_BOOLEAN`, `X_INT64` or `X_DOUBLE`, if all elements are
+ *    scalars of the same type (strings may be mixed with nulls, and integers with doubles), or else heterogeneous
+ *    arrays (`X_FIELD`).
+ *
+ * Attributes are skipped.
+ *
+ * @param name      The name of the returned field.
+ * @param data      Pointer to the RESP data.
+ * @param size      (bytes) The number of bytes available in the buffer.
+ * @param[out] len  (bytes) (optional) Pointer to which to return the number of bytes consumed by the reply, i.e.
+ *                  the offset at which the next pipelined reply starts in the buffer. It may be NULL if not needed.
+ * @return          A newly created field containing the reply, or else NULL if there was an error (errno is set to
+ *                  EAGAIN if the buffer does not contain a complete reply yet, or else to EINVAL).
+ *
+ * @since 1.1
+ *
+ * @sa xrespEncodeHSET()
+ */
+XField *xrespDecode(const char *name, const void *data, size_t size, size_t *len) {
+  static const char *fn = "xrespDecode";
+
+  RESPReader r = {NULL};
+  XField *f;
+  int status;
+
+  if(!name) {
+    x_error(0, EINVAL, fn, "input name is NULL");
+    return NULL;
+  }
+
+  if(!data) {
+    x_error(0, EINVAL, fn, "input data is NULL");
+    return NULL;
+  }
+
+  r.data = (const char *) data;
+  r.size = size;
+
+  f = x_alloc_field();
+  x_check_alloc(f);
+  f->name = x_copy_name(name);
+
+  status = DecodeItem(&r, f);
+  if(status != X_SUCCESS) {
+    xDestroyField(f);
+    if(status == X_INCOMPLETE) {
+      x_error(0, EAGAIN, fn, "incomplete RESP data");
+      return NULL;
+    }
+    return x_trace_null(fn, NULL);
+  }
+
+  if(len) *len = r.n;
+  return f;
+}
@@ -14,10 +14,214 @@
 #include <string.h>
 #include <errno.h>
 #include <search.h>
+#include <ctype.h>
 
 #define __XCHANGE_INTERNAL_API__      ///< Use internal definitions
 #include "xchange.h"
 
+static const void *GetCachedElementAtIndex(const XField *f, int idx);
+
+/// \cond PRIVATE
+#define INDEX_MIN_FIELDS      16      ///< Structures with at least this many fields get a hash index
+#define INDEX_MIN_SIZE        32      ///< Smallest hash table size
+
+/// An entry in the hash index of a structure
+typedef struct {
+  XField *field;            ///< The indexed field, or NULL if the slot is empty
+  XField *prev;             ///< The field preceding it in the structure, or NULL if it is the first field
+  unsigned int hash;        ///< The hash of the field's name
+} XIndexEntry;
+
+/// The hash index of the fields in a structure, which the library builds and maintains for large structures.
+typedef struct {
+  XIndexEntry *table;       ///< Open-addressing hash table, or NULL if disabled (e.g. due to duplicate names)
+  unsigned int mask;        ///< Table size - 1 (the table size is a power of 2)
+  int n;                    ///< Number of fields in the structure (if the index is enabled)
+  XField *first;            ///< The first field in the structure (compared only, never dereferenced)
+  XField *last;             ///< The last field in the structure (if the index is enabled)
+} XFieldIndex;
+/// \endcond
+
+static unsigned int HashName(const char *name, int len) {
+  unsigned int h = 2166136261U;         // FNV-1a
+  int i;
+
+  for(i = 0; i < len; i++) h = (h ^ (unsigned char) name[i]) * 16777619U;
+  return h;
+}
+
+static XIndexEntry *FindEntry(const XFieldIndex *idx, const char *name, int len, unsigned int hash) {
+  unsigned int i;
+
+  for(i = hash & idx->mask; idx->table[i].field; i = (i + 1) & idx->mask) {
+    XIndexEntry *e = &idx->table[i];
+    if(e->hash != hash) continue;
+    if(e->field->name == name ? name[len] == '\0' : strncmp(e->field->name, name, len) == 0 && e->field->name[len] == '\0') return e;
+  }
+
+  return NULL;
+}
+
+static XIndexEntry *FindFieldEntry(const XFieldIndex *idx, const XField *f) {
+  const int len = strlen(f->name);
+  return FindEntry(idx, f->name, len, HashName(f->name, len));
+}
+
+static void PutEntry(XIndexEntry *table, unsigned int mask, const XIndexEntry *e) {
+  unsigned int i;
+  for(i = e->hash & mask; table[i].field; i = (i + 1) & mask);
+  table[i] = *e;
+}
+
+/// Adds a field (which must not be in the index yet) to the index, growing the hash table as necessary.
+static void AddEntry(XFieldIndex *idx, XField *f, XField *prev, unsigned int hash) {
+  const XIndexEntry e = { f, prev, hash };
+
+  if(2 * (idx->n + 1) > (int) idx->mask + 1) {
+    // Keep the table at most half full.
+    const unsigned int mask = 2 * idx->mask + 1;
+    XIndexEntry *table = (XIndexEntry *) calloc(mask + 1, sizeof(XIndexEntry));
+    unsigned int i;
+
+    x_check_alloc(table);
+
+    for(i = 0; i <= idx->mask; i++) if(idx->table[i].field) PutEntry(table, mask, &idx->table[i]);
+    free(idx->table);
+
+    idx->table = table;
+    idx->mask = mask;
+  }
+
+  PutEntry(idx->table, idx->mask, &e);
+  idx->n++;
+}
+
+/// Removes an entry from the index, shifting back the entries that follow, so no tombstones are needed.
+static void DeleteEntry(XFieldIndex *idx, XIndexEntry *e) {
+  XIndexEntry *table = idx->table;
+  unsigned int i = e - table, j = i;
+
+  for(;;) {
+    unsigned int k;
+
+    j = (j + 1) & idx->mask;
+    if(!table[j].field) break;
+
+    // The entry at j may fill the hole at i, unless its home slot is cyclically in (i, j].
+    k = table[j].hash & idx->mask;
+    if(i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue;
+
+    table[i] = table[j];
+    i = j;
+  }
+
+  table[i].field = NULL;
+  idx->n--;
+}
+
+/// Builds a new index for a structure, which is disabled if the structure has unnamed or duplicate fields.
+static XFieldIndex *BuildIndex(const XStructure *s) {
+  XFieldIndex *idx = (XFieldIndex *) calloc(1, sizeof(XFieldIndex));
+  XField *f;
+
+  x_check_alloc(idx);
+
+  idx->mask = INDEX_MIN_SIZE - 1;
+  idx->table = (XIndexEntry *) calloc(INDEX_MIN_SIZE, sizeof(XIndexEntry));
+  x_check_alloc(idx->table);
+
+  idx->first = s->firstField;
+
+  for(f = s->firstField; f != NULL; f = f->next) {
+    if(idx->table) {
+      const int len = f->name ? (int) strlen(f->name) : 0;
+      const unsigned int hash = HashName(f->name, len);
+
+      if(!f->name || FindEntry(idx, f->name, len, hash)) {
+        // Fall back to linear searches.
+        free(idx->table);
+        idx->table = NULL;
+      }
+      else AddEntry(idx, f, idx->last, hash);
+    }
+
+    if(!idx->table) idx->n++;
+    idx->last = f;
+  }
+
+  return idx;
+}
+
+/// Returns the index of a structure, provided it is up to date, or else NULL. The returned index may be disabled.
+static XFieldIndex *GetIndex(const XStructure *s) {
+  XFieldIndex *idx = (XFieldIndex *) __atomic_load_n(&s->index, __ATOMIC_ACQUIRE);
+
+  if(!idx) return NULL;
+
+  // If the head of the list was changed directly, the index is stale. The cached fields themselves are never
+  // dereferenced here, since the caller may have destroyed them (see xClearStructIndex()).
+  if(idx->first != s->firstField) return NULL;
+
+  return idx;
+}
+
+/// Creates the index of a structure lazily, from a reader. Readers never discard a stale index.
+static void CreateIndex(const XStructure *s) {
+  XFieldIndex *idx, *none = NULL;
+
+  if(__atomic_load_n(&s->index, __ATOMIC_ACQUIRE)) return;
+
+  idx = BuildIndex(s);
+
+  // Publish the new index. If another thread beat us to it, use theirs instead.
+  if(!__atomic_compare_exchange_n((void **) &s->index, (void **) &none, idx, FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    if(idx->table) free(idx->table);
+    free(idx);
+  }
+}
+
+static void DiscardIndex(XStructure *s) {
+  XFieldIndex *idx = (XFieldIndex *) s->index;
+
+  if(!idx) return;
+
+  if(idx->table) free(idx->table);
+  free(idx);
+  s->index = NULL;
+}
+
+/// Returns the index of a structure for modification, or NULL if there is none. A stale index is discarded, whereas
+/// a disabled one is kept (so it is not rebuilt on every modification), and must be checked for by the caller.
+static XFieldIndex *GetUpdatableIndex(XStructure *s) {
+  XFieldIndex *idx = GetIndex(s);
+
+  if(idx) return idx;
+
+  DiscardIndex(s);
+  return NULL;
+}
+
+/// Disables the index of a structure, e.g. because it has a duplicate name now.
+static void DisableIndex(XFieldIndex *idx) {
+  free(idx->table);
+  idx->table = NULL;
+}
+
+
+/**
+ * Sets the structure as the parent of all its direct substructures.
+ *
+ * @param s     Pointer to a structure
+ */
+static void AdoptSubstructs(XStructure *s) {
+  XField *f;
+
+  for(f = s->firstField; f; f = f->next) if(f->type == X_STRUCT && f->value) {
+    XStructure *sub = (XStructure *) f->value;
+    int i = xGetFieldCount(f);
+    while(--i >= 0) sub[i].parent = s;
+  }
+}
 
 /**
  * Creates a new empty XStructure.
@@ -26,7 +230,7 @@
  *
  */
 XStructure *xCreateStruct() {
-  XStructure *s = (XStructure *) calloc(1, sizeof(XStructure));
+  XStructure *s = x_alloc_struct();
   x_check_alloc(s);
   return s;
 }
@@ -55,7 +259,7 @@ XField *xCreateMixedArrayField(const char *name, int ndim, const int *sizes, XFi
   while(--count >= 0) {
     char idx[20];
     sprintf(idx, ".%d", (count+1));
-    array[count].name = xStringCopyOf(idx);
+    array[count].name = x_copy_name(idx);
   }
 
   return f;
@@ -110,19 +314,15 @@ XStructure *xCopyOfStruct(const XStructure *s) {
       return x_trace_null(fn, NULL);
     }
 
-    if(f->type == X_STRUCT) if(f->value) {
-      // Set the copy as the parent structure for any copied substructures.
-      XStructure *sub = (XStructure *) f->value;
-      int k;
-      for(k = xGetFieldCount(f); --k >= 0; ) sub[k].parent = copy;
-    }
-
     if(last) last->next = cf;
     else copy->firstField = cf;
 
     last = cf;
   }
 
+  // Set the copy as the parent structure for any copied substructures.
+  AdoptSubstructs(copy);
+
   return copy;
 }
 
@@ -142,6 +342,7 @@ XField *xCopyOfField(const XField *f) {
   static const char *fn = "xCopyOfField";
 
   XField *copy;
+  void *pool;
   int k, n, eCount;
 
   if(!f) {
@@ -149,19 +350,23 @@ XField *xCopyOfField(const XField *f) {
     return NULL;
   }
 
-  copy = (XField *) calloc(1, sizeof(XField));
+  copy = x_alloc_field();
   x_check_alloc(copy);
 
   // Start with a clone...
+  pool = copy->pool;
   *copy = *f;
 
   copy->name = NULL;        // To be assigned below...
   copy->subtype = NULL;     // To be assigned below...
   copy->value = NULL;       // To be assigned below...
+  copy->extSizes = NULL;    // To be assigned below...
   copy->next = NULL;        // Clear the link of the copy to avoid corrupted structures.
+  copy->cache = NULL;       // The copy builds its own cache, as needed.
+  copy->pool = pool;        // The copy's own storage.
 
   if(f->name) {
-    copy->name = xStringCopyOf(f->name);
+    copy->name = x_copy_name(f->name);
     if(!copy->name) {
       xDestroyField(copy);
       return x_trace_null(fn, f->name);
@@ -176,6 +381,11 @@ XField *xCopyOfField(const XField *f) {
     }
   }
 
+  if(f->extSizes && xSetFieldDims(copy, f->ndim, f->extSizes) != X_SUCCESS) {
+    xDestroyField(copy);
+    return x_trace_null(fn, f->name);
+  }
+
   if(!f->value) return copy;
 
   // Copy data
@@ -202,7 +412,9 @@ XField *xCopyOfField(const XField *f) {
         return x_trace_null(fn, f->name);
       }
       c[k] = *e;
-      free(e);
+      c[k].pool = NULL;
+      x_free_struct(e);
+      AdoptSubstructs(&c[k]);
     }
 
     return copy;
@@ -229,7 +441,7 @@ XField *xCopyOfField(const XField *f) {
   if(n <= 0) return copy;
 
   // Allocate the copy value storage.
-  copy->value = (char *) malloc(n);
+  copy->value = (char *) x_alloc_value(copy, n);
   if(!copy->value) {
     x_error(0, errno, fn, "field %s alloc error (%d bytes)", f->name, n);
     xDestroyField(copy);
@@ -242,23 +454,22 @@ XField *xCopyOfField(const XField *f) {
     for(k = 0; k < eCount; k++) {
       XField *tmp = xCopyOfField(&src[k]);
       dst[k] = *tmp;  // Copy to destination with references.
-      free(tmp);      // Empty the temporary container.
+      dst[k].pool = NULL;
+      x_rebase_value(&dst[k], tmp);
+      x_free_field(tmp);  // Empty the temporary container.
     }
   }
 
   else if(f->type == X_RAW) {
     // raw value is single string pointer
     char **src = (char **) f->value;
-    if(*src) {
-      char *str = xStringCopyOf(*src);
-      if(*src) copy->value =  &str;
-    }
+    *(char **) copy->value = x_copy_element_string(copy, *src);
   }
 
   else if(f->type == X_STRING) {
     char **src = (char **) f->value;
     char **dst = (char **) copy->value;
-    for(k = 0; k < eCount; k++) dst[k] = xStringCopyOf(src[k]);
+    for(k = 0; k < eCount; k++) dst[k] = x_copy_element_string(copy, src[k]);
   }
   else memcpy(copy->value, f->value, n);
 
@@ -284,7 +495,9 @@ XField *xCopyOfField(const XField *f) {
 XField *xGetField(const XStructure *s, const char *id) {
   static const char *fn = "xGetField";
 
+  const XFieldIndex *idx;
   XField *e;
+  int n = 0;
 
   if(s == NULL) {
     x_error(0, EINVAL, fn, "input structure is NULL");
@@ -295,14 +508,34 @@ XField *xGetField(const XStructure *s, const char *id) {
     return NULL;
   }
 
-  for(e = s->firstField; e != NULL; e = e->next) if(e->name) if(xMatchNextID(e->name, id) == X_SUCCESS) {
+  idx = GetIndex(s);
+
+  if(idx && idx->table) {
+    const char *sep = strstr(id, X_SEP);
+    const int len = sep ? (int) (sep - id) : (int) strlen(id);
+    const XIndexEntry *entry = FindEntry(idx, id, len, HashName(id, len));
+
+    if(!entry) return NULL;
+
+    e = entry->field;
+    if(!sep) return e;
+
+    if(e->type != X_STRUCT) return NULL;
+    return xGetField((XStructure *) e->value, sep + X_SEP_LENGTH);
+  }
+
+  for(e = s->firstField; e != NULL; e = e->next, n++) if(e->name) if(e->name == id || xMatchNextID(e->name, id) == X_SUCCESS) {
     const char *next = xNextIDToken(id);
+
+    if(n >= INDEX_MIN_FIELDS && !idx) CreateIndex(s);
     if(!next) return e;
 
     if(e->type != X_STRUCT) return NULL;
     return xGetField((XStructure *) e->value, next);
   }
 
+  if(n >= INDEX_MIN_FIELDS && !idx) CreateIndex(s);
+
   return NULL;
 }
 
@@ -346,6 +579,9 @@ long xGetAsLong(const XField *f, long defaultValue) {
  * between numerical types (e.g. `float` to `long`), while for string values will attempt to
  * parse an integer value.
  *
+ * For serialized numerical or boolean fields, the entire serialized value is decoded on the first access, and
+ * cached with the field, so that subsequent reads of any element are fast.
+ *
  * @param f                 Pointer to a field.
  * @param idx               Array index (zero-based) of the element of interest.
  * @param defaultValue      The value to return if the structure contains no field with the
@@ -368,11 +604,10 @@ long xGetAsLongAtIndex(const XField *f, int idx, long defaultValue) {
 
   if(!f) return x_error(defaultValue, EINVAL, fn, "input field is NULL");
   if(!f->value) return x_error(defaultValue, EFAULT, fn, "field has NULL value");
-  if(f->isSerialized) return x_error(defaultValue, ENOSR, fn, "cannot convert serialized field");
 
   errno = 0;
 
-  ptr = xGetElementAtIndex(f, idx);
+  ptr = f->isSerialized ? GetCachedElementAtIndex(f, idx) : xGetElementAtIndex(f, idx);
   if(!ptr) {
     if(errno) x_trace(fn, NULL, defaultValue);
     return defaultValue;
@@ -451,6 +686,9 @@ double xGetAsDouble(const XField *f) {
  * convert between numerical types (e.g. `short` to `double`), while for string values will attempt
  * to parse a decomal value.
  *
+ * For serialized numerical or boolean fields, the entire serialized value is decoded on the first access, and
+ * cached with the field, so that subsequent reads of any element are fast.
+ *
  * @param f     Pointer to field
  * @param idx   Array index (zero-based) of the element of interest.
  *
@@ -477,14 +715,9 @@ double xGetAsDoubleAtIndex(const XField *f, int idx) {
     return NAN;
   }
 
-  if(f->isSerialized) {
-    x_error(0, ENOSR, fn, "cannot convert serialized field");
-    return NAN;
-  }
-
   errno = 0;
 
-  ptr = xGetElementAtIndex(f, idx);
+  ptr = f->isSerialized ? GetCachedElementAtIndex(f, idx) : xGetElementAtIndex(f, idx);
   if(!ptr) {
     if(errno) x_trace_null(fn, NULL);
     return NAN;
@@ -512,14 +745,8 @@ double xGetAsDoubleAtIndex(const XField *f, int idx) {
     case X_INT16: return *(int16_t *) ptr;
     case X_INT32: return *(int32_t *) ptr;
     case X_INT64: return *(int64_t *) ptr;
-    case X_FLOAT: {
-      const float *x = (float *) ptr;
-      return (long) floor(*x + 0.5);
-    }
-    case X_DOUBLE: {
-      const double *x = (double *) ptr;
-      return (long) floor(*x + 0.5);
-    }
+    case X_FLOAT: return *(float *) ptr;
+    case X_DOUBLE: return *(double *) ptr;
     case X_STRING:
     case X_RAW: {
       double d = 0.0;
@@ -694,24 +921,20 @@ XField *xCreateField(const char *name, XType type, int ndim, const int *sizes, c
     return NULL;
   }
 
-  f = (XField *) calloc(1, sizeof(XField));
+  f = x_alloc_field();
   x_check_alloc(f);
 
-  f->name = xStringCopyOf(name);
+  f->name = x_copy_name(name);
   if(!f->name) {
-    free(f);
+    x_free_field(f);
     return x_trace_null(fn, "copy of name");
   }
 
   f->type = type;
 
-  if(ndim < 1) {
-    f->ndim = 0;
-    f->sizes[0] = 1;
-  }
-  else {
-    f->ndim = ndim;
-    memcpy(f->sizes, sizes, sizeof(f->sizes));
+  if(xSetFieldDims(f, ndim, sizes) != X_SUCCESS) {
+    xDestroyField(f);
+    return x_trace_null(fn, "dimensions");
   }
 
   if(!value) {
@@ -724,7 +947,7 @@ XField *xCreateField(const char *name, XType type, int ndim, const int *sizes, c
     return f;
   }
 
-  f->value = (char *) malloc(n);
+  f->value = (char *) x_alloc_value(f, n);
 
   if(!f->value) {
     x_error(0, errno, fn, "alloc error (%d bytes)", n);
@@ -736,9 +959,19 @@ XField *xCreateField(const char *name, XType type, int ndim, const int *sizes, c
     const char **src = (const char **) value;
     char **dst = (char **) f->value;
     int i;
-    for(i = 0; i < count; i++) dst[i] = xStringCopyOf(src[i]);
+    for(i = 0; i < count; i++) dst[i] = x_copy_element_string(f, src[i]);
+  }
+  else {
+    memcpy(f->value, value, n);
+
+    if(f->type == X_FIELD) {
+      // Element values stored inside the supplied fields now belong to the copies.
+      const XField *src = (const XField *) value;
+      XField *dst = (XField *) f->value;
+      int i;
+      for(i = 0; i < count; i++) x_rebase_value(&dst[i], &src[i]);
+    }
   }
-  else memcpy(f->value, value, n);
 
   return f;
 }
@@ -906,7 +1139,73 @@ long xGetFieldCount(const XField *f) {
     x_error(0, EINVAL, "xGetFieldCount", "input field is NULL");
     return 0;
   }
-  return xGetElementCount(f->ndim, f->sizes);
+  return xGetElementCount(f->ndim, xGetFieldSizes(f));
+}
+
+/**
+ * Returns the sizes along each dimension of a field, as a contiguous array of `ndim` elements. Since fields store
+ * only the first X_INLINE_DIMS dimensions in their `sizes` member, you should use this function to access the
+ * dimensions of fields, which may have more.
+ *
+ * @param f     Pointer to a field
+ * @return      Pointer to the (read-only) sizes along each dimension of the field, or NULL if the field is NULL.
+ *              For scalars (ndim = 0), the first element is 1.
+ *
+ * @since 1.1
+ *
+ * @sa xSetFieldDims()
+ * @sa xGetFieldCount()
+ */
+const int *xGetFieldSizes(const XField *f) {
+  if(!f) {
+    x_error(0, EINVAL, "xGetFieldSizes", "input field is NULL");
+    return NULL;
+  }
+  return f->ndim > X_INLINE_DIMS ? f->extSizes : f->sizes;
+}
+
+/**
+ * Sets the dimensions of a field. The first X_INLINE_DIMS dimensions are stored in the field itself, while all
+ * dimensions of fields with more dimensions are stored in a separately allocated array, which is released by
+ * xClearField() / xDestroyField(). The field's value is not affected.
+ *
+ * @param f       Pointer to a field
+ * @param ndim    Number of dimensions (0:20). If ndim &lt; 1, the field is set to be a scalar, with sizes[0] = 1.
+ * @param sizes   Array of sizes along each dimension, with at least ndim elements, or NULL with ndim &lt; 1.
+ * @return        X_SUCCESS (0) if successful, or else X_NULL if the field is NULL, or X_SIZE_INVALID if the number of
+ *                dimensions is too large, or if sizes is NULL with ndim &gt; 0, or X_FAILURE if the storage of the
+ *                dimensions could not be allocated.
+ *
+ * @since 1.1
+ *
+ * @sa xGetFieldSizes()
+ */
+int xSetFieldDims(XField *f, int ndim, const int *sizes) {
+  static const char *fn = "xSetFieldDims";
+
+  int lead[X_INLINE_DIMS] = {1}, *ext = NULL;
+
+  if(!f) return x_error(X_NULL, EINVAL, fn, "input field is NULL");
+  if(ndim > X_MAX_DIMS) return x_error(X_SIZE_INVALID, EINVAL, fn, "too many dimensions: %d", ndim);
+  if(ndim > 0 && !sizes) return x_error(X_SIZE_INVALID, EINVAL, fn, "input sizes is NULL");
+
+  // (The sizes may be those of the field itself.)
+  if(ndim > 0) memcpy(lead, sizes, (ndim < X_INLINE_DIMS ? ndim : X_INLINE_DIMS) * sizeof(int));
+  else ndim = 0;
+
+  if(ndim > X_INLINE_DIMS) {
+    ext = (int *) malloc(ndim * sizeof(int));
+    if(!ext) return x_error(X_FAILURE, errno, fn, "alloc error (%d dimensions)", ndim);
+    memcpy(ext, sizes, ndim * sizeof(int));
+  }
+
+  if(f->extSizes) free(f->extSizes);
+  f->extSizes = ext;
+
+  f->ndim = ndim;
+  memcpy(f->sizes, lead, sizeof(lead));
+
+  return X_SUCCESS;
 }
 
 /**
@@ -1012,6 +1311,7 @@ XField *xSetSubstruct(XStructure *s, const char *name, XStructure *substruct) {
 XField *xRemoveField(XStructure *s, const char *name) {
   static const char *fn = "xRemoveField";
 
+  XFieldIndex *idx;
   XField *e, *last = NULL;
 
   if(!s) {
@@ -1029,22 +1329,48 @@ XField *xRemoveField(XStructure *s, const char *name) {
     return NULL;
   }
 
-  for(e = s->firstField; e != NULL; e = e->next) {
-    if(!strcmp(name, e->name)) {
-      if(last) last->next = e->next;
-      else s->firstField = e->next;
-      e->next = NULL;
-      if(e->type == X_STRUCT) if(e->value) {
-        XStructure *sub = (XStructure *) e->value;
-        int k = xGetFieldCount(e);
-        while(--k >= 0) sub[k].parent = NULL;
-      }
-      return e;
+  idx = GetUpdatableIndex(s);
+
+  // Removing a field may resolve duplicates, so a disabled index is discarded (and may be rebuilt later).
+  if(idx && !idx->table) {
+    DiscardIndex(s);
+    idx = NULL;
+  }
+
+  if(idx) {
+    const int len = strlen(name);
+    XIndexEntry *entry = FindEntry(idx, name, len, HashName(name, len));
+
+    if(!entry) return NULL;
+
+    e = entry->field;
+    last = entry->prev;
+
+    if(e->next) FindFieldEntry(idx, e->next)->prev = last;
+    if(idx->last == e) idx->last = last;
+    DeleteEntry(idx, entry);
+  }
+  else {
+    for(e = s->firstField; e != NULL; e = e->next) {
+      if(e->name == name || !strcmp(name, e->name)) break;
+      last = e;
     }
-    last = e;
+    if(!e) return NULL;
   }
 
-  return NULL;
+  if(last) last->next = e->next;
+  else s->firstField = e->next;
+  e->next = NULL;
+
+  if(idx) idx->first = s->firstField;
+
+  if(e->type == X_STRUCT) if(e->value) {
+    XStructure *sub = (XStructure *) e->value;
+    int k = xGetFieldCount(e);
+    while(--k >= 0) sub[k].parent = NULL;
+  }
+
+  return e;
 }
 
 /**
@@ -1069,6 +1395,8 @@ XField *xRemoveField(XStructure *s, const char *name) {
 int xInsertField(XStructure *s, XField *f) {
   static const char *fn = "xInsertField";
 
+  XFieldIndex *idx;
+
   if(!s) return x_error(X_STRUCT_INVALID, EINVAL, fn, "input structure is NULL");
   if(!f) return x_error(X_NULL, EINVAL, fn, "input field is NULL");
   if(!f->name) return x_error(X_NAME_INVALID, EINVAL, fn, "field->name is NULL");
@@ -1077,10 +1405,26 @@ int xInsertField(XStructure *s, XField *f) {
   // The field name contains a separator?
   if(xLastSeparator(f->name)) return x_error(X_NAME_INVALID, EINVAL, fn, "field->name contains separator");
 
+  idx = GetUpdatableIndex(s);
+
+  if(idx && idx->table) {
+    const int len = strlen(f->name);
+    const unsigned int hash = HashName(f->name, len);
+
+    if(FindEntry(idx, f->name, len, hash)) DisableIndex(idx);      // Duplicate names are not indexed.
+    else {
+      if(s->firstField) FindFieldEntry(idx, s->firstField)->prev = f;
+      else idx->last = f;
+      AddEntry(idx, f, NULL, hash);
+    }
+  }
+
   // Add the new field at the head of the list...
   f->next = s->firstField;
   s->firstField = f;
 
+  if(idx) idx->first = f;
+
   return X_SUCCESS;
 }
 
@@ -1110,7 +1454,9 @@ int xInsertField(XStructure *s, XField *f) {
 XField *xSetField(XStructure *s, XField *f) {
   static const char *fn = "xSetField";
 
+  XFieldIndex *idx;
   XField *e, *last = NULL;
+  int n = 0;
 
   if(!s) {
     x_error(0, EINVAL, fn, "input structure is NULL");
@@ -1134,26 +1480,51 @@ XField *xSetField(XStructure *s, XField *f) {
 
   f->next = NULL;
 
-  for(e = s->firstField; e != NULL; e = e->next) {
-    if(!strcmp(f->name, e->name)) {
+  idx = GetUpdatableIndex(s);
 
-      f->next = e->next;                    // Inherit the link to the successive field
-      e->next = NULL;                       // Unlink the prior field by the same name.
+  if(idx && idx->table) {
+    const int len = strlen(f->name);
+    const unsigned int hash = HashName(f->name, len);
+    XIndexEntry *entry = FindEntry(idx, f->name, len, hash);
 
-      if(last == NULL) s->firstField = f;   // If it's right at the top, then replace the top.
-      else last->next = f;                  // Otherwise, link to the prior field.
+    if(entry) {
+      e = entry->field;
+      last = entry->prev;
 
-      return e;
+      // The replacement takes the place of the prior field in the index also.
+      entry->field = f;
+      if(e->next) FindFieldEntry(idx, e->next)->prev = f;
+      if(idx->first == e) idx->first = f;
+      if(idx->last == e) idx->last = f;
+    }
+    else {
+      // Add the new field at the end of the list...
+      e = NULL;
+      last = idx->last;
+      AddEntry(idx, f, last, hash);
+      if(!last) idx->first = f;
+      idx->last = f;
+    }
+  }
+  else {
+    for(e = s->firstField; e != NULL; e = e->next, n++) {
+      if(e->name == f->name || !strcmp(f->name, e->name)) break;
+      last = e;
     }
+  }
 
-    last = e;
+  if(e) {
+    f->next = e->next;                      // Inherit the link to the successive field
+    e->next = NULL;                         // Unlink the prior field by the same name.
   }
 
-  // Add the new field at the end of the list...
-  if(last == NULL) s->firstField = f;
-  else last->next = f;
+  if(last == NULL) s->firstField = f;       // If it's right at the top, then replace the top.
+  else last->next = f;                      // Otherwise, link to the prior field.
 
-  return NULL;
+  if(!idx && n + 1 >= INDEX_MIN_FIELDS) s->index = BuildIndex(s);
+  else if(idx) idx->first = s->firstField;     // (A disabled index is kept current also.)
+
+  return e;
 }
 
 /**
@@ -1165,16 +1536,110 @@ XField *xSetField(XStructure *s, XField *f) {
  * @sa xDeepCountFields()
  */
 int xCountFields(const XStructure *s) {
+  const XFieldIndex *idx;
   XField *f;
   int n = 0;
 
   if(!s) return 0;
 
+  idx = GetIndex(s);
+  if(idx && idx->table) return idx->n;
+
   for(f = s->firstField; f != NULL; f = f->next) n++;
 
   return n;
 }
 
+/**
+ * Discards the field index of a structure (if any), after the structure's linked list of fields has been modified
+ * directly. The index is rebuilt automatically, as needed, on subsequent accesses to the structure. You must call it,
+ * before the structure is accessed again with any library function, after you directly:
+ *
+ *  - link a field into, or unlink (and possibly destroy) a field from, the list anywhere other than at its head
+ *    (including appending to, or removing from, its tail),
+ *  - rename a field in place, or
+ *  - replace a field in the list by another one.
+ *
+ * Only a change of `XStructure.firstField` is detected by the library itself. Changes made via library functions,
+ * such as xSetField(), xInsertField(), xRemoveField(), xSortFields(), or xReverseFieldOrder(), need no such call.
+ *
+ * @param s     Pointer to a structure
+ *
+ * @since 1.1
+ *
+ * @sa xGetField()
+ * @sa xSetField()
+ */
+void xClearStructIndex(XStructure *s) {
+  if(s) DiscardIndex(s);
+}
+
+/**
+ * Relocates the fields of a structure, and recursively those of all its substructures, into contiguous storage (one
+ * block per structure), in their current order. Traversing the fields of a packed structure (e.g. for iteration,
+ * serialization, or copying) then streams through memory, instead of chasing pointers scattered across the heap.
+ * Packing is worth it for structures that are accessed many times after they have been assembled, e.g. after
+ * parsing.
+ *
+ * The fields of packed structures otherwise behave just like any other: they may be modified, removed, replaced, or
+ * destroyed with the usual functions, and new fields may be added to the structure also (which are stored
+ * individually until the structure is packed again). The storage of a block is released once all fields in it have
+ * been destroyed. However, fields in packed structures must be destroyed with xDestroyField() (or else via
+ * xDestroyStruct() etc.), and never with free() directly.
+ *
+ * NOTE: since the fields are moved, any pointers to the prior fields of the structure (or its substructures) are
+ * invalidated by this call. Pointers to fields obtained after packing remain valid until the field is destroyed, or
+ * until the structure is packed again.
+ *
+ * @param s     Pointer to a structure
+ * @return      X_SUCCESS (0) if successful, or X_STRUCT_INVALID if the input structure is NULL, or else X_FAILURE
+ *              if the storage could not be allocated (errno set to ENOMEM).
+ *
+ * @since 1.1
+ *
+ * @sa xCreateStruct()
+ * @sa xDestroyStruct()
+ */
+int xPackStruct(XStructure *s) {
+  static const char *fn = "xPackStruct";
+
+  XField *f, *fields;
+  int i, n = 0;
+
+  if(!s) return x_error(X_STRUCT_INVALID, EINVAL, fn, "input structure is NULL");
+
+  for(f = s->firstField; f; f = f->next) {
+    if(f->type == X_STRUCT && f->value) {
+      XStructure *sub = (XStructure *) f->value;
+      for(i = xGetFieldCount(f); --i >= 0; ) prop_error(fn, xPackStruct(&sub[i]));
+    }
+    n++;
+  }
+
+  if(!n) return X_SUCCESS;
+
+  fields = x_alloc_fields(n);
+  if(!fields) return x_error(X_FAILURE, errno, fn, "alloc error (%d fields)", n);
+
+  for(i = 0, f = s->firstField; f; i++) {
+    XField *next = f->next, *e = &fields[i];
+    void *pool = e->pool;
+
+    *e = *f;
+    e->pool = pool;
+    x_rebase_value(e, f);
+    e->next = next ? &e[1] : NULL;
+
+    x_free_field(f);
+    f = next;
+  }
+
+  s->firstField = fields;
+  DiscardIndex(s);
+
+  return X_SUCCESS;
+}
+
 /**
  * Destroys an X structure, freeing up resources used by name and value.
  *
@@ -1184,7 +1649,7 @@ int xCountFields(const XStructure *s) {
 void xDestroyStruct(XStructure *s) {
   if(s == NULL) return;
   xClearStruct(s);
-  free(s);
+  x_free_struct(s);
 }
 
 /**
@@ -1196,6 +1661,8 @@ void xDestroyStruct(XStructure *s) {
  * \sa xDestroyField()
  */
 void xClearField(XField *f) {
+  void *pool;
+
   if(!f) return;
 
   if(f->value != NULL) {
@@ -1204,6 +1671,8 @@ void xClearField(XField *f) {
         XStructure *sub = (XStructure *) f->value;
         int i = xGetFieldCount(f);
         while(--i >= 0) xClearStruct(&sub[i]);
+        x_free_struct(sub);
+        f->value = NULL;
         break;
       }
 
@@ -1214,30 +1683,35 @@ void xClearField(XField *f) {
         break;
       }
 
-      case X_RAW: {
-        // raw value is single string pointer
-        char **str = (char **) f->value;
-        if(*str) free(*str);
+      case X_RAW:
+        if(!f->isSerialized) {
+          // raw value is single string pointer
+          char **str = (char **) f->value;
+          x_free_value(f, *str);
+        }
         break;
-      }
 
       case X_STRING:
         if(!f->isSerialized) {
           // value is an array of string pointers...
           char **str = (char **) f->value;
           int i = xGetFieldCount(f);
-          while(--i >= 0) if(str[i]) free(str[i]);
+          while(--i >= 0) x_free_value(f, str[i]);
         }
         break;
     }
 
-    free(f->value);
+    x_free_value(f, f->value);
   }
 
-  if(f->name != NULL) free(f->name);
+  if(f->name != NULL) x_free_name(f->name);
   if(f->subtype != NULL) free(f->subtype);
+  if(f->extSizes != NULL) free(f->extSizes);
+  xClearFieldCache(f);
 
+  pool = f->pool;           // The field stays where it is allocated...
   memset(f, 0, sizeof(XField));
+  f->pool = pool;
 }
 
 /**
@@ -1251,7 +1725,7 @@ void xClearField(XField *f) {
 void xDestroyField(XField *f) {
   if(!f) return;
   xClearField(f);
-  free(f);
+  x_free_field(f);
 }
 
 /**
@@ -1273,6 +1747,7 @@ void xClearStruct(XStructure *s) {
   }
 
   s->firstField = NULL;
+  DiscardIndex(s);
 }
 
 /**
@@ -1308,7 +1783,7 @@ int xReduceDims(int *ndim, int *sizes) {
 
   for(i = *ndim; --i >= 0; ) if (sizes[i] == 1) {
     (*ndim)--;
-    if(i < *ndim) memmove(&sizes[i], &sizes[i+1], (*ndim - i - 1) * sizeof(int));
+    if(i < *ndim) memmove(&sizes[i], &sizes[i+1], (*ndim - i) * sizeof(int));
     else sizes[i] = 0;
   }
 
@@ -1335,13 +1810,26 @@ static int xUnwrapField(XField *f) {
     int i = xGetFieldCount(nested);
     while(--i >= 0) xReduceStruct(&s[i]);
   }
-  else if(nested->type == X_FIELD) return xUnwrapField(nested);
+  else if(nested->type == X_FIELD) prop_error("xUnwrapField", xUnwrapField(nested));
 
-  if(f->name) free(f->name);
   if(f->subtype) free(f->subtype);
-  if(f->value) free(f->value);
-
-  *f = *nested;
+  if(nested->name) x_free_name(nested->name);
+  xClearFieldCache(f);
+
+  // Move the contents of the nested field, but keep the name, link, and storage of the field itself.
+  f->type = nested->type;
+  f->subtype = nested->subtype;
+  f->ndim = nested->ndim;
+  memcpy(f->sizes, nested->sizes, sizeof(f->sizes));
+  if(f->extSizes) free(f->extSizes);
+  f->extSizes = nested->extSizes;
+  f->isSerialized = nested->isSerialized;
+  f->cache = nested->cache;
+  f->value = nested->value;
+  f->local = nested->local;
+  x_rebase_value(f, nested);
+
+  free(nested);
   return X_SUCCESS;
 }
 
@@ -1357,7 +1845,12 @@ static int xUnwrapField(XField *f) {
 int xReduceField(XField *f) {
   if(!f) return x_error(X_NULL, EINVAL, "xReduceField", "input field is NULL");
 
-  xReduceDims(&f->ndim, f->sizes);
+  if(f->ndim > 0) {
+    int ndim = f->ndim, sizes[X_MAX_DIMS];
+    memcpy(sizes, xGetFieldSizes(f), ndim * sizeof(int));
+    xReduceDims(&ndim, sizes);
+    prop_error("xReduceField", xSetFieldDims(f, ndim, sizes));
+  }
 
   if(f->type == X_FIELD) xUnwrapField(f);
   else if(f->type == X_STRUCT) {
@@ -1393,19 +1886,16 @@ int xReduceStruct(XStructure *s) {
     // We can eliminate the unnecessary nesting.
 
     XStructure *sub = (XStructure *) f->value;
-    XField *sf;
 
     s->firstField = sub->firstField;
+    sub->firstField = NULL;
+    DiscardIndex(s);
 
-    for(sf = s->firstField; sf; sf = sf->next) if(sf->type == X_STRUCT) {
-      XStructure *ss = (XStructure *) f->value;
-      int i = xGetFieldCount(sf);
-      while(--i >= 0) ss[i].parent = s;
-    }
+    AdoptSubstructs(s);
 
     xReduceStruct(s);
 
-    free(f);
+    xDestroyField(f);
     return X_SUCCESS;
   }
 
@@ -1665,6 +2155,7 @@ int xSortFields(XStructure *s, int (*cmp)(const XField **f1, const XField **f2),
     f = next;
   }
   s->firstField = NULL;
+  DiscardIndex(s);      // It will be rebuilt as needed.
 
   qsort(array, n, sizeof(XField *), (int (*)(const void *, const void *)) cmp);
 
@@ -1713,6 +2204,7 @@ int xReverseFieldOrder(XStructure *s, boolean recursive) {
 
   f = s->firstField;
   s->firstField = NULL;
+  DiscardIndex(s);      // It will be rebuilt as needed.
 
   while(f != NULL) {
     XField *next = f->next;
@@ -1731,3 +2223,635 @@ int xReverseFieldOrder(XStructure *s, boolean recursive) {
   s->firstField = rev;
   return X_SUCCESS;
 }
+
+/// \cond PRIVATE
+#define STRING_ELEMENT_SEP    '\r'      ///< Separator of string elements in serialized values
+#define MAX_EXACT_FLOAT       16777216.0F         ///< (2^24) Integral floats up to this are printed as integers.
+#define MAX_EXACT_DOUBLE      9007199254740992.0  ///< (2^53) Integral doubles up to this are printed as integers.
+
+/// Pairs of decimal digits, for printing integers two digits at a time
+static const char digitPairs[201] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+/// \endcond
+
+static char *PrintUnsigned(char *dst, unsigned long long value) {
+  char buf[20], *p = &buf[sizeof(buf)];
+  size_t n;
+
+  while(value >= 100) {
+    const int k = 2 * (int) (value % 100);
+    value /= 100;
+    *(--p) = digitPairs[k + 1];
+    *(--p) = digitPairs[k];
+  }
+
+  if(value >= 10) {
+    *(--p) = digitPairs[2 * value + 1];
+    *(--p) = digitPairs[2 * value];
+  }
+  else *(--p) = (char) ('0' + value);
+
+  n = &buf[sizeof(buf)] - p;
+  memcpy(dst, p, n);
+  return dst + n;
+}
+
+static char *PrintInteger(char *dst, long long value) {
+  if(value >= 0) return PrintUnsigned(dst, (unsigned long long) value);
+  *(dst++) = '-';
+  return PrintUnsigned(dst, 0ULL - (unsigned long long) value);
+}
+
+/// Prints a float with the fewest significant digits (7 to 9) that parse back to the exact same value.
+static char *PrintExactFloat(char *dst, float value) {
+  int digits;
+
+  if(value <= MAX_EXACT_FLOAT && value >= -MAX_EXACT_FLOAT && value == (long long) value && (value != 0 || !signbit(value)))
+    return PrintInteger(dst, (long long) value);
+
+  if(!isfinite(value)) return dst + xPrintFloat(dst, value);
+
+  for(digits = 7; digits < 9; digits++) {
+    const int n = sprintf(dst, "%.*g", digits, value);
+    if(xParseFloat(dst, NULL) == value) return dst + n;
+  }
+
+  return dst + sprintf(dst, "%.9g", value);
+}
+
+/// Prints a double with the fewest significant digits (16 or 17) that parse back to the exact same value.
+static char *PrintExactDouble(char *dst, double value) {
+  int n;
+
+  if(value <= MAX_EXACT_DOUBLE && value >= -MAX_EXACT_DOUBLE && value == (long long) value && (value != 0 || !signbit(value)))
+    return PrintInteger(dst, (long long) value);
+
+  if(!isfinite(value)) return dst + xPrintDouble(dst, value);
+
+  n = sprintf(dst, "%.16g", value);
+  if(xParseDouble(dst, NULL) == value) return dst + n;
+
+  return dst + sprintf(dst, "%.17g", value);
+}
+
+/// Returns an upper bound to the serialized length of the field value, including separators and termination.
+static size_t GetSerializedSizeBound(const XField *f, long count) {
+  long i;
+  size_t n = 0;
+
+  switch(f->type) {
+    case X_RAW:         // count is 1 (NULL strings are serialized as empty)
+    case X_STRING:
+      for(i = 0; i < count; i++) {
+        const char *str = ((char **) f->value)[i];
+        n += (str ? strlen(str) : 0) + 1;
+      }
+      return n;
+    case X_BOOLEAN: return count * sizeof("false");
+    case X_BYTE: return count * sizeof("-128");
+    case X_INT16: return count * sizeof("-32768");
+    case X_INT32: return count * sizeof("-2147483648");
+    case X_INT64: return count * sizeof("-9223372036854775808");
+    case X_FLOAT: return count * 17;
+    case X_DOUBLE: return count * 26;
+  }
+
+  return count * (-f->type + 1);      // X_CHARS(n)
+}
+
+/**
+ * Converts the value of a field to its serialized string representation, in situ. The serialized form is a
+ * whitespace-separated list of the elements for numerical and boolean types (with booleans as `true` or `false`).
+ * For strings and fixed-length character arrays, the elements are separated by carriage returns (`\r`) instead,
+ * since the strings themselves may contain whitespace. The type and dimensions of the field are retained. It is
+ * the inverse of xDeserializeField().
+ *
+ * The serialized value is formatted with a single bulk loop over the typed data, into a single allocation, without
+ * relying on `sprintf()` for integers, or for integral floating-point values. Other floating-point values are
+ * printed with the fewest significant digits (up to 9 for floats, or 17 for doubles) that parse back to the same
+ * binary value, so the serialized form round-trips exactly, including negative zero and subnormal values.
+ *
+ * @param f     Pointer to a field.
+ * @return      X_SUCCESS (0) if successful, or if the field is already serialized or has no value, or else
+ *              X_NULL if the field is NULL, or X_TYPE_INVALID if the field is a structure or a heterogeneous
+ *              array, or has an unknown type.
+ *
+ * @since 1.1
+ *
+ * @sa xDeserializeField()
+ */
+int xSerializeField(XField *f) {
+  static const char *fn = "xSerializeField";
+
+  long i, count;
+  char *str, *p;
+
+  if(!f) return x_error(X_NULL, EINVAL, fn, "input field is NULL");
+  if(f->isSerialized || !f->value) return X_SUCCESS;
+
+  if(f->type == X_STRUCT || f->type == X_FIELD || xElementSizeOf(f->type) <= 0)
+    return x_error(X_TYPE_INVALID, EINVAL, fn, "cannot serialize type: %d", f->type);
+
+  count = xGetFieldCount(f);
+  if(f->type == X_RAW) count = 1;
+
+  p = str = (char *) malloc(GetSerializedSizeBound(f, count) + 1);
+  x_check_alloc(str);
+
+  switch(f->type) {
+    case X_RAW:
+    case X_STRING:
+      for(i = 0; i < count; i++) {
+        const char *s = ((char **) f->value)[i];
+        if(i) *(p++) = STRING_ELEMENT_SEP;
+        if(s) {
+          const size_t l = strlen(s);
+          memcpy(p, s, l);
+          p += l;
+        }
+      }
+      break;
+
+    case X_BOOLEAN: {
+      const boolean *b = (const boolean *) f->value;
+      for(i = 0; i < count; i++) {
+        if(i) *(p++) = ' ';
+        if(b[i]) { memcpy(p, "true", 4); p += 4; }
+        else { memcpy(p, "false", 5); p += 5; }
+      }
+      break;
+    }
+
+    case X_BYTE: {
+      const int8_t *v = (const int8_t *) f->value;
+      for(i = 0; i < count; i++) {
+        if(i) *(p++) = ' ';
+        p = PrintInteger(p, v[i]);
+      }
+      break;
+    }
+
+    case X_INT16: {
+      const int16_t *v = (const int16_t *) f->value;
+      for(i = 0; i < count; i++) {
+        if(i) *(p++) = ' ';
+        p = PrintInteger(p, v[i]);
+      }
+      break;
+    }
+
+    case X_INT32: {
+      const int32_t *v = (const int32_t *) f->value;
+      for(i = 0; i < count; i++) {
+        if(i) *(p++) = ' ';
+        p = PrintInteger(p, v[i]);
+      }
+      break;
+    }
+
+    case X_INT64: {
+      const int64_t *v = (const int64_t *) f->value;
+      for(i = 0; i < count; i++) {
+        if(i) *(p++) = ' ';
+        p = PrintInteger(p, v[i]);
+      }
+      break;
+    }
+
+    case X_FLOAT: {
+      const float *v = (const float *) f->value;
+      for(i = 0; i < count; i++) {
+        if(i) *(p++) = ' ';
+        p = PrintExactFloat(p, v[i]);
+      }
+      break;
+    }
+
+    case X_DOUBLE: {
+      const double *v = (const double *) f->value;
+      for(i = 0; i < count; i++) {
+        if(i) *(p++) = ' ';
+        p = PrintExactDouble(p, v[i]);
+      }
+      break;
+    }
+
+    default: {
+      // X_CHARS(n)
+      const int n = -f->type;
+      const char *c = (const char *) f->value;
+
+      for(i = 0; i < count; i++, c += n) {
+        const char *end = (const char *) memchr(c, '\0', n);
+        const size_t l = end ? (size_t) (end - c) : (size_t) n;
+
+        if(i) *(p++) = STRING_ELEMENT_SEP;
+        memcpy(p, c, l);
+        p += l;
+      }
+    }
+  }
+
+  *p = '\0';
+
+  // Shrink to the exact size (usually in place).
+  p = (char *) realloc(str, p - str + 1);
+  if(p) str = p;
+
+  if(f->type == X_STRING || f->type == X_RAW) {
+    char **s = (char **) f->value;
+    for(i = 0; i < count; i++) x_free_value(f, s[i]);
+  }
+  x_free_value(f, f->value);
+  xClearFieldCache(f);
+
+  f->value = str;
+  f->isSerialized = TRUE;
+
+  return X_SUCCESS;
+}
+
+static boolean IsTokenEnd(char c) {
+  return c == '\0' || isspace((unsigned char) c);
+}
+
+/// Skips leading whitespace, and checks that there is another token to parse.
+static int NextToken(const char **pos) {
+  const char *p = *pos;
+  while(isspace((unsigned char) *p)) p++;
+  *pos = p;
+  return *p ? X_SUCCESS : X_NOT_ENOUGH_TOKENS;
+}
+
+/// Parses a decimal integer token, within the specified range.
+static int ParseIntegerToken(const char **pos, long long min, long long max, long long *value) {
+  const char *p = *pos;
+  unsigned long long v = 0, limit = (unsigned long long) max;
+  boolean isNegative = FALSE;
+  int n;
+
+  if(*p == '-' || *p == '+') {
+    isNegative = (*p == '-');
+    if(isNegative) limit = 0ULL - (unsigned long long) min;
+    p++;
+  }
+
+  for(n = 0; *p >= '0' && *p <= '9'; p++, n++) {
+    const unsigned int d = *p - '0';
+    if(v > (limit - d) / 10) return X_PARSE_ERROR;      // Out of range
+    v = 10 * v + d;
+  }
+
+  if(!n || !IsTokenEnd(*p)) return X_PARSE_ERROR;
+
+  *value = isNegative ? (long long) (0ULL - v) : (long long) v;
+  *pos = p;
+  return X_SUCCESS;
+}
+
+/// Parses a floating-point token, with a fast path for integer values that are exactly representable.
+static int ParseDecimalToken(const char **pos, XType type, double *value) {
+  const long long max = (type == X_FLOAT) ? (1LL << 24) : (1LL << 53);
+  const char *start = *pos;
+  long long l;
+  char *end;
+
+  if(ParseIntegerToken(pos, -max, max, &l) == X_SUCCESS) {
+    *value = (l == 0 && *start == '-') ? -0.0 : (double) l;     // keep the sign of negative zero
+    return X_SUCCESS;
+  }
+
+  *value = (type == X_FLOAT) ? xParseFloat(*pos, &end) : xParseDouble(*pos, &end);
+  if(end == *pos || !IsTokenEnd(*end)) return X_PARSE_ERROR;
+
+  *pos = end;
+  return X_SUCCESS;
+}
+
+static int ParseBooleanToken(const char **pos, boolean *value) {
+  char token[16], *end;
+  size_t l;
+
+  for(l = 0; !IsTokenEnd((*pos)[l]); l++) if(l >= sizeof(token) - 1) return X_PARSE_ERROR;
+
+  memcpy(token, *pos, l);
+  token[l] = '\0';
+
+  *value = xParseBoolean(token, &end);
+  if(end != &token[l]) return X_PARSE_ERROR;
+
+  *pos += l;
+  return X_SUCCESS;
+}
+
+static int ParseElements(const char *str, XType type, long count, void *buf) {
+  long i;
+  long long l = 0;
+  double d = 0.0;
+
+  switch(type) {
+    case X_BOOLEAN:
+      for(i = 0; i < count; i++) {
+        prop_error("ParseElements", NextToken(&str));
+        prop_error("ParseElements", ParseBooleanToken(&str, &((boolean *) buf)[i]));
+      }
+      return X_SUCCESS;
+
+    case X_BYTE:
+      for(i = 0; i < count; i++) {
+        prop_error("ParseElements", NextToken(&str));
+        prop_error("ParseElements", ParseIntegerToken(&str, -128, 255, &l));     // accept signed or unsigned bytes
+        ((int8_t *) buf)[i] = (int8_t) l;
+      }
+      return X_SUCCESS;
+
+    case X_INT16:
+      for(i = 0; i < count; i++) {
+        prop_error("ParseElements", NextToken(&str));
+        prop_error("ParseElements", ParseIntegerToken(&str, INT16_MIN, INT16_MAX, &l));
+        ((int16_t *) buf)[i] = (int16_t) l;
+      }
+      return X_SUCCESS;
+
+    case X_INT32:
+      for(i = 0; i < count; i++) {
+        prop_error("ParseElements", NextToken(&str));
+        prop_error("ParseElements", ParseIntegerToken(&str, INT32_MIN, INT32_MAX, &l));
+        ((int32_t *) buf)[i] = (int32_t) l;
+      }
+      return X_SUCCESS;
+
+    case X_INT64:
+      for(i = 0; i < count; i++) {
+        prop_error("ParseElements", NextToken(&str));
+        prop_error("ParseElements", ParseIntegerToken(&str, INT64_MIN, INT64_MAX, &l));
+        ((int64_t *) buf)[i] = (int64_t) l;
+      }
+      return X_SUCCESS;
+
+    case X_FLOAT:
+      for(i = 0; i < count; i++) {
+        prop_error("ParseElements", NextToken(&str));
+        prop_error("ParseElements", ParseDecimalToken(&str, X_FLOAT, &d));
+        ((float *) buf)[i] = (float) d;
+      }
+      return X_SUCCESS;
+
+    case X_DOUBLE:
+      for(i = 0; i < count; i++) {
+        prop_error("ParseElements", NextToken(&str));
+        prop_error("ParseElements", ParseDecimalToken(&str, X_DOUBLE, &d));
+        ((double *) buf)[i] = d;
+      }
+      return X_SUCCESS;
+  }
+
+  return X_TYPE_INVALID;
+}
+
+/**
+ * (<i>for internal use</i>) Prints a single numerical or boolean value, in the same format as xSerializeField()
+ * does, i.e. without `sprintf()` for integers or for integral floating-point values. The output is not terminated.
+ *
+ * @param dst     Buffer, with room for at least 26 characters.
+ * @param type    The numerical or boolean type of the value.
+ * @param value   Pointer to the value.
+ * @return        Pointer to just after the last character printed, or `dst` if the type is not numerical or
+ *                boolean.
+ *
+ * @sa x_parse_scalar()
+ */
+char *x_print_scalar(char *dst, XType type, const void *value) {
+  switch(type) {
+    case X_BOOLEAN:
+      if(*(const boolean *) value) { memcpy(dst, "true", 4); return dst + 4; }
+      memcpy(dst, "false", 5);
+      return dst + 5;
+    case X_BYTE: return PrintInteger(dst, *(const int8_t *) value);
+    case X_INT16: return PrintInteger(dst, *(const int16_t *) value);
+    case X_INT32: return PrintInteger(dst, *(const int32_t *) value);
+    case X_INT64: return PrintInteger(dst, *(const int64_t *) value);
+    case X_FLOAT: return PrintExactFloat(dst, *(const float *) value);
+    case X_DOUBLE: return PrintExactDouble(dst, *(const double *) value);
+  }
+
+  return dst;
+}
+
+/**
+ * (<i>for internal use</i>) Parses a single numerical or boolean value, in the same way as xDeserializeField()
+ * does. Leading and trailing whitespace is allowed, but nothing else may follow the value.
+ *
+ * @param str     String to parse.
+ * @param type    The numerical or boolean type of the value.
+ * @param value   Pointer to where the parsed value is stored.
+ * @return        X_SUCCESS (0) if successful, or else X_NOT_ENOUGH_TOKENS if the string is blank, X_PARSE_ERROR
+ *                if it is not a valid value of the type (or in range), or X_TYPE_INVALID if the type is not
+ *                numerical or boolean.
+ *
+ * @sa x_print_scalar()
+ */
+int x_parse_scalar(const char *str, XType type, void *value) {
+  int status = ParseElements(str, type, 1, value);
+  if(status != X_SUCCESS) return status;
+
+  while(isspace((unsigned char) *str)) str++;
+  for(; *str && !isspace((unsigned char) *str); str++);
+  return NextToken(&str) == X_SUCCESS ? X_PARSE_ERROR : X_SUCCESS;
+}
+
+/// Splits a serialized string value into string elements, or fixed-length character arrays.
+static int SplitStrings(const char *str, XType type, long count, void *buf) {
+  long i;
+
+  for(i = 0; i < count; i++) {
+    const char *end = (count > 1) ? strchr(str, STRING_ELEMENT_SEP) : NULL;
+    size_t l;
+
+    if(!end) {
+      if(i < count - 1) return X_NOT_ENOUGH_TOKENS;
+      end = str + strlen(str);
+    }
+
+    l = end - str;
+
+    if(type == X_STRING) {
+      char *s = (char *) malloc(l + 1);
+      x_check_alloc(s);
+      memcpy(s, str, l);
+      s[l] = '\0';
+      ((char **) buf)[i] = s;
+    }
+    else memcpy((char *) buf + i * (-type), str, l < (size_t) -type ? l : (size_t) -type);
+
+    str = *end ? end + 1 : end;
+  }
+
+  return X_SUCCESS;
+}
+
+/**
+ * Converts a serialized field back to its native binary representation, in situ, given the type and dimensions of
+ * the field. It is the inverse of xSerializeField(). Numerical and boolean elements may be separated by any
+ * whitespace, while the elements of string or fixed-length character arrays must be separated by carriage returns
+ * (`\r`). (Scalar strings are not split, and may contain carriage returns.) Tokens beyond the element count
+ * of the field are ignored.
+ *
+ * Integers, and floating-point values that are written as integers, are parsed by a fast path of their own, while
+ * other floating-point values are parsed by xParseFloat() or xParseDouble(). The native value is stored in a single
+ * allocation of exactly the size required by the field's type and dimensions.
+ *
+ * @param f     Pointer to a field.
+ * @return      X_SUCCESS (0) if successful, or if the field is not serialized. Otherwise X_NULL if the field is
+ *              NULL, X_TYPE_INVALID if the field is a structure or a heterogeneous array, or has an unknown type,
+ *              X_NOT_ENOUGH_TOKENS if the serialized value has fewer elements than the field, or X_PARSE_ERROR if
+ *              an element could not be parsed for the type of the field (or is out of range). The field is left
+ *              unchanged if there was an error.
+ *
+ * @since 1.1
+ *
+ * @sa xSerializeField()
+ */
+int xDeserializeField(XField *f) {
+  static const char *fn = "xDeserializeField";
+
+  long count;
+  char *str;
+  void *buf;
+  int status;
+
+  if(!f) return x_error(X_NULL, EINVAL, fn, "input field is NULL");
+  if(!f->isSerialized) return X_SUCCESS;
+
+  if(f->type == X_STRUCT || f->type == X_FIELD || xElementSizeOf(f->type) <= 0)
+    return x_error(X_TYPE_INVALID, EINVAL, fn, "cannot deserialize type: %d", f->type);
+
+  str = (char *) f->value;
+
+  if(f->type == X_RAW || !str) {
+    // Raw values are just the string itself, which we take over.
+    if(str) {
+      char **raw = (char **) malloc(sizeof(char *));
+      x_check_alloc(raw);
+      *raw = str;
+      f->value = raw;
+    }
+    xClearFieldCache(f);
+    f->isSerialized = FALSE;
+    return X_SUCCESS;
+  }
+
+  count = xGetFieldCount(f);
+
+  buf = calloc(count > 0 ? count : 1, xElementSizeOf(f->type));
+  x_check_alloc(buf);
+
+  if(f->type == X_STRING || xIsCharSequence(f->type)) status = SplitStrings(str, f->type, count, buf);
+  else status = ParseElements(str, f->type, count, buf);
+
+  if(status != X_SUCCESS) {
+    if(f->type == X_STRING) {
+      long i;
+      for(i = 0; i < count; i++) if(((char **) buf)[i]) free(((char **) buf)[i]);
+    }
+    free(buf);
+    return x_error(status, EINVAL, fn, "invalid serialized value for type '%c': %s", xTypeChar(f->type), str);
+  }
+
+  free(str);
+  xClearFieldCache(f);
+
+  f->value = buf;
+  f->isSerialized = FALSE;
+
+  return X_SUCCESS;
+}
+
+/// \cond PRIVATE
+/// Decoded native data, cached for a serialized field
+typedef struct {
+  const void *source;       ///< The serialized value, from which the data was decoded
+  XType type;               ///< The type of the decoded data
+  long count;               ///< The number of decoded elements
+  char data[];              ///< The decoded elements
+} XFieldCache;
+/// \endcond
+
+/**
+ * Returns a pointer to the decoded native element at the specified index in a serialized numerical or boolean
+ * field. The entire serialized value is decoded on first access, and cached with the field, so that subsequent
+ * indexed reads are O(1). The cache is rebuilt if the serialized value, type, or element count of the field changes.
+ * It is safe for multiple threads to build the cache concurrently.
+ *
+ * @param f     Pointer to a serialized field
+ * @param idx   Array index (zero-based) of the element of interest.
+ * @return      Pointer to the decoded element, or NULL if there was an error (errno set).
+ */
+static const void *GetCachedElementAtIndex(const XField *f, int idx) {
+  static const char *fn = "GetCachedElementAtIndex";
+
+  XFieldCache *c, *old;
+  const long count = xGetFieldCount(f);
+  const int eSize = xElementSizeOf(f->type);
+
+  if(!xIsNumeric(f->type) && f->type != X_BOOLEAN) {
+    x_error(0, ENOSR, fn, "cannot convert serialized field of type '%c'", xTypeChar(f->type));
+    return NULL;
+  }
+
+  if(idx < 0 || idx >= count) {
+    x_error(0, EINVAL, fn, "index %d is out of bounds for element count %ld", idx, count);
+    return NULL;
+  }
+
+  old = c = (XFieldCache *) __atomic_load_n(&f->cache, __ATOMIC_ACQUIRE);
+  if(c && c->source == f->value && c->type == f->type && c->count == count) return &c->data[idx * eSize];
+
+  c = (XFieldCache *) malloc(sizeof(XFieldCache) + count * eSize);
+  x_check_alloc(c);
+
+  c->source = f->value;
+  c->type = f->type;
+  c->count = count;
+
+  if(ParseElements((const char *) f->value, f->type, count, c->data) != X_SUCCESS) {
+    free(c);
+    x_error(0, EINVAL, fn, "invalid serialized value for type '%c'", xTypeChar(f->type));
+    return NULL;
+  }
+
+  // Publish the new cache. If another thread beat us to it, use theirs instead.
+  if(__atomic_compare_exchange_n((void **) &f->cache, (void **) &old, c, FALSE, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    if(old) free(old);      // Discard the stale cache.
+  }
+  else {
+    free(c);
+    c = old;
+  }
+
+  return &c->data[idx * eSize];
+}
+
+/**
+ * Discards the decoded data that the library may have cached for a serialized field, e.g. by xGetAsLongAtIndex()
+ * or xGetAsDoubleAtIndex(). The cache is discarded automatically when the field is cleared or (de)serialized, and
+ * it is rebuilt on demand if the serialized value pointer, type or dimensions of the field change. However, if the
+ * application modifies the serialized string in place, or else frees it and assigns a new string (which may
+ * reuse the same address), it should call this function, so that subsequent reads do not return stale data.
+ *
+ * This function is not thread-safe with respect to concurrent reads of the same field.
+ *
+ * @param f     Pointer to a field
+ *
+ * @since 1.1
+ *
+ * @sa xGetAsLongAtIndex()
+ * @sa xGetAsDoubleAtIndex()
+ */
+void xClearFieldCache(XField *f) {
+  if(!f || !f->cache) return;
+  free(f->cache);
+  f->cache = NULL;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "xchange.h"
+#include "xarrow.h"
+
+#define ROWS      100000
+
+static uint32_t getLE(const unsigned char *p, int n) {
+  uint32_t v = 0;
+  while(--n >= 0) v = (v << 8) | p[n];
+  return v;
+}
+
+// Returns a pointer to a field in a FlatBuffers table, or NULL if absent.
+static const unsigned char *getTableField(const unsigned char *table, int i) {
+  const unsigned char *vt = table - (int32_t) getLE(table, 4);
+  int off;
+
+  if(4 + 2 * i >= (int) getLE(vt, 2)) return NULL;
+  off = getLE(&vt[4 + 2 * i], 2);
+  return off ? &table[off] : NULL;
+}
+
+// Checks the messages of a stream, and returns the total number of rows in its record batches, or -1 on error.
+static long checkStream(const unsigned char *data, size_t size, int *batchValue) {
+  size_t pos = 0;
+  long rows = 0;
+  int n;
+
+  for(n = 0; pos + 8 <= size; n++) {
+    const unsigned char *fb, *msg, *p;
+    uint32_t metaLen;
+    long bodyLength;
+
+    if(getLE(&data[pos], 4) != 0xffffffff) return -1;
+    metaLen = getLE(&data[pos + 4], 4);
+    if(metaLen == 0) return rows;       // end-of-stream
+    if((pos + 8 + metaLen) % 8) return -1;
+
+    fb = &data[pos + 8];
+    msg = fb + getLE(fb, 4);
+
+    p = getTableField(msg, 0);
+    if(!p || getLE(p, 2) != 4) return -1;       // V5
+
+    p = getTableField(msg, 3);
+    bodyLength = p ? (long) getLE(p, 4) : 0;
+
+    p = getTableField(msg, 1);
+    if(!p || *p != (n ? 3 : 1)) return -1;      // Schema first, then RecordBatch
+
+    if(n) {
+      const unsigned char *rb = getTableField(msg, 2);
+      rb += getLE(rb, 4);
+      p = getTableField(rb, 0);
+      rows += getLE(p, 4);
+
+      // The first column ('i') has no nulls, so its int32 values start the body.
+      *batchValue = (int) getLE(&data[pos + 8 + metaLen], 4);
+    }
+
+    pos += 8 + metaLen + bodyLength;
+  }
+
+  return -1;
+}
+
+int main() {
+  XStructure *s = (XStructure *) calloc(ROWS, sizeof(XStructure));
+  char *names[] = { "alpha", "b", "ccc" };
+  int i, sizes[] = { ROWS }, value = -1;
+  unsigned char *data;
+  size_t n, m;
+  XField *f;
+  FILE *fp;
+
+  for(i = 0; i < ROWS; i++) {
+    xSetField(&s[i], xCreateIntField("i", i));
+    xSetField(&s[i], xCreateDoubleField("d", 0.5 * i));
+    xSetField(&s[i], xCreateBooleanField("b", i & 1));
+    if(i % 3) xSetField(&s[i], xCreateStringField("s", names[i % 3]));      // nulls in between
+    xSetField(&s[i], xCreate1DField("array", X_INT, 1, &i));                // not exported
+  }
+
+  f = xCreateField("records", X_STRUCT, 1, sizes, s);
+
+  data = (unsigned char *) xarrowEncodeField(f, XARROW_STREAM, &n);
+  if(!data) {
+    perror("ERROR! xarrowEncodeField");
+    return 1;
+  }
+
+  if(checkStream(data, n, &value) != ROWS || value != 65536) {
+    fprintf(stderr, "ERROR! invalid Arrow stream (%d)\n", value);
+    return 1;
+  }
+
+  // Same data written to a file, one batch at a time.
+  fp = fopen("/tmp/test-arrow.arrows", "wb");
+  if(!fp || xarrowWrite(s, ROWS, XARROW_STREAM, fp) != X_SUCCESS) {
+    perror("ERROR! xarrowWrite");
+    return 1;
+  }
+  m = ftell(fp);
+  fclose(fp);
+  remove("/tmp/test-arrow.arrows");
+
+  if(m != n) {
+    fprintf(stderr, "ERROR! xarrowWrite size mismatch: %zu vs %zu\n", m, n);
+    return 1;
+  }
+  free(data);
+
+  data = (unsigned char *) xarrowEncode(s, 3, XARROW_FILE, &n);
+  if(!data || memcmp(data, "ARROW1\0\0", 8) != 0 || memcmp(&data[n - 6], "ARROW1", 6) != 0) {
+    fprintf(stderr, "ERROR! invalid Arrow file magic\n");
+    return 1;
+  }
+
+  if(checkStream(&data[8], n - 8, &value) != 3 || value != 0) {
+    fprintf(stderr, "ERROR! invalid Arrow file stream\n");
+    return 1;
+  }
+
+  m = getLE(&data[n - 10], 4);
+  if(m + 10 > n) {
+    fprintf(stderr, "ERROR! invalid Arrow footer length: %zu\n", m);
+    return 1;
+  }
+  free(data);
+
+  if(xarrowEncode(s, 3, 2, &n) != NULL || xarrowEncode(NULL, 3, XARROW_FILE, &n) != NULL) {
+    fprintf(stderr, "ERROR! accepted invalid arguments\n");
+    return 1;
+  }
+
+  xDestroyField(f);
+
+  fprintf(stdout, "test-arrow: OK\n");
+  return 0;
+}
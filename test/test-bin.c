@@ -0,0 +1,167 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xchange.h"
+#include "xjson.h"
+#include "xbin.h"
+#include "test-codec.h"
+
+// Headers of a single-field structure, with a field named "a" of the given type, flags, and ndim.
+#define FIELD(type, flags, ndim) 'X', 'B', 'I', 'N', 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 'a', \
+        (type) & 0xff, ((type) >> 8) & 0xff, ((type) >> 16) & 0xff, ((type) >> 24) & 0xff, 0, 0, 0, 0, flags, ndim
+
+static int checkInvalid(const char *what, const unsigned char *data, size_t size) {
+  XStructure *s = xbinDecode(data, size);
+  if(s) {
+    fprintf(stderr, "ERROR! decoded %s\n", what);
+    xDestroyStruct(s);
+    return 1;
+  }
+  return 0;
+}
+
+int main() {
+  XStructure *s = createCodecStruct(), *s1;
+  XField *f, *f1;
+  short sh[2][3] = {{1, -2, 3}, {4, 5, -6}};
+  int sizes[] = { 2, 3 }, sizes4[] = { 2, 1, 3, 1 };
+  char *bin;
+  size_t n;
+  int i;
+
+  xSetField(s, xCreateField("short", X_SHORT, 2, sizes, sh));
+  xSetField(s, xCreateStringField("empty", ""));
+
+  bin = xbinEncode(s, &n);
+  if(!bin) {
+    perror("ERROR! xbinEncode");
+    return 1;
+  }
+
+  s1 = xbinDecode(bin, n);
+  if(checkCodecRoundTrip("xbin", s, s1) != 0) return 1;
+
+  f = xGetField(s1, "array4");
+  if(!f || f->ndim != 4 || memcmp(xGetFieldSizes(f), sizes4, sizeof(sizes4)) != 0 || xGetAsLongAtIndex(f, 5, 0) != -6) {
+    fprintf(stderr, "ERROR! decoded 4D field\n");
+    return 1;
+  }
+
+  // Fields that have no JSON representation...
+  xSetField(s, xCreateField("chars", X_CHARS(4), 0, NULL, "abcd"));
+
+  f = xCreateIntField("serialized", 0);
+  free(f->value);
+  f->value = xStringCopyOf("1 2 3");
+  f->isSerialized = TRUE;
+  f->subtype = xStringCopyOf("my-type");
+  xSetField(s, f);
+
+  free(bin);
+  bin = xbinEncode(s, &n);
+  xDestroyStruct(s1);
+  s1 = xbinDecode(bin, n);
+
+  f1 = xGetField(s1, "chars");
+  if(f1->type != X_CHARS(4) || memcmp(f1->value, "abcd", 4) != 0) {
+    fprintf(stderr, "ERROR! mismatched fixed-length chars\n");
+    return 1;
+  }
+
+  f1 = xGetField(s1, "serialized");
+  if(!f1->isSerialized || f1->type != X_INT || strcmp(f1->subtype, "my-type") != 0 || strcmp((char *) f1->value, "1 2 3") != 0) {
+    fprintf(stderr, "ERROR! mismatched serialized field\n");
+    return 1;
+  }
+
+  // NULL strings in arrays must stay NULL
+  f = xGetField(s, "names");
+  free(((char **) f->value)[1]);
+  ((char **) f->value)[1] = NULL;
+  free(bin);
+  bin = xbinEncode(s, &n);
+  xDestroyStruct(s1);
+  s1 = xbinDecode(bin, n);
+  f1 = xGetField(s1, "names");
+  if(((char **) f1->value)[1] != NULL || strcmp(((char **) f1->value)[2], "three") != 0) {
+    fprintf(stderr, "ERROR! mismatched NULL string element\n");
+    return 1;
+  }
+
+  // Any truncation must be caught.
+  for(i = 0; i < (int) n; i++) {
+    XStructure *s2 = xbinDecode(bin, i);
+    if(s2) {
+      fprintf(stderr, "ERROR! decoded truncated binary of %d bytes\n", i);
+      return 1;
+    }
+  }
+
+  // Corrupted data must be decoded or rejected cleanly.
+  for(i = 0; i < (int) n; i++) {
+    static const unsigned char values[] = { 0x00, 0x01, 0x7f, 0x80, 0xff };
+    int k;
+
+    for(k = 0; k < (int) sizeof(values); k++) {
+      char *bad = (char *) malloc(n);
+      XStructure *s2;
+
+      memcpy(bad, bin, n);
+      bad[i] = (char) values[k];
+
+      s2 = xbinDecode(bad, n);
+      if(s2) xDestroyStruct(s2);
+      free(bad);
+    }
+  }
+
+  free(bin);
+  xDestroyStruct(s1);
+
+  {
+    // Fixed-length chars longer than the data itself
+    const unsigned char chars[] = { FIELD(X_CHARS(0x40000000), 0, 1), 0xe8, 0x03, 0, 0 };
+    // A serialized structure
+    const unsigned char serialized[] = { FIELD(X_STRUCT, 1, 0), 4, 0, 0, 0, 'a', 'b', 'c', 'd' };
+    // Dimensions whose product overflows
+    const unsigned char overflow[] = { FIELD(X_INT32, 0, 3), 0xff, 0xff, 0xff, 0x7f, 0xff, 0xff, 0xff, 0x7f, 0xff, 0xff, 0xff, 0x7f };
+    // More strings than there is data for
+    const unsigned char strings[] = { FIELD(X_STRING, 0, 1), 0x00, 0x00, 0x10, 0x00, 0, 0, 0, 0 };
+    // An unknown type
+    const unsigned char unknown[] = { FIELD('Q', 0, 0), 0, 0, 0, 0 };
+    const unsigned char raw[] = { FIELD(X_RAW, 0, 1), 2, 0, 0, 0, 2, 0, 0, 0, 'a', 2, 0, 0, 0, 'b' };
+
+    if(checkInvalid("oversized chars", chars, sizeof(chars))) return 1;
+    if(checkInvalid("serialized structure", serialized, sizeof(serialized))) return 1;
+    if(checkInvalid("overflowing dimensions", overflow, sizeof(overflow))) return 1;
+    if(checkInvalid("too many strings", strings, sizeof(strings))) return 1;
+    if(checkInvalid("unknown type", unknown, sizeof(unknown))) return 1;
+    if(checkInvalid("raw array", raw, sizeof(raw))) return 1;
+  }
+
+  // A string value right at the end of the data
+  s1 = xCreateStruct();
+  xSetField(s1, xCreateStringField("unit", "m"));
+  bin = xbinEncode(s1, &n);
+  xDestroyStruct(s1);
+  s1 = xbinDecode(bin, n);
+  if(!s1 || strcmp(xGetStringValue(xGetField(s1, "unit")), "m") != 0) {
+    fprintf(stderr, "ERROR! trailing string\n");
+    return 1;
+  }
+
+  free(bin);
+  xDestroyStruct(s);
+  xDestroyStruct(s1);
+
+  printf("OK\n");
+  return 0;
+}
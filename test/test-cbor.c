@@ -0,0 +1,107 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xchange.h"
+#include "xjson.h"
+#include "xcbor.h"
+#include "test-codec.h"
+
+int main() {
+  XStructure *s = createCodecStruct(), *s1;
+  XField *f;
+  unsigned char *bin;
+  size_t n;
+  int i;
+
+  // 55799({_ "a": [_ 1, 1.5 (half) ], "b": 40([ [ 2, 2 ], 65(h'0001 0002 0003 FFFF') ]), "c": (_ "h", "i"),
+  //          "d": h'010203', "e": 40([ [ 2 ], [ 1, -1 ] ]) })
+  const unsigned char msg[] = {
+          0xd9, 0xd9, 0xf7,
+          0xbf,
+          0x61, 'a', 0x9f, 0x01, 0xf9, 0x3e, 0x00, 0xff,
+          0x61, 'b', 0xd8, 40, 0x82, 0x82, 0x02, 0x02, 0xd8, 65, 0x48, 0, 1, 0, 2, 0, 3, 0xff, 0xff,
+          0x61, 'c', 0x7f, 0x61, 'h', 0x61, 'i', 0xff,
+          0x61, 'd', 0x43, 1, 2, 3,
+          0x61, 'e', 0xd8, 40, 0x82, 0x81, 0x02, 0x82, 0x01, 0x20,
+          0xff
+  };
+
+  bin = (unsigned char *) xcborEncode(s, &n);
+  if(!bin) {
+    perror("ERROR! xcborEncode");
+    return 1;
+  }
+
+  // The doubles must be an RFC 8746 little-endian typed array (tag 86) of 40 bytes.
+  for(i = 0; i + 4 < (int) n; i++) if(bin[i] == 0xd8 && bin[i+1] == 86 && bin[i+2] == 0x58 && bin[i+3] == 40) break;
+  if(i + 4 >= (int) n || memcmp(&bin[i+4], "\0\0\0\0\0\0\xf0\x3f", 8) != 0) {
+    fprintf(stderr, "ERROR! no little-endian typed array for doubles\n");
+    return 1;
+  }
+
+  s1 = xcborDecode(bin, n);
+  if(checkCodecRoundTrip("CBOR", s, s1) != 0) return 1;
+
+  // Any truncation must be caught.
+  for(i = 0; i < (int) n; i++) {
+    XStructure *s2 = xcborDecode(bin, i);
+    if(s2) {
+      fprintf(stderr, "ERROR! decoded truncated CBOR of %d bytes\n", i);
+      return 1;
+    }
+  }
+
+  free(bin);
+  xDestroyStruct(s);
+  xDestroyStruct(s1);
+
+  // Standard CBOR from elsewhere...
+  s = xcborDecode(msg, sizeof(msg));
+  if(!s) {
+    perror("ERROR! xcborDecode (external)");
+    return 1;
+  }
+
+  f = xGetField(s, "a");
+  if(f->type != X_FLOAT || f->ndim != 1 || f->sizes[0] != 2 || ((float *) f->value)[1] != 1.5) {
+    fprintf(stderr, "ERROR! external 'a' mismatch\n");
+    return 1;
+  }
+
+  f = xGetField(s, "b");
+  if(f->type != X_INT32 || f->ndim != 2 || f->sizes[1] != 2 || ((int32_t *) f->value)[1] != 2 || ((int32_t *) f->value)[3] != 65535) {
+    fprintf(stderr, "ERROR! external 'b' mismatch\n");
+    return 1;
+  }
+
+  f = xGetField(s, "c");
+  if(f->type != X_STRING || strcmp(*(char **) f->value, "hi") != 0) {
+    fprintf(stderr, "ERROR! external 'c' mismatch\n");
+    return 1;
+  }
+
+  f = xGetField(s, "d");
+  if(f->type != X_BYTE || f->sizes[0] != 3 || memcmp(f->value, "\1\2\3", 3) != 0) {
+    fprintf(stderr, "ERROR! external 'd' mismatch\n");
+    return 1;
+  }
+
+  f = xGetField(s, "e");
+  if(f->type != X_INT32 || f->ndim != 1 || f->sizes[0] != 2 || ((int32_t *) f->value)[1] != -1) {
+    fprintf(stderr, "ERROR! external 'e' mismatch\n");
+    return 1;
+  }
+
+  xDestroyStruct(s);
+
+  printf("OK\n");
+  return 0;
+}
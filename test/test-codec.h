@@ -0,0 +1,125 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ *
+ *  A common test structure, and round-trip checks, for the tests of the binary codecs.
+ */
+
+#ifndef TEST_CODEC_H_
+#define TEST_CODEC_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xchange.h"
+#include "xjson.h"
+
+/// The values of the "double" field in the test structure
+static const double codecDoubles[5] = { 1.0, -2.5, 3.14159265358979, 1e-300, 0.0 };
+
+/// Creates the test structure, with all commonly supported field types, including multi-dimensional arrays, a
+/// heterogeneous (`X_FIELD`) array, a nested structure, and an array of structures.
+static inline XStructure *createCodecStruct() {
+  XStructure *s = xCreateStruct(), *sub = xCreateStruct();
+  XStructure *list = (XStructure *) calloc(2, sizeof(XStructure));
+  int array[2][3] = {{1, -200, 3}, {40000, 5, -6}};
+  char *names[] = { "one", "two", "three" };
+  boolean b[] = { TRUE, FALSE, TRUE };
+  int sizes[] = { 2, 3 }, sizes4[] = { 2, 1, 3, 1 };
+
+  int i1[] = { 1, 2 };
+  char *s2[] = { "aa", "bb", "cc" };
+  boolean b3[] = { TRUE };
+
+  // Heterogeneous array...
+  XField *f1 = xCreate1DField(".1", X_INT, 2, i1);
+  XField *f2 = xCreate1DField(".2", X_BOOLEAN, 1, b3);
+  XField *f3 = xCreate1DField(".3", X_STRING, 3, s2);
+  XField fa[] = { *f1, *f2, *f3 };
+
+  // Discard the unused containers (we only used their content...)
+  free(f1);
+  free(f2);
+  free(f3);
+
+  xSetField(s, xCreateBooleanField("bool", TRUE));
+  xSetField(s, xCreateStringField("string", "Hello world!"));
+  xSetField(s, xCreateIntField("int", -10));
+  xSetField(s, xCreateLongField("long", 12345678901L));
+  xSetField(s, xCreate1DField("double", X_DOUBLE, 5, codecDoubles));
+  xSetField(s, xCreateField("array", X_INT, 2, sizes, array));
+  xSetField(s, xCreateField("array4", X_INT, 4, sizes4, array));
+  xSetField(s, xCreate1DField("names", X_STRING, 3, names));
+  xSetField(s, xCreate1DField("bools", X_BOOLEAN, 3, b));
+  xSetField(s, xCreate1DField("mixed", X_FIELD, 3, fa));
+
+  xSetField(sub, xCreateIntField("int", 1154));
+  xSetField(sub, xCreateDoubleField("double", -1.5e100));
+  xSetSubstruct(s, "sub", sub);
+
+  xSetField(&list[0], xCreateIntField("x", 1));
+  xSetField(&list[0], xCreateStringField("name", "first"));
+  xSetField(&list[1], xCreateIntField("x", 2));
+  xSetField(&list[1], xCreateStringField("name", "second"));
+  xSetField(s, xCreate1DField("list", X_STRUCT, 2, list));
+
+  return s;
+}
+
+/// Checks that a decoded structure matches the original, in its JSON representation, and in the exact double
+/// values, and that the parents of the decoded substructures are set.
+static inline int checkCodecRoundTrip(const char *codec, const XStructure *s, XStructure *s1) {
+  const XField *f;
+  char *str, *str1;
+  int i, status = 0;
+
+  if(!s1) {
+    fprintf(stderr, "ERROR! %s: round trip failed\n", codec);
+    return 1;
+  }
+
+  str = xjsonToString(s);
+  str1 = xjsonToString(s1);
+  if(!str || !str1 || strcmp(str, str1) != 0) {
+    fprintf(stderr, "ERROR! %s: mismatched JSON after round trip:\n%s\n---\n%s\n", codec, str, str1);
+    status = 1;
+  }
+  free(str);
+  free(str1);
+  if(status) return status;
+
+  f = xGetField(s1, "double");
+  if(!f || f->type != X_DOUBLE || memcmp(f->value, codecDoubles, sizeof(codecDoubles)) != 0) {
+    fprintf(stderr, "ERROR! %s: mismatched double values\n", codec);
+    return 1;
+  }
+
+  f = xGetField(s1, "sub");
+  if(!f || ((XStructure *) f->value)->parent != s1) {
+    fprintf(stderr, "ERROR! %s: substructure parent not set\n", codec);
+    return 1;
+  }
+
+  f = xGetField(s1, "mixed");
+  if(!f || f->type != X_FIELD || xGetFieldCount(f) != 3 || ((XField *) f->value)[2].type != X_STRING) {
+    fprintf(stderr, "ERROR! %s: mismatched heterogeneous array\n", codec);
+    return 1;
+  }
+
+  f = xGetField(s1, "list");
+  if(!f || f->type != X_STRUCT || xGetFieldCount(f) != 2) {
+    fprintf(stderr, "ERROR! %s: mismatched structure array\n", codec);
+    return 1;
+  }
+  for(i = 0; i < 2; i++) if(((XStructure *) f->value)[i].parent != s1) {
+    fprintf(stderr, "ERROR! %s: parent of structure array element %d not set\n", codec, i);
+    return 1;
+  }
+
+  return 0;
+}
+
+#endif /* TEST_CODEC_H_ */
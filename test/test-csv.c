@@ -0,0 +1,144 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xchange.h"
+#include "xcsv.h"
+
+#define ROWS      1000
+
+static const char *fileName = "/tmp/test-csv.csv";
+
+static XField *readBack(char delim, const XStructure *proto) {
+  FILE *fp = fopen(fileName, "rb");
+  XField *f;
+
+  if(!fp) return NULL;
+  f = xcsvRead("table", fp, delim, proto);
+  fclose(fp);
+  return f;
+}
+
+static int writeText(const char *text) {
+  FILE *fp = fopen(fileName, "wb");
+  if(!fp) return -1;
+  fputs(text, fp);
+  fclose(fp);
+  return 0;
+}
+
+int main() {
+  XStructure *s = (XStructure *) calloc(ROWS, sizeof(XStructure)), *r, *proto;
+  char *names[] = { "plain", "with, comma", "\"quoted\"\r\nline", "" };
+  XField *f;
+  FILE *fp;
+  int i, sizes[2] = {1, 2};
+
+  for(i = 0; i < ROWS; i++) {
+    XStructure *sub = xCreateStruct();
+
+    xSetField(&s[i], xCreateIntField("i", i));
+    xSetField(&s[i], xCreateDoubleField("d", i + 0.25));
+    xSetField(&s[i], xCreateBooleanField("b", i & 1));
+    if(i % 5 != 1) xSetField(&s[i], xCreateStringField("s", names[i % 4]));   // some missing
+    xSetField(&s[i], xCreateLongField("l", 10000000000LL * i));
+    xSetField(sub, xCreateIntField("x", -i));
+    xSetSubstruct(&s[i], "sub", sub);
+    xSetField(&s[i], xCreate1DField("array", X_INT, 2, sizes));         // not a column
+  }
+
+  // CSV
+  fp = fopen(fileName, "wb");
+  if(!fp || xcsvWrite(s, ROWS, XCSV_COMMA, fp) != X_SUCCESS) {
+    perror("ERROR! xcsvWrite");
+    return 1;
+  }
+  fclose(fp);
+
+  f = readBack(XCSV_COMMA, NULL);
+  if(!f || f->type != X_STRUCT || f->sizes[0] != ROWS) {
+    perror("ERROR! xcsvRead");
+    return 1;
+  }
+
+  r = (XStructure *) f->value;
+  for(i = 0; i < ROWS; i++) {
+    XField *e = xGetField(&r[i], "s");
+
+    if(xGetField(&r[i], "i")->type != X_INT || xGetAsLong(xGetField(&r[i], "i"), -1) != i
+            || xGetAsDouble(xGetField(&r[i], "d")) != i + 0.25 || *(boolean *) xGetField(&r[i], "b")->value != (i & 1)
+            || xGetField(&r[i], "l")->type != X_LLONG || *(long long *) xGetField(&r[i], "l")->value != 10000000000LL * i
+            || xGetAsLong(xGetField(&r[i], "sub:x"), 1) != -i || xGetField(&r[i], "array")) {
+      fprintf(stderr, "ERROR! CSV row %d\n", i);
+      return 1;
+    }
+
+    if((i % 5 != 1) ? (!e || strcmp(*(char **) e->value, names[i % 4]) != 0) : (e != NULL)) {
+      fprintf(stderr, "ERROR! CSV string in row %d\n", i);
+      return 1;
+    }
+  }
+  xDestroyField(f);
+
+  // TSV, with a prototype for the types
+  fp = fopen(fileName, "wb");
+  if(!fp || xcsvWrite(s, ROWS, XCSV_TAB, fp) != X_SUCCESS) {
+    perror("ERROR! xcsvWrite TSV");
+    return 1;
+  }
+  fclose(fp);
+
+  proto = xCreateStruct();
+  xSetField(proto, xCreateScalarField("i", X_SHORT, &i));
+  xSetField(proto, xCreateScalarField("d", X_FLOAT, &i));
+
+  f = readBack(XCSV_TAB, proto);
+  r = f ? (XStructure *) f->value : NULL;
+  if(!r || xGetField(&r[7], "i")->type != X_SHORT || *(short *) xGetField(&r[7], "i")->value != 7
+          || *(float *) xGetField(&r[7], "d")->value != 7.25f) {
+    fprintf(stderr, "ERROR! TSV with prototype\n");
+    return 1;
+  }
+  xDestroyField(f);
+
+  // Prototype type mismatch
+  writeText("i,d\n1,2\nx,3\n");
+  if(readBack(XCSV_COMMA, proto) != NULL) {
+    fprintf(stderr, "ERROR! accepted invalid value\n");
+    return 1;
+  }
+  xDestroyStruct(proto);
+
+  // Ragged rows, blank lines, no final line break, and type promotion
+  writeText("a,b,c\r\n1,true\r\n\r\n2.5,FALSE,x,extra\r\n3,,\"\"");
+  f = readBack(XCSV_COMMA, NULL);
+  r = f ? (XStructure *) f->value : NULL;
+  if(!r || f->sizes[0] != 3 || xGetField(&r[0], "a")->type != X_DOUBLE || xGetField(&r[1], "b")->type != X_BOOLEAN
+          || xGetField(&r[0], "c") || strcmp(*(char **) xGetField(&r[1], "c")->value, "x") != 0
+          || xCountFields(&r[1]) != 3 || strcmp(*(char **) xGetField(&r[2], "c")->value, "") != 0) {
+    fprintf(stderr, "ERROR! ragged table\n");
+    return 1;
+  }
+  xDestroyField(f);
+
+  writeText("a\n\"unterminated\n");
+  if(readBack(XCSV_COMMA, NULL) != NULL) {
+    fprintf(stderr, "ERROR! accepted unterminated quote\n");
+    return 1;
+  }
+
+  remove(fileName);
+
+  for(i = 0; i < ROWS; i++) xClearStruct(&s[i]);
+  free(s);
+
+  fprintf(stdout, "test-csv: OK\n");
+  return 0;
+}
@@ -0,0 +1,335 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "xchange.h"
+#include "xjson.h"
+#include "xfrozen.h"
+#include "test-codec.h"
+
+static int check(const XFrozenStruct *root) {
+  const XFrozenField *f;
+  const char *sub;
+  int sizes[X_MAX_DIMS] = {0};
+
+  if(xfrozenCountFields(root) != 13) {
+    fprintf(stderr, "ERROR! wrong field count: %d\n", xfrozenCountFields(root));
+    return 1;
+  }
+
+  if(strcmp(xfrozenGetName(xfrozenGetFieldByIndex(root, 0)), "bool") != 0) {
+    fprintf(stderr, "ERROR! fields out of order\n");
+    return 1;
+  }
+
+  f = xfrozenGetField(root, "array");
+  if(!f || xfrozenGetType(f) != X_INT || xfrozenGetDims(f, sizes) != 2 || sizes[0] != 2 || sizes[1] != 3) {
+    fprintf(stderr, "ERROR! wrong 'array' field\n");
+    return 1;
+  }
+  if(xfrozenGetFieldCount(f) != 6 || *(const int *) xfrozenGetElementAtIndex(f, 4) != 5) {
+    fprintf(stderr, "ERROR! wrong 'array' element\n");
+    return 1;
+  }
+
+  f = xfrozenGetField(root, "names");
+  if(!f || strcmp(xfrozenGetStringAtIndex(f, 2), "three") != 0 || xfrozenGetStringAtIndex(f, 1) != NULL) {
+    fprintf(stderr, "ERROR! wrong 'names' element\n");
+    return 1;
+  }
+
+  f = xfrozenGetField(root, "mixed");
+  if(!f || xfrozenGetType(f) != X_FIELD || xfrozenGetFieldCount(f) != 3
+          || strcmp(xfrozenGetStringAtIndex(xfrozenGetFieldAtIndex(f, 2), 1), "bb") != 0) {
+    fprintf(stderr, "ERROR! wrong 'mixed' field\n");
+    return 1;
+  }
+
+  f = xfrozenGetField(root, "list");
+  if(!f || xfrozenGetType(f) != X_STRUCT || xfrozenGetFieldCount(f) != 2
+          || strcmp(xfrozenGetStringAtIndex(xfrozenGetField(xfrozenGetStructAtIndex(f, 1), "name"), 0), "second") != 0) {
+    fprintf(stderr, "ERROR! wrong 'list' field\n");
+    return 1;
+  }
+
+  f = xfrozenGetField(root, "serial");
+  if(!f || !xfrozenIsSerialized(f) || strcmp((const char *) xfrozenGetValue(f), "1 2 3") != 0) {
+    fprintf(stderr, "ERROR! wrong 'serial' field\n");
+    return 1;
+  }
+
+  f = xfrozenGetField(root, "sub:double");
+  if(!f || *(const double *) xfrozenGetElementAtIndex(f, 0) != -1.5e100) {
+    fprintf(stderr, "ERROR! wrong 'sub:double' field\n");
+    return 1;
+  }
+
+  sub = xfrozenGetSubtype(xfrozenGetField(root, "sub"));
+  if(!sub || strcmp(sub, "test") != 0) {
+    fprintf(stderr, "ERROR! wrong subtype for 'sub'\n");
+    return 1;
+  }
+
+  if(xfrozenGetField(root, "sub:nothing") || xfrozenGetField(root, "int:x") || xfrozenGetField(root, "i")) {
+    fprintf(stderr, "ERROR! found non-existent field\n");
+    return 1;
+  }
+
+  if(xfrozenGetElementAtIndex(xfrozenGetField(root, "array"), 6) || xfrozenGetElementAtIndex(xfrozenGetField(root, "names"), 0)) {
+    fprintf(stderr, "ERROR! accepted invalid element access\n");
+    return 1;
+  }
+
+  return 0;
+}
+
+#define PUBLICATIONS    2000
+
+static XFrozenSegment *writer;
+static XStructure *published;
+
+static void *publish(void *arg) {
+  int i;
+  (void) arg;
+  for(i = 0; i < PUBLICATIONS; i++) xfrozenPublish(writer, published);
+  return NULL;
+}
+
+// Accesses everything in a frozen structure that was accepted by xfrozenRoot().
+static void visit(const XFrozenStruct *s) {
+  int i, sizes[X_MAX_DIMS];
+
+  for(i = 0; i < xfrozenCountFields(s); i++) {
+    const XFrozenField *f = xfrozenGetFieldByIndex(s, i);
+    long k, n = xfrozenGetFieldCount(f);
+
+    xfrozenGetField(s, xfrozenGetName(f));
+    xfrozenGetSubtype(f);
+    xfrozenGetDims(f, sizes);
+
+    if(xfrozenIsSerialized(f) || !xfrozenGetValue(f)) continue;
+
+    for(k = 0; k < n; k++) switch(xfrozenGetType(f)) {
+      case X_STRING:
+      case X_RAW: {
+        const char *str = xfrozenGetStringAtIndex(f, k);
+        if(str) (void) strlen(str);
+        break;
+      }
+      case X_STRUCT: visit(xfrozenGetStructAtIndex(f, k)); break;
+      case X_FIELD: xfrozenGetName(xfrozenGetFieldAtIndex(f, k)); break;
+      default: xfrozenGetElementAtIndex(f, k);
+    }
+  }
+}
+
+int main() {
+  XStructure *s = createCodecStruct(), *s1, *s2;
+  XField *f;
+  const void *mapped;
+  char *image, *str;
+  const char *fileName = "/tmp/test-frozen.bin";
+  const char *segmentName = "/test-frozen";
+  XFrozenSegment *reader;
+  pthread_t thread;
+  uint64_t gen = 0;
+  size_t n, m, i;
+  FILE *fp;
+
+  // A NULL string element, a serialized field, and a subtype
+  f = xGetField(s, "names");
+  free(((char **) f->value)[1]);
+  ((char **) f->value)[1] = NULL;
+
+  f = xCreateIntField("serial", 0);
+  free(f->value);
+  f->value = xStringCopyOf("1 2 3");
+  f->isSerialized = TRUE;
+  xSetField(s, f);
+
+  xGetField(s, "sub")->subtype = xStringCopyOf("test");
+
+  image = (char *) xfrozenCreate(s, &n);
+  if(!image) {
+    perror("ERROR! xfrozenCreate");
+    return 1;
+  }
+
+  if(check(xfrozenRoot(image, n)) != 0) return 1;
+
+  if(xfrozenRoot(image, n - 8) != NULL) {
+    fprintf(stderr, "ERROR! accepted truncated image\n");
+    return 1;
+  }
+
+  // Corrupted images must be rejected, or else be safe to access.
+  xSetDebug(FALSE);
+  for(i = 0; i < n; i++) {
+    static const unsigned char values[] = { 0x00, 0x01, 0x7f, 0x80, 0xff };
+    int k;
+
+    for(k = 0; k < (int) sizeof(values); k++) {
+      char *bad = (char *) malloc(n);
+      const XFrozenStruct *root;
+
+      memcpy(bad, image, n);
+      bad[i] = (char) values[k];
+
+      root = xfrozenRoot(bad, n);
+      if(root) {
+        visit(root);
+        xDestroyStruct(xfrozenThaw(root));
+      }
+      free(bad);
+    }
+  }
+
+  {
+    // A field index out of range (the index follows the fields of the root structure)
+    const XFrozenStruct *root = xfrozenRoot(image, n);
+    const char *f0 = (const char *) xfrozenGetFieldByIndex(root, 0), *f1 = (const char *) xfrozenGetFieldByIndex(root, 1);
+    char *bad = (char *) malloc(n);
+
+    memcpy(bad, image, n);
+    *(int32_t *) (bad + (f0 - image) + xfrozenCountFields(root) * (f1 - f0)) = xfrozenCountFields(root);
+    if(xfrozenRoot(bad, n) != NULL) {
+      fprintf(stderr, "ERROR! accepted invalid field index\n");
+      return 1;
+    }
+    free(bad);
+  }
+  xSetDebug(TRUE);
+
+  // Thaw and compare (without the serialized field, which JSON does not represent)
+  s1 = xfrozenThaw(xfrozenRoot(image, n));
+  if(!s1) {
+    perror("ERROR! xfrozenThaw");
+    return 1;
+  }
+
+  f = xGetField(s1, "serial");
+  if(!f || !f->isSerialized || strcmp((char *) f->value, "1 2 3") != 0) {
+    fprintf(stderr, "ERROR! wrong thawed 'serial' field\n");
+    return 1;
+  }
+  xDestroyField(xRemoveField(s, "serial"));
+  xDestroyField(xRemoveField(s1, "serial"));
+  xDestroyField(xRemoveField(s, "names"));
+  xDestroyField(xRemoveField(s1, "names"));
+
+  if(checkCodecRoundTrip("frozen", s, s1) != 0) return 1;
+  xDestroyStruct(s1);
+
+  // Write to file, and query the memory mapped image
+  fp = fopen(fileName, "wb");
+  if(!fp || fwrite(image, 1, n, fp) != n) {
+    perror("ERROR! writing image");
+    return 1;
+  }
+  fclose(fp);
+
+  mapped = xfrozenMapFile(fileName, &m);
+  remove(fileName);
+  if(!mapped || m != n) {
+    perror("ERROR! xfrozenMapFile");
+    return 1;
+  }
+
+  if(check(xfrozenRoot(mapped, m)) != 0) return 1;
+
+  xfrozenUnmapFile(mapped, m);
+
+  // Publish (the complete original) to shared memory, and read it from another mapping
+  s1 = xfrozenThaw(xfrozenRoot(image, n));
+  xfrozenRemoveSegment(segmentName);    // in case it was left over...
+  writer = xfrozenCreateSegment(segmentName, n);
+  reader = xfrozenAttachSegment(segmentName);
+  if(!writer || !reader) {
+    perror("ERROR! shared segment");
+    return 1;
+  }
+
+  xSetDebug(FALSE);
+  if(xfrozenBeginRead(reader, &gen) != NULL) {
+    fprintf(stderr, "ERROR! read from empty segment\n");
+    return 1;
+  }
+  xSetDebug(TRUE);
+
+  if(xfrozenPublish(writer, s1) != X_SUCCESS || xfrozenGetGeneration(reader) != 1) {
+    fprintf(stderr, "ERROR! xfrozenPublish\n");
+    return 1;
+  }
+
+  if(check(xfrozenBeginRead(reader, &gen)) != 0 || gen != 1 || !xfrozenEndRead(reader, gen)) {
+    fprintf(stderr, "ERROR! in-place read from segment\n");
+    return 1;
+  }
+
+  // After two more publications, the first image is gone.
+  xfrozenPublish(writer, s1);
+  if(!xfrozenEndRead(reader, gen)) {
+    fprintf(stderr, "ERROR! image overwritten too soon\n");
+    return 1;
+  }
+  xfrozenPublish(writer, s1);
+  if(xfrozenEndRead(reader, gen)) {
+    fprintf(stderr, "ERROR! overwritten image not detected\n");
+    return 1;
+  }
+
+  s2 = xfrozenSnapshot(reader, &gen);
+  str = s2 ? xfrozenCreate(s2, &m) : NULL;
+  if(gen != 3 || !str || check(xfrozenRoot(str, m)) != 0) {
+    fprintf(stderr, "ERROR! xfrozenSnapshot\n");
+    return 1;
+  }
+  free(str);
+  xDestroyStruct(s2);
+
+  // Snapshots while the publisher keeps overwriting the slots
+  published = s1;
+  pthread_create(&thread, NULL, publish, NULL);
+  xSetDebug(FALSE);
+  for(i = 0; i < PUBLICATIONS; i++) {
+    s2 = xfrozenSnapshot(reader, &gen);
+    if(!s2) continue;   // too fast to get a snapshot
+    str = xfrozenCreate(s2, &m);
+    if(!str || check(xfrozenRoot(str, m)) != 0) {
+      fprintf(stderr, "ERROR! xfrozenSnapshot during publication\n");
+      return 1;
+    }
+    free(str);
+    xDestroyStruct(s2);
+  }
+  xSetDebug(TRUE);
+  pthread_join(thread, NULL);
+
+  // Too large for the segment
+  xSetField(s1, xCreateStringField("extra", "does not fit"));
+  xSetDebug(FALSE);
+  if(xfrozenPublish(writer, s1) == X_SUCCESS) {
+    fprintf(stderr, "ERROR! published oversized image\n");
+    return 1;
+  }
+  xSetDebug(TRUE);
+
+  xfrozenCloseSegment(reader);
+  xfrozenCloseSegment(writer);
+  if(xfrozenRemoveSegment(segmentName) != X_SUCCESS) return 1;
+  xDestroyStruct(s1);
+
+  free(image);
+  xDestroyStruct(s);
+
+  fprintf(stdout, "test-frozen: OK\n");
+  return 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "xchange.h"
+#include "xjson.h"
+#include "xbin.h"
+
+#define THREADS       4
+#define NAMES         10000
+
+static const char *atoms[THREADS][NAMES];
+static const int mult[THREADS] = { 1, 3, 7, 9 };
+
+static void *run(void *arg) {
+  int k = *(int *) arg, i;
+
+  for(i = 0; i < NAMES; i++) {
+    char name[20];
+    sprintf(name, "name%d", (i * mult[k]) % NAMES);
+    atoms[k][(i * mult[k]) % NAMES] = xInternName(name);
+  }
+
+  return NULL;
+}
+
+int main() {
+  XStructure *s, *s1;
+  XField *f, *f1;
+  pthread_t threads[THREADS];
+  int ids[THREADS], i, k, result = 0;
+  char name[20], *json, longName[100];
+  const char *value;
+  void *bin;
+  size_t n = 0;
+
+  value = xInternName("value");
+  strcpy(name, "value");
+  if(!value || xInternName(name) != value || strcmp(value, "value") != 0 || xInternName("unit") == value) {
+    fprintf(stderr, "ERROR! xInternName()\n");
+    result = 1;
+  }
+  if(!xIsInternedName(value) || xIsInternedName(name) || xIsInternedName(NULL)) {
+    fprintf(stderr, "ERROR! xIsInternedName()\n");
+    result = 1;
+  }
+
+  // Concurrent interning (and table growth)
+  for(i = 0; i < THREADS; i++) {
+    ids[i] = i;
+    pthread_create(&threads[i], NULL, run, &ids[i]);
+  }
+  for(i = 0; i < THREADS; i++) pthread_join(threads[i], NULL);
+
+  for(i = 0; i < NAMES; i++) {
+    sprintf(name, "name%d", i);
+    for(k = 0; k < THREADS; k++) if(!atoms[k][i] || atoms[k][i] != atoms[0][i] || strcmp(atoms[k][i], name) != 0) break;
+    if(k < THREADS || xInternName(name) != atoms[0][i]) {
+      fprintf(stderr, "ERROR! concurrently interned '%s'\n", name);
+      result = 1;
+      break;
+    }
+  }
+
+  // Automatic interning of field names
+  xSetNameInterning(TRUE);
+  if(!xIsNameInterning()) {
+    fprintf(stderr, "ERROR! xIsNameInterning()\n");
+    result = 1;
+  }
+
+  s = xCreateStruct();
+  for(i = 0; i < 100; i++) {
+    XStructure *sub = xCreateStruct();
+    xSetField(sub, xCreateIntField("value", i));
+    xSetField(sub, xCreateStringField("unit", "m"));
+    sprintf(name, "s%d", i);
+    xSetSubstruct(s, name, sub);
+  }
+
+  f = xGetField(s, "s0:value");
+  f1 = xGetField(s, "s99:value");
+  if(!f || f->name != value || f1->name != value || xGetField(xGetSubstruct(s, "s1"), value) == NULL) {
+    fprintf(stderr, "ERROR! interned field names\n");
+    result = 1;
+  }
+
+  memset(longName, 'x', sizeof(longName) - 1);
+  longName[sizeof(longName) - 1] = '\0';
+  f = xCreateIntField(longName, 1);
+  if(xIsInternedName(f->name)) {
+    fprintf(stderr, "ERROR! interned long name\n");
+    result = 1;
+  }
+  xDestroyField(f);
+
+  // Parsed, decoded, and copied structures
+  json = xjsonToString(s);
+  s1 = xjsonParseString(json, NULL);
+  free(json);
+  if(!s1 || xGetField(s1, "s42:unit")->name != xGetField(s, "s0:unit")->name) {
+    fprintf(stderr, "ERROR! parsed interned names\n");
+    result = 1;
+  }
+  xDestroyStruct(s1);
+
+  bin = xbinEncode(s, &n);
+  s1 = xbinDecode(bin, n);
+  free(bin);
+  if(!s1 || xGetField(s1, "s42:value")->name != value) {
+    fprintf(stderr, "ERROR! decoded interned names\n");
+    result = 1;
+  }
+  xDestroyStruct(s1);
+
+  s1 = xCopyOfStruct(s);
+  if(!s1 || xGetField(s1, "s7:value")->name != value) {
+    fprintf(stderr, "ERROR! copied interned names\n");
+    result = 1;
+  }
+
+  // Interned names are released properly after interning is disabled.
+  xSetNameInterning(FALSE);
+  f = xCreateIntField("value", -1);
+  if(f->name == value) {
+    fprintf(stderr, "ERROR! uninterned field name\n");
+    result = 1;
+  }
+  f = xSetField(xGetSubstruct(s1, "s3"), f);
+  xDestroyField(f);
+  if(xGetAsLong(xGetField(s1, "s3:value"), 0) != -1) {
+    fprintf(stderr, "ERROR! replaced interned field\n");
+    result = 1;
+  }
+
+  xDestroyStruct(s1);
+  xDestroyStruct(s);
+
+  if(!result) fprintf(stdout, "test-intern: OK\n");
+  return result;
+}
@@ -55,6 +55,266 @@ static XStructure *createStruct() {
 }
 
 
+static int checkParallel() {
+  XStructure *s = xCreateStruct();
+  char *str, *str1;
+  int i, status = 0;
+
+  for(i = 0; i < 64; i++) {
+    double data[2000];
+    char name[20];
+    int k;
+
+    for(k = 0; k < 2000; k++) data[k] = 1e-3 * i * k;
+
+    sprintf(name, "field-%d", i);
+    xSetField(s, xCreate1DField(name, X_DOUBLE, 2000, data));
+  }
+
+  str = xjsonToString(s);
+
+  xjsonSetThreads(4);
+  str1 = xjsonToString(s);
+  xjsonSetThreads(1);
+
+  if(!str1 || strcmp(str, str1) != 0) {
+    fprintf(stderr, "ERROR! parallel JSON differs from serial.\n");
+    status = 1;
+  }
+
+  free(str);
+  free(str1);
+  xDestroyStruct(s);
+
+  return status;
+}
+
+static int checkPlan() {
+  XStructure *s = createStruct();
+  XJsonPlan *plan = xjsonCompile(s);
+  XField *f;
+  char *str, *str1;
+  int status = 0;
+
+  if(!plan) {
+    fprintf(stderr, "ERROR! could not compile plan.\n");
+    return 1;
+  }
+
+  // Change some values...
+  *(int *) xGetField(s, "int")->value = 42;
+  f = xGetField(s, "sub" X_SEP "string");
+  free(*(char **) f->value);
+  *(char **) f->value = xStringCopyOf("A different \"string\" now");
+
+  str = xjsonToString(s);
+  str1 = xjsonRender(plan, s);
+
+  if(!str1 || strcmp(str, str1) != 0) {
+    fprintf(stderr, "ERROR! rendered JSON differs from xjsonToString().\n");
+    status = 1;
+  }
+
+  free(str);
+  free(str1);
+
+  // Changed layout
+  xDestroyField(xRemoveField(s, "double"));
+  str1 = xjsonRender(plan, s);
+  if(str1) {
+    fprintf(stderr, "ERROR! rendered JSON with mismatched layout.\n");
+    free(str1);
+    status = 1;
+  }
+
+  xjsonDestroyPlan(plan);
+  xDestroyStruct(s);
+
+  return status;
+}
+
+static int checkBase64() {
+  XStructure *s = xCreateStruct(), *s1;
+  double d[2][300];
+  short k[1000];
+  char *str, *str1;
+  int sizes[] = {2, 300}, sizes4[] = {2, 5, 2, 10}, tiny[] = {2, 1, 3, 1};
+  int i, status = 0;
+
+  for(i = 0; i < 600; i++) d[i / 300][i % 300] = 1.0 / (i + 1);
+  for(i = 0; i < 1000; i++) k[i] = (short) (i * 37 - 16000);
+
+  xSetField(s, xCreateField("double", X_DOUBLE, 2, sizes, d));
+  xSetField(s, xCreate1DField("short", X_SHORT, 1000, k));
+  xSetField(s, xCreate1DField("small", X_SHORT, 3, k));
+  xSetField(s, xCreateField("short4", X_SHORT, 4, sizes4, k));
+  xSetField(s, xCreateField("tiny4", X_SHORT, 4, tiny, k));
+
+  xjsonSetBase64Threshold(100);
+  str = xjsonToString(s);
+  xjsonSetBase64Threshold(0);
+
+  if(!str || !strstr(str, "\"$base64\"")) {
+    fprintf(stderr, "ERROR! no base64 encoded arrays in JSON.\n");
+    return 1;
+  }
+
+  s1 = xjsonParseString(str, NULL);
+  str1 = xjsonToString(s1);
+  free(str);
+
+  str = xjsonToString(s);
+  if(!str1 || strcmp(str, str1) != 0) {
+    fprintf(stderr, "ERROR! base64 round trip differs.\n");
+    status = 1;
+  }
+
+  if(memcmp(xGetFieldSizes(xGetField(s1, "short4")), sizes4, sizeof(sizes4)) != 0
+          || memcmp(xGetFieldSizes(xGetField(s1, "tiny4")), tiny, sizeof(tiny)) != 0) {
+    fprintf(stderr, "ERROR! 4D dimensions after round trip.\n");
+    status = 1;
+  }
+
+  free(str);
+  free(str1);
+  xDestroyStruct(s);
+  xDestroyStruct(s1);
+
+  // User objects with the same keys, which are not base64 arrays, are kept as objects.
+  xSetDebug(FALSE);
+  s = xjsonParseString("{ \"meta\": { \"$type\": \"note\", \"$dims\": \"abc\", \"$base64\": \"not really\" },"
+          " \"bad\": { \"$type\": \"D\", \"$dims\": [ 2 ], \"$base64\": \"!!\" }, \"x\": 1 }", NULL);
+  xSetDebug(TRUE);
+  if(!s || xGetField(s, "meta")->type != X_STRUCT || xGetField(s, "bad")->type != X_STRUCT
+          || strcmp(xGetStringValue(xGetField(s, "meta" X_SEP "$type")), "note") != 0 || xGetAsLong(xGetField(s, "x"), 0) != 1) {
+    fprintf(stderr, "ERROR! user object with base64 keys.\n");
+    status = 1;
+  }
+  xDestroyStruct(s);
+
+  return status;
+}
+
+static int checkIOVector() {
+  XStructure *s = createStruct();
+  XJsonIOVector *v;
+  char text[1000], *str, *str1;
+  int i, n = 0, status = 0;
+
+  memset(text, 'x', sizeof(text) - 1);
+  text[sizeof(text) - 1] = '\0';
+  xSetField(s, xCreateStringField("long-string", text));
+
+  text[500] = '\n';
+  xSetField(s, xCreateStringField("long-escaped", text));
+
+  str = xjsonToString(s);
+
+  v = xjsonToIOVector(s);
+  if(!v) {
+    fprintf(stderr, "ERROR! could not create I/O vectors.\n");
+    return 1;
+  }
+
+  for(i = 0; i < v->n; i++) n += v->iov[i].iov_len;
+
+  str1 = (char *) malloc(n + 1);
+  for(i = 0, n = 0; i < v->n; i++) {
+    memcpy(&str1[n], v->iov[i].iov_base, v->iov[i].iov_len);
+    n += v->iov[i].iov_len;
+  }
+  str1[n] = '\0';
+
+  if(v->n != 3) {
+    fprintf(stderr, "ERROR! expected 3 I/O vectors, got %d.\n", v->n);
+    status = 1;
+  }
+
+  if(strcmp(str, str1) != 0) {
+    fprintf(stderr, "ERROR! I/O vectors differ from JSON string.\n");
+    status = 1;
+  }
+
+  free(str);
+  free(str1);
+  xjsonDestroyIOVector(v);
+  xDestroyStruct(s);
+
+  return status;
+}
+
+static int checkDiff() {
+  XStructure *s = createStruct(), *s1 = createStruct();
+  XStructure *sub;
+  char *patch;
+  int i, status = 0;
+
+  patch = xjsonDiff(s, s1);
+  if(!patch || strcmp(patch, "[ ]\n") != 0) {
+    fprintf(stderr, "ERROR! non-empty patch for identical structures:\n%s\n", patch ? patch : "(null)");
+    status = 1;
+  }
+  if(patch) free(patch);
+
+  *(int *) xGetField(s1, "int")->value = 42;
+  xDestroyField(xRemoveField(s1, "double"));
+  sub = xGetSubstruct(s1, "sub");
+  xSetField(sub, xCreateStringField("new/name", "value"));
+
+  patch = xjsonDiff(s, s1);
+  if(!patch) {
+    fprintf(stderr, "ERROR! could not create patch.\n");
+    return 1;
+  }
+
+  if(!strstr(patch, "{ \"op\": \"replace\", \"path\": \"/int\", \"value\": 42 }")
+          || !strstr(patch, "{ \"op\": \"remove\", \"path\": \"/double\" }")
+          || !strstr(patch, "{ \"op\": \"add\", \"path\": \"/sub/new~1name\", \"value\": \"value\" }")) {
+    fprintf(stderr, "ERROR! unexpected patch:\n%s\n", patch);
+    status = 1;
+  }
+
+  free(patch);
+
+  // Changed serialized fields are emitted as (serialized) strings
+  for(i = 0; i < 2; i++) {
+    int values[] = { 1, 2, i + 3 };
+    XField *f = xCreate1DField("serial", X_INT, 3, values);
+    xSerializeField(f);
+    xSetField(i ? s1 : s, f);
+  }
+
+  patch = xjsonDiff(s, s1);
+  if(!patch || !strstr(patch, "{ \"op\": \"replace\", \"path\": \"/serial\", \"value\": \"1 2 4\" }")) {
+    fprintf(stderr, "ERROR! unexpected patch for serialized field:\n%s\n", patch ? patch : "(null)");
+    status = 1;
+  }
+  if(patch) free(patch);
+
+  // Unnamed fields inside structure arrays are invalid, and must fail the diff cleanly.
+  for(i = 0; i < 2; i++) {
+    XStructure *list = xCreateStruct();
+    XField *f = xCreateIntField("unnamed", 1);
+    free(f->name);
+    f->name = NULL;
+    list->firstField = f;
+    xSetField(i ? s1 : s, xCreate1DField("list", X_STRUCT, 1, list));
+  }
+
+  xSetDebug(FALSE);
+  patch = xjsonDiff(s, s1);
+  xSetDebug(TRUE);
+  if(patch) {
+    fprintf(stderr, "ERROR! patch for unnamed fields:\n%s\n", patch);
+    free(patch);
+    status = 1;
+  }
+
+  xDestroyStruct(s);
+  xDestroyStruct(s1);
+
+  return status;
+}
 
 int main() {
   XStructure *s = createStruct(), *s1;
@@ -79,6 +339,14 @@ int main() {
   free(str);
   free(str1);
 
+  // Long string with special characters in between long runs of regular ones.
+  str = xjsonEscape("The quick brown fox jumps over the \"lazy\" dog.\nThe quick brown fox jumps over the lazy dog\x7f!", 0);
+  if(strcmp(str, "The quick brown fox jumps over the \\\"lazy\\\" dog.\\nThe quick brown fox jumps over the lazy dog\\u007f!") != 0) {
+    fprintf(stderr, "ERROR: unexpected escaped long string: '%s'\n", str);
+    return 1;
+  }
+  free(str);
+
   str = xjsonToString(s);
   printf("%s", str);
 
@@ -97,6 +365,12 @@ int main() {
   xDestroyStruct(s);
   xDestroyStruct(s1);
 
+  if(checkParallel()) return 1;
+  if(checkPlan()) return 1;
+  if(checkBase64()) return 1;
+  if(checkIOVector()) return 1;
+  if(checkDiff()) return 1;
+
   printf("OK\n");
 
   return 0;
@@ -56,12 +56,14 @@ int main() {
     return 1;
   }
 
-  xLookupRemove(l, "other");
-  if(xLookupField(l, "other") != NULL) {
+  if(xLookupRemove(l, "other") != f || xLookupField(l, "other") != NULL) {
     fprintf(stderr, "ERROR! remove other\n");
     return 1;
   }
-  xDestroyLookupAndData(l);
+  xDestroyField(f);
+
+  // The fields belong to 's', which we still use below.
+  xDestroyLookup(l);
 
   l = xAllocLookup(16);
   status = xLookupPutAll(l, NULL, s, TRUE);
@@ -87,6 +89,14 @@ int main() {
   }
 
   xDestroyLookup(l);
+
+  // Destroying the data of a recursive lookup (which references nested fields also)
+  sys = xCopyOfStruct(s);
+  l = xCreateLookup(sys, TRUE);
+  sys->firstField = NULL;    // The fields are now owned by the lookup
+  xDestroyStruct(sys);
+  xDestroyLookupAndData(l);
+
   xDestroyStruct(s);
 
   printf("OK\n");
@@ -0,0 +1,161 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "xchange.h"
+#include "xjson.h"
+#include "xlz4.h"
+
+#define SIZE      300000
+
+static const char *fileName = "/tmp/test-lz4.lz4";
+
+static int checkRoundTrip(const char *label, const char *data, size_t size) {
+  size_t n = 0, m = 0;
+  char *z = xlz4Compress(data, size, &n), *out;
+
+  if(!z) {
+    fprintf(stderr, "ERROR! %s: compress\n", label);
+    return 1;
+  }
+
+  out = xlz4Decompress(z, n, &m);
+  free(z);
+
+  if(!out || m != size || memcmp(out, data, size) != 0) {
+    fprintf(stderr, "ERROR! %s: round trip (%ld -> %ld -> %ld bytes)\n", label, (long) size, (long) n, (long) m);
+    free(out);
+    return 1;
+  }
+
+  free(out);
+  return 0;
+}
+
+int main() {
+  char *text = (char *) malloc(SIZE), *random = (char *) malloc(SIZE), *z, *out, buf[1000];
+  XStructure *s = xCreateStruct(), *s1;
+  XLZ4Stream *zs;
+  size_t n = 0, m = 0;
+  long L;
+  int i, result = 0;
+  FILE *fp, *fz;
+  char *json;
+
+  for(i = 0; i < SIZE; i++) {
+    text[i] = "The quick brown fox jumps over the lazy dog. "[(i * 7 / 3) % 45];
+    random[i] = rand() & 0xff;
+  }
+
+  result |= checkRoundTrip("empty", "", 0);
+  result |= checkRoundTrip("short", "abc", 3);
+  result |= checkRoundTrip("text", text, SIZE);
+  result |= checkRoundTrip("random", random, SIZE);
+
+  z = (char *) calloc(1, SIZE);
+  result |= checkRoundTrip("zeroes", z, SIZE);
+  free(z);
+
+  z = xlz4Compress(text, SIZE, &n);
+  if(n > SIZE / 4) {
+    fprintf(stderr, "ERROR! poor compression: %ld -> %ld\n", (long) SIZE, (long) n);
+    result = 1;
+  }
+
+  // Corrupt data must be rejected
+  z[n / 2] ^= 0x55;
+  xSetDebug(FALSE);
+  out = xlz4Decompress(z, n, &m);
+  xSetDebug(TRUE);
+  if(out) {
+    fprintf(stderr, "ERROR! corrupt data not detected\n");
+    free(out);
+    result = 1;
+  }
+  free(z);
+
+  // Streaming, in odd-sized pieces, with two concatenated frames
+  fp = fopen(fileName, "wb");
+  zs = xlz4OpenWriter(fp);
+  for(i = 0; i < SIZE; i += 777) xlz4Write(zs, &text[i], (SIZE - i) < 777 ? (SIZE - i) : 777);
+  if(xlz4Close(zs) != X_SUCCESS) {
+    fprintf(stderr, "ERROR! xlz4Close (writer)\n");
+    result = 1;
+  }
+  zs = xlz4OpenWriter(fp);
+  xlz4Write(zs, random, SIZE);
+  xlz4Close(zs);
+  fclose(fp);
+
+  fp = fopen(fileName, "rb");
+  zs = xlz4OpenReader(fp);
+  for(n = 0; (L = xlz4Read(zs, buf, sizeof(buf))) > 0; n += L) {
+    const char *ref = n < SIZE ? &text[n] : &random[n - SIZE];
+    if(n < SIZE && n + L > SIZE) continue;      // straddles the two frames
+    if(memcmp(buf, ref, L) != 0) {
+      fprintf(stderr, "ERROR! stream mismatch at %ld\n", (long) n);
+      result = 1;
+      break;
+    }
+  }
+  xlz4Close(zs);
+  fclose(fp);
+
+  if(L != 0 || n != 2 * SIZE) {
+    fprintf(stderr, "ERROR! stream read %ld bytes (%ld)\n", (long) n, L);
+    result = 1;
+  }
+
+  // JSON through a compressing stdio stream, and parsed back from a decompressing one
+  for(i = 0; i < 1000; i++) {
+    char name[20];
+    sprintf(name, "field%d", i);
+    xSetField(s, xCreateIntField(name, i));
+  }
+  json = xjsonToString(s);
+
+  fp = fopen(fileName, "wb");
+  fz = xlz4Open(fp, "w");
+  if(!fz) {
+    if(errno == ENOSYS) {
+      // Not supported on this platform.
+      if(!result) fprintf(stdout, "test-lz4: OK (without xlz4Open())\n");
+      return result;
+    }
+    fprintf(stderr, "ERROR! xlz4Open(w)\n");
+    return 1;
+  }
+  fputs(json, fz);
+  fclose(fz);
+  fclose(fp);
+  free(json);
+
+  fp = fopen(fileName, "rb");
+  fz = xlz4Open(fp, "r");
+  s1 = xjsonParseFile(fz, 0);
+  fclose(fz);
+  fclose(fp);
+
+  if(!s1 || xCountFields(s1) != 1000 || xGetAsLong(xGetField(s1, "field999"), -1) != 999) {
+    fprintf(stderr, "ERROR! JSON through xlz4Open()\n");
+    result = 1;
+  }
+
+  xDestroyStruct(s);
+  xDestroyStruct(s1);
+  free(text);
+  free(random);
+
+  remove(fileName);
+
+  if(!result) fprintf(stdout, "test-lz4: OK\n");
+  return result;
+}
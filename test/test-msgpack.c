@@ -0,0 +1,101 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xchange.h"
+#include "xjson.h"
+#include "xmsgpack.h"
+#include "test-codec.h"
+
+int main() {
+  XStructure *s = createCodecStruct(), *s1;
+  XField *f;
+  char *bin, *str;
+  size_t n;
+  int i;
+
+  // { "a": [ 1, 2.5 ], "b": "hi", "c": [ true, nil ], "d": bin(3), "e": [ [ 1, 2 ], [ 3, -1 ] ], "f": [ 1, "x" ] }
+  const unsigned char msg[] = {
+          0x86,
+          0xa1, 'a', 0x92, 0x01, 0xcb, 0x40, 0x04, 0, 0, 0, 0, 0, 0,
+          0xa1, 'b', 0xa2, 'h', 'i',
+          0xa1, 'c', 0x92, 0xc3, 0xc0,
+          0xa1, 'd', 0xc4, 0x03, 1, 2, 3,
+          0xa1, 'e', 0x92, 0x92, 0x01, 0x02, 0x92, 0x03, 0xff,
+          0xa1, 'f', 0x92, 0x01, 0xa1, 'x'
+  };
+
+  bin = xmsgpackEncode(s, &n);
+  if(!bin) {
+    perror("ERROR! xmsgpackEncode");
+    return 1;
+  }
+
+  s1 = xmsgpackDecode(bin, n);
+  if(checkCodecRoundTrip("MessagePack", s, s1) != 0) return 1;
+
+  // Any truncation must be caught.
+  for(i = 0; i < (int) n; i++) {
+    XStructure *s2 = xmsgpackDecode(bin, i);
+    if(s2) {
+      fprintf(stderr, "ERROR! decoded truncated MessagePack of %d bytes\n", i);
+      return 1;
+    }
+  }
+
+  free(bin);
+  xDestroyStruct(s);
+  xDestroyStruct(s1);
+
+  // Standard MessagePack from elsewhere...
+  s = xmsgpackDecode(msg, sizeof(msg));
+  if(!s) {
+    perror("ERROR! xmsgpackDecode (external)");
+    return 1;
+  }
+
+  f = xGetField(s, "a");
+  if(f->type != X_DOUBLE || f->ndim != 1 || f->sizes[0] != 2 || ((double *) f->value)[1] != 2.5) {
+    fprintf(stderr, "ERROR! external 'a' mismatch\n");
+    return 1;
+  }
+
+  f = xGetField(s, "c");
+  if(f->type != X_BOOLEAN || f->sizes[0] != 2 || !((boolean *) f->value)[0] || ((boolean *) f->value)[1]) {
+    fprintf(stderr, "ERROR! external 'c' mismatch\n");
+    return 1;
+  }
+
+  f = xGetField(s, "d");
+  if(f->type != X_BYTE || f->sizes[0] != 3 || memcmp(f->value, "\1\2\3", 3) != 0) {
+    fprintf(stderr, "ERROR! external 'd' mismatch\n");
+    return 1;
+  }
+
+  f = xGetField(s, "e");
+  if(f->type != X_INT32 || f->ndim != 2 || f->sizes[1] != 2 || ((int32_t *) f->value)[3] != -1) {
+    fprintf(stderr, "ERROR! external 'e' mismatch\n");
+    return 1;
+  }
+
+  f = xGetField(s, "f");
+  if(f->type != X_FIELD || f->sizes[0] != 2 || ((XField *) f->value)[1].type != X_STRING) {
+    fprintf(stderr, "ERROR! external 'f' mismatch\n");
+    return 1;
+  }
+
+  str = xjsonToString(s);
+  printf("%s", str);
+  free(str);
+  xDestroyStruct(s);
+
+  printf("OK\n");
+  return 0;
+}
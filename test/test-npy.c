@@ -0,0 +1,157 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "xchange.h"
+#include "xnpy.h"
+
+static int check(const XField *f, const char *label) {
+  if(!f || f->type != X_DOUBLE || f->ndim != 2 || f->sizes[0] != 2 || f->sizes[1] != 3) {
+    fprintf(stderr, "ERROR! %s: wrong type or shape\n", label);
+    return 1;
+  }
+
+  if(((double *) f->value)[4] != -1.5e100 || ((double *) f->value)[5] != 6.0) {
+    fprintf(stderr, "ERROR! %s: wrong data\n", label);
+    return 1;
+  }
+
+  return 0;
+}
+
+static int writeRaw(const char *fileName, const char *dict, const void *data, size_t size) {
+  char header[128];
+  FILE *fp;
+  int n = sprintf(header, "%s", dict);
+
+  while((n + 11) % 64) header[n++] = ' ';
+  header[n++] = '\n';
+
+  fp = fopen(fileName, "wb");
+  if(!fp) return -1;
+  fwrite("\x93NUMPY\x01\x00", 1, 8, fp);
+  fputc(n & 0xff, fp);
+  fputc(n >> 8, fp);
+  fwrite(header, 1, n, fp);
+  fwrite(data, 1, size, fp);
+  fclose(fp);
+  return 0;
+}
+
+int main() {
+  double d[2][3] = {{1.0, -2.5, 3.14159265358979}, {1e-300, -1.5e100, 6.0}};
+  boolean b[4] = { TRUE, FALSE, FALSE, TRUE };
+  char c[2][5] = { "abcde", "xyz" };
+  int sizes[] = { 2, 3 };
+  unsigned char u[6] = { 1, 2, 3, 4, 5, 255 };
+  const char *fileName = "/tmp/test-npy.npy";
+  XField *f, *g;
+
+  f = xCreateField("d", X_DOUBLE, 2, sizes, d);
+  if(xnpyWrite(f, fileName) != X_SUCCESS) {
+    perror("ERROR! xnpyWrite");
+    return 1;
+  }
+  xDestroyField(f);
+
+  f = xnpyRead(fileName, "d");
+  if(check(f, "xnpyRead") != 0) return 1;
+  xDestroyField(f);
+
+  f = xnpyMap(fileName, "d");
+  if(check(f, "xnpyMap") != 0) return 1;
+  ((double *) f->value)[0] = 0.0;       // private mapping, so we can write to it...
+  xnpyUnmap(f);
+
+  f = xnpyRead(fileName, "d");
+  if(!f || ((double *) f->value)[0] != 1.0) {
+    fprintf(stderr, "ERROR! mapped write reached the file\n");
+    return 1;
+  }
+  xDestroyField(f);
+
+  // Booleans (converted to single bytes and back)
+  f = xCreate1DField("b", X_BOOLEAN, 4, b);
+  if(xnpyWrite(f, fileName) != X_SUCCESS) return 1;
+  xDestroyField(f);
+
+  f = xnpyMap(fileName, "b");
+  if(!f || f->type != X_BOOLEAN || f->sizes[0] != 4 || memcmp(f->value, b, sizeof(b)) != 0) {
+    fprintf(stderr, "ERROR! boolean array\n");
+    return 1;
+  }
+  xnpyUnmap(f);
+
+  // Fixed-length strings
+  f = xCreate1DField("c", X_CHARS(5), 2, c);
+  if(xnpyWrite(f, fileName) != X_SUCCESS) return 1;
+  xDestroyField(f);
+
+  f = xnpyRead(fileName, "c");
+  if(!f || f->type != X_CHARS(5) || memcmp(f->value, c, sizeof(c)) != 0) {
+    fprintf(stderr, "ERROR! character array\n");
+    return 1;
+  }
+  xDestroyField(f);
+
+  // Serialized field, written as a scalar
+  f = xCreateIntField("serial", 0);
+  free(f->value);
+  f->value = xStringCopyOf("-42");
+  f->isSerialized = TRUE;
+  if(xnpyWrite(f, fileName) != X_SUCCESS) return 1;
+  xDestroyField(f);
+
+  f = xnpyRead(fileName, "serial");
+  if(!f || f->type != X_INT32 || f->ndim != 0 || *(int32_t *) f->value != -42) {
+    fprintf(stderr, "ERROR! serialized scalar\n");
+    return 1;
+  }
+  xDestroyField(f);
+
+  // Fortran-ordered, unsigned, and big-endian arrays, as written by NumPy
+  writeRaw(fileName, "{'descr': '|u1', 'fortran_order': True, 'shape': (2, 3), }", u, sizeof(u));
+  f = xnpyMap(fileName, "u");
+  if(!f || f->type != X_INT16 || ((int16_t *) f->value)[1] != 3 || ((int16_t *) f->value)[3] != 2
+          || ((int16_t *) f->value)[5] != 255) {
+    fprintf(stderr, "ERROR! Fortran-ordered unsigned array\n");
+    return 1;
+  }
+  xnpyUnmap(f);
+
+  writeRaw(fileName, "{'descr': '>i2', 'fortran_order': False, 'shape': (3,), }", u, sizeof(u));
+  f = xnpyRead(fileName, "s");
+  if(!f || f->type != X_INT16 || f->sizes[0] != 3 || ((int16_t *) f->value)[2] != 0x05ff) {
+    fprintf(stderr, "ERROR! big-endian array\n");
+    return 1;
+  }
+  xDestroyField(f);
+
+  // Invalid input
+  writeRaw(fileName, "{'descr': '<c16', 'fortran_order': False, 'shape': (3,), }", u, sizeof(u));
+  g = xnpyRead(fileName, "x");
+  f = xnpyRead(fileName, NULL);
+  if(f || g || xnpyRead("/tmp/no-such-file.npy", "x")) {
+    fprintf(stderr, "ERROR! accepted invalid input\n");
+    return 1;
+  }
+
+  writeRaw(fileName, "{'descr': '<f8', 'fortran_order': False, 'shape': (3,), }", u, sizeof(u));
+  if(xnpyMap(fileName, "x") || xnpyRead(fileName, "x")) {
+    fprintf(stderr, "ERROR! accepted truncated data\n");
+    return 1;
+  }
+
+  remove(fileName);
+
+  fprintf(stdout, "test-npy: OK\n");
+  return 0;
+}
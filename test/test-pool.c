@@ -0,0 +1,218 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "xchange.h"
+#include "xjson.h"
+
+#define THREADS       4
+#define NFIELDS       1000
+#define ROUNDS        50
+
+static XStructure *queue[THREADS];
+
+static XStructure *createStruct(int id) {
+  XStructure *s = xCreateStruct(), *sub = xCreateStruct();
+  char name[20];
+  int i;
+
+  for(i = 0; i < NFIELDS; i++) {
+    sprintf(name, "f%d", i);
+    xSetField(s, xCreateIntField(name, id + i));
+  }
+
+  xSetField(sub, xCreateStringField("name", "sub"));
+  xSetSubstruct(s, "sub", sub);
+
+  return s;
+}
+
+static int checkStruct(const XStructure *s, int id) {
+  char name[20];
+  int i;
+
+  for(i = 0; i < NFIELDS; i++) {
+    sprintf(name, "f%d", i);
+    if(xGetAsLong(xGetField(s, name), -1) != id + i) return 1;
+  }
+
+  return strcmp(xGetStringValue(xGetField(s, "sub:name")), "sub") != 0;
+}
+
+static boolean isLocal(const XField *f, const void *ptr) {
+  return (const char *) ptr >= f->local.bytes && (const char *) ptr < &f->local.bytes[X_INLINE_VALUE_SIZE];
+}
+
+static void *run(void *arg) {
+  int k = *(int *) arg, i, bad = 0;
+
+  for(i = 0; i < ROUNDS; i++) {
+    // Destroy the structure created by another thread, and create a new one for the next.
+    XStructure *s = createStruct(k * ROUNDS + i), *prior;
+
+    prior = __atomic_exchange_n(&queue[k], s, __ATOMIC_ACQ_REL);
+    if(prior) xDestroyStruct(prior);
+
+    s = __atomic_exchange_n(&queue[(k + 1) % THREADS], NULL, __ATOMIC_ACQ_REL);
+    if(s) {
+      XStructure *copy = xCopyOfStruct(s);
+      xDestroyStruct(s);
+      if(!copy || xCountFields(copy) != NFIELDS + 1) bad++;
+      xDestroyStruct(copy);
+    }
+  }
+
+  return bad ? arg : NULL;
+}
+
+int main() {
+  XStructure *s, *s1;
+  XField *f, *f1, *heap;
+  pthread_t threads[THREADS];
+  int ids[THREADS], i, result = 0;
+  char *json;
+
+  heap = xCreateIntField("heap", 1);
+
+  xSetNodePooling(TRUE);
+  if(!xIsNodePooling()) {
+    fprintf(stderr, "ERROR! xIsNodePooling()\n");
+    return 1;
+  }
+
+  // Released nodes are reused
+  f = xCreateIntField("a", 1);
+  xDestroyField(f);
+  f1 = xCreateIntField("b", 2);
+  if(f1 != f || !f1->pool || xGetAsLong(f1, 0) != 2 || f1->next) {
+    fprintf(stderr, "ERROR! reuse of pooled field\n");
+    result = 1;
+  }
+  xDestroyField(f1);
+
+  // Structures, copies, and JSON round trip with pooled nodes
+  s = createStruct(0);
+  if(checkStruct(s, 0)) {
+    fprintf(stderr, "ERROR! pooled structure\n");
+    result = 1;
+  }
+
+  s1 = xCopyOfStruct(s);
+  json = xjsonToString(s1);
+  xDestroyStruct(s1);
+
+  s1 = xjsonParseString(json, NULL);
+  free(json);
+  if(!s1 || checkStruct(s1, 0)) {
+    fprintf(stderr, "ERROR! parsed pooled structure\n");
+    result = 1;
+  }
+
+  // Packing pooled structures, mixed with an individually allocated field
+  xSetField(s1, heap);
+  if(xPackStruct(s1) != X_SUCCESS || checkStruct(s1, 0) || xGetAsLong(xGetField(s1, "heap"), 0) != 1) {
+    fprintf(stderr, "ERROR! packed pooled structure\n");
+    result = 1;
+  }
+  xDestroyStruct(s1);
+
+  // Small values stored inside pooled fields
+  xSetValueInlining(TRUE);
+  if(!xIsValueInlining()) {
+    fprintf(stderr, "ERROR! xIsValueInlining()\n");
+    result = 1;
+  }
+
+  f = xCreateIntField("int", 42);
+  f1 = xCreateStringField("unit", "deg");
+  if(f->value != f->local.bytes || xGetAsLong(f, 0) != 42 || f1->value != f1->local.bytes
+          || !isLocal(f1, *(char **) f1->value) || strcmp(xGetStringValue(f1), "deg") != 0) {
+    fprintf(stderr, "ERROR! inline values\n");
+    result = 1;
+  }
+  xDestroyField(f);
+  xDestroyField(f1);
+
+  f = xCreateStringField("long", "a longer string value");
+  f1 = xCopyOfField(f);
+  if(f1->value != f1->local.bytes || isLocal(f1, *(char **) f1->value)
+          || strcmp(xGetStringValue(f1), "a longer string value") != 0) {
+    fprintf(stderr, "ERROR! inline copy of long string\n");
+    result = 1;
+  }
+  xDestroyField(f);
+  xDestroyField(f1);
+
+  s1 = xjsonParseString("{ \"i\": 1, \"d\": 2.5, \"b\": true, \"s\": \"ok\", \"m\": [ 3, \"x\", { \"j\": 4 } ] }", NULL);
+  if(!s1 || xPackStruct(s1) != X_SUCCESS) {
+    fprintf(stderr, "ERROR! parsed inline values\n");
+    result = 1;
+  }
+  else {
+    XStructure *c = xCopyOfStruct(s1);
+    xDestroyStruct(s1);
+    s1 = c;
+
+    f = xGetField(s1, "m");
+    if(!s1 || xGetAsLong(xGetField(s1, "i"), 0) != 1 || xGetAsDouble(xGetField(s1, "d")) != 2.5
+            || !*(boolean *) xGetField(s1, "b")->value || strcmp(xGetStringValue(xGetField(s1, "s")), "ok") != 0
+            || xGetAsLong(&((XField *) f->value)[0], 0) != 3 || strcmp(xGetStringValue(&((XField *) f->value)[1]), "x") != 0) {
+      fprintf(stderr, "ERROR! copied inline values\n");
+      result = 1;
+    }
+  }
+
+  // Unwrapping a single-element heterogeneous array with an inline value
+  f1 = xCreateIntField("row", 5);
+  free(f1->name);
+  f1->name = NULL;
+  f = xCreateMixed1DField("wrapped", 1, f1);
+  xDestroyField(f1);
+  xSetField(s1, f);
+  if(xReduceStruct(s1) != X_SUCCESS || f->type != X_INT || f->value != f->local.bytes || xGetAsLong(f, 0) != 5) {
+    fprintf(stderr, "ERROR! unwrapped inline value\n");
+    result = 1;
+  }
+  xDestroyStruct(s1);
+
+  // Nodes created and destroyed across threads
+  for(i = 0; i < THREADS; i++) {
+    ids[i] = i;
+    pthread_create(&threads[i], NULL, run, &ids[i]);
+  }
+  for(i = 0; i < THREADS; i++) {
+    void *ret = NULL;
+    pthread_join(threads[i], &ret);
+    if(ret) {
+      fprintf(stderr, "ERROR! thread %d\n", i);
+      result = 1;
+    }
+  }
+  for(i = 0; i < THREADS; i++) xDestroyStruct(queue[i]);
+
+  // Pooled nodes are still released properly after pooling is disabled.
+  xSetNodePooling(FALSE);
+  xSetValueInlining(FALSE);
+  f = xCreateIntField("c", 3);
+  if(f->pool || f->value == f->local.bytes) {
+    fprintf(stderr, "ERROR! unpooled field\n");
+    result = 1;
+  }
+  xSetField(s, f);
+  if(checkStruct(s, 0)) {
+    fprintf(stderr, "ERROR! pooled structure after disabling pool\n");
+    result = 1;
+  }
+  xDestroyStruct(s);
+
+  if(!result) fprintf(stdout, "test-pool: OK\n");
+  return result;
+}
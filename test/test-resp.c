@@ -0,0 +1,289 @@
+/**
+ * @file
+ *
+ * @date Created  on Oct 19, 2026
+ * @author Attila Kovacs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#include "xchange.h"
+#include "xresp.h"
+#include "test-codec.h"
+
+#define MAX_TABLES      10
+
+// A minimal, in-memory stand-in for a Redis server, with support for HSET and HGETALL only.
+static char *keys[MAX_TABLES];
+static XStructure *tables[MAX_TABLES];
+static int nTables;
+
+static char reply[65536];
+static size_t replySize;
+
+static XStructure *GetTable(const char *key, int create) {
+  int i;
+
+  for(i = 0; i < nTables; i++) if(!strcmp(keys[i], key)) return tables[i];
+  if(!create || nTables >= MAX_TABLES) return NULL;
+
+  keys[nTables] = xStringCopyOf(key);
+  tables[nTables] = xCreateStruct();
+  return tables[nTables++];
+}
+
+static void Respond(const char *fmt, const char *str) {
+  replySize += sprintf(&reply[replySize], fmt, (int) strlen(str), str);
+}
+
+static int Serve(const char *req, size_t size) {
+  size_t pos = 0;
+
+  while(pos < size) {
+    size_t len;
+    XField *cmd = xrespDecode("command", &req[pos], size - pos, &len);
+    char **argv;
+    int argc;
+
+    if(!cmd || cmd->type != X_STRING || cmd->ndim != 1) {
+      fprintf(stderr, "ERROR! server: invalid command\n");
+      return -1;
+    }
+
+    argv = (char **) cmd->value;
+    argc = cmd->sizes[0];
+    pos += len;
+
+    if(!strcmp(argv[0], "HSET") && argc >= 4 && argc % 2 == 0) {
+      XStructure *table = GetTable(argv[1], 1);
+      int i, added = 0;
+
+      for(i = 2; i < argc; i += 2) {
+        XField *old = xSetField(table, xCreateStringField(argv[i], argv[i+1]));
+        if(old) xDestroyField(old);
+        else added++;
+      }
+      replySize += sprintf(&reply[replySize], ":%d\r\n", added);
+    }
+    else if(!strcmp(argv[0], "HGETALL") && argc == 2) {
+      XStructure *table = GetTable(argv[1], 0);
+      XField *f;
+
+      replySize += sprintf(&reply[replySize], "%%%d\r\n", xCountFields(table));
+      if(table) for(f = table->firstField; f != NULL; f = f->next) {
+        Respond("$%d\r\n%s\r\n", f->name);
+        Respond("$%d\r\n%s\r\n", *(char **) f->value);
+      }
+    }
+    else Respond("-ERR unknown command '%.*s'\r\n", argv[0]);
+
+    xDestroyField(cmd);
+  }
+
+  return 0;
+}
+
+static const char *GetString(const XStructure *s, const char *name) {
+  const XField *f = xGetField(s, name);
+  if(!f || f->type != X_STRING || f->ndim != 0) return NULL;
+  return *(char **) f->value;
+}
+
+static XStructure *HGetAll(const char *key) {
+  char cmd[100];
+  XField *f;
+  XStructure *s;
+
+  sprintf(cmd, "*2\r\n$7\r\nHGETALL\r\n$%d\r\n%s\r\n", (int) strlen(key), key);
+
+  replySize = 0;
+  if(Serve(cmd, strlen(cmd)) != 0) return NULL;
+
+  f = xrespDecode(key, reply, replySize, NULL);
+  if(!f || f->type != X_STRUCT) return NULL;
+
+  s = (XStructure *) f->value;
+  f->value = NULL;
+  xDestroyField(f);
+  return s;
+}
+
+static int TestServer() {
+  XStructure *s = createCodecStruct(), *h;
+  int nCommands, i;
+  char *cmd;
+  size_t n, pos;
+
+  cmd = xrespEncodeHSET(s, "test", &n, &nCommands);
+  if(!cmd || nCommands != 5) {
+    fprintf(stderr, "ERROR! xrespEncodeHSET: %d commands\n", nCommands);
+    return 1;
+  }
+
+  // An incomplete command must be recognized as such
+  if(xrespDecode("partial", cmd, 20, NULL) != NULL || errno != EAGAIN) {
+    fprintf(stderr, "ERROR! incomplete command not detected\n");
+    return 1;
+  }
+
+  replySize = 0;
+  if(Serve(cmd, n) != 0) return 1;
+  free(cmd);
+
+  // Read the pipelined replies
+  for(i = 0, pos = 0; i < nCommands; i++) {
+    size_t len;
+    XField *f = xrespDecode("reply", &reply[pos], replySize - pos, &len);
+    if(!f || f->type != X_INT64 || *(int64_t *) f->value < 1) {
+      fprintf(stderr, "ERROR! HSET reply #%d\n", i);
+      return 1;
+    }
+    xDestroyField(f);
+    pos += len;
+  }
+
+  h = HGetAll("test");
+  if(!h || xCountFields(h) != 12) {
+    fprintf(stderr, "ERROR! HGETALL test\n");
+    return 1;
+  }
+
+  if(strcmp(GetString(h, "bool"), "true") || strcmp(GetString(h, "int"), "-10")
+          || strcmp(GetString(h, "double"), "1 -2.5 3.14159265358979 1e-300 0")
+          || strcmp(GetString(h, "array4"), "1 -200 3 40000 5 -6")
+          || strcmp(GetString(h, "names"), "one\rtwo\rthree") || strcmp(GetString(h, "sub"), "test:sub")
+          || strcmp(GetString(h, "mixed"), "test:mixed") || strcmp(GetString(h, "list"), "test:list:0\rtest:list:1")) {
+    fprintf(stderr, "ERROR! HGETALL test values\n");
+    return 1;
+  }
+  xDestroyStruct(h);
+
+  h = HGetAll("test:mixed");
+  if(!h || strcmp(GetString(h, ".1"), "1 2") || strcmp(GetString(h, ".2"), "true") || strcmp(GetString(h, ".3"), "aa\rbb\rcc")) {
+    fprintf(stderr, "ERROR! HGETALL test:mixed\n");
+    return 1;
+  }
+  xDestroyStruct(h);
+
+  h = HGetAll("test:list:1");
+  if(!h || strcmp(GetString(h, "x"), "2") || strcmp(GetString(h, "name"), "second")) {
+    fprintf(stderr, "ERROR! HGETALL test:list:1\n");
+    return 1;
+  }
+  xDestroyStruct(h);
+
+  xDestroyStruct(s);
+
+  for(i = 0; i < nTables; i++) {
+    free(keys[i]);
+    xDestroyStruct(tables[i]);
+  }
+
+  return 0;
+}
+
+static int TestRESP3() {
+  const char *msg =
+          "|1\r\n+ttl\r\n:3600\r\n"
+          "%11\r\n"
+          "+int\r\n:-42\r\n"
+          "+dbl\r\n,-inf\r\n"
+          "+bool\r\n#t\r\n"
+          "+null\r\n_\r\n"
+          "+big\r\n(3492890328409238509324850943850943825024385\r\n"
+          "+txt\r\n=15\r\ntxt:Some string\r\n"
+          "+ints\r\n*3\r\n:1\r\n:2\r\n:3\r\n"
+          "+nums\r\n*2\r\n:1\r\n,2.5\r\n"
+          "+names\r\n~3\r\n$1\r\na\r\n$-1\r\n+c\r\n"
+          "+mixed\r\n*2\r\n:1\r\n*1\r\n#f\r\n"
+          "+maps\r\n*2\r\n%1\r\n+x\r\n:1\r\n%1\r\n+x\r\n:2\r\n"
+          "-ERR wrong type\r\n";
+  XField *f, *e;
+  XStructure *s;
+  size_t len;
+
+  f = xrespDecode("reply", msg, strlen(msg), &len);
+  if(!f || f->type != X_STRUCT) {
+    perror("ERROR! RESP3 map");
+    return 1;
+  }
+  s = (XStructure *) f->value;
+
+  if(*(int64_t *) xGetField(s, "int")->value != -42 || !isinf(*(double *) xGetField(s, "dbl")->value)
+          || *(boolean *) xGetField(s, "bool")->value != TRUE || xGetField(s, "null")->type != X_UNKNOWN) {
+    fprintf(stderr, "ERROR! RESP3 scalars\n");
+    return 1;
+  }
+
+  e = xGetField(s, "big");
+  if(strcmp(e->subtype, XRESP_BIGNUM_SUBTYPE) || strcmp(GetString(s, "big"), "3492890328409238509324850943850943825024385")) {
+    fprintf(stderr, "ERROR! RESP3 big number\n");
+    return 1;
+  }
+
+  e = xGetField(s, "txt");
+  if(strcmp(e->subtype, "txt") || strcmp(*(char **) e->value, "Some string")) {
+    fprintf(stderr, "ERROR! RESP3 verbatim string\n");
+    return 1;
+  }
+
+  e = xGetField(s, "ints");
+  if(e->type != X_INT64 || e->ndim != 1 || e->sizes[0] != 3 || ((int64_t *) e->value)[2] != 3) {
+    fprintf(stderr, "ERROR! RESP3 integer array\n");
+    return 1;
+  }
+
+  e = xGetField(s, "nums");
+  if(e->type != X_DOUBLE || ((double *) e->value)[0] != 1.0 || ((double *) e->value)[1] != 2.5) {
+    fprintf(stderr, "ERROR! RESP3 mixed numbers\n");
+    return 1;
+  }
+
+  e = xGetField(s, "names");
+  if(e->type != X_STRING || e->sizes[0] != 3 || ((char **) e->value)[1] != NULL || strcmp(((char **) e->value)[2], "c")) {
+    fprintf(stderr, "ERROR! RESP3 set of strings\n");
+    return 1;
+  }
+
+  e = xGetField(s, "mixed");
+  if(e->type != X_FIELD || e->sizes[0] != 2 || ((XField *) e->value)[1].type != X_BOOLEAN) {
+    fprintf(stderr, "ERROR! RESP3 heterogeneous array\n");
+    return 1;
+  }
+
+  e = xGetField(s, "maps");
+  if(e->type != X_FIELD || e->sizes[0] != 2 || ((XField *) e->value)[1].type != X_STRUCT
+          || *(int64_t *) xGetField((XStructure *) ((XField *) e->value)[1].value, "x")->value != 2) {
+    fprintf(stderr, "ERROR! RESP3 array of maps\n");
+    return 1;
+  }
+
+  xDestroyField(f);
+
+  // The pipelined error reply
+  f = xrespDecode("reply", &msg[len], strlen(msg) - len, NULL);
+  if(!f || !f->subtype || strcmp(f->subtype, XRESP_ERROR_SUBTYPE) || strcmp(*(char **) f->value, "ERR wrong type")) {
+    fprintf(stderr, "ERROR! RESP error reply\n");
+    return 1;
+  }
+  xDestroyField(f);
+
+  if(xrespDecode("reply", "*1\r\nX\r\n", 7, NULL) != NULL || errno != EINVAL) {
+    fprintf(stderr, "ERROR! accepted invalid RESP\n");
+    return 1;
+  }
+
+  return 0;
+}
+
+int main() {
+  if(TestServer() != 0) return 1;
+  if(TestRESP3() != 0) return 1;
+
+  fprintf(stdout, "test-resp: OK\n");
+  return 0;
+}
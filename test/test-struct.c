@@ -9,9 +9,48 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <float.h>
+#include <stdint.h>
 
 #include "xchange.h"
 
+#define NFIELDS     5000
+#define NRANDOM     10000
+
+static int checkRoundTrip(XField *f, int count) {
+  size_t n = count * xElementSizeOf(f->type);
+  void *orig = malloc(n);
+
+  memcpy(orig, f->value, n);
+
+  if(xSerializeField(f) != X_SUCCESS || xDeserializeField(f) != X_SUCCESS || memcmp(f->value, orig, n) != 0) {
+    fprintf(stderr, "ERROR! %s round trip\n", f->name);
+    free(orig);
+    return 1;
+  }
+
+  free(orig);
+  return 0;
+}
+
+static int checkIndexed(const XStructure *s, int n) {
+  const XField *f;
+  int i = 0;
+
+  for(f = s->firstField; f != NULL; f = f->next, i++) if(xGetField(s, f->name) != f) {
+    fprintf(stderr, "ERROR! indexed lookup of '%s'\n", f->name);
+    return 1;
+  }
+
+  if(i != n || xCountFields(s) != n) {
+    fprintf(stderr, "ERROR! indexed count %d / %d, expected %d\n", xCountFields(s), i, n);
+    return 1;
+  }
+
+  return 0;
+}
+
 int main() {
   XStructure *s, *sys, *sub;
   XField *f;
@@ -53,6 +92,370 @@ int main() {
     return 1;
   }
 
+  // -------------------------------------------------------------
+
+  {
+    double d[] = { 1.0, -2.5, 3.14159265358979, 1e-300, 0.0, 1e20 };
+    long long ll[] = { -9223372036854775807LL - 1, 0, 9223372036854775807LL };
+    boolean b[] = { TRUE, FALSE };
+    char *names[] = { "a b", "", "c" };
+    int i;
+
+    f = xCreate1DField("double", X_DOUBLE, 6, d);
+    if(xSerializeField(f) != X_SUCCESS || !f->isSerialized || strcmp((char *) f->value, "1 -2.5 3.14159265358979 1e-300 0 1e+20") != 0) {
+      fprintf(stderr, "ERROR! serialize double: got '%s'\n", (char *) f->value);
+      return 1;
+    }
+    if(xDeserializeField(f) != X_SUCCESS || f->isSerialized || memcmp(f->value, d, sizeof(d)) != 0) {
+      fprintf(stderr, "ERROR! deserialize double\n");
+      return 1;
+    }
+    xDestroyField(f);
+
+    // Exact round trips of floating-point edge values, and of random bit patterns
+    {
+      float fe[] = { 16777216.0F, -16777216.0F, 16777218.0F, 0.1F, -0.0F, FLT_MAX, -FLT_MAX, FLT_MIN, FLT_MIN / 3.0F,
+              1e-45F, 1.0F / 3.0F, 3.4e38F, INFINITY, -INFINITY };
+      double de[] = { 9007199254740992.0, 9007199254740994.0, 0.1, 0.1 + 0.2, -0.0, DBL_MAX, -DBL_MAX, DBL_MIN,
+              DBL_MIN / 3.0, 4.9e-324, 1.0 / 3.0, 1e23, INFINITY, -INFINITY };
+      float fr[NRANDOM];
+      double dr[NRANDOM];
+      uint64_t seed = 12345;
+
+      for(i = 0; i < NRANDOM; i++) {
+        uint32_t bits;
+        uint64_t lbits;
+
+        do {
+          seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+          bits = (uint32_t) (seed >> 32);
+          memcpy(&fr[i], &bits, sizeof(bits));
+        } while(isnan(fr[i]));
+
+        do {
+          seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+          lbits = seed ^ (seed >> 29);
+          memcpy(&dr[i], &lbits, sizeof(lbits));
+        } while(isnan(dr[i]));
+      }
+
+      f = xCreate1DField("float edges", X_FLOAT, sizeof(fe) / sizeof(float), fe);
+      if(checkRoundTrip(f, sizeof(fe) / sizeof(float))) return 1;
+      if(!signbit(((float *) f->value)[4])) {
+        fprintf(stderr, "ERROR! float -0.0 lost its sign\n");
+        return 1;
+      }
+      xDestroyField(f);
+
+      f = xCreate1DField("double edges", X_DOUBLE, sizeof(de) / sizeof(double), de);
+      if(checkRoundTrip(f, sizeof(de) / sizeof(double))) return 1;
+      xDestroyField(f);
+
+      f = xCreate1DField("random floats", X_FLOAT, NRANDOM, fr);
+      if(checkRoundTrip(f, NRANDOM)) return 1;
+      xDestroyField(f);
+
+      f = xCreate1DField("random doubles", X_DOUBLE, NRANDOM, dr);
+      if(checkRoundTrip(f, NRANDOM)) return 1;
+      xDestroyField(f);
+    }
+
+    f = xCreate1DField("long", X_LLONG, 3, ll);
+    if(xSerializeField(f) != X_SUCCESS || strcmp((char *) f->value, "-9223372036854775808 0 9223372036854775807") != 0) {
+      fprintf(stderr, "ERROR! serialize long: got '%s'\n", (char *) f->value);
+      return 1;
+    }
+    if(xDeserializeField(f) != X_SUCCESS || memcmp(f->value, ll, sizeof(ll)) != 0) {
+      fprintf(stderr, "ERROR! deserialize long\n");
+      return 1;
+    }
+    xDestroyField(f);
+
+    f = xCreate1DField("boolean", X_BOOLEAN, 2, b);
+    if(xSerializeField(f) != X_SUCCESS || strcmp((char *) f->value, "true false") != 0
+            || xDeserializeField(f) != X_SUCCESS || memcmp(f->value, b, sizeof(b)) != 0) {
+      fprintf(stderr, "ERROR! (de)serialize boolean\n");
+      return 1;
+    }
+    xDestroyField(f);
+
+    f = xCreate1DField("names", X_STRING, 3, names);
+    if(xSerializeField(f) != X_SUCCESS || strcmp((char *) f->value, "a b\r\rc") != 0 || xDeserializeField(f) != X_SUCCESS) {
+      fprintf(stderr, "ERROR! (de)serialize strings\n");
+      return 1;
+    }
+    for(i = 0; i < 3; i++) if(strcmp(((char **) f->value)[i], names[i]) != 0) {
+      fprintf(stderr, "ERROR! deserialize strings: element %d is '%s'\n", i, ((char **) f->value)[i]);
+      return 1;
+    }
+    xDestroyField(f);
+
+    {
+      // A NULL raw value is serialized as empty
+      char *raw = NULL;
+      f = xCreateField("raw", X_RAW, 0, NULL, &raw);
+      if(xSerializeField(f) != X_SUCCESS || !f->isSerialized || strcmp((char *) f->value, "") != 0) {
+        fprintf(stderr, "ERROR! serialize NULL raw\n");
+        return 1;
+      }
+      xDestroyField(f);
+    }
+
+    f = xCreate1DField("int", X_INT, 3, (int[]) { 1, 2, 3 });
+    xSerializeField(f);
+    free(f->value);
+
+    f->value = xStringCopyOf("1\t2 x");
+    if(xDeserializeField(f) != X_PARSE_ERROR || !f->isSerialized) {
+      fprintf(stderr, "ERROR! deserialize invalid int\n");
+      return 1;
+    }
+    free(f->value);
+
+    f->value = xStringCopyOf("1 2147483648 3");
+    if(xDeserializeField(f) != X_PARSE_ERROR) {
+      fprintf(stderr, "ERROR! deserialize out-of-range int\n");
+      return 1;
+    }
+    free(f->value);
+
+    f->value = xStringCopyOf(" 1  2 ");
+    if(xDeserializeField(f) != X_NOT_ENOUGH_TOKENS) {
+      fprintf(stderr, "ERROR! deserialize too few ints\n");
+      return 1;
+    }
+    xDestroyField(f);
+
+    // Indexed reads of serialized fields
+    f = xCreate1DField("double", X_DOUBLE, 6, d);
+    xSerializeField(f);
+    if(xGetAsDoubleAtIndex(f, 1) != -2.5 || !f->cache || xGetAsDoubleAtIndex(f, 5) != 1e20 || xGetAsLongAtIndex(f, 2, 0) != 3) {
+      fprintf(stderr, "ERROR! cached serialized double\n");
+      return 1;
+    }
+
+    free(f->value);
+    f->value = xStringCopyOf("6 5 4 3 2 1");
+    xClearFieldCache(f);
+    if(xGetAsDoubleAtIndex(f, 1) != 5.0 || f->cache == NULL) {
+      fprintf(stderr, "ERROR! cleared cache of serialized double\n");
+      return 1;
+    }
+
+    if(!isnan(xGetAsDoubleAtIndex(f, 6))) {
+      fprintf(stderr, "ERROR! cached serialized double out of bounds\n");
+      return 1;
+    }
+    xDestroyField(f);
+  }
+
+  // Large (indexed) structures
+  {
+    XStructure *big = xCreateStruct();
+    char name[20];
+    int i;
+
+    for(i = 0; i < NFIELDS; i++) {
+      sprintf(name, "f%d", i);
+      xSetField(big, xCreateIntField(name, i));
+    }
+    if(checkIndexed(big, NFIELDS)) return 1;
+
+    // Replace, remove (first, last and in the middle), and insert at the head
+    xDestroyField(xSetField(big, xCreateIntField("f100", -100)));
+    xDestroyField(xRemoveField(big, "f0"));
+    xDestroyField(xRemoveField(big, "f4999"));
+    for(i = 1000; i < 2000; i += 2) {
+      sprintf(name, "f%d", i);
+      xDestroyField(xRemoveField(big, name));
+    }
+    xInsertField(big, xCreateIntField("head", 0));
+    xSetField(big, xCreateIntField("tail", 0));
+    if(checkIndexed(big, NFIELDS - 500)) return 1;
+
+    if(xGetAsLong(xGetField(big, "f100"), 0) != -100 || xGetField(big, "f1000") || !xGetField(big, "f1001")) {
+      fprintf(stderr, "ERROR! indexed values\n");
+      return 1;
+    }
+
+    if(strcmp(big->firstField->name, "head") != 0 || strcmp(big->firstField->next->name, "f1") != 0) {
+      fprintf(stderr, "ERROR! indexed order\n");
+      return 1;
+    }
+
+    // Aggregate IDs through an indexed structure
+    xSetSubstruct(big, "sub", xCopyOfStruct(sys));
+    if(!xGetField(big, "sub:subsystem:bbb")) {
+      fprintf(stderr, "ERROR! indexed aggregate ID\n");
+      return 1;
+    }
+
+    // Direct modification of the list, at the head
+    f = xCreateIntField("direct", 1);
+    f->next = big->firstField;
+    big->firstField = f;
+    if(checkIndexed(big, NFIELDS - 498)) return 1;
+
+    // Sorting and reversing
+    xSortFieldsByName(big, FALSE);
+    if(checkIndexed(big, NFIELDS - 498)) return 1;
+    xReverseFieldOrder(big, FALSE);
+    if(checkIndexed(big, NFIELDS - 498)) return 1;
+
+    // Duplicate names
+    xInsertField(big, xCreateIntField("f1", 1));
+    if(xGetAsLong(xGetField(big, "f1"), -1) != 1 || xCountFields(big) != NFIELDS - 497) {
+      fprintf(stderr, "ERROR! duplicate names\n");
+      return 1;
+    }
+
+    {
+      // The disabled index is kept (not rebuilt) while the structure is modified.
+      const void *index = big->index;
+      xSetField(big, xCreateIntField("g1", 1));
+      xDestroyField(xSetField(big, xCreateIntField("g1", 2)));
+      if(big->index != index || xGetAsLong(xGetField(big, "g1"), -1) != 2 || xCountFields(big) != NFIELDS - 496) {
+        fprintf(stderr, "ERROR! disabled index\n");
+        return 1;
+      }
+    }
+
+    // Removing the duplicate enables the index again.
+    xDestroyField(xRemoveField(big, "f1"));
+    xSetField(big, xCreateIntField("g2", 2));
+    if(checkIndexed(big, NFIELDS - 496)) return 1;
+
+    // Direct removal (and destruction) of the head field is detected.
+    f = big->firstField;
+    big->firstField = f->next;
+    xDestroyField(f);
+    if(checkIndexed(big, NFIELDS - 497)) return 1;
+
+    // Direct removal of the tail field, followed by xClearStructIndex()
+    for(f = big->firstField; f->next->next; f = f->next);
+    xDestroyField(f->next);
+    f->next = NULL;
+    xClearStructIndex(big);
+    if(checkIndexed(big, NFIELDS - 498)) return 1;
+
+    xDestroyStruct(big);
+  }
+
+  // Packed (contiguous) structures
+  {
+    XStructure *packed = xCreateStruct(), *copy;
+    XField *last;
+    char name[20];
+    int i;
+
+    for(i = 0; i < NFIELDS; i++) {
+      sprintf(name, "f%d", i);
+      xSetField(packed, xCreateIntField(name, i));
+    }
+    xSetSubstruct(packed, "sub", xCopyOfStruct(sys));
+
+    if(xPackStruct(packed) != X_SUCCESS) {
+      fprintf(stderr, "ERROR! xPackStruct()\n");
+      return 1;
+    }
+
+    for(f = packed->firstField, i = 0; f->next; f = f->next, i++) if(f->next != &f[1]) {
+      fprintf(stderr, "ERROR! packed field %d is not contiguous\n", i);
+      return 1;
+    }
+    if(strcmp(packed->firstField->name, "f0") != 0 || strcmp(f->name, "sub") != 0) {
+      fprintf(stderr, "ERROR! packed order\n");
+      return 1;
+    }
+    if(checkIndexed(packed, NFIELDS + 1)) return 1;
+
+    f = xGetSubstruct(packed, "sub:subsystem")->firstField;
+    if(f->next != &f[1] || xGetSubstruct(packed, "sub:subsystem")->parent != xGetSubstruct(packed, "sub")) {
+      fprintf(stderr, "ERROR! packed substructure\n");
+      return 1;
+    }
+
+    // Modifications of a packed structure
+    xDestroyField(xRemoveField(packed, "f0"));
+    xDestroyField(xSetField(packed, xCreateIntField("f10", -10)));
+    xSetField(packed, xCreateIntField("new", 1));
+    if(checkIndexed(packed, NFIELDS + 1) || xGetAsLong(xGetField(packed, "f10"), 0) != -10) {
+      fprintf(stderr, "ERROR! modified packed structure\n");
+      return 1;
+    }
+
+    // Repacking, and copying
+    if(xPackStruct(packed) != X_SUCCESS || checkIndexed(packed, NFIELDS + 1)) return 1;
+    last = xRemoveField(packed, "new");
+    copy = xCopyOfStruct(packed);
+    xDestroyStruct(packed);
+
+    if(!copy || checkIndexed(copy, NFIELDS) || xGetAsLong(last, 0) != 1) {
+      fprintf(stderr, "ERROR! copy of packed structure\n");
+      return 1;
+    }
+
+    xDestroyField(last);
+    xDestroyStruct(copy);
+  }
+
+  // Fields with more dimensions than stored inline
+  {
+    int sizes[] = { 2, 1, 3, 1, 2 }, reduced[] = { 2, 3, 2 }, values[12] = {0};
+    XField *copy;
+
+    values[11] = 11;
+    f = xCreateField("dims", X_INT, 5, sizes, values);
+    if(!f || f->ndim != 5 || xGetFieldCount(f) != 12 || memcmp(xGetFieldSizes(f), sizes, sizeof(sizes)) != 0
+            || f->sizes[2] != 3 || xGetAsLongAtIndex(f, 11, 0) != 11) {
+      fprintf(stderr, "ERROR! extended dimensions\n");
+      return 1;
+    }
+
+    copy = xCopyOfField(f);
+    xDestroyField(f);
+    if(!copy || xGetFieldCount(copy) != 12 || memcmp(xGetFieldSizes(copy), sizes, sizeof(sizes)) != 0) {
+      fprintf(stderr, "ERROR! copy of extended dimensions\n");
+      return 1;
+    }
+
+    if(xReduceField(copy) != X_SUCCESS || copy->ndim != 3 || memcmp(xGetFieldSizes(copy), reduced, sizeof(reduced)) != 0) {
+      fprintf(stderr, "ERROR! reduced extended dimensions\n");
+      return 1;
+    }
+
+    if(xSetFieldDims(copy, X_MAX_DIMS + 1, sizes) != X_SIZE_INVALID || xSetFieldDims(copy, 0, NULL) != X_SUCCESS
+            || copy->ndim != 0 || xGetFieldSizes(copy)[0] != 1) {
+      fprintf(stderr, "ERROR! xSetFieldDims()\n");
+      return 1;
+    }
+    xDestroyField(copy);
+  }
+
+  // Reducing single-element heterogeneous arrays
+  {
+    XStructure *r = xCreateStruct();
+    XField *e = xCreate1DField("row", X_INT, 3, (int[]) { 1, 2, 3 }), row;
+
+    row = *e;
+    free(e->name);
+    free(e);
+    row.name = NULL;
+
+    xSetField(r, xCreateMixed1DField("mixed", 1, &row));
+    xSetField(r, xCreateIntField("after", 1));
+    free(row.name);
+
+    f = xGetField(r, "mixed");
+    if(xReduceStruct(r) != X_SUCCESS || f->type != X_INT || xGetFieldCount(f) != 3 || xGetAsLongAtIndex(f, 2, 0) != 3
+            || strcmp(f->name, "mixed") != 0 || !xGetField(r, "after")) {
+      fprintf(stderr, "ERROR! reduced mixed field\n");
+      return 1;
+    }
+
+    xDestroyStruct(r);
+  }
+
   xDestroyStruct(s);
 
   printf("OK\n");